@@ -0,0 +1,157 @@
+/**
+ * \file bench.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Helpers shared by the benchmark programs. Header-only, since each benchmark is built as its own executable
+ */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * \fn static inline uint64_t bench_now_ns()
+ * \brief Returns a monotonic timestamp in nanoseconds
+ *
+ * \return Nanoseconds since an arbitrary fixed point
+ */
+static inline uint64_t bench_now_ns() {
+
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t)(now.tv_sec) * 1000000000ull) + (uint64_t)(now.tv_nsec);
+}
+
+/**
+ * \fn static inline long bench_rss_kb()
+ * \brief Returns the peak resident set size of the calling process so far
+ *
+ * \return Peak RSS in KiB
+ */
+static inline long bench_rss_kb() {
+
+	struct rusage usage;
+
+	getrusage(RUSAGE_SELF, &usage);
+
+	return usage.ru_maxrss;
+}
+
+/**
+ * \fn static inline void* bench_shared_alloc(size_t size)
+ * \brief Allocates zeroed memory that stays shared with children created by bench_run_isolated, so a child can hand its results back
+ *
+ * \param size Number of bytes
+ *
+ * \return Pointer to the memory, or NULL on failure
+ */
+static inline void* bench_shared_alloc(size_t size) {
+
+	void* memory;
+
+	memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+	return (memory == MAP_FAILED) ? (NULL) : (memory);
+}
+
+/**
+ * \fn static inline int bench_run_isolated(void (*run)(void*), void* arg, long* peak_rss_kb)
+ * \brief Runs one benchmark case in a forked child so its peak RSS (and any heap it leaves behind) doesn't leak into the next case
+ *
+ * \param run Benchmark case to run. Should write its results through arg, which must come from bench_shared_alloc
+ * \param arg Passed to run
+ * \param peak_rss_kb Set to the child's peak RSS in KiB. May be NULL
+ *
+ * \return If the child exited cleanly, returns EXIT_SUCCESS (0). Otherwise returns EXIT_FAILURE (1)
+ */
+static inline int bench_run_isolated(void (*run)(void*), void* arg, long* peak_rss_kb) {
+
+	int status;
+	pid_t child;
+	struct rusage usage;
+
+	fflush(stdout);
+
+	child = fork();
+	if (child < 0) {
+		return EXIT_FAILURE;
+	}
+
+	if (child == 0) {
+		run(arg);
+		fflush(stdout);
+		_exit(EXIT_SUCCESS);
+	}
+
+	if (wait4(child, &status, 0, &usage) != child) {
+		return EXIT_FAILURE;
+	}
+
+	if (peak_rss_kb != NULL) {
+		*peak_rss_kb = usage.ru_maxrss;
+	}
+
+	return (WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS)) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+}
+
+/**
+ * \fn static inline int bench_compare_u64(const void* a, const void* b)
+ * \brief qsort comparator for uint64_t, ascending
+ *
+ * \param a First value
+ * \param b Second value
+ *
+ * \return Negative, 0 or positive as a is less than, equal to or greater than b
+ */
+static inline int bench_compare_u64(const void* a, const void* b) {
+
+	uint64_t x = *(const uint64_t*)(a);
+	uint64_t y = *(const uint64_t*)(b);
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * \fn static inline uint64_t bench_percentile(const uint64_t* sorted, size_t n, double p)
+ * \brief Nearest-rank percentile of samples already sorted with bench_compare_u64
+ *
+ * \param sorted The samples, ascending
+ * \param n Number of samples
+ * \param p Percentile wanted, from 0 to 100. 0 gives the minimum, 100 the maximum
+ *
+ * \return The sample at that rank, or 0 if there are no samples
+ */
+static inline uint64_t bench_percentile(const uint64_t* sorted, size_t n, double p) {
+
+	size_t rank;
+	double scaled;
+
+	if (n == 0) {
+		return 0;
+	}
+
+	// 1-based rank is ceil(p / 100 * n), rounded up by hand so benchmarks don't need libm. Index is one less, clamped to the samples
+	scaled = (p / 100.0) * (double)(n);
+	if (scaled <= 0.0) {
+		return sorted[0];
+	}
+
+	rank = (size_t)(scaled);
+	if ((double)(rank) < scaled) {
+		rank++;
+	}
+
+	return (rank >= n) ? (sorted[n - 1]) : (sorted[rank - 1]);
+}
+
+#endif // _BENCH_H_
@@ -0,0 +1,245 @@
+/**
+ * \file bench_cbfifo.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Throughput + latency of cbfifo_enqueue and cbfifo_dequeue for chunk sizes from 1 byte to 64 KiB, with the FIFO held at fill levels from empty to near-full. Each case runs twice: "sequential" lets head + tail advance naturally, "wrap" moves them before every call so the chunk straddles the end of the buffer
+ *
+ * Usage: ./bench_cbfifo [max_ops]   (default 100000 enqueue + dequeue pairs per case)
+ *
+ * Hardware counters (see bench_perf.h) cover the throughput pass and are reported per enqueue + dequeue pair
+ *
+ * Built by "make bench" with CB_SIZE raised to BENCH_CB_SIZE (128 KiB), since the 128-byte buffer main.c uses can't hold a 64 KiB chunk
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "bench_perf.h"
+#include "cbfifo.h"
+
+#ifndef CB_SIZE
+#define CB_SIZE ((size_t)(131072))
+#endif
+
+#define MAX_CHUNK ((size_t)(65536))
+#define DEFAULT_MAX_OPS ((size_t)(100000))
+#define MIN_OPS ((size_t)(200))
+#define TARGET_BYTES ((size_t)(16) << 20)
+
+/**
+ * \typedef cbfifo_t
+ * \brief Allows struct cbfifo_s to be instantiated as cbfifo_t
+ */
+typedef struct cbfifo_s cbfifo_t;
+
+/**
+ * \struct cbfifo_s
+ * \brief Circular buffer of fixed size. Must match the layout in cbfifo.c, which is built with the same CB_SIZE
+ *
+ * \detail uint8_t buf[CB_SIZE] - Buffer of fixed size. It is CB_SIZE number of bytes large
+ * \detail size_t head - Current head. This increments just after elements are added to buf
+ * \detail size_t tail - Current tail. This increments just after elements are removed from buf
+ * \detail size_t capacity - The amount of bytes the buffer can store at a time
+ * \detail size_t length - The amount of bytes currently stored in the buffer
+ * \detail bool is_full - Flag to keep track of status of the buf
+ */
+struct cbfifo_s {
+	uint8_t buf[CB_SIZE];
+	size_t head;
+	size_t tail;
+	size_t capacity;
+	size_t length;
+	bool is_full;
+};
+
+/**
+ * \var cbfifo_t cbfifo
+ * \brief The global instance cbfifo.c works on. main.c defines it for the unit tests, this defines it for the benchmark
+ */
+cbfifo_t cbfifo = { .head = 0, .tail = 0, .capacity = CB_SIZE, .length = 0, .is_full = false };
+
+/**
+ * \fn static void reset_fifo(size_t fill)
+ * \brief Empties the FIFO, then enqueues fill bytes, so every case starts at the same fill level with head + tail at the start of the buffer
+ *
+ * \param fill Bytes to leave queued
+ *
+ * \return N/A
+ */
+static void reset_fifo(size_t fill) {
+
+	static uint8_t filler[CB_SIZE];
+
+	cbfifo.head = 0;
+	cbfifo.tail = 0;
+	cbfifo.length = 0;
+	cbfifo.is_full = false;
+
+	if (fill > 0) {
+		cbfifo_enqueue(filler, fill);
+	}
+}
+
+/**
+ * \fn static void place_across_wrap(int head, size_t chunk)
+ * \brief Moves head (or tail) to chunk / 2 bytes before the end of the buffer, keeping the length, so the next call of chunk bytes crosses the wrap. Only moves indices, so it costs nothing next to the call being measured. Queued bytes are garbage afterwards, which the benchmark never looks at
+ *
+ * \param head Nonzero to place head for an enqueue, zero to place tail for a dequeue
+ * \param chunk Size of the next call
+ *
+ * \return N/A
+ */
+static void place_across_wrap(int head, size_t chunk) {
+
+	size_t position = CB_SIZE - ((chunk + 1) / 2);
+
+	if (head) {
+		cbfifo.head = position;
+		cbfifo.tail = (position + CB_SIZE - cbfifo.length) & (CB_SIZE - 1);
+	}
+	else {
+		cbfifo.tail = position;
+		cbfifo.head = (position + cbfifo.length) & (CB_SIZE - 1);
+	}
+}
+
+/**
+ * \fn static void run_case(const char* pattern, int wrap, size_t chunk, int fill_pct, size_t max_ops, uint8_t* data, uint64_t* enqueue_ns, uint64_t* dequeue_ns)
+ * \brief Measures one chunk size at one fill level + prints its CSV row. Each op is one cbfifo_enqueue of chunk bytes followed by one cbfifo_dequeue of chunk bytes
+ *
+ * \param pattern Label printed in the results
+ * \param wrap Nonzero to make every call cross the end of the buffer
+ * \param chunk Bytes per call
+ * \param fill_pct Fill level to hold the FIFO at, as a percentage of capacity. 100 means as full as still leaves room for one chunk
+ * \param max_ops Most ops to measure
+ * \param data Source + destination buffer of at least MAX_CHUNK bytes
+ * \param enqueue_ns Scratch space for max_ops latency samples
+ * \param dequeue_ns Scratch space for max_ops latency samples
+ * \param perf Hardware counters, already opened
+ *
+ * \return N/A
+ */
+static void run_case(const char* pattern, int wrap, size_t chunk, int fill_pct, size_t max_ops, uint8_t* data, uint64_t* enqueue_ns, uint64_t* dequeue_ns, bench_perf_t* perf) {
+
+	size_t i;
+	size_t ops;
+	size_t fill;
+	size_t moved = 0;
+	uint64_t start;
+	uint64_t elapsed;
+
+	// Hold the FIFO at the fill level, leaving room for one chunk
+	fill = (CB_SIZE * (size_t)(fill_pct)) / 100;
+	if (fill > (CB_SIZE - chunk)) {
+		fill = CB_SIZE - chunk;
+	}
+
+	// Move about TARGET_BYTES per case, within MIN_OPS..max_ops ops
+	ops = TARGET_BYTES / chunk;
+	ops = (ops < MIN_OPS) ? (MIN_OPS) : (ops);
+	ops = (ops > max_ops) ? (max_ops) : (ops);
+
+	// Throughput pass: one clock read around the whole loop
+	reset_fifo(fill);
+	bench_perf_start(perf);
+	start = bench_now_ns();
+	for (i = 0; i < ops; i++) {
+		if (wrap) {
+			place_across_wrap(1, chunk);
+		}
+		moved += cbfifo_enqueue(data, chunk);
+		if (wrap) {
+			place_across_wrap(0, chunk);
+		}
+		moved -= cbfifo_dequeue(data, chunk);
+	}
+	elapsed = bench_now_ns() - start;
+	bench_perf_stop(perf);
+
+	// Latency pass: one clock read around each call, so samples include the cost of reading the clock
+	reset_fifo(fill);
+	for (i = 0; i < ops; i++) {
+		if (wrap) {
+			place_across_wrap(1, chunk);
+		}
+		start = bench_now_ns();
+		moved += cbfifo_enqueue(data, chunk);
+		enqueue_ns[i] = bench_now_ns() - start;
+
+		if (wrap) {
+			place_across_wrap(0, chunk);
+		}
+		start = bench_now_ns();
+		moved -= cbfifo_dequeue(data, chunk);
+		dequeue_ns[i] = bench_now_ns() - start;
+	}
+
+	qsort(enqueue_ns, ops, sizeof(uint64_t), bench_compare_u64);
+	qsort(dequeue_ns, ops, sizeof(uint64_t), bench_compare_u64);
+
+	// Bytes go through the FIFO once per op, in + out
+	printf("%s,%zu,%d,%zu,%zu,%.2f,%.3f,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%s",
+		pattern,
+		chunk,
+		fill_pct,
+		fill,
+		ops,
+		(double)(elapsed) / (double)(ops),
+		((double)(chunk) * (double)(ops)) / (double)(elapsed),
+		(unsigned long long)bench_percentile(enqueue_ns, ops, 50.0),
+		(unsigned long long)bench_percentile(enqueue_ns, ops, 99.0),
+		(unsigned long long)bench_percentile(enqueue_ns, ops, 99.9),
+		(unsigned long long)bench_percentile(enqueue_ns, ops, 100.0),
+		(unsigned long long)bench_percentile(dequeue_ns, ops, 50.0),
+		(unsigned long long)bench_percentile(dequeue_ns, ops, 99.0),
+		(unsigned long long)bench_percentile(dequeue_ns, ops, 99.9),
+		(unsigned long long)bench_percentile(dequeue_ns, ops, 100.0),
+		(moved == 0) ? "yes" : "no");
+	bench_perf_print(perf, ops);
+	printf("\n");
+}
+
+int main(int argc, char** argv) {
+
+	int f;
+	int wrap;
+	size_t chunk;
+	size_t max_ops;
+	uint8_t* data;
+	uint64_t* enqueue_ns;
+	uint64_t* dequeue_ns;
+	bench_perf_t perf;
+	const int fill_pcts[5] = { 0, 25, 50, 75, 100 };
+
+	max_ops = (argc > 1) ? (size_t)(strtoull(argv[1], NULL, 10)) : (DEFAULT_MAX_OPS);
+	max_ops = (max_ops < MIN_OPS) ? (MIN_OPS) : (max_ops);
+
+	data = (uint8_t*)malloc(MAX_CHUNK);
+	enqueue_ns = (uint64_t*)malloc(max_ops * sizeof(uint64_t));
+	dequeue_ns = (uint64_t*)malloc(max_ops * sizeof(uint64_t));
+	if ((data == NULL) || (enqueue_ns == NULL) || (dequeue_ns == NULL) || (cbfifo_capacity() < (2 * MAX_CHUNK))) {
+		return EXIT_FAILURE;
+	}
+	memset(data, 0xA5, MAX_CHUNK);
+	bench_perf_open(&perf);
+
+	printf("pattern,chunk_bytes,fill_pct,fill_bytes,ops,ns_per_op,gb_per_s,enqueue_p50_ns,enqueue_p99_ns,enqueue_p999_ns,enqueue_max_ns,dequeue_p50_ns,dequeue_p99_ns,dequeue_p999_ns,dequeue_max_ns,ok" BENCH_PERF_CSV_HEADER "\n");
+
+	for (wrap = 0; wrap < 2; wrap++) {
+		for (chunk = 1; chunk <= MAX_CHUNK; chunk *= 2) {
+			for (f = 0; f < 5; f++) {
+				run_case((wrap) ? ("wrap") : ("sequential"), wrap, chunk, fill_pcts[f], max_ops, data, enqueue_ns, dequeue_ns, &perf);
+			}
+		}
+	}
+
+	bench_perf_close(&perf);
+	free(data);
+	free(enqueue_ns);
+	free(dequeue_ns);
+
+	return EXIT_SUCCESS;
+}
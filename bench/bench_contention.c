@@ -0,0 +1,609 @@
+/**
+ * \file bench_contention.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Producer/consumer contention benchmark. Each producer thread sends messages stamped with the time they were enqueued, and consumers record how long each one took to come out the other side. Runs every FIFO flavor below with the same thread counts + CPU placement, and reports throughput plus p50/p99/p99.9 hand-off latency
+ *
+ * Flavors:
+ *	llfifo_mutex - plain llfifo behind one pthread mutex taken by the caller. Consumers poll. The baseline
+ *	llfifo_sync - llfifo in synchronized mode. Consumers block in llfifo_dequeue_wait
+ *	llfifo_sync_batch - llfifo in synchronized mode. Consumers take up to BATCH_SIZE at a time with llfifo_dequeue_batch, parking in llfifo_dequeue_wait when it is empty
+ *	cbfifo_mutex - the global cbfifo behind the same mutex, carrying each message as its 8-byte pointer. Producers retry while it is full, consumers poll
+ *
+ * Usage: ./bench_contention [producers] [consumers] [messages_per_producer] [cpus]   (default 2 2 1000000 all)
+ *	cpus - Comma-separated CPU numbers. Thread i (producers first, then consumers) is pinned to the (i mod count)th one. "all" pins round-robin over every online CPU, "none" doesn't pin. Pick CPUs on one socket, across sockets, or on hyperthread siblings to see what each placement costs
+ *
+ * Built by "make bench" with CB_SIZE set to BENCH_CONTENTION_CB_SIZE, so the cbfifo holds a few hundred messages
+ */
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+#include "cbfifo.h"
+#include "llfifo.h"
+#include "llfifo_ext.h"
+
+#ifndef CB_SIZE
+#define CB_SIZE ((size_t)(4096))
+#endif
+
+#define DEFAULT_PRODUCERS (2)
+#define DEFAULT_CONSUMERS (2)
+#define DEFAULT_MESSAGES ((size_t)(1000000))
+#define MAX_THREADS (256)
+#define BATCH_SIZE (64)
+
+/**
+ * \typedef cbfifo_t
+ * \brief Allows struct cbfifo_s to be instantiated as cbfifo_t
+ */
+typedef struct cbfifo_s cbfifo_t;
+
+/**
+ * \struct cbfifo_s
+ * \brief Circular buffer of fixed size. Must match the layout in cbfifo.c, which is built with the same CB_SIZE
+ *
+ * \detail uint8_t buf[CB_SIZE] - Buffer of fixed size. It is CB_SIZE number of bytes large
+ * \detail size_t head - Current head. This increments just after elements are added to buf
+ * \detail size_t tail - Current tail. This increments just after elements are removed from buf
+ * \detail size_t capacity - The amount of bytes the buffer can store at a time
+ * \detail size_t length - The amount of bytes currently stored in the buffer
+ * \detail bool is_full - Flag to keep track of status of the buf
+ */
+struct cbfifo_s {
+	uint8_t buf[CB_SIZE];
+	size_t head;
+	size_t tail;
+	size_t capacity;
+	size_t length;
+	bool is_full;
+};
+
+/**
+ * \var cbfifo_t cbfifo
+ * \brief The global instance cbfifo.c works on. main.c defines it for the unit tests, this defines it for the benchmark
+ */
+cbfifo_t cbfifo = { .head = 0, .tail = 0, .capacity = CB_SIZE, .length = 0, .is_full = false };
+
+/**
+ * \typedef message_t
+ * \brief Allows struct message_s to be instantiated as message_t
+ */
+typedef struct message_s message_t;
+
+/**
+ * \struct message_s
+ * \brief Payload carried through the FIFO. Producers own an array of these, so sending one doesn't allocate
+ *
+ * \detail uint64_t sent_ns - When the producer enqueued it
+ */
+struct message_s {
+	uint64_t sent_ns;
+};
+
+/**
+ * \typedef flavor_t
+ * \brief Which FIFO + locking scheme a run uses
+ */
+typedef enum {
+	FLAVOR_LLFIFO_MUTEX,
+	FLAVOR_LLFIFO_SYNC,
+	FLAVOR_LLFIFO_SYNC_BATCH,
+	FLAVOR_CBFIFO_MUTEX,
+	FLAVOR_COUNT
+} flavor_t;
+
+/**
+ * \var static const char* flavor_names[]
+ * \brief Label printed for each flavor
+ */
+static const char* flavor_names[FLAVOR_COUNT] = { "llfifo_mutex", "llfifo_sync", "llfifo_sync_batch", "cbfifo_mutex" };
+
+/**
+ * \typedef run_t
+ * \brief Allows struct run_s to be instantiated as run_t
+ */
+typedef struct run_s run_t;
+
+/**
+ * \struct run_s
+ * \brief Everything the threads of one run share
+ *
+ * \detail flavor_t flavor - FIFO flavor being measured
+ * \detail llfifo_t* fifo - The FIFO. Unused by FLAVOR_CBFIFO_MUTEX, which goes through the global cbfifo
+ * \detail pthread_mutex_t lock - Taken around every FIFO call in FLAVOR_LLFIFO_MUTEX + FLAVOR_CBFIFO_MUTEX
+ * \detail pthread_mutex_t gate - Guards ready + go
+ * \detail pthread_cond_t gate_changed - Signalled when ready or go changes
+ * \detail int ready - Threads waiting at the gate
+ * \detail int go - 0 until every thread is ready, then 1 to start them all at once. -1 if a thread couldn't be created, in which case the others leave without running
+ * \detail size_t messages - Messages each producer sends
+ * \detail atomic_int producers_left - Producers still sending. Polling consumers exit once it is 0 + the FIFO is empty
+ * \detail atomic_size_t received - Messages consumed so far, across consumers
+ * \detail uint64_t* latency_ns - One hand-off latency per message, filled in by whichever consumer got it
+ */
+struct run_s {
+	flavor_t flavor;
+	llfifo_t* fifo;
+	pthread_mutex_t lock;
+	pthread_mutex_t gate;
+	pthread_cond_t gate_changed;
+	int ready;
+	int go;
+	size_t messages;
+	atomic_int producers_left;
+	atomic_size_t received;
+	uint64_t* latency_ns;
+};
+
+/**
+ * \typedef worker_t
+ * \brief Allows struct worker_s to be instantiated as worker_t
+ */
+typedef struct worker_s worker_t;
+
+/**
+ * \struct worker_s
+ * \brief One producer or consumer thread
+ *
+ * \detail run_t* run - The run it belongs to
+ * \detail pthread_t thread - The thread
+ * \detail int cpu - CPU to pin to, or -1 to leave it to the scheduler
+ * \detail int pinned - Set by the thread once pinning succeeded
+ * \detail message_t* messages - Producers only: the messages to send
+ */
+struct worker_s {
+	run_t* run;
+	pthread_t thread;
+	int cpu;
+	int pinned;
+	message_t* messages;
+};
+
+/**
+ * \fn static void pin(worker_t* worker)
+ * \brief Pins the calling thread to worker->cpu, if one was chosen
+ *
+ * \param worker The worker running on this thread
+ *
+ * \return N/A
+ */
+static void pin(worker_t* worker) {
+
+	cpu_set_t set;
+
+	if (worker->cpu < 0) {
+		return;
+	}
+
+	CPU_ZERO(&set);
+	CPU_SET(worker->cpu, &set);
+	worker->pinned = (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0);
+}
+
+/**
+ * \fn static int wait_at_gate(run_t* run)
+ * \brief Blocks the calling worker until run_flavor starts the run
+ *
+ * \param run The run in question
+ *
+ * \return 1 to start measuring, or 0 if the run was called off
+ */
+static int wait_at_gate(run_t* run) {
+
+	int go;
+
+	pthread_mutex_lock(&(run->gate));
+	run->ready++;
+	pthread_cond_broadcast(&(run->gate_changed));
+	while (run->go == 0) {
+		pthread_cond_wait(&(run->gate_changed), &(run->gate));
+	}
+	go = run->go;
+	pthread_mutex_unlock(&(run->gate));
+
+	return (go > 0);
+}
+
+/**
+ * \fn static int is_locked(flavor_t flavor)
+ * \brief Whether a flavor takes run->lock around every FIFO call, as opposed to relying on llfifo's synchronized mode
+ *
+ * \param flavor The flavor in question
+ *
+ * \return 1 for FLAVOR_LLFIFO_MUTEX + FLAVOR_CBFIFO_MUTEX, 0 otherwise
+ */
+static int is_locked(flavor_t flavor) {
+
+	return (flavor == FLAVOR_LLFIFO_MUTEX) || (flavor == FLAVOR_CBFIFO_MUTEX);
+}
+
+/**
+ * \fn static int enqueue_locked(run_t* run, message_t* message)
+ * \brief Sends a message under run->lock. cbfifo carries the message's pointer, 8 bytes at a time, so a capacity that is a multiple of 8 never splits one
+ *
+ * \param run The run in question
+ * \param message The message
+ *
+ * \return 1 if the message was enqueued, 0 if the FIFO was full
+ */
+static int enqueue_locked(run_t* run, message_t* message) {
+
+	int sent;
+
+	pthread_mutex_lock(&(run->lock));
+	if (run->flavor == FLAVOR_CBFIFO_MUTEX) {
+		sent = (cbfifo_enqueue(&message, sizeof(message)) == sizeof(message));
+	}
+	else {
+		sent = (llfifo_enqueue(run->fifo, message) > 0);
+	}
+	pthread_mutex_unlock(&(run->lock));
+
+	return sent;
+}
+
+/**
+ * \fn static message_t* dequeue_locked(run_t* run)
+ * \brief Takes a message under run->lock
+ *
+ * \param run The run in question
+ *
+ * \return The message, or NULL if the FIFO was empty
+ */
+static message_t* dequeue_locked(run_t* run) {
+
+	message_t* message = NULL;
+
+	pthread_mutex_lock(&(run->lock));
+	if (run->flavor == FLAVOR_CBFIFO_MUTEX) {
+		if (cbfifo_dequeue(&message, sizeof(message)) != sizeof(message)) {
+			message = NULL;
+		}
+	}
+	else {
+		message = (message_t*)(llfifo_dequeue(run->fifo));
+	}
+	pthread_mutex_unlock(&(run->lock));
+
+	return message;
+}
+
+/**
+ * \fn static size_t length_locked(run_t* run)
+ * \brief Reads how full the FIFO is under run->lock
+ *
+ * \param run The run in question
+ *
+ * \return Bytes queued for FLAVOR_CBFIFO_MUTEX, messages queued otherwise
+ */
+static size_t length_locked(run_t* run) {
+
+	size_t length;
+
+	pthread_mutex_lock(&(run->lock));
+	length = (run->flavor == FLAVOR_CBFIFO_MUTEX) ? (cbfifo_length()) : ((size_t)(llfifo_length(run->fifo)));
+	pthread_mutex_unlock(&(run->lock));
+
+	return length;
+}
+
+/**
+ * \fn static void record(run_t* run, message_t* message)
+ * \brief Stores the hand-off latency of a message that just came out of the FIFO
+ *
+ * \param run The run in question
+ * \param message The message
+ *
+ * \return N/A
+ */
+static void record(run_t* run, message_t* message) {
+
+	uint64_t now = bench_now_ns();
+	size_t slot = atomic_fetch_add_explicit(&(run->received), 1, memory_order_relaxed);
+
+	run->latency_ns[slot] = now - message->sent_ns;
+}
+
+/**
+ * \fn static void* producer_main(void* arg)
+ * \brief Producer thread: stamps + sends each of its messages as fast as the FIFO takes them
+ *
+ * \param arg The worker_t
+ *
+ * \return NULL
+ */
+static void* producer_main(void* arg) {
+
+	size_t i;
+	worker_t* worker = (worker_t*)arg;
+	run_t* run = worker->run;
+
+	pin(worker);
+	if (!wait_at_gate(run)) {
+		return NULL;
+	}
+
+	for (i = 0; i < run->messages; i++) {
+
+		worker->messages[i].sent_ns = bench_now_ns();
+
+		if (is_locked(run->flavor)) {
+
+			// cbfifo is bounded, so wait for the consumers to make room
+			while (!enqueue_locked(run, &(worker->messages[i]))) {
+				sched_yield();
+			}
+		}
+		else {
+			llfifo_enqueue(run->fifo, &(worker->messages[i]));
+		}
+	}
+
+	// Last producer out closes the FIFO, which lets blocked consumers finish
+	if (atomic_fetch_sub(&(run->producers_left), 1) == 1) {
+		if (!is_locked(run->flavor)) {
+			llfifo_close(run->fifo);
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \fn static void* consumer_main(void* arg)
+ * \brief Consumer thread: takes messages until every producer is done + the FIFO is empty, recording each one's latency
+ *
+ * \param arg The worker_t
+ *
+ * \return NULL
+ */
+static void* consumer_main(void* arg) {
+
+	int i;
+	int n;
+	void* element;
+	void* batch[BATCH_SIZE];
+	worker_t* worker = (worker_t*)arg;
+	run_t* run = worker->run;
+
+	pin(worker);
+	if (!wait_at_gate(run)) {
+		return NULL;
+	}
+
+	while (1) {
+
+		if (is_locked(run->flavor)) {
+			element = dequeue_locked(run);
+
+			if (element != NULL) {
+				record(run, (message_t*)(element));
+			}
+
+			// Producers may have enqueued between the dequeue + the check
+			else if ((atomic_load(&(run->producers_left)) == 0) && (length_locked(run) == 0)) {
+				break;
+			}
+			else {
+				sched_yield();
+			}
+		}
+
+		else if (run->flavor == FLAVOR_LLFIFO_SYNC) {
+			element = llfifo_dequeue_wait(run->fifo, -1);
+			if (element == NULL) {
+				break;
+			}
+			record(run, (message_t*)(element));
+		}
+
+		else {
+			n = llfifo_dequeue_batch(run->fifo, batch, BATCH_SIZE);
+			if (n <= 0) {
+				element = llfifo_dequeue_wait(run->fifo, -1);
+				if (element == NULL) {
+					break;
+				}
+				record(run, (message_t*)(element));
+			}
+			for (i = 0; i < n; i++) {
+				record(run, (message_t*)(batch[i]));
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \fn static int parse_cpus(const char* spec, int* cpus, int max)
+ * \brief Turns the cpus argument into a list of CPU numbers
+ *
+ * \param spec "all", "none", or comma-separated CPU numbers
+ * \param cpus Filled in with the CPUs
+ * \param max Size of cpus
+ *
+ * \return Number of CPUs in the list. 0 means don't pin
+ */
+static int parse_cpus(const char* spec, int* cpus, int max) {
+
+	int count = 0;
+	long online;
+	char* end;
+
+	if (strcmp(spec, "none") == 0) {
+		return 0;
+	}
+
+	if (strcmp(spec, "all") == 0) {
+		online = sysconf(_SC_NPROCESSORS_ONLN);
+		for (count = 0; (count < online) && (count < max); count++) {
+			cpus[count] = count;
+		}
+		return count;
+	}
+
+	while ((*spec != '\0') && (count < max)) {
+		cpus[count++] = (int)strtol(spec, &end, 10);
+		spec = (*end == ',') ? (end + 1) : (end);
+		if (end == spec) {
+			break;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * \fn static void run_flavor(flavor_t flavor, int producers, int consumers, size_t messages, const int* cpus, int cpu_count, const char* cpu_spec)
+ * \brief Runs one flavor + prints its CSV row
+ *
+ * \param flavor FIFO flavor to measure
+ * \param producers Number of producer threads
+ * \param consumers Number of consumer threads
+ * \param messages Messages each producer sends
+ * \param cpus CPUs to pin threads to
+ * \param cpu_count Number of CPUs in cpus. 0 means don't pin
+ * \param cpu_spec The cpus argument, printed as is
+ *
+ * \return N/A
+ */
+static void run_flavor(flavor_t flavor, int producers, int consumers, size_t messages, const int* cpus, int cpu_count, const char* cpu_spec) {
+
+	int i;
+	int created;
+	int pinned = 1;
+	size_t total;
+	size_t received;
+	uint64_t start;
+	uint64_t elapsed = 0;
+	run_t run;
+	worker_t workers[MAX_THREADS];
+
+	total = messages * (size_t)(producers);
+
+	memset(&run, 0, sizeof(run));
+	run.flavor = flavor;
+	run.messages = messages;
+	run.fifo = llfifo_create(0);
+	run.latency_ns = (uint64_t*)malloc(total * sizeof(uint64_t));
+	atomic_init(&(run.producers_left), producers);
+	atomic_init(&(run.received), 0);
+	pthread_mutex_init(&(run.lock), NULL);
+	pthread_mutex_init(&(run.gate), NULL);
+	pthread_cond_init(&(run.gate_changed), NULL);
+	run.ready = 0;
+	run.go = 0;
+
+	// Every producer's messages up front, so a failed allocation is caught before any thread starts
+	for (i = 0; i < (producers + consumers); i++) {
+		workers[i].run = &run;
+		workers[i].cpu = (cpu_count > 0) ? (cpus[i % cpu_count]) : (-1);
+		workers[i].pinned = 0;
+		workers[i].messages = (i < producers) ? ((message_t*)calloc(messages, sizeof(message_t))) : (NULL);
+		if ((i < producers) && (workers[i].messages == NULL)) {
+			run.go = -1;
+		}
+	}
+
+	if ((run.go == 0) && (run.fifo != NULL) && (run.latency_ns != NULL) && (is_locked(flavor) || (llfifo_enable_sync(run.fifo) == EXIT_SUCCESS))) {
+
+		for (created = 0; created < (producers + consumers); created++) {
+			if (pthread_create(&(workers[created].thread), NULL, (created < producers) ? (producer_main) : (consumer_main), &workers[created]) != 0) {
+				break;
+			}
+		}
+
+		// Start everyone at once, or call the run off if a thread is missing
+		pthread_mutex_lock(&(run.gate));
+		while ((created == (producers + consumers)) && (run.ready < created)) {
+			pthread_cond_wait(&(run.gate_changed), &(run.gate));
+		}
+		run.go = (created == (producers + consumers)) ? (1) : (-1);
+		pthread_cond_broadcast(&(run.gate_changed));
+		pthread_mutex_unlock(&(run.gate));
+
+		start = bench_now_ns();
+
+		for (i = 0; i < created; i++) {
+			pthread_join(workers[i].thread, NULL);
+			if ((cpu_count > 0) && !(workers[i].pinned)) {
+				pinned = 0;
+			}
+		}
+
+		elapsed = bench_now_ns() - start;
+	}
+
+	if (run.go > 0) {
+
+		// Only the first received slots were filled in
+		received = atomic_load(&(run.received));
+		qsort(run.latency_ns, received, sizeof(uint64_t), bench_compare_u64);
+
+		printf("%s,%d,%d,%zu,%s,%s,%.0f,%llu,%llu,%llu,%llu,%s\n",
+			flavor_names[flavor],
+			producers,
+			consumers,
+			messages,
+			cpu_spec,
+			(cpu_count == 0) ? ("no") : ((pinned) ? ("yes") : ("failed")),
+			((double)(received) * 1e9) / (double)(elapsed),
+			(unsigned long long)bench_percentile(run.latency_ns, received, 50.0),
+			(unsigned long long)bench_percentile(run.latency_ns, received, 99.0),
+			(unsigned long long)bench_percentile(run.latency_ns, received, 99.9),
+			(unsigned long long)bench_percentile(run.latency_ns, received, 100.0),
+			(received == total) ? "yes" : "no");
+	}
+	else {
+		printf("%s,%d,%d,%zu,%s,,,,,,,failed\n", flavor_names[flavor], producers, consumers, messages, cpu_spec);
+	}
+
+	for (i = 0; i < producers; i++) {
+		free(workers[i].messages);
+	}
+	free(run.latency_ns);
+	llfifo_destroy(run.fifo);
+	pthread_cond_destroy(&(run.gate_changed));
+	pthread_mutex_destroy(&(run.gate));
+	pthread_mutex_destroy(&(run.lock));
+}
+
+int main(int argc, char** argv) {
+
+	int flavor;
+	int producers;
+	int consumers;
+	int cpu_count;
+	int cpus[MAX_THREADS];
+	size_t messages;
+	const char* cpu_spec;
+
+	producers = (argc > 1) ? (atoi(argv[1])) : (DEFAULT_PRODUCERS);
+	consumers = (argc > 2) ? (atoi(argv[2])) : (DEFAULT_CONSUMERS);
+	messages = (argc > 3) ? (size_t)(strtoull(argv[3], NULL, 10)) : (DEFAULT_MESSAGES);
+	cpu_spec = (argc > 4) ? (argv[4]) : ("all");
+
+	if ((producers <= 0) || (consumers <= 0) || ((producers + consumers) > MAX_THREADS) || (messages == 0)) {
+		return EXIT_FAILURE;
+	}
+
+	cpu_count = parse_cpus(cpu_spec, cpus, MAX_THREADS);
+
+	printf("flavor,producers,consumers,messages_per_producer,cpus,pinned,msgs_per_sec,p50_ns,p99_ns,p999_ns,max_ns,ok\n");
+
+	for (flavor = 0; flavor < FLAVOR_COUNT; flavor++) {
+		run_flavor((flavor_t)(flavor), producers, consumers, messages, cpus, cpu_count, cpu_spec);
+	}
+
+	return EXIT_SUCCESS;
+}
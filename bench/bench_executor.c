@@ -0,0 +1,180 @@
+/**
+ * \file bench_executor.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Throughput + queueing latency of executor for tiny tasks, submitted one at a time vs in batches, on 1..N workers. A second case has each task spawn children from inside the pool, so they go to the worker's local wsdeque instead of the shared injection queue
+ *
+ * Usage: ./bench_executor [tasks] [max_workers]   (default 1000000, number of online CPUs)
+ */
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "bench.h"
+#include "executor.h"
+
+#define DEFAULT_TASKS (1000000)
+#define BATCH_SIZE (256)
+#define SPAWN_FANOUT (16)
+
+/**
+ * \var static atomic_long bench_done
+ * \brief Number of tasks that have run so far in the current case
+ */
+static atomic_long bench_done;
+
+/**
+ * \var static executor_t* bench_executor
+ * \brief Executor of the current case, so spawning tasks can submit to it
+ */
+static executor_t* bench_executor;
+
+/**
+ * \fn static void bench_task(void* arg)
+ * \brief Smallest possible task: just counts itself, so the bench measures executor overhead
+ *
+ * \param arg Unused
+ *
+ * \return N/A
+ */
+static void bench_task(void* arg) {
+
+	(void)arg;
+	atomic_fetch_add_explicit(&bench_done, 1, memory_order_relaxed);
+}
+
+/**
+ * \fn static void bench_spawn_task(void* arg)
+ * \brief Counts itself, then submits SPAWN_FANOUT bench_task children from inside the pool
+ *
+ * \param arg Unused
+ *
+ * \return N/A
+ */
+static void bench_spawn_task(void* arg) {
+
+	int i;
+
+	atomic_fetch_add_explicit(&bench_done, 1, memory_order_relaxed);
+
+	for (i = 0; i < SPAWN_FANOUT; i++) {
+		executor_submit(bench_executor, bench_task, arg);
+	}
+}
+
+/**
+ * \fn static int next_worker_count(int workers)
+ * \brief Steps through 1, 2, 3, 4, 8, 16, ... workers
+ *
+ * \param workers The current worker count
+ *
+ * \return The next worker count to try
+ */
+static int next_worker_count(int workers) {
+
+	return (workers < 4) ? (workers + 1) : (workers * 2);
+}
+
+/**
+ * \fn static void run_case(const char* name, int workers, long tasks, int mode)
+ * \brief Runs one case + prints its CSV row
+ *
+ * \param name Label printed in the results
+ * \param workers Number of workers
+ * \param tasks Number of tasks to run in total
+ * \param mode 0 to submit one at a time, 1 to submit in batches of BATCH_SIZE, 2 to submit spawning tasks that each fan out SPAWN_FANOUT children
+ *
+ * \return N/A
+ */
+static void run_case(const char* name, int workers, long tasks, int mode) {
+
+	int i;
+	long submitted;
+	uint64_t start;
+	uint64_t elapsed;
+	uint64_t latency_sum = 0;
+	uint64_t latency_max = 0;
+	uint64_t executed = 0;
+	uint64_t stolen = 0;
+	void* args[BATCH_SIZE] = { NULL };
+	executor_stats_t stats;
+
+	bench_executor = executor_create(workers);
+	if (bench_executor == NULL) {
+		printf("%s,%d,%ld,,,,,failed\n", name, workers, tasks);
+		return;
+	}
+
+	atomic_store(&bench_done, 0);
+
+	start = bench_now_ns();
+
+	if (mode == 0) {
+		for (submitted = 0; submitted < tasks; submitted++) {
+			executor_submit(bench_executor, bench_task, NULL);
+		}
+	}
+	else if (mode == 1) {
+		for (submitted = 0; submitted < tasks; submitted += BATCH_SIZE) {
+			executor_submit_batch(bench_executor, bench_task, args, (int)(((tasks - submitted) < BATCH_SIZE) ? (tasks - submitted) : (BATCH_SIZE)));
+		}
+	}
+	else {
+		for (submitted = 0; submitted < tasks; submitted += SPAWN_FANOUT + 1) {
+			executor_submit(bench_executor, bench_spawn_task, NULL);
+		}
+		tasks = (submitted / (SPAWN_FANOUT + 1)) * (SPAWN_FANOUT + 1);
+	}
+
+	executor_shutdown(bench_executor);
+	elapsed = bench_now_ns() - start;
+
+	for (i = 0; i < workers; i++) {
+		executor_stats(bench_executor, i, &stats);
+		executed += stats.executed;
+		stolen += stats.stolen;
+		latency_sum += stats.latency_avg_ns * stats.executed;
+		if (stats.latency_max_ns > latency_max) {
+			latency_max = stats.latency_max_ns;
+		}
+	}
+
+	printf("%s,%d,%ld,%.2f,%.2f,%llu,%llu,%s\n",
+		name,
+		workers,
+		tasks,
+		(double)(elapsed) / (double)(tasks),
+		(executed > 0) ? ((double)(latency_sum) / (double)(executed)) : (0.0),
+		(unsigned long long)(latency_max),
+		(unsigned long long)(stolen),
+		((executed == (uint64_t)(tasks)) && (atomic_load(&bench_done) == tasks)) ? "yes" : "no");
+
+	executor_destroy(bench_executor);
+	bench_executor = NULL;
+}
+
+int main(int argc, char** argv) {
+
+	int workers;
+	int max_workers;
+	long tasks;
+
+	tasks = (argc > 1) ? (strtol(argv[1], NULL, 10)) : (DEFAULT_TASKS);
+	max_workers = (argc > 2) ? (atoi(argv[2])) : ((int)sysconf(_SC_NPROCESSORS_ONLN));
+
+	if ((tasks <= 0) || (max_workers <= 0)) {
+		return EXIT_FAILURE;
+	}
+
+	printf("case,workers,tasks,ns_per_task,latency_avg_ns,latency_max_ns,stolen,ok\n");
+
+	for (workers = 1; workers <= max_workers; workers = next_worker_count(workers)) {
+		run_case("submit", workers, tasks, 0);
+		run_case("submit_batch", workers, tasks, 1);
+		run_case("spawn", workers, tasks, 2);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,523 @@
+/**
+ * \file bench_llfifo.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Runs FIFO engines through the access patterns real queues see: steady state, burst fill then drain, sawtooth, create/destroy churn and very deep queues. Reports ops/sec, malloc + free calls, peak RSS and bytes per element. Every engine is driven through the same 4 calls (create, enqueue, dequeue, destroy), so another engine is compared by adding one entry to the engines table
+ *
+ * Usage: ./bench_llfifo [elements]   (default 10000000, the depth of the deep pattern. The other patterns scale from it)
+ *
+ * Hardware counters (see bench_perf.h) cover the same region as ops/sec and are reported per enqueue or dequeue
+ *
+ * Built by "make bench" with -Wl,--wrap for malloc, calloc, realloc + free, so every allocation the engines make passes through the counting wrappers below
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "bench_perf.h"
+#include "llfifo.h"
+#include "llfifo_compact.h"
+
+#define DEFAULT_ELEMENTS ((size_t)(10000000))
+#define STEADY_IN_FLIGHT ((size_t)(1024))
+#define BURST_ROUNDS ((size_t)(10))
+#define SAWTOOTH_RISE ((size_t)(1000))
+#define SAWTOOTH_FALL ((size_t)(500))
+#define CHURN_ELEMENTS ((size_t)(16))
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+/**
+ * \var static size_t alloc_calls
+ * \brief malloc + calloc calls made by the code under test since the case started
+ */
+static size_t alloc_calls;
+
+/**
+ * \var static size_t realloc_calls
+ * \brief realloc calls made by the code under test since the case started
+ */
+static size_t realloc_calls;
+
+/**
+ * \var static size_t free_calls
+ * \brief free calls made by the code under test since the case started
+ */
+static size_t free_calls;
+
+/**
+ * \fn void* __wrap_malloc(size_t size)
+ * \brief Counts the call, then forwards to the real malloc
+ */
+void* __wrap_malloc(size_t size) {
+
+	alloc_calls++;
+
+	return __real_malloc(size);
+}
+
+/**
+ * \fn void* __wrap_calloc(size_t count, size_t size)
+ * \brief Counts the call, then forwards to the real calloc
+ */
+void* __wrap_calloc(size_t count, size_t size) {
+
+	alloc_calls++;
+
+	return __real_calloc(count, size);
+}
+
+/**
+ * \fn void* __wrap_realloc(void* ptr, size_t size)
+ * \brief Counts the call, then forwards to the real realloc
+ */
+void* __wrap_realloc(void* ptr, size_t size) {
+
+	realloc_calls++;
+
+	return __real_realloc(ptr, size);
+}
+
+/**
+ * \fn void __wrap_free(void* ptr)
+ * \brief Counts the call, then forwards to the real free. free(NULL) isn't counted
+ */
+void __wrap_free(void* ptr) {
+
+	if (ptr != NULL) {
+		free_calls++;
+	}
+
+	__real_free(ptr);
+}
+
+/**
+ * \typedef engine_t
+ * \brief Allows struct engine_s to be instantiated as engine_t
+ */
+typedef struct engine_s engine_t;
+
+/**
+ * \struct engine_s
+ * \brief One FIFO implementation, adapted to the calls the patterns make
+ *
+ * \detail const char* name - Label printed in the results
+ * \detail void* (*create)(void) - Creates an empty FIFO with no preallocated capacity
+ * \detail int (*enqueue)(void* fifo, void* element) - Returns 0 on success
+ * \detail void* (*dequeue)(void* fifo) - Returns NULL when empty
+ * \detail void (*destroy)(void* fifo) - Frees the FIFO
+ */
+struct engine_s {
+	const char* name;
+	void* (*create)(void);
+	int (*enqueue)(void* fifo, void* element);
+	void* (*dequeue)(void* fifo);
+	void (*destroy)(void* fifo);
+};
+
+/**
+ * \fn static void* llfifo_engine_create(void)
+ * \brief llfifo_create with capacity 0
+ */
+static void* llfifo_engine_create(void) {
+
+	return llfifo_create(0);
+}
+
+/**
+ * \fn static int llfifo_engine_enqueue(void* fifo, void* element)
+ * \brief llfifo_enqueue, with the new length mapped to 0
+ */
+static int llfifo_engine_enqueue(void* fifo, void* element) {
+
+	return (llfifo_enqueue((llfifo_t*)(fifo), element) < 0) ? (-1) : (0);
+}
+
+/**
+ * \fn static void* llfifo_engine_dequeue(void* fifo)
+ * \brief llfifo_dequeue
+ */
+static void* llfifo_engine_dequeue(void* fifo) {
+
+	return llfifo_dequeue((llfifo_t*)(fifo));
+}
+
+/**
+ * \fn static void llfifo_engine_destroy(void* fifo)
+ * \brief llfifo_destroy
+ */
+static void llfifo_engine_destroy(void* fifo) {
+
+	llfifo_destroy((llfifo_t*)(fifo));
+}
+
+/**
+ * \fn static void* compact_engine_create(void)
+ * \brief llfifo_compact_create with capacity 0
+ */
+static void* compact_engine_create(void) {
+
+	return llfifo_compact_create(0);
+}
+
+/**
+ * \fn static int compact_engine_enqueue(void* fifo, void* element)
+ * \brief llfifo_compact_enqueue, with the new length mapped to 0
+ */
+static int compact_engine_enqueue(void* fifo, void* element) {
+
+	return (llfifo_compact_enqueue((llfifo_compact_t*)(fifo), element) == (size_t)(-1)) ? (-1) : (0);
+}
+
+/**
+ * \fn static void* compact_engine_dequeue(void* fifo)
+ * \brief llfifo_compact_dequeue
+ */
+static void* compact_engine_dequeue(void* fifo) {
+
+	return llfifo_compact_dequeue((llfifo_compact_t*)(fifo));
+}
+
+/**
+ * \fn static void compact_engine_destroy(void* fifo)
+ * \brief llfifo_compact_destroy
+ */
+static void compact_engine_destroy(void* fifo) {
+
+	llfifo_compact_destroy((llfifo_compact_t*)(fifo));
+}
+
+/**
+ * \var static const engine_t engines[]
+ * \brief Every engine the patterns are run against
+ */
+static const engine_t engines[] = {
+	{ "llfifo", llfifo_engine_create, llfifo_engine_enqueue, llfifo_engine_dequeue, llfifo_engine_destroy },
+	{ "llfifo_compact", compact_engine_create, compact_engine_enqueue, compact_engine_dequeue, compact_engine_destroy },
+};
+
+/**
+ * \typedef pattern_case_t
+ * \brief Allows struct pattern_case_s to be instantiated as pattern_case_t
+ */
+typedef struct pattern_case_s pattern_case_t;
+
+/**
+ * \struct pattern_case_s
+ * \brief One engine + pattern run. Lives in shared memory so the forked child can report back
+ *
+ * \detail const engine_t* engine - Engine to run
+ * \detail int pattern - Index into patterns
+ * \detail size_t elements - Scale of the run, see DEFAULT_ELEMENTS
+ * \detail size_t ops - Enqueues + dequeues made
+ * \detail size_t peak_depth - Most elements queued at once
+ * \detail uint64_t elapsed_ns - Time spent in the pattern
+ * \detail size_t allocs - malloc + calloc calls during the pattern
+ * \detail size_t reallocs - realloc calls during the pattern
+ * \detail size_t frees - free calls during the pattern
+ * \detail long baseline_kb - RSS of the child before the pattern started
+ * \detail bench_perf_t perf - Hardware counters over the pattern, read by the child
+ * \detail int ok - Nonzero if every element came back in order
+ */
+struct pattern_case_s {
+	const engine_t* engine;
+	int pattern;
+	size_t elements;
+	size_t ops;
+	size_t peak_depth;
+	uint64_t elapsed_ns;
+	size_t allocs;
+	size_t reallocs;
+	size_t frees;
+	long baseline_kb;
+	bench_perf_t perf;
+	int ok;
+};
+
+/**
+ * \typedef pattern_state_t
+ * \brief Allows struct pattern_state_s to be instantiated as pattern_state_t
+ */
+typedef struct pattern_state_s pattern_state_t;
+
+/**
+ * \struct pattern_state_s
+ * \brief Bookkeeping shared by the patterns. Elements are the integers 1, 2, 3, ... so order can be checked on the way out
+ *
+ * \detail pattern_case_t* c - The case being run
+ * \detail void* fifo - The FIFO in use
+ * \detail uintptr_t next_in - Next element to enqueue
+ * \detail uintptr_t next_out - Element the next dequeue must return
+ */
+struct pattern_state_s {
+	pattern_case_t* c;
+	void* fifo;
+	uintptr_t next_in;
+	uintptr_t next_out;
+};
+
+/**
+ * \fn static void push(pattern_state_t* s, size_t n)
+ * \brief Enqueues the next n elements
+ *
+ * \param s State of the pattern being run
+ * \param n Number of elements
+ *
+ * \return N/A
+ */
+static void push(pattern_state_t* s, size_t n) {
+
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		if (s->c->engine->enqueue(s->fifo, (void*)(s->next_in++)) != 0) {
+			s->c->ok = 0;
+		}
+	}
+
+	s->c->ops += n;
+	if ((size_t)(s->next_in - s->next_out) > s->c->peak_depth) {
+		s->c->peak_depth = (size_t)(s->next_in - s->next_out);
+	}
+}
+
+/**
+ * \fn static void pop(pattern_state_t* s, size_t n)
+ * \brief Dequeues n elements, checking each is the one expected
+ *
+ * \param s State of the pattern being run
+ * \param n Number of elements
+ *
+ * \return N/A
+ */
+static void pop(pattern_state_t* s, size_t n) {
+
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		if (s->c->engine->dequeue(s->fifo) != (void*)(s->next_out++)) {
+			s->c->ok = 0;
+		}
+	}
+
+	s->c->ops += n;
+}
+
+/**
+ * \fn static void pattern_steady(pattern_state_t* s)
+ * \brief Holds STEADY_IN_FLIGHT elements queued while elements stream through one enqueue + one dequeue at a time. Only the warm-up should allocate
+ *
+ * \param s State of the pattern being run
+ *
+ * \return N/A
+ */
+static void pattern_steady(pattern_state_t* s) {
+
+	size_t i;
+
+	push(s, STEADY_IN_FLIGHT);
+	for (i = 0; i < s->c->elements; i++) {
+		push(s, 1);
+		pop(s, 1);
+	}
+	pop(s, STEADY_IN_FLIGHT);
+}
+
+/**
+ * \fn static void pattern_burst(pattern_state_t* s)
+ * \brief Fills with elements / BURST_ROUNDS elements then drains completely, BURST_ROUNDS times. Only the first burst should allocate
+ *
+ * \param s State of the pattern being run
+ *
+ * \return N/A
+ */
+static void pattern_burst(pattern_state_t* s) {
+
+	size_t round;
+
+	for (round = 0; round < BURST_ROUNDS; round++) {
+		push(s, s->c->elements / BURST_ROUNDS);
+		pop(s, s->c->elements / BURST_ROUNDS);
+	}
+}
+
+/**
+ * \fn static void pattern_sawtooth(pattern_state_t* s)
+ * \brief Enqueues SAWTOOTH_RISE then dequeues SAWTOOTH_FALL, over and over, so the depth climbs in teeth up to elements / 2, then drains
+ *
+ * \param s State of the pattern being run
+ *
+ * \return N/A
+ */
+static void pattern_sawtooth(pattern_state_t* s) {
+
+	size_t enqueued;
+
+	for (enqueued = 0; enqueued < s->c->elements; enqueued += SAWTOOTH_RISE) {
+		push(s, SAWTOOTH_RISE);
+		pop(s, SAWTOOTH_FALL);
+	}
+	pop(s, (size_t)(s->next_in - s->next_out));
+}
+
+/**
+ * \fn static void pattern_churn(pattern_state_t* s)
+ * \brief Creates a FIFO, passes CHURN_ELEMENTS elements through it and destroys it, elements / CHURN_ELEMENTS times. Measures create + destroy + growth from empty
+ *
+ * \param s State of the pattern being run
+ *
+ * \return N/A
+ */
+static void pattern_churn(pattern_state_t* s) {
+
+	size_t i;
+
+	s->c->engine->destroy(s->fifo);
+
+	for (i = 0; i < s->c->elements / CHURN_ELEMENTS; i++) {
+		s->fifo = s->c->engine->create();
+		if (s->fifo == NULL) {
+			s->c->ok = 0;
+			return;
+		}
+		push(s, CHURN_ELEMENTS);
+		pop(s, CHURN_ELEMENTS);
+		s->c->engine->destroy(s->fifo);
+	}
+
+	s->fifo = s->c->engine->create();
+}
+
+/**
+ * \fn static void pattern_deep(pattern_state_t* s)
+ * \brief Fills with every element before draining any, so the queue gets as deep as elements
+ *
+ * \param s State of the pattern being run
+ *
+ * \return N/A
+ */
+static void pattern_deep(pattern_state_t* s) {
+
+	push(s, s->c->elements);
+	pop(s, s->c->elements);
+}
+
+/**
+ * \var static const struct patterns[]
+ * \brief Every pattern, in the order they are run
+ */
+static const struct {
+	const char* name;
+	void (*run)(pattern_state_t* s);
+} patterns[] = {
+	{ "steady", pattern_steady },
+	{ "burst", pattern_burst },
+	{ "sawtooth", pattern_sawtooth },
+	{ "churn", pattern_churn },
+	{ "deep", pattern_deep },
+};
+
+/**
+ * \fn static void run_pattern_case(void* arg)
+ * \brief Runs one engine through one pattern, counting allocations + time. Runs inside bench_run_isolated
+ *
+ * \param arg The pattern_case_t to run + fill in
+ *
+ * \return N/A
+ */
+static void run_pattern_case(void* arg) {
+
+	uint64_t start;
+	pattern_case_t* c = (pattern_case_t*)arg;
+	pattern_state_t s = { .c = c, .fifo = NULL, .next_in = 1, .next_out = 1 };
+
+	c->ok = 1;
+	c->baseline_kb = bench_rss_kb();
+
+	alloc_calls = 0;
+	realloc_calls = 0;
+	free_calls = 0;
+
+	bench_perf_open(&(c->perf));
+	bench_perf_start(&(c->perf));
+	start = bench_now_ns();
+
+	s.fifo = c->engine->create();
+	if (s.fifo == NULL) {
+		c->ok = 0;
+		bench_perf_close(&(c->perf));
+		return;
+	}
+
+	patterns[c->pattern].run(&s);
+
+	// Queue must be empty again
+	if (c->engine->dequeue(s.fifo) != NULL) {
+		c->ok = 0;
+	}
+
+	c->engine->destroy(s.fifo);
+
+	c->elapsed_ns = bench_now_ns() - start;
+	bench_perf_stop(&(c->perf));
+	bench_perf_close(&(c->perf));
+	c->allocs = alloc_calls;
+	c->reallocs = realloc_calls;
+	c->frees = free_calls;
+}
+
+int main(int argc, char** argv) {
+
+	size_t e;
+	size_t p;
+	long peak_kb;
+	size_t elements;
+	pattern_case_t* c;
+
+	elements = (argc > 1) ? (size_t)(strtoull(argv[1], NULL, 10)) : (DEFAULT_ELEMENTS);
+	if (elements < (BURST_ROUNDS * CHURN_ELEMENTS)) {
+		return EXIT_FAILURE;
+	}
+
+	c = (pattern_case_t*)bench_shared_alloc(sizeof(pattern_case_t));
+	if (c == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	printf("engine,pattern,ops,ops_per_sec,mallocs,reallocs,frees,peak_depth,peak_rss_mib,bytes_per_element,ok" BENCH_PERF_CSV_HEADER "\n");
+
+	for (p = 0; p < (sizeof(patterns) / sizeof(patterns[0])); p++) {
+		for (e = 0; e < (sizeof(engines) / sizeof(engines[0])); e++) {
+
+			*c = (pattern_case_t){ .engine = &engines[e], .pattern = (int)(p), .elements = elements };
+
+			if (bench_run_isolated(run_pattern_case, c, &peak_kb) != EXIT_SUCCESS) {
+				printf("%s,%s,,,,,,,,,crashed", engines[e].name, patterns[p].name);
+				bench_perf_print(NULL, 0);
+				printf("\n");
+				continue;
+			}
+
+			printf("%s,%s,%zu,%.0f,%zu,%zu,%zu,%zu,%.1f,%.2f,%s",
+				engines[e].name,
+				patterns[p].name,
+				c->ops,
+				((double)(c->ops) * 1e9) / (double)(c->elapsed_ns),
+				c->allocs,
+				c->reallocs,
+				c->frees,
+				c->peak_depth,
+				(double)(peak_kb) / 1024.0,
+				((double)(peak_kb - c->baseline_kb) * 1024.0) / (double)(c->peak_depth),
+				c->ok ? "yes" : "no");
+			bench_perf_print(&(c->perf), c->ops);
+			printf("\n");
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+/**
+ * \file bench_llfifo_allocator.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Measures create/destroy-heavy use of llfifo, the way request-scoped queues get used: every request creates a handful of FIFOs, grows them past their initial capacity, drains them, then throws them away. Compares malloc against a bump arena plugged in through llfifo_create_with_allocator, and against shared node pools: one pool for every FIFO, or two pools with consecutive FIFOs alternating between them so each node operation switches pool
+ *
+ * Usage: ./bench_llfifo_allocator [requests]   (default 1000000)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "fifo_allocator.h"
+#include "llfifo_ext.h"
+
+#define DEFAULT_REQUESTS ((size_t)(1000000))
+#define FIFOS_PER_REQUEST (8)
+#define INITIAL_CAPACITY (4)
+#define ELEMENTS_PER_FIFO (32)
+#define ARENA_BYTES ((size_t)(1) << 20)
+#define POOLS (2)
+
+/**
+ * \typedef bench_arena_t
+ * \brief Allows struct bench_arena_s to be instantiated as bench_arena_t
+ */
+typedef struct bench_arena_s bench_arena_t;
+
+/**
+ * \struct bench_arena_s
+ * \brief Bump allocator. Allocating is a pointer bump, freeing single objects does nothing, and resetting releases everything in O(1)
+ *
+ * \detail unsigned char* memory - Backing buffer
+ * \detail size_t size - Size of memory in bytes
+ * \detail size_t used - Bytes handed out since the last reset
+ */
+struct bench_arena_s {
+	unsigned char* memory;
+	size_t size;
+	size_t used;
+};
+
+/**
+ * \fn static void* bench_arena_alloc(void* ctx, size_t size)
+ * \brief alloc hook for bench_arena_t. Keeps every allocation 16-byte aligned
+ *
+ * \param ctx The bench_arena_t to allocate from
+ * \param size Number of bytes to allocate
+ *
+ * \return Pointer into the arena, or NULL if it is exhausted
+ */
+static void* bench_arena_alloc(void* ctx, size_t size) {
+
+	void* ptr;
+	bench_arena_t* arena = (bench_arena_t*)ctx;
+
+	size = (size + 15) & ~((size_t)(15));
+	if (size > (arena->size - arena->used)) {
+		return NULL;
+	}
+
+	ptr = arena->memory + arena->used;
+	arena->used += size;
+
+	return ptr;
+}
+
+/**
+ * \typedef alloc_case_t
+ * \brief Allows struct alloc_case_s to be instantiated as alloc_case_t
+ */
+typedef struct alloc_case_s alloc_case_t;
+
+/**
+ * \struct alloc_case_s
+ * \brief One benchmark case
+ *
+ * \detail const char* name - Label printed in the results
+ * \detail int arena - Nonzero to create every FIFO on the bump arena, zero to use malloc
+ * \detail int skip_destroy - Nonzero to release a request's FIFOs by resetting the arena instead of calling llfifo_destroy on each
+ * \detail int pools - Number of shared node pools the FIFOs are created on, handed out round-robin. 0 to give each FIFO its own nodes
+ */
+struct alloc_case_s {
+	const char* name;
+	int arena;
+	int skip_destroy;
+	int pools;
+};
+
+/**
+ * \fn static int run_requests(const alloc_case_t* c, bench_arena_t* arena, nodepool_t** pools, size_t requests)
+ * \brief Runs every request for one case
+ *
+ * \param c The case to run
+ * \param arena Arena to use if the case asks for one
+ * \param pools Node pools to use if the case asks for them
+ * \param requests Number of requests to run
+ *
+ * \return EXIT_SUCCESS if every element came back in order, EXIT_FAILURE otherwise
+ */
+static int run_requests(const alloc_case_t* c, bench_arena_t* arena, nodepool_t** pools, size_t requests) {
+
+	size_t r;
+	int f;
+	int i;
+	int ok = 1;
+	llfifo_t* fifos[FIFOS_PER_REQUEST];
+	fifo_allocator_t allocator = { bench_arena_alloc, NULL, arena };
+
+	for (r = 0; r < requests; r++) {
+
+		for (f = 0; f < FIFOS_PER_REQUEST; f++) {
+			if (c->pools > 0) {
+				fifos[f] = llfifo_create_pooled(pools[f % c->pools]);
+			}
+			else {
+				fifos[f] = (c->arena) ? (llfifo_create_with_allocator(INITIAL_CAPACITY, &allocator)) : (llfifo_create(INITIAL_CAPACITY));
+			}
+			if (fifos[f] == NULL) {
+				return EXIT_FAILURE;
+			}
+		}
+
+		for (i = 1; i <= ELEMENTS_PER_FIFO; i++) {
+			for (f = 0; f < FIFOS_PER_REQUEST; f++) {
+				llfifo_enqueue(fifos[f], (void*)(uintptr_t)(i));
+			}
+		}
+
+		for (i = 1; i <= ELEMENTS_PER_FIFO; i++) {
+			for (f = 0; f < FIFOS_PER_REQUEST; f++) {
+				if (llfifo_dequeue(fifos[f]) != (void*)(uintptr_t)(i)) {
+					ok = 0;
+				}
+			}
+		}
+
+		if (!(c->skip_destroy)) {
+			for (f = 0; f < FIFOS_PER_REQUEST; f++) {
+				llfifo_destroy(fifos[f]);
+			}
+		}
+
+		// The whole request's memory goes away at once
+		arena->used = 0;
+	}
+
+	return (ok) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+}
+
+int main(int argc, char** argv) {
+
+	int i;
+	int result;
+	uint64_t start;
+	uint64_t elapsed_ns;
+	size_t requests;
+	bench_arena_t arena;
+	nodepool_t* pools[POOLS];
+	const alloc_case_t cases[] = {
+		{ .name = "malloc", .arena = 0, .skip_destroy = 0, .pools = 0 },
+		{ .name = "arena_destroy", .arena = 1, .skip_destroy = 0, .pools = 0 },
+		{ .name = "arena_reset_only", .arena = 1, .skip_destroy = 1, .pools = 0 },
+		{ .name = "pool_one", .arena = 0, .skip_destroy = 0, .pools = 1 },
+		{ .name = "pool_two_alternating", .arena = 0, .skip_destroy = 0, .pools = 2 },
+	};
+
+	requests = (argc > 1) ? (size_t)(strtoull(argv[1], NULL, 10)) : (DEFAULT_REQUESTS);
+
+	arena.memory = (unsigned char*)aligned_alloc(16, ARENA_BYTES);
+	arena.size = ARENA_BYTES;
+	arena.used = 0;
+	if (arena.memory == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < POOLS; i++) {
+		pools[i] = llfifo_pool_create(0);
+		if (pools[i] == NULL) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	printf("allocator,requests,fifos_per_request,elements_per_fifo,ns_per_request,ns_per_fifo_lifetime,ok\n");
+
+	for (i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++) {
+
+		// Warm up so the first case doesn't pay for faulting in the heap
+		run_requests(&cases[i], &arena, pools, requests / 10);
+
+		start = bench_now_ns();
+		result = run_requests(&cases[i], &arena, pools, requests);
+		elapsed_ns = bench_now_ns() - start;
+
+		printf("%s,%zu,%d,%d,%.1f,%.1f,%s\n",
+			cases[i].name,
+			requests,
+			FIFOS_PER_REQUEST,
+			ELEMENTS_PER_FIFO,
+			(double)(elapsed_ns) / (double)(requests),
+			(double)(elapsed_ns) / (double)(requests * FIFOS_PER_REQUEST),
+			(result == EXIT_SUCCESS) ? "yes" : "no");
+	}
+
+	for (i = 0; i < POOLS; i++) {
+		nodepool_destroy(pools[i]);
+	}
+	free(arena.memory);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+/**
+ * \file bench_llfifo_compact.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Compares memory + throughput of llfifo against llfifo_compact on very deep queues
+ *
+ * Usage: ./bench_llfifo_compact [elements]   (default 100000000)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "llfifo.h"
+#include "llfifo_compact.h"
+
+#define DEFAULT_ELEMENTS ((size_t)(100000000))
+
+/**
+ * \typedef deep_case_t
+ * \brief Allows struct deep_case_s to be instantiated as deep_case_t
+ */
+typedef struct deep_case_s deep_case_t;
+
+/**
+ * \struct deep_case_s
+ * \brief One benchmark case. Lives in shared memory so the forked child can report back
+ *
+ * \detail const char* name - Label printed in the results
+ * \detail int compact - Nonzero to run llfifo_compact, zero to run llfifo
+ * \detail int preallocate - Nonzero to create the FIFO with capacity for every element, zero to grow on demand from capacity 0
+ * \detail size_t elements - Number of elements to fill + drain
+ * \detail long baseline_kb - RSS of the child before creating the FIFO
+ * \detail uint64_t enqueue_ns - Total time spent filling
+ * \detail uint64_t dequeue_ns - Total time spent draining
+ * \detail int ok - Nonzero if every element came back in order
+ */
+struct deep_case_s {
+	const char* name;
+	int compact;
+	int preallocate;
+	size_t elements;
+	long baseline_kb;
+	uint64_t enqueue_ns;
+	uint64_t dequeue_ns;
+	int ok;
+};
+
+/**
+ * \fn static void run_deep_case(void* arg)
+ * \brief Fills a FIFO with elements 1..n then drains it, timing both halves. Runs inside bench_run_isolated
+ *
+ * \param arg The deep_case_t to run + fill in
+ *
+ * \return N/A
+ */
+static void run_deep_case(void* arg) {
+
+	size_t i;
+	uint64_t start;
+	deep_case_t* c = (deep_case_t*)arg;
+	llfifo_t* fifo = NULL;
+	llfifo_compact_t* compact = NULL;
+
+	c->ok = 1;
+	c->baseline_kb = bench_rss_kb();
+
+	if (c->compact) {
+		compact = llfifo_compact_create(c->preallocate ? c->elements : 0);
+	}
+	else {
+		fifo = llfifo_create(c->preallocate ? (int)(c->elements) : 0);
+	}
+
+	if ((compact == NULL) && (fifo == NULL)) {
+		c->ok = 0;
+		return;
+	}
+
+	start = bench_now_ns();
+	for (i = 1; i <= c->elements; i++) {
+		if (c->compact) {
+			llfifo_compact_enqueue(compact, (void*)(uintptr_t)(i));
+		}
+		else {
+			llfifo_enqueue(fifo, (void*)(uintptr_t)(i));
+		}
+	}
+	c->enqueue_ns = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	for (i = 1; i <= c->elements; i++) {
+		void* element = (c->compact) ? (llfifo_compact_dequeue(compact)) : (llfifo_dequeue(fifo));
+		if (element != (void*)(uintptr_t)(i)) {
+			c->ok = 0;
+		}
+	}
+	c->dequeue_ns = bench_now_ns() - start;
+}
+
+int main(int argc, char** argv) {
+
+	int i;
+	long peak_kb;
+	size_t elements;
+	deep_case_t* cases;
+	const int case_count = 4;
+
+	elements = (argc > 1) ? (size_t)(strtoull(argv[1], NULL, 10)) : (DEFAULT_ELEMENTS);
+
+	cases = (deep_case_t*)bench_shared_alloc(sizeof(deep_case_t) * case_count);
+	if (cases == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	cases[0] = (deep_case_t){ .name = "llfifo_grow", .compact = 0, .preallocate = 0 };
+	cases[1] = (deep_case_t){ .name = "llfifo_prealloc", .compact = 0, .preallocate = 1 };
+	cases[2] = (deep_case_t){ .name = "compact_grow", .compact = 1, .preallocate = 0 };
+	cases[3] = (deep_case_t){ .name = "compact_prealloc", .compact = 1, .preallocate = 1 };
+
+	printf("engine,elements,enqueue_ns_per_op,dequeue_ns_per_op,peak_rss_mib,bytes_per_element,ok\n");
+
+	for (i = 0; i < case_count; i++) {
+
+		cases[i].elements = elements;
+
+		if (bench_run_isolated(run_deep_case, &cases[i], &peak_kb) != EXIT_SUCCESS) {
+			printf("%s,%zu,,,,,crashed\n", cases[i].name, elements);
+			continue;
+		}
+
+		printf("%s,%zu,%.2f,%.2f,%.1f,%.2f,%s\n",
+			cases[i].name,
+			elements,
+			(double)(cases[i].enqueue_ns) / (double)(elements),
+			(double)(cases[i].dequeue_ns) / (double)(elements),
+			(double)(peak_kb) / 1024.0,
+			((double)(peak_kb - cases[i].baseline_kb) * 1024.0) / (double)(elements),
+			cases[i].ok ? "yes" : "no");
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+/**
+ * \file bench_llfifo_foreach.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Cost of scanning every queued element of an llfifo: draining it + enqueuing everything back, vs walking it in place with llfifo_foreach. The queue is built by interleaving two FIFOs so its nodes are scattered, the way a long-lived queue's nodes end up
+ *
+ * Usage: ./bench_llfifo_foreach [elements] [rounds]   (default 1000000, 10)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "llfifo.h"
+#include "llfifo_ext.h"
+
+#define DEFAULT_ELEMENTS ((size_t)(1000000))
+#define DEFAULT_ROUNDS (10)
+
+/**
+ * \fn static int sum_element(void* element, void* ctx)
+ * \brief llfifo_foreach callback: adds the element's value to the running sum in ctx
+ *
+ * \param element The element, a small integer cast to a pointer
+ * \param ctx The uint64_t sum
+ *
+ * \return 0, to keep walking
+ */
+static int sum_element(void* element, void* ctx) {
+
+	*(uint64_t*)(ctx) += (uint64_t)(uintptr_t)(element);
+
+	return 0;
+}
+
+int main(int argc, char** argv) {
+
+	int round;
+	int rounds;
+	size_t i;
+	size_t elements;
+	uint64_t start;
+	uint64_t drain_ns = 0;
+	uint64_t foreach_ns = 0;
+	uint64_t expected;
+	uint64_t sum;
+	void* element;
+	llfifo_t* fifo;
+	llfifo_t* other;
+
+	elements = (argc > 1) ? (size_t)(strtoull(argv[1], NULL, 10)) : (DEFAULT_ELEMENTS);
+	rounds = (argc > 2) ? (atoi(argv[2])) : (DEFAULT_ROUNDS);
+
+	fifo = llfifo_create(0);
+	other = llfifo_create(0);
+	if ((fifo == NULL) || (other == NULL) || (rounds <= 0)) {
+		return EXIT_FAILURE;
+	}
+
+	// Grow both FIFOs in lockstep so consecutive nodes of fifo are not adjacent in memory
+	for (i = 1; i <= elements; i++) {
+		llfifo_enqueue_sz(fifo, (void*)(uintptr_t)(i));
+		llfifo_enqueue_sz(other, (void*)(uintptr_t)(i));
+	}
+
+	expected = ((uint64_t)(elements) * ((uint64_t)(elements) + 1)) / 2;
+
+	printf("method,elements,rounds,ns_per_element,ok\n");
+
+	for (round = 0; round < rounds; round++) {
+
+		// Drain every element + enqueue it back, which is what scanning took before llfifo_foreach
+		sum = 0;
+		start = bench_now_ns();
+		for (i = 0; i < elements; i++) {
+			element = llfifo_dequeue(fifo);
+			sum += (uint64_t)(uintptr_t)(element);
+			llfifo_enqueue_sz(fifo, element);
+		}
+		drain_ns += bench_now_ns() - start;
+		if (sum != expected) {
+			printf("drain_rebuild,%zu,%d,,no\n", elements, rounds);
+			return EXIT_FAILURE;
+		}
+
+		sum = 0;
+		start = bench_now_ns();
+		llfifo_foreach(fifo, sum_element, &sum);
+		foreach_ns += bench_now_ns() - start;
+		if (sum != expected) {
+			printf("foreach,%zu,%d,,no\n", elements, rounds);
+			return EXIT_FAILURE;
+		}
+	}
+
+	printf("drain_rebuild,%zu,%d,%.2f,yes\n", elements, rounds, (double)(drain_ns) / ((double)(elements) * rounds));
+	printf("foreach,%zu,%d,%.2f,yes\n", elements, rounds, (double)(foreach_ns) / ((double)(elements) * rounds));
+
+	llfifo_destroy(fifo);
+	llfifo_destroy(other);
+
+	return EXIT_SUCCESS;
+}
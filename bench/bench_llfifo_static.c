@@ -0,0 +1,73 @@
+/**
+ * \file bench_llfifo_static.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Steady-state enqueue + dequeue cost of llfifo vs the heap-free FIFO from LLFIFO_STATIC_DEFINE, keeping a fixed number of elements in flight. llfifo is created with enough capacity up front, so neither side allocates inside the timed loop
+ *
+ * Usage: ./bench_llfifo_static [operations]   (default 100000000)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "llfifo.h"
+#include "llfifo_static.h"
+
+#define DEFAULT_OPERATIONS ((size_t)(100000000))
+#define IN_FLIGHT (64)
+
+LLFIFO_STATIC_DEFINE(bench_static_fifo, IN_FLIGHT)
+
+/**
+ * \var static bench_static_fifo_t static_fifo
+ * \brief Instance in static storage
+ */
+static bench_static_fifo_t static_fifo;
+
+int main(int argc, char** argv) {
+
+	size_t i;
+	size_t operations;
+	uint64_t start;
+	uint64_t llfifo_ns;
+	uint64_t static_ns;
+	uintptr_t sum_llfifo = 0;
+	uintptr_t sum_static = 0;
+	llfifo_t* fifo;
+
+	operations = (argc > 1) ? (size_t)(strtoull(argv[1], NULL, 10)) : (DEFAULT_OPERATIONS);
+
+	fifo = llfifo_create(IN_FLIGHT);
+	if (fifo == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	// Fill both to IN_FLIGHT - 1 so every timed enqueue fits
+	for (i = 1; i < IN_FLIGHT; i++) {
+		llfifo_enqueue(fifo, (void*)(uintptr_t)(i));
+		bench_static_fifo_enqueue(&static_fifo, (void*)(uintptr_t)(i));
+	}
+
+	start = bench_now_ns();
+	for (i = 0; i < operations; i++) {
+		llfifo_enqueue(fifo, (void*)(uintptr_t)(i + IN_FLIGHT));
+		sum_llfifo += (uintptr_t)llfifo_dequeue(fifo);
+	}
+	llfifo_ns = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	for (i = 0; i < operations; i++) {
+		bench_static_fifo_enqueue(&static_fifo, (void*)(uintptr_t)(i + IN_FLIGHT));
+		sum_static += (uintptr_t)bench_static_fifo_dequeue(&static_fifo);
+	}
+	static_ns = bench_now_ns() - start;
+
+	printf("engine,operations,in_flight,ns_per_enqueue_dequeue,capacity,ok\n");
+	printf("llfifo,%zu,%d,%.2f,%d,%s\n", operations, IN_FLIGHT, (double)(llfifo_ns) / (double)(operations), llfifo_capacity(fifo), (sum_llfifo == sum_static) ? "yes" : "no");
+	printf("llfifo_static,%zu,%d,%.2f,%d,%s\n", operations, IN_FLIGHT, (double)(static_ns) / (double)(operations), bench_static_fifo_capacity(&static_fifo), (sum_llfifo == sum_static) ? "yes" : "no");
+
+	llfifo_destroy(fifo);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+/**
+ * \file bench_llfifo_wide.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Fills + drains llfifo through the int API and the size_t API to measure any overhead from the wider counters. The default run goes past 2^32 elements, which needs roughly 100 GiB of nodes
+ *
+ * Usage: ./bench_llfifo_wide [elements]   (default 4000000000)
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "llfifo_ext.h"
+
+#define DEFAULT_ELEMENTS ((size_t)(4000000000ULL))
+
+/**
+ * \typedef wide_case_t
+ * \brief Allows struct wide_case_s to be instantiated as wide_case_t
+ */
+typedef struct wide_case_s wide_case_t;
+
+/**
+ * \struct wide_case_s
+ * \brief One benchmark case. Lives in shared memory so the forked child can report back
+ *
+ * \detail const char* name - Label printed in the results
+ * \detail int wide - Nonzero to use the size_t API, zero to use the int API
+ * \detail size_t elements - Number of elements to fill + drain
+ * \detail uint64_t enqueue_ns - Total time spent filling
+ * \detail uint64_t dequeue_ns - Total time spent draining
+ * \detail size_t peak_length - Length reported by the size_t API once every element is queued
+ * \detail int ok - Nonzero if every element came back in order
+ */
+struct wide_case_s {
+	const char* name;
+	int wide;
+	size_t elements;
+	uint64_t enqueue_ns;
+	uint64_t dequeue_ns;
+	size_t peak_length;
+	int ok;
+};
+
+/**
+ * \fn static void run_wide_case(void* arg)
+ * \brief Fills a preallocated FIFO with elements 1..n then drains it, timing both halves. Runs inside bench_run_isolated
+ *
+ * \param arg The wide_case_t to run + fill in
+ *
+ * \return N/A
+ */
+static void run_wide_case(void* arg) {
+
+	size_t i;
+	uint64_t start;
+	wide_case_t* c = (wide_case_t*)arg;
+	llfifo_t* fifo;
+
+	c->ok = 1;
+
+	fifo = llfifo_create_sz(c->elements);
+	if (fifo == NULL) {
+		c->ok = 0;
+		return;
+	}
+
+	start = bench_now_ns();
+	for (i = 1; i <= c->elements; i++) {
+		if (c->wide) {
+			if (llfifo_enqueue_sz(fifo, (void*)(uintptr_t)(i)) == (size_t)(-1)) {
+				c->ok = 0;
+			}
+		}
+		else {
+			if (llfifo_enqueue(fifo, (void*)(uintptr_t)(i)) < 0) {
+				c->ok = 0;
+			}
+		}
+	}
+	c->enqueue_ns = bench_now_ns() - start;
+	c->peak_length = llfifo_length_sz(fifo);
+
+	start = bench_now_ns();
+	for (i = 1; i <= c->elements; i++) {
+		if (llfifo_dequeue(fifo) != (void*)(uintptr_t)(i)) {
+			c->ok = 0;
+		}
+	}
+	c->dequeue_ns = bench_now_ns() - start;
+
+	llfifo_destroy(fifo);
+}
+
+int main(int argc, char** argv) {
+
+	int i;
+	long peak_kb;
+	size_t elements;
+	wide_case_t* cases;
+	const int case_count = 2;
+
+	elements = (argc > 1) ? (size_t)(strtoull(argv[1], NULL, 10)) : (DEFAULT_ELEMENTS);
+
+	cases = (wide_case_t*)bench_shared_alloc(sizeof(wide_case_t) * case_count);
+	if (cases == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	cases[0] = (wide_case_t){ .name = "int_api", .wide = 0 };
+	cases[1] = (wide_case_t){ .name = "size_t_api", .wide = 1 };
+
+	printf("api,elements,enqueue_ns_per_op,dequeue_ns_per_op,peak_rss_mib,peak_length,past_int_max,ok\n");
+
+	for (i = 0; i < case_count; i++) {
+
+		cases[i].elements = elements;
+
+		if (bench_run_isolated(run_wide_case, &cases[i], &peak_kb) != EXIT_SUCCESS) {
+			printf("%s,%zu,,,,,,crashed\n", cases[i].name, elements);
+			continue;
+		}
+
+		printf("%s,%zu,%.2f,%.2f,%.1f,%zu,%s,%s\n",
+			cases[i].name,
+			elements,
+			(double)(cases[i].enqueue_ns) / (double)(elements),
+			(double)(cases[i].dequeue_ns) / (double)(elements),
+			(double)(peak_kb) / 1024.0,
+			cases[i].peak_length,
+			(cases[i].peak_length > (size_t)(INT_MAX)) ? "yes" : "no",
+			cases[i].ok ? "yes" : "no");
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,256 @@
+/**
+ * \file bench_perf.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Hardware performance counters for the benchmark programs, read through perf_event_open around a measured region. Header-only like bench.h
+ *
+ * Counters the kernel or container won't give us (no PMU, perf_event_paranoid too high, seccomp blocking the syscall, non-Linux builds) are simply reported as blank CSV fields, so a benchmark runs the same everywhere and only loses those columns. Set BENCH_PERF=0 in the environment to skip them on purpose
+ */
+
+#ifndef _BENCH_PERF_H_
+#define _BENCH_PERF_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+/**
+ * \typedef bench_perf_event_t
+ * \brief Counters collected by bench_perf_t, in the order their CSV columns are printed
+ */
+typedef enum {
+	BENCH_PERF_CYCLES,
+	BENCH_PERF_INSTRUCTIONS,
+	BENCH_PERF_L1D_MISSES,
+	BENCH_PERF_LLC_MISSES,
+	BENCH_PERF_BRANCH_MISSES,
+	BENCH_PERF_DTLB_MISSES,
+	BENCH_PERF_COUNT
+} bench_perf_event_t;
+
+/**
+ * \def BENCH_PERF_CSV_HEADER
+ * \brief CSV columns printed by bench_perf_print, with a leading comma so it can be appended to a benchmark's own header
+ */
+#define BENCH_PERF_CSV_HEADER ",cycles_per_op,instructions_per_op,ipc,l1d_misses_per_op,llc_misses_per_op,branch_misses_per_op,dtlb_misses_per_op"
+
+/**
+ * \typedef bench_perf_t
+ * \brief Allows struct bench_perf_s to be instantiated as bench_perf_t
+ */
+typedef struct bench_perf_s bench_perf_t;
+
+/**
+ * \struct bench_perf_s
+ * \brief One set of counters. Plain data, so it can live in bench_shared_alloc memory and be filled in by a bench_run_isolated child
+ *
+ * \detail int fd[BENCH_PERF_COUNT] - File descriptor of each counter, or -1 if it couldn't be opened. Only meaningful in the process that opened them
+ * \detail int valid[BENCH_PERF_COUNT] - Nonzero once count holds a real reading for that counter
+ * \detail uint64_t count[BENCH_PERF_COUNT] - Events counted between the last bench_perf_start + bench_perf_stop, scaled up if the kernel had to multiplex counters
+ */
+struct bench_perf_s {
+	int fd[BENCH_PERF_COUNT];
+	int valid[BENCH_PERF_COUNT];
+	uint64_t count[BENCH_PERF_COUNT];
+};
+
+#ifdef __linux__
+/**
+ * \fn static inline int bench_perf_open_one(uint32_t type, uint64_t config)
+ * \brief Opens one disabled, user-space-only counter on the calling thread
+ *
+ * \param type PERF_TYPE_HARDWARE or PERF_TYPE_HW_CACHE
+ * \param config The event within type
+ *
+ * \return File descriptor of the counter, or -1 if it isn't available
+ */
+static inline int bench_perf_open_one(uint32_t type, uint64_t config) {
+
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return (int)(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+/**
+ * \def BENCH_PERF_CACHE_MISS
+ * \brief config value for a PERF_TYPE_HW_CACHE read miss on the given cache
+ */
+#define BENCH_PERF_CACHE_MISS(cache) ((uint64_t)(cache) | ((uint64_t)(PERF_COUNT_HW_CACHE_OP_READ) << 8) | ((uint64_t)(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16))
+#endif
+
+/**
+ * \fn static inline int bench_perf_open(bench_perf_t* perf)
+ * \brief Opens every counter on the calling thread. Each one is opened on its own, so a PMU that lacks (say) dTLB events still gives the rest. Call it from the thread + process that runs the measured region, e.g. inside the bench_run_isolated child
+ *
+ * \param perf The counters to open
+ *
+ * \return Number of counters that opened. 0 means none are available, which is not an error
+ */
+static inline int bench_perf_open(bench_perf_t* perf) {
+
+	int i;
+	int opened = 0;
+	const char* setting = getenv("BENCH_PERF");
+
+	for (i = 0; i < BENCH_PERF_COUNT; i++) {
+		perf->fd[i] = -1;
+		perf->valid[i] = 0;
+		perf->count[i] = 0;
+	}
+
+	if ((setting != NULL) && (strcmp(setting, "0") == 0)) {
+		return 0;
+	}
+
+#ifdef __linux__
+	perf->fd[BENCH_PERF_CYCLES] = bench_perf_open_one(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	perf->fd[BENCH_PERF_INSTRUCTIONS] = bench_perf_open_one(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	perf->fd[BENCH_PERF_L1D_MISSES] = bench_perf_open_one(PERF_TYPE_HW_CACHE, BENCH_PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_L1D));
+	perf->fd[BENCH_PERF_LLC_MISSES] = bench_perf_open_one(PERF_TYPE_HW_CACHE, BENCH_PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_LL));
+	perf->fd[BENCH_PERF_BRANCH_MISSES] = bench_perf_open_one(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+	perf->fd[BENCH_PERF_DTLB_MISSES] = bench_perf_open_one(PERF_TYPE_HW_CACHE, BENCH_PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_DTLB));
+#endif
+
+	for (i = 0; i < BENCH_PERF_COUNT; i++) {
+		if (perf->fd[i] >= 0) {
+			opened++;
+		}
+	}
+
+	return opened;
+}
+
+/**
+ * \fn static inline void bench_perf_start(bench_perf_t* perf)
+ * \brief Zeroes + starts every open counter. Call right before the measured region
+ *
+ * \param perf The counters
+ *
+ * \return N/A
+ */
+static inline void bench_perf_start(bench_perf_t* perf) {
+
+	int i;
+
+	for (i = 0; i < BENCH_PERF_COUNT; i++) {
+		perf->valid[i] = 0;
+		perf->count[i] = 0;
+#ifdef __linux__
+		if (perf->fd[i] >= 0) {
+			ioctl(perf->fd[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(perf->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+}
+
+/**
+ * \fn static inline void bench_perf_stop(bench_perf_t* perf)
+ * \brief Stops every open counter + reads it into perf->count. Call right after the measured region
+ *
+ * \param perf The counters
+ *
+ * \return N/A
+ */
+static inline void bench_perf_stop(bench_perf_t* perf) {
+
+	int i;
+#ifdef __linux__
+	uint64_t reading[3];
+
+	// Disable them all first so reading one doesn't get counted by the others
+	for (i = 0; i < BENCH_PERF_COUNT; i++) {
+		if (perf->fd[i] >= 0) {
+			ioctl(perf->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+
+	for (i = 0; i < BENCH_PERF_COUNT; i++) {
+
+		// reading is { value, time enabled, time running }. A counter that never got scheduled onto the PMU has nothing to report
+		if ((perf->fd[i] < 0) || (read(perf->fd[i], reading, sizeof(reading)) != (ssize_t)(sizeof(reading))) || (reading[2] == 0)) {
+			continue;
+		}
+
+		// Scale up if the kernel multiplexed this counter with others
+		perf->count[i] = (reading[2] < reading[1]) ? ((uint64_t)((double)(reading[0]) * ((double)(reading[1]) / (double)(reading[2])))) : (reading[0]);
+		perf->valid[i] = 1;
+	}
+#else
+	(void)(i);
+	(void)(perf);
+#endif
+}
+
+/**
+ * \fn static inline void bench_perf_close(bench_perf_t* perf)
+ * \brief Closes every open counter. perf->count + perf->valid keep their last readings
+ *
+ * \param perf The counters
+ *
+ * \return N/A
+ */
+static inline void bench_perf_close(bench_perf_t* perf) {
+
+	int i;
+
+	for (i = 0; i < BENCH_PERF_COUNT; i++) {
+		if (perf->fd[i] >= 0) {
+			close(perf->fd[i]);
+			perf->fd[i] = -1;
+		}
+	}
+}
+
+/**
+ * \fn static inline void bench_perf_print(const bench_perf_t* perf, size_t ops)
+ * \brief Prints the BENCH_PERF_CSV_HEADER columns for the last reading, divided by ops. Unavailable counters print as blank fields
+ *
+ * \param perf The counters. May be NULL, which prints every column blank
+ * \param ops Operations the measured region performed
+ *
+ * \return N/A
+ */
+static inline void bench_perf_print(const bench_perf_t* perf, size_t ops) {
+
+	int i;
+
+	for (i = 0; i < BENCH_PERF_COUNT; i++) {
+
+		if ((perf != NULL) && (perf->valid[i]) && (ops > 0)) {
+			printf(",%.3f", (double)(perf->count[i]) / (double)(ops));
+		}
+		else {
+			printf(",");
+		}
+
+		// Instructions per cycle goes right after the two counters it comes from
+		if (i == BENCH_PERF_INSTRUCTIONS) {
+			if ((perf != NULL) && (perf->valid[BENCH_PERF_CYCLES]) && (perf->valid[BENCH_PERF_INSTRUCTIONS]) && (perf->count[BENCH_PERF_CYCLES] > 0)) {
+				printf(",%.3f", (double)(perf->count[BENCH_PERF_INSTRUCTIONS]) / (double)(perf->count[BENCH_PERF_CYCLES]));
+			}
+			else {
+				printf(",");
+			}
+		}
+	}
+}
+
+#endif // _BENCH_PERF_H_
@@ -0,0 +1,331 @@
+/**
+ * \file bench_wsdeque_fib.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Fork/join recursive fib on a pool of workers, each owning a wsdeque. A task pushes its fib(n-1) child, computes fib(n-2) itself, then pops the child back, or, if a thief took it, steals other work until the child is done. Reports time + speedup over 1 worker for 1..N workers
+ *
+ * Usage: ./bench_wsdeque_fib [n] [max_workers]   (default 36, number of online CPUs)
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "bench.h"
+#include "wsdeque.h"
+
+#define DEFAULT_N (36)
+#define MAX_WORKERS (256)
+#define SERIAL_CUTOFF (18)
+
+/**
+ * \typedef fib_task_t
+ * \brief Allows struct fib_task_s to be instantiated as fib_task_t
+ */
+typedef struct fib_task_s fib_task_t;
+
+/**
+ * \struct fib_task_s
+ * \brief A pushed fib(n) child. Lives on the parent's stack, which stays put until done is set
+ *
+ * \detail int n - Argument
+ * \detail long result - fib(n), valid once done is set
+ * \detail atomic_int done - Set with release ordering by whoever ran the task
+ */
+struct fib_task_s {
+	int n;
+	long result;
+	atomic_int done;
+};
+
+/**
+ * \typedef fib_pool_t
+ * \brief Allows struct fib_pool_s to be instantiated as fib_pool_t
+ */
+typedef struct fib_pool_s fib_pool_t;
+
+/**
+ * \struct fib_pool_s
+ * \brief Workers + their deques for one run
+ *
+ * \detail int workers - Number of workers, including the thread that runs the root task
+ * \detail wsdeque_t* deques[MAX_WORKERS] - One deque per worker
+ * \detail atomic_int finished - Set once the root task is done, so idle workers exit
+ * \detail atomic_long steals - Number of successful steals, for the report
+ */
+struct fib_pool_s {
+	int workers;
+	wsdeque_t* deques[MAX_WORKERS];
+	atomic_int finished;
+	atomic_long steals;
+};
+
+/**
+ * \typedef fib_worker_t
+ * \brief Allows struct fib_worker_s to be instantiated as fib_worker_t
+ */
+typedef struct fib_worker_s fib_worker_t;
+
+/**
+ * \struct fib_worker_s
+ * \brief Per-thread view of the pool
+ *
+ * \detail fib_pool_t* pool - The pool this worker belongs to
+ * \detail int id - Index of this worker's deque
+ * \detail unsigned int seed - State for picking random victims
+ */
+struct fib_worker_s {
+	fib_pool_t* pool;
+	int id;
+	unsigned int seed;
+};
+
+static void fib_run(fib_worker_t* self, fib_task_t* task);
+
+/**
+ * \fn static long fib_serial(int n)
+ * \brief Plain recursive fib, used below the cutoff where a task would cost more than it saves
+ *
+ * \param n Argument
+ *
+ * \return fib(n)
+ */
+static long fib_serial(int n) {
+
+	return (n < 2) ? (n) : (fib_serial(n - 1) + fib_serial(n - 2));
+}
+
+/**
+ * \fn static int fib_steal_one(fib_worker_t* self)
+ * \brief Tries to steal one task from a random other worker and run it
+ *
+ * \param self The stealing worker
+ *
+ * \return 1 if a task was run, 0 if the steal came back empty
+ */
+static int fib_steal_one(fib_worker_t* self) {
+
+	int victim;
+	fib_task_t* task;
+
+	if (self->pool->workers < 2) {
+		return 0;
+	}
+
+	victim = (int)(rand_r(&(self->seed)) % (unsigned int)(self->pool->workers - 1));
+	if (victim >= self->id) {
+		victim++;
+	}
+
+	task = (fib_task_t*)wsdeque_steal(self->pool->deques[victim]);
+	if (task == NULL) {
+		return 0;
+	}
+
+	atomic_fetch_add_explicit(&(self->pool->steals), 1, memory_order_relaxed);
+	fib_run(self, task);
+
+	return 1;
+}
+
+/**
+ * \fn static long fib_task(fib_worker_t* self, int n)
+ * \brief Computes fib(n), exposing fib(n-1) to thieves while working on fib(n-2)
+ *
+ * \param self The worker doing the computing
+ * \param n Argument
+ *
+ * \return fib(n)
+ */
+static long fib_task(fib_worker_t* self, int n) {
+
+	long right;
+	fib_task_t child;
+	wsdeque_t* deque = self->pool->deques[self->id];
+
+	if (n < SERIAL_CUTOFF) {
+		return fib_serial(n);
+	}
+
+	child.n = n - 1;
+	child.result = 0;
+	atomic_init(&(child.done), 0);
+
+	wsdeque_push(deque, &child);
+	right = fib_task(self, n - 2);
+
+	// Our child is the newest entry, so if it wasn't stolen this pops it back. If it was, everything older was stolen too and the deque is empty
+	if (wsdeque_pop(deque) == &child) {
+		return fib_task(self, n - 1) + right;
+	}
+
+	// Stay busy until the thief finishes our child
+	while (!atomic_load_explicit(&(child.done), memory_order_acquire)) {
+		fib_steal_one(self);
+	}
+
+	return child.result + right;
+}
+
+/**
+ * \fn static void fib_run(fib_worker_t* self, fib_task_t* task)
+ * \brief Runs a stolen task and publishes its result
+ *
+ * \param self The worker running the task
+ * \param task The task
+ *
+ * \return N/A
+ */
+static void fib_run(fib_worker_t* self, fib_task_t* task) {
+
+	task->result = fib_task(self, task->n);
+	atomic_store_explicit(&(task->done), 1, memory_order_release);
+}
+
+/**
+ * \fn static void* fib_idle_worker(void* arg)
+ * \brief Thread body for every worker except the one running the root task: steal until the root is done
+ *
+ * \param arg The fib_worker_t for this thread
+ *
+ * \return NULL
+ */
+static void* fib_idle_worker(void* arg) {
+
+	fib_worker_t* self = (fib_worker_t*)arg;
+
+	while (!atomic_load_explicit(&(self->pool->finished), memory_order_acquire)) {
+		if (!fib_steal_one(self)) {
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \fn static long fib_parallel(int n, int workers, uint64_t* elapsed_ns, long* steals)
+ * \brief Runs fib(n) on a fresh pool of workers
+ *
+ * \param n Argument
+ * \param workers Number of workers, including the calling thread
+ * \param elapsed_ns Filled in with the wall time of the computation
+ * \param steals Filled in with the number of successful steals
+ *
+ * \return fib(n), or -1 if the pool couldn't be set up
+ */
+static long fib_parallel(int n, int workers, uint64_t* elapsed_ns, long* steals) {
+
+	int i;
+	long result;
+	uint64_t start;
+	fib_pool_t pool;
+	fib_worker_t self[MAX_WORKERS];
+	pthread_t thread[MAX_WORKERS];
+
+	pool.workers = workers;
+	atomic_init(&(pool.finished), 0);
+	atomic_init(&(pool.steals), 0);
+
+	for (i = 0; i < workers; i++) {
+		pool.deques[i] = wsdeque_create(64);
+		if (pool.deques[i] == NULL) {
+			return -1;
+		}
+		self[i].pool = &pool;
+		self[i].id = i;
+		self[i].seed = (unsigned int)(i + 1);
+	}
+
+	for (i = 1; i < workers; i++) {
+		pthread_create(&thread[i], NULL, fib_idle_worker, &self[i]);
+	}
+
+	start = bench_now_ns();
+	result = fib_task(&self[0], n);
+	*elapsed_ns = bench_now_ns() - start;
+
+	atomic_store_explicit(&(pool.finished), 1, memory_order_release);
+	for (i = 1; i < workers; i++) {
+		pthread_join(thread[i], NULL);
+	}
+
+	*steals = atomic_load(&(pool.steals));
+
+	for (i = 0; i < workers; i++) {
+		wsdeque_destroy(pool.deques[i]);
+	}
+
+	return result;
+}
+
+/**
+ * \fn static int next_worker_count(int workers, int max_workers)
+ * \brief Steps through 1, 2, 3, 4, 8, 16, ... workers, capped at max_workers
+ *
+ * \param workers Current number of workers
+ * \param max_workers Largest number of workers to try
+ *
+ * \return Next number of workers to try
+ */
+static int next_worker_count(int workers, int max_workers) {
+
+	int next = (workers < 4) ? (workers + 1) : (workers * 2);
+
+	return (next > max_workers) ? (max_workers) : (next);
+}
+
+int main(int argc, char** argv) {
+
+	int n;
+	int workers;
+	int max_workers;
+	long result;
+	long expected;
+	long steals;
+	uint64_t elapsed_ns;
+	uint64_t serial_ns;
+	uint64_t one_worker_ns = 0;
+
+	n = (argc > 1) ? (atoi(argv[1])) : (DEFAULT_N);
+	max_workers = (argc > 2) ? (atoi(argv[2])) : ((int)(sysconf(_SC_NPROCESSORS_ONLN)));
+	if (max_workers < 1) {
+		max_workers = 1;
+	}
+	if (max_workers > MAX_WORKERS) {
+		max_workers = MAX_WORKERS;
+	}
+
+	serial_ns = bench_now_ns();
+	expected = fib_serial(n);
+	serial_ns = bench_now_ns() - serial_ns;
+
+	printf("workers,n,ms,speedup_vs_1_worker,overhead_vs_serial,steals,ok\n");
+
+	// 1, 2, 3, 4, 8, 16, ... workers, always ending on max_workers
+	for (workers = 1; ; workers = next_worker_count(workers, max_workers)) {
+
+		result = fib_parallel(n, workers, &elapsed_ns, &steals);
+		if (workers == 1) {
+			one_worker_ns = elapsed_ns;
+		}
+
+		printf("%d,%d,%.1f,%.2f,%.2f,%ld,%s\n",
+			workers,
+			n,
+			(double)(elapsed_ns) / 1e6,
+			(double)(one_worker_ns) / (double)(elapsed_ns),
+			(double)(elapsed_ns) / (double)(serial_ns),
+			steals,
+			(result == expected) ? "yes" : "no");
+
+		if (workers == max_workers) {
+			break;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
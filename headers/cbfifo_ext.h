@@ -0,0 +1,18 @@
+/**
+ * \file cbfifo_ext.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Additions to the cbfifo API. cbfifo.h is kept exactly as delivered, so anything beyond it is declared here and implemented in cbfifo.c
+ */
+
+#ifndef _CBFIFO_EXT_H_
+#define _CBFIFO_EXT_H_
+
+#include "cbfifo.h"
+#include "sojourn.h"
+
+#ifdef FIFO_SOJOURN
+int cbfifo_set_sojourn(sojourn_hist_t* hist);
+#endif
+
+#endif // _CBFIFO_EXT_H_
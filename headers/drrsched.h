@@ -0,0 +1,38 @@
+/**
+ * \file drrsched.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _DRRSCHED_H_
+#define _DRRSCHED_H_
+
+#include <stdlib.h>  // for size_t
+#include "llfifo.h"
+
+/**
+ * \typedef drrsched_t
+ * \brief Deficit round-robin scheduler over many llfifo queues. Only queues holding elements sit on its active list, so idle queues cost nothing per dispatch. Defined as an incomplete type to hide the implementation
+ */
+typedef struct drrsched_s drrsched_t;
+
+/**
+ * \typedef drrsched_flow_t
+ * \brief One llfifo attached to a drrsched_t, plus its quantum + deficit. Defined as an incomplete type to hide the implementation
+ */
+typedef struct drrsched_flow_s drrsched_flow_t;
+
+/**
+ * \typedef drrsched_cost_t
+ * \brief Callback for drrsched_create: returns what dispatching an element costs against its queue's deficit (bytes, say), given the element + the ctx passed to drrsched_create
+ */
+typedef size_t (*drrsched_cost_t)(void* element, void* ctx);
+
+drrsched_t* drrsched_create(drrsched_cost_t cost, void* ctx);
+drrsched_flow_t* drrsched_attach(drrsched_t* sched, llfifo_t* queue, size_t quantum);
+int drrsched_detach(drrsched_t* sched, drrsched_flow_t* flow);
+size_t drrsched_enqueue(drrsched_t* sched, drrsched_flow_t* flow, void* element);
+void* drrsched_dispatch(drrsched_t* sched, drrsched_flow_t** flow);
+size_t drrsched_active(drrsched_t* sched);
+void drrsched_destroy(drrsched_t* sched);
+
+#endif // _DRRSCHED_H_
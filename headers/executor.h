@@ -0,0 +1,59 @@
+/**
+ * \file executor.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _EXECUTOR_H_
+#define _EXECUTOR_H_
+
+#include <stdint.h>
+#include <stdlib.h>  // for size_t
+
+/**
+ * \typedef executor_t
+ * \brief Fixed-size thread pool. Tasks submitted from outside go through a shared injection queue (a synchronized llfifo), tasks submitted from inside a running task go to that worker's own local queue (a wsdeque), and idle workers steal from each other. Defined as an incomplete type to hide the implementation
+ */
+typedef struct executor_s executor_t;
+
+/**
+ * \typedef executor_fn_t
+ * \brief A task: called once on some worker thread with the argument it was submitted with
+ */
+typedef void (*executor_fn_t)(void* arg);
+
+/**
+ * \typedef executor_stats_t
+ * \brief Allows struct executor_stats_s to be instantiated as executor_stats_t
+ */
+typedef struct executor_stats_s executor_stats_t;
+
+/**
+ * \struct executor_stats_s
+ * \brief Snapshot of one worker's metrics. Counters are cumulative since the executor was created
+ *
+ * \detail uint64_t executed - Tasks this worker has run
+ * \detail uint64_t stolen - How many of those it stole from another worker's local queue
+ * \detail size_t local_depth - Tasks currently in this worker's local queue
+ * \detail size_t local_depth_max - Most tasks ever seen in this worker's local queue
+ * \detail uint64_t latency_avg_ns - Average time from submit until this worker started the task
+ * \detail uint64_t latency_max_ns - Longest time from submit until this worker started a task
+ */
+struct executor_stats_s {
+	uint64_t executed;
+	uint64_t stolen;
+	size_t local_depth;
+	size_t local_depth_max;
+	uint64_t latency_avg_ns;
+	uint64_t latency_max_ns;
+};
+
+executor_t* executor_create(int workers);
+int executor_submit(executor_t* executor, executor_fn_t fn, void* arg);
+int executor_submit_batch(executor_t* executor, executor_fn_t fn, void** args, int n);
+size_t executor_pending(executor_t* executor);
+int executor_workers(executor_t* executor);
+int executor_stats(executor_t* executor, int worker, executor_stats_t* stats);
+void executor_shutdown(executor_t* executor);
+void executor_destroy(executor_t* executor);
+
+#endif // _EXECUTOR_H_
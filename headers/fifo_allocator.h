@@ -0,0 +1,31 @@
+/**
+ * \file fifo_allocator.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _FIFO_ALLOCATOR_H_
+#define _FIFO_ALLOCATOR_H_
+
+#include <stdlib.h>  // for size_t
+
+/**
+ * \typedef fifo_allocator_t
+ * \brief Allows struct fifo_allocator_s to be instantiated as fifo_allocator_t
+ */
+typedef struct fifo_allocator_s fifo_allocator_t;
+
+/**
+ * \struct fifo_allocator_s
+ * \brief Memory hooks a FIFO uses instead of malloc/free. The FIFO keeps its own copy, so the struct itself may go out of scope after create, but ctx must outlive the FIFO
+ *
+ * \detail void* (*alloc)(void* ctx, size_t size) - Returns size bytes aligned for any type, or NULL on failure. Cannot be NULL
+ * \detail void (*free)(void* ctx, void* ptr, size_t size) - Releases ptr, which alloc returned for the same size. May be NULL for arenas that release everything at once
+ * \detail void* ctx - Passed through to alloc + free untouched
+ */
+struct fifo_allocator_s {
+	void* (*alloc)(void* ctx, size_t size);
+	void (*free)(void* ctx, void* ptr, size_t size);
+	void* ctx;
+};
+
+#endif // _FIFO_ALLOCATOR_H_
@@ -0,0 +1,62 @@
+/**
+ * \file ilfifo.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _ILFIFO_H_
+#define _ILFIFO_H_
+
+#include <stddef.h>  // for offsetof
+
+/**
+ * \def ILFIFO_ENTRY(link, type, member)
+ * \brief Recovers a pointer to the caller's struct from a pointer to the ilfifo_link_t embedded in it
+ *
+ * \detail link - Pointer to the embedded ilfifo_link_t, as returned by ilfifo_dequeue
+ * \detail type - The caller's struct type that embeds the link
+ * \detail member - Name of the ilfifo_link_t field within type
+ */
+#define ILFIFO_ENTRY(link, type, member) ((type*)((char*)(link) - offsetof(type, member)))
+
+/**
+ * \typedef ilfifo_link_t
+ * \brief Allows struct ilfifo_link_s to be instantiated as ilfifo_link_t
+ */
+typedef struct ilfifo_link_s ilfifo_link_t;
+
+/**
+ * \typedef ilfifo_t
+ * \brief Allows struct ilfifo_s to be instantiated as ilfifo_t
+ */
+typedef struct ilfifo_s ilfifo_t;
+
+/**
+ * \struct ilfifo_link_s
+ * \brief Link field that callers embed in their own struct so it can be queued without allocating a node
+ *
+ * \detail ilfifo_link_t* next - Points to link next in the FIFO (towards the head). If NULL then the link is the head
+ */
+struct ilfifo_link_s {
+	ilfifo_link_t* next;
+};
+
+/**
+ * \struct ilfifo_s
+ * \brief Intrusive FIFO. Defined here (rather than hidden like llfifo_s) so it can live in static storage or inside another struct
+ *
+ * \detail ilfifo_link_t* head - Points to the most recently enqueued link. If NULL then the FIFO is empty
+ * \detail ilfifo_link_t* tail - Points to the oldest link, which is the next to be dequeued. If NULL then the FIFO is empty
+ * \detail int length - The number of links currently in the FIFO
+ */
+struct ilfifo_s {
+	ilfifo_link_t* head;
+	ilfifo_link_t* tail;
+	int length;
+};
+
+void ilfifo_init(ilfifo_t* fifo);
+int ilfifo_enqueue(ilfifo_t* fifo, ilfifo_link_t* link);
+ilfifo_link_t* ilfifo_dequeue(ilfifo_t* fifo);
+int ilfifo_length(ilfifo_t* fifo);
+
+#endif // _ILFIFO_H_
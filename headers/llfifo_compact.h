@@ -0,0 +1,24 @@
+/**
+ * \file llfifo_compact.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _LLFIFO_COMPACT_H_
+#define _LLFIFO_COMPACT_H_
+
+#include <stdlib.h>  // for size_t
+
+/**
+ * \typedef llfifo_compact_t
+ * \brief Compact llfifo for very deep queues. Nodes live in an index-addressed pool and are singly linked by 32-bit index, so each element costs 12 bytes. Defined as an incomplete type to hide the implementation
+ */
+typedef struct llfifo_compact_s llfifo_compact_t;
+
+llfifo_compact_t* llfifo_compact_create(size_t capacity);
+size_t llfifo_compact_enqueue(llfifo_compact_t* fifo, void* element);
+void* llfifo_compact_dequeue(llfifo_compact_t* fifo);
+size_t llfifo_compact_length(llfifo_compact_t* fifo);
+size_t llfifo_compact_capacity(llfifo_compact_t* fifo);
+void llfifo_compact_destroy(llfifo_compact_t* fifo);
+
+#endif // _LLFIFO_COMPACT_H_
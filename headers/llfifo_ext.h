@@ -0,0 +1,114 @@
+/**
+ * \file llfifo_ext.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Additions to the llfifo API. llfifo.h is kept exactly as delivered, so anything beyond it is declared here and implemented in llfifo.c
+ */
+
+#ifndef _LLFIFO_EXT_H_
+#define _LLFIFO_EXT_H_
+
+#include <stdint.h>
+#include <stdlib.h>  // for size_t
+#include "fifo_allocator.h"
+#include "llfifo.h"
+#include "nodepool.h"
+#include "sojourn.h"
+
+/**
+ * \def LLFIFO_FULL
+ * \brief Returned instead of a length by the int enqueue functions when a FIFO bounded by llfifo_set_limit has no room. Distinct from the -1 error code
+ */
+#define LLFIFO_FULL ((int)(-2))
+
+/**
+ * \def LLFIFO_FULL_SZ
+ * \brief LLFIFO_FULL for the size_t enqueue functions
+ */
+#define LLFIFO_FULL_SZ ((size_t)(-2))
+
+/**
+ * \def LLFIFO_STAMPED
+ * \brief Defined when the build gives every node an enqueue timestamp, which FIFO_SOJOURN + FIFO_CODEL both rely on
+ */
+#if defined(FIFO_SOJOURN) || defined(FIFO_CODEL)
+#define LLFIFO_STAMPED
+#endif
+
+/**
+ * \typedef llfifo_visit_t
+ * \brief Callback for llfifo_foreach: called with each queued element + the ctx passed to llfifo_foreach. Returns nonzero to stop the walk
+ */
+typedef int (*llfifo_visit_t)(void* element, void* ctx);
+
+/**
+ * \typedef llfifo_dtor_t
+ * \brief Callback for llfifo_destroy_with + llfifo_clear: called once with each element still queued, typically to free it
+ */
+typedef void (*llfifo_dtor_t)(void* element);
+
+/**
+ * \typedef llfifo_drop_t
+ * \brief Callback for llfifo_set_codel + llfifo_set_reject: called with each element CoDel drops, or each one discarded for missing its deadline, at dequeue + the ctx passed when it was set
+ */
+typedef void (*llfifo_drop_t)(void* element, void* ctx);
+
+#ifdef FIFO_DEADLINE
+/**
+ * \typedef llfifo_deadline_stats_t
+ * \brief Allows struct llfifo_deadline_stats_s to be instantiated as llfifo_deadline_stats_t
+ */
+typedef struct llfifo_deadline_stats_s llfifo_deadline_stats_t;
+
+/**
+ * \struct llfifo_deadline_stats_s
+ * \brief Snapshot of a FIFO's deadline counters, filled in by llfifo_deadline_stats. Counters are cumulative since the FIFO was created
+ *
+ * \detail uint64_t tagged - Elements enqueued with a deadline by llfifo_enqueue_deadline
+ * \detail uint64_t expired - Elements discarded at dequeue because their deadline had passed
+ */
+struct llfifo_deadline_stats_s {
+	uint64_t tagged;
+	uint64_t expired;
+};
+#endif
+
+llfifo_t* llfifo_create_sz(size_t capacity);
+size_t llfifo_enqueue_sz(llfifo_t* fifo, void* element);
+size_t llfifo_length_sz(llfifo_t* fifo);
+size_t llfifo_capacity_sz(llfifo_t* fifo);
+int llfifo_enqueue_batch(llfifo_t* fifo, void** elements, int n);
+int llfifo_dequeue_batch(llfifo_t* fifo, void** out, int max);
+int llfifo_reserve(llfifo_t* fifo, int n);
+nodepool_t* llfifo_pool_create(int block_nodes);
+llfifo_t* llfifo_create_pooled(nodepool_t* pool);
+llfifo_t* llfifo_create_with_allocator(size_t capacity, const fifo_allocator_t* allocator);
+int llfifo_enable_sync(llfifo_t* fifo);
+void* llfifo_dequeue_wait(llfifo_t* fifo, long long timeout_ns);
+int llfifo_close(llfifo_t* fifo);
+int llfifo_closed(llfifo_t* fifo);
+int llfifo_set_limit(llfifo_t* fifo, size_t limit);
+size_t llfifo_limit(llfifo_t* fifo);
+int llfifo_enqueue_wait(llfifo_t* fifo, void* element, long long timeout_ns);
+size_t llfifo_splice(llfifo_t* dst, llfifo_t* src);
+void* llfifo_peek(llfifo_t* fifo);
+size_t llfifo_foreach(llfifo_t* fifo, llfifo_visit_t visit, void* ctx);
+void llfifo_destroy_with(llfifo_t* fifo, llfifo_dtor_t dtor);
+size_t llfifo_clear(llfifo_t* fifo, llfifo_dtor_t dtor, int keep_free);
+
+#ifdef FIFO_SOJOURN
+int llfifo_set_sojourn(llfifo_t* fifo, sojourn_hist_t* hist);
+#endif
+
+#ifdef FIFO_CODEL
+int llfifo_set_codel(llfifo_t* fifo, uint64_t target_ns, uint64_t interval_ns, llfifo_drop_t drop, void* ctx);
+size_t llfifo_codel_dropped(llfifo_t* fifo);
+#endif
+
+#ifdef FIFO_DEADLINE
+int llfifo_enqueue_deadline(llfifo_t* fifo, void* element, uint64_t deadline_ns);
+int llfifo_set_reject(llfifo_t* fifo, llfifo_drop_t reject, void* ctx);
+int llfifo_deadline_stats(llfifo_t* fifo, llfifo_deadline_stats_t* stats);
+#endif
+
+#endif // _LLFIFO_EXT_H_
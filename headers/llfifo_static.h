@@ -0,0 +1,78 @@
+/**
+ * \file llfifo_static.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Fixed-capacity llfifo that never touches the heap. LLFIFO_STATIC_DEFINE generates a FIFO type whose storage is sized at compile time, so instances can live in static storage, on the stack or inside another struct, plus static inline functions to use it. Same element rules + return values as the int API in llfifo.h, except that a full FIFO reports LLFIFO_FULL instead of growing
+ */
+
+#ifndef _LLFIFO_STATIC_H_
+#define _LLFIFO_STATIC_H_
+
+#include <limits.h>  // for INT_MAX
+#include <stdlib.h>  // for size_t, NULL
+#include "llfifo_ext.h"  // for LLFIFO_FULL
+
+/**
+ * \def LLFIFO_STATIC_DEFINE(name, N)
+ * \brief Defines type name##_t, holding up to N elements, and the functions below. Capacity never changes, so instead of free + used lists of nodes the elements sit in a ring of N slots, which is the same FIFO order without the per-node links. Use at file scope, once per name, without a trailing semicolon
+ *
+ * \detail void name##_init(name##_t* fifo) - Empties the FIFO. Instances in static storage start out empty, ones on the stack must be initialized first
+ * \detail int name##_enqueue(name##_t* fifo, void* element) - Enqueues a non-NULL element. Returns the new length, LLFIFO_FULL (-2) if N elements are already queued, or -1 if fifo or element is NULL
+ * \detail void* name##_dequeue(name##_t* fifo) - Removes + returns the oldest element, or NULL if the FIFO is empty or NULL
+ * \detail int name##_length(name##_t* fifo) - Returns the number of elements queued, or -1 if fifo is NULL
+ * \detail int name##_capacity(name##_t* fifo) - Returns N, or -1 if fifo is NULL
+ *
+ * \detail name - Prefix for the generated type + functions
+ * \detail N - Capacity in elements. Must be a constant in the range of 1 to INT_MAX
+ */
+#define LLFIFO_STATIC_DEFINE(name, N) \
+	_Static_assert(((N) > 0) && ((N) <= INT_MAX), "LLFIFO_STATIC_DEFINE capacity must be in the range of 1 to INT_MAX"); \
+	\
+	typedef struct name##_s { \
+		void* slots[(N)]; \
+		size_t tail; \
+		size_t length; \
+	} name##_t; \
+	\
+	static inline void name##_init(name##_t* fifo) { \
+		fifo->tail = 0; \
+		fifo->length = 0; \
+	} \
+	\
+	static inline int name##_enqueue(name##_t* fifo, void* element) { \
+		size_t head; \
+		if ((fifo == NULL) || (element == NULL)) { \
+			return -1; \
+		} \
+		if (fifo->length == (size_t)(N)) { \
+			return LLFIFO_FULL; \
+		} \
+		head = fifo->tail + fifo->length; \
+		if (head >= (size_t)(N)) { \
+			head -= (size_t)(N); \
+		} \
+		fifo->slots[head] = element; \
+		fifo->length++; \
+		return (int)(fifo->length); \
+	} \
+	\
+	static inline void* name##_dequeue(name##_t* fifo) { \
+		void* element; \
+		if ((fifo == NULL) || (fifo->length == 0)) { \
+			return NULL; \
+		} \
+		element = fifo->slots[fifo->tail]; \
+		fifo->tail = (fifo->tail == ((size_t)(N) - 1)) ? (0) : (fifo->tail + 1); \
+		fifo->length--; \
+		return element; \
+	} \
+	\
+	static inline int name##_length(name##_t* fifo) { \
+		return (fifo == NULL) ? (-1) : ((int)(fifo->length)); \
+	} \
+	\
+	static inline int name##_capacity(name##_t* fifo) { \
+		return (fifo == NULL) ? (-1) : ((int)(N)); \
+	}
+
+#endif // _LLFIFO_STATIC_H_
@@ -0,0 +1,51 @@
+/**
+ * \file mcring.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _MCRING_H_
+#define _MCRING_H_
+
+#include <stdlib.h>  // for size_t
+
+/**
+ * \def MCRING_MAX_CONSUMERS
+ * \brief Most consumers an mcring_t can have subscribed at once
+ */
+#define MCRING_MAX_CONSUMERS ((int)(64))
+
+/**
+ * \def MCRING_DETACHED
+ * \brief Returned instead of a byte count by mcring_dequeue + mcring_length once the producer has detached the consumer. Distinct from the -1 error code
+ */
+#define MCRING_DETACHED ((size_t)(-2))
+
+/**
+ * \typedef mcring_t
+ * \brief Multicast byte ring: one producer writes each byte once, and every subscribed consumer reads every byte through its own cursor. Defined as an incomplete type to hide the implementation
+ */
+typedef struct mcring_s mcring_t;
+
+/**
+ * \typedef mcring_policy_t
+ * \brief What mcring_enqueue does when the slowest consumer hasn't made room yet
+ *
+ * \detail MCRING_WAIT_SLOWEST - Write only as much as the slowest consumer has made room for, like cbfifo_enqueue on a full buffer. No consumer ever misses a byte
+ * \detail MCRING_DETACH_SLOW - Detach every consumer standing in the way, then write. A stalled consumer never holds up the producer or the others, and finds out through MCRING_DETACHED
+ */
+typedef enum {
+	MCRING_WAIT_SLOWEST,
+	MCRING_DETACH_SLOW
+} mcring_policy_t;
+
+mcring_t* mcring_create(size_t capacity, mcring_policy_t policy);
+int mcring_subscribe(mcring_t* ring);
+int mcring_unsubscribe(mcring_t* ring, int consumer);
+size_t mcring_enqueue(mcring_t* ring, void* buf, size_t nbyte);
+size_t mcring_dequeue(mcring_t* ring, int consumer, void* buf, size_t nbyte);
+size_t mcring_length(mcring_t* ring, int consumer);
+size_t mcring_space(mcring_t* ring);
+size_t mcring_capacity(mcring_t* ring);
+void mcring_destroy(mcring_t* ring);
+
+#endif // _MCRING_H_
@@ -0,0 +1,25 @@
+/**
+ * \file nodepool.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _NODEPOOL_H_
+#define _NODEPOOL_H_
+
+#include <stdlib.h>  // for size_t
+
+/**
+ * \typedef nodepool_t
+ * \brief Pool of fixed-size objects shared by any number of FIFOs. Defined as an incomplete type to hide the implementation
+ */
+typedef struct nodepool_s nodepool_t;
+
+nodepool_t* nodepool_create(size_t object_size, int block_objects);
+void* nodepool_get(nodepool_t* pool);
+void nodepool_put(nodepool_t* pool, void* object);
+int nodepool_reserve(nodepool_t* pool, int n);
+size_t nodepool_object_size(nodepool_t* pool);
+size_t nodepool_allocated(nodepool_t* pool);
+void nodepool_destroy(nodepool_t* pool);
+
+#endif // _NODEPOOL_H_
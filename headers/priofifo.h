@@ -0,0 +1,66 @@
+/**
+ * \file priofifo.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _PRIOFIFO_H_
+#define _PRIOFIFO_H_
+
+#include <stdint.h>
+#include <stdlib.h>  // for size_t
+
+/**
+ * \def PRIOFIFO_MAX_LANES
+ * \brief Most lanes a priofifo_t can have, one per bit of its non-empty lane bitmap
+ */
+#define PRIOFIFO_MAX_LANES ((int)(64))
+
+/**
+ * \typedef priofifo_t
+ * \brief FIFO split into lanes, each an llfifo, with a dequeue that chooses which lane to serve. Lane 0 is the highest priority. Defined as an incomplete type to hide the implementation
+ */
+typedef struct priofifo_s priofifo_t;
+
+/**
+ * \typedef priofifo_policy_t
+ * \brief How priofifo_dequeue chooses a lane
+ *
+ * \detail PRIOFIFO_STRICT - Always the lowest-numbered non-empty lane. Higher lanes only run when every lane below them is empty
+ * \detail PRIOFIFO_WEIGHTED - Weighted round-robin over the non-empty lanes: each one gets up to its weight (see priofifo_set_weight) dequeues in a row before moving on, so no lane starves
+ */
+typedef enum {
+	PRIOFIFO_STRICT,
+	PRIOFIFO_WEIGHTED
+} priofifo_policy_t;
+
+/**
+ * \typedef priofifo_stats_t
+ * \brief Allows struct priofifo_stats_s to be instantiated as priofifo_stats_t
+ */
+typedef struct priofifo_stats_s priofifo_stats_t;
+
+/**
+ * \struct priofifo_stats_s
+ * \brief Snapshot of one lane's metrics. Counters are cumulative since the priofifo was created
+ *
+ * \detail uint64_t enqueued - Elements enqueued onto this lane
+ * \detail uint64_t dequeued - Elements dequeued from this lane
+ * \detail size_t length - Elements currently queued in this lane
+ * \detail size_t length_max - Most elements ever queued in this lane at once
+ */
+struct priofifo_stats_s {
+	uint64_t enqueued;
+	uint64_t dequeued;
+	size_t length;
+	size_t length_max;
+};
+
+priofifo_t* priofifo_create(int lanes, priofifo_policy_t policy);
+int priofifo_set_weight(priofifo_t* fifo, int lane, unsigned int weight);
+size_t priofifo_enqueue(priofifo_t* fifo, int lane, void* element);
+void* priofifo_dequeue(priofifo_t* fifo, int* lane);
+size_t priofifo_length(priofifo_t* fifo);
+int priofifo_stats(priofifo_t* fifo, int lane, priofifo_stats_t* stats);
+void priofifo_destroy(priofifo_t* fifo);
+
+#endif // _PRIOFIFO_H_
@@ -0,0 +1,65 @@
+/**
+ * \file sojourn.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Log-linear (HDR-style) histogram of how long data waited inside a FIFO. Recording is lock-free, so any number of FIFOs + threads can share one histogram while another thread takes snapshots
+ */
+
+#ifndef _SOJOURN_H_
+#define _SOJOURN_H_
+
+#include <stdint.h>
+#include <stdlib.h>  // for size_t
+
+/**
+ * \def SOJOURN_SUB_BITS
+ * \brief Each power of 2 is split into 2^SOJOURN_SUB_BITS equal buckets, so a recorded value is off by at most 1 part in 32 (about 3%). Values below 2^SOJOURN_SUB_BITS ns are exact
+ */
+#define SOJOURN_SUB_BITS (5)
+
+/**
+ * \def SOJOURN_BUCKETS
+ * \brief Number of buckets needed to cover every uint64_t nanosecond value
+ */
+#define SOJOURN_BUCKETS ((size_t)((64 - SOJOURN_SUB_BITS + 1) << SOJOURN_SUB_BITS))
+
+/**
+ * \typedef sojourn_hist_t
+ * \brief Histogram that wait times are recorded into. Defined as an incomplete type to hide the implementation
+ */
+typedef struct sojourn_hist_s sojourn_hist_t;
+
+/**
+ * \typedef sojourn_snapshot_t
+ * \brief Allows struct sojourn_snapshot_s to be instantiated as sojourn_snapshot_t
+ */
+typedef struct sojourn_snapshot_s sojourn_snapshot_t;
+
+/**
+ * \struct sojourn_snapshot_s
+ * \brief Plain copy of a histogram at one point in time, filled in by sojourn_snapshot
+ *
+ * \detail uint64_t count - Number of waits recorded. Always equals the sum of counts
+ * \detail uint64_t sum_ns - Total of every wait recorded, for the mean
+ * \detail uint64_t max_ns - Longest wait recorded
+ * \detail uint64_t counts[SOJOURN_BUCKETS] - Waits recorded in each bucket. Bucket i covers sojourn_bucket_lower(i) to sojourn_bucket_upper(i) ns
+ */
+struct sojourn_snapshot_s {
+	uint64_t count;
+	uint64_t sum_ns;
+	uint64_t max_ns;
+	uint64_t counts[SOJOURN_BUCKETS];
+};
+
+sojourn_hist_t* sojourn_create();
+void sojourn_record(sojourn_hist_t* hist, uint64_t wait_ns);
+int sojourn_snapshot(sojourn_hist_t* hist, sojourn_snapshot_t* snapshot);
+uint64_t sojourn_percentile(const sojourn_snapshot_t* snapshot, double p);
+void sojourn_reset(sojourn_hist_t* hist);
+void sojourn_destroy(sojourn_hist_t* hist);
+size_t sojourn_bucket(uint64_t wait_ns);
+uint64_t sojourn_bucket_lower(size_t bucket);
+uint64_t sojourn_bucket_upper(size_t bucket);
+uint64_t sojourn_now_ns();
+
+#endif // _SOJOURN_H_
@@ -0,0 +1,14 @@
+/**
+ * \file test_drrsched.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _TEST_DRRSCHED_H_
+#define _TEST_DRRSCHED_H_
+
+#include "drrsched.h"
+
+void test_drrsched();
+int test_drrsched_dispatch(drrsched_t* sched, void* expected, drrsched_flow_t* expected_flow);
+
+#endif // _TEST_DRRSCHED_H_
@@ -0,0 +1,18 @@
+/**
+ * \file test_executor.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _TEST_EXECUTOR_H_
+#define _TEST_EXECUTOR_H_
+
+#include "executor.h"
+
+void test_executor();
+int test_executor_submit(executor_t* executor, int tasks, int batch);
+int test_executor_spawn(executor_t* executor, int depth);
+int test_executor_drain(int workers, int tasks);
+int test_executor_shutdown_race(int workers, int rounds);
+void executor_dump_state(executor_t* executor);
+
+#endif // _TEST_EXECUTOR_H_
@@ -0,0 +1,17 @@
+/**
+ * \file test_ilfifo.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _TEST_ILFIFO_H_
+#define _TEST_ILFIFO_H_
+
+#include "ilfifo.h"
+
+void test_ilfifo();
+int test_ilfifo_enqueue(ilfifo_t* fifo, ilfifo_link_t* link, int max_links);
+int test_ilfifo_dequeue(ilfifo_t* fifo, const char* expected, int max_links);
+int test_ilfifo_length(ilfifo_t* fifo, int expected, int max_links);
+void ilfifo_dump_state(ilfifo_t* fifo, int max_links);
+
+#endif // _TEST_ILFIFO_H_
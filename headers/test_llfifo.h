@@ -7,6 +7,7 @@
 #define _TEST_LLFIFO_H_
 
 #include "llfifo.h"
+#include "llfifo_ext.h"
 
 void test_llfifo();
 int test_llfifo_create(int capacity, int max_nodes);
@@ -15,6 +16,28 @@ int test_llfifo_dequeue(llfifo_t* fifo, int max_nodes);
 int test_llfifo_length(llfifo_t* fifo, int max_nodes);
 int test_llfifo_capacity(llfifo_t* fifo, int max_nodes);
 int test_llfifo_destroy(llfifo_t* fifo);
+int test_llfifo_enqueue_batch(llfifo_t* fifo, void** elements, int n, int max_nodes);
+int test_llfifo_dequeue_batch(llfifo_t* fifo, void** out, int max, int max_nodes);
+int test_llfifo_reserve(llfifo_t* fifo, int n, int max_nodes);
+int test_llfifo_pooled(llfifo_t* fifo, int expected, int max_nodes);
+int test_llfifo_enqueue_sz(llfifo_t* fifo, void* element, int max_nodes);
+int test_llfifo_allocator(fifo_allocator_t* allocator, size_t capacity, int enqueues, int max_nodes);
+int test_llfifo_dequeue_wait(llfifo_t* fifo, long long timeout_ns, void* expected, int max_nodes);
+void* test_llfifo_sync_delayed_enqueue(void* fifo);
+void* test_llfifo_sync_delayed_close(void* fifo);
+void* test_llfifo_sync_producer(void* fifo);
+int test_llfifo_sync_consume(llfifo_t* fifo, int count);
+int test_llfifo_enqueue_wait(llfifo_t* fifo, void* element, long long timeout_ns, int expected, int max_nodes);
+void* test_llfifo_limit_delayed_dequeue(void* fifo);
+int test_llfifo_splice(llfifo_t* dst, llfifo_t* src, size_t expected, int max_nodes);
+int test_llfifo_foreach(llfifo_t* fifo, void** expected, int count, int stop_after, int max_nodes);
+int test_llfifo_clear(llfifo_t* fifo, llfifo_dtor_t dtor, int keep_free, size_t expected, int max_nodes);
+#ifdef FIFO_CODEL
+int test_llfifo_codel(llfifo_t* fifo, const char* expected, size_t expected_dropped, int max_nodes);
+#endif
+#ifdef FIFO_DEADLINE
+int test_llfifo_deadline(llfifo_t* fifo, const char* expected, uint64_t expected_expired, int max_nodes);
+#endif
 void llfifo_dump_state(llfifo_t* fifo, int max_nodes);
 
 #endif // _TEST_LLFIFO_H_
\ No newline at end of file
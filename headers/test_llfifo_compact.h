@@ -0,0 +1,15 @@
+/**
+ * \file test_llfifo_compact.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _TEST_LLFIFO_COMPACT_H_
+#define _TEST_LLFIFO_COMPACT_H_
+
+#include "llfifo_compact.h"
+
+void test_llfifo_compact();
+int test_llfifo_compact_enqueue(llfifo_compact_t* fifo, void* element, size_t expected_capacity);
+int test_llfifo_compact_dequeue(llfifo_compact_t* fifo, void* expected);
+
+#endif // _TEST_LLFIFO_COMPACT_H_
@@ -0,0 +1,17 @@
+/**
+ * \file test_llfifo_static.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _TEST_LLFIFO_STATIC_H_
+#define _TEST_LLFIFO_STATIC_H_
+
+#include "llfifo_static.h"
+
+LLFIFO_STATIC_DEFINE(test_static_fifo, 3)
+
+void test_llfifo_static();
+int test_llfifo_static_enqueue(test_static_fifo_t* fifo, void* element, int expected);
+int test_llfifo_static_dequeue(test_static_fifo_t* fifo, void* expected);
+
+#endif // _TEST_LLFIFO_STATIC_H_
@@ -0,0 +1,14 @@
+/**
+ * \file test_mcring.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _TEST_MCRING_H_
+#define _TEST_MCRING_H_
+
+#include "mcring.h"
+
+void test_mcring();
+int test_mcring_dequeue(mcring_t* ring, int consumer, const char* expected);
+
+#endif // _TEST_MCRING_H_
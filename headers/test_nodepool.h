@@ -0,0 +1,16 @@
+/**
+ * \file test_nodepool.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _TEST_NODEPOOL_H_
+#define _TEST_NODEPOOL_H_
+
+#include "nodepool.h"
+
+void test_nodepool();
+int test_nodepool_get_put(nodepool_t* pool, int count);
+int test_nodepool_threads(nodepool_t* pool, int threads);
+int test_nodepool_churn(nodepool_t* pool, int threads);
+
+#endif // _TEST_NODEPOOL_H_
@@ -0,0 +1,14 @@
+/**
+ * \file test_priofifo.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _TEST_PRIOFIFO_H_
+#define _TEST_PRIOFIFO_H_
+
+#include "priofifo.h"
+
+void test_priofifo();
+int test_priofifo_dequeue(priofifo_t* fifo, void* expected, int expected_lane);
+
+#endif // _TEST_PRIOFIFO_H_
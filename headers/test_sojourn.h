@@ -0,0 +1,17 @@
+/**
+ * \file test_sojourn.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _TEST_SOJOURN_H_
+#define _TEST_SOJOURN_H_
+
+#include <stdint.h>
+#include "sojourn.h"
+
+void test_sojourn();
+int test_sojourn_bucket(uint64_t wait_ns);
+int test_sojourn_expect(sojourn_hist_t* hist, uint64_t count, uint64_t min_ns);
+int test_sojourn_threads(sojourn_hist_t* hist, int threads);
+
+#endif // _TEST_SOJOURN_H_
@@ -0,0 +1,17 @@
+/**
+ * \file test_wsdeque.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _TEST_WSDEQUE_H_
+#define _TEST_WSDEQUE_H_
+
+#include "wsdeque.h"
+
+void test_wsdeque();
+int test_wsdeque_push(wsdeque_t* deque, int first, int count);
+int test_wsdeque_pop(wsdeque_t* deque, int first, int count);
+int test_wsdeque_steal(wsdeque_t* deque, int first, int count);
+int test_wsdeque_threads(wsdeque_t* deque, int thieves);
+
+#endif // _TEST_WSDEQUE_H_
@@ -0,0 +1,25 @@
+/**
+ * \file wsdeque.h
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#ifndef _WSDEQUE_H_
+#define _WSDEQUE_H_
+
+#include <stdlib.h>  // for size_t
+
+/**
+ * \typedef wsdeque_t
+ * \brief Chase-Lev work-stealing deque of non-NULL void* elements, the same element convention as llfifo. One owner thread pushes + pops at the bottom without locking, while any number of thief threads steal from the top. Defined as an incomplete type to hide the implementation
+ */
+typedef struct wsdeque_s wsdeque_t;
+
+wsdeque_t* wsdeque_create(size_t capacity);
+size_t wsdeque_push(wsdeque_t* deque, void* element);
+void* wsdeque_pop(wsdeque_t* deque);
+void* wsdeque_steal(wsdeque_t* deque);
+size_t wsdeque_length(wsdeque_t* deque);
+size_t wsdeque_capacity(wsdeque_t* deque);
+void wsdeque_destroy(wsdeque_t* deque);
+
+#endif // _WSDEQUE_H_
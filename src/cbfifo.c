@@ -7,10 +7,17 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include "cbfifo.h"
+#include "cbfifo_ext.h"
 
+#ifndef CB_SIZE
 #define CB_SIZE ((size_t)(128))
+#endif
 #define EXIT_FAILURE_N ((size_t)(-1))
 
+#ifdef FIFO_SOJOURN
+#define CB_SOJOURN_MARKS ((size_t)(16))
+#endif
+
 /**
  * \typedef cbfifo_t
  * \brief Allows struct cbfifo_s to be instantiated as cbfifo_t
@@ -43,6 +50,134 @@ struct cbfifo_s {
  */
 extern cbfifo_t cbfifo;
 
+#ifdef FIFO_SOJOURN
+/**
+ * \typedef cbfifo_mark_t
+ * \brief Allows struct cbfifo_mark_s to be instantiated as cbfifo_mark_t
+ */
+typedef struct cbfifo_mark_s cbfifo_mark_t;
+
+/**
+ * \struct cbfifo_mark_s
+ * \brief One stamped enqueue batch
+ *
+ * \detail uint64_t end - Value of cbfifo_sojourn.enqueued just after the batch went in. The batch has left once cbfifo_sojourn.dequeued reaches it
+ * \detail uint64_t enqueued_ns - sojourn_now_ns() when the batch went in
+ */
+struct cbfifo_mark_s {
+	uint64_t end;
+	uint64_t enqueued_ns;
+};
+
+/**
+ * \typedef cbfifo_sojourn_t
+ * \brief Allows struct cbfifo_sojourn_s to be instantiated as cbfifo_sojourn_t
+ */
+typedef struct cbfifo_sojourn_s cbfifo_sojourn_t;
+
+/**
+ * \struct cbfifo_sojourn_s
+ * \brief Sojourn bookkeeping for the global instance. Kept out of cbfifo_s so the buffer's layout is the same with or without FIFO_SOJOURN
+ *
+ * \detail sojourn_hist_t* hist - Histogram each batch's wait is recorded into. If NULL then nothing is stamped or recorded
+ * \detail uint64_t enqueued - Bytes enqueued since hist was attached. Only ever grows, so batches are located by byte count rather than by buffer position
+ * \detail uint64_t dequeued - Bytes dequeued since hist was attached, not counting bytes that were already queued then
+ * \detail cbfifo_mark_t marks[CB_SOJOURN_MARKS] - Batches still (partly) in the buffer, as a ring, oldest at first
+ * \detail size_t first - Index of the oldest mark
+ * \detail size_t count - Number of marks in the ring
+ */
+struct cbfifo_sojourn_s {
+	sojourn_hist_t* hist;
+	uint64_t enqueued;
+	uint64_t dequeued;
+	cbfifo_mark_t marks[CB_SOJOURN_MARKS];
+	size_t first;
+	size_t count;
+};
+
+/**
+ * \var static cbfifo_sojourn_t cbfifo_sojourn
+ * \brief Sojourn bookkeeping for the global instance
+ */
+static cbfifo_sojourn_t cbfifo_sojourn;
+
+/**
+ * \fn static void cbfifo_sojourn_enqueued(size_t nbyte)
+ * \brief Stamps the batch just enqueued. If every mark is in use, the batch is merged into the newest one, which keeps that mark's earlier stamp. That rounds the merged bytes' wait up rather than losing track of them
+ *
+ * \param nbyte Bytes the enqueue actually added, at least 1
+ *
+ * \return N/A
+ */
+static void cbfifo_sojourn_enqueued(size_t nbyte) {
+
+	cbfifo_mark_t* mark;
+
+	cbfifo_sojourn.enqueued += nbyte;
+
+	if (cbfifo_sojourn.count == CB_SOJOURN_MARKS) {
+		cbfifo_sojourn.marks[(cbfifo_sojourn.first + CB_SOJOURN_MARKS - 1) % CB_SOJOURN_MARKS].end = cbfifo_sojourn.enqueued;
+		return;
+	}
+
+	mark = &(cbfifo_sojourn.marks[(cbfifo_sojourn.first + cbfifo_sojourn.count) % CB_SOJOURN_MARKS]);
+	mark->end = cbfifo_sojourn.enqueued;
+	mark->enqueued_ns = sojourn_now_ns();
+	cbfifo_sojourn.count++;
+}
+
+/**
+ * \fn static void cbfifo_sojourn_dequeued(size_t nbyte, size_t length_before)
+ * \brief Records the wait of every batch whose last byte just left the buffer
+ *
+ * \param nbyte Bytes the dequeue actually removed, at least 1
+ * \param length_before cbfifo.length before the dequeue
+ *
+ * \return N/A
+ */
+static void cbfifo_sojourn_dequeued(size_t nbyte, size_t length_before) {
+
+	uint64_t now;
+	uint64_t stamped;
+	uint64_t unstamped;
+
+	// Bytes queued before hist was attached sit in front of every batch + carry no stamp
+	stamped = cbfifo_sojourn.enqueued - cbfifo_sojourn.dequeued;
+	unstamped = ((uint64_t)(length_before) > stamped) ? ((uint64_t)(length_before) - stamped) : (0);
+	cbfifo_sojourn.dequeued += (nbyte > unstamped) ? (nbyte - unstamped) : (0);
+
+	if ((cbfifo_sojourn.count == 0) || (cbfifo_sojourn.marks[cbfifo_sojourn.first].end > cbfifo_sojourn.dequeued)) {
+		return;
+	}
+
+	now = sojourn_now_ns();
+	while ((cbfifo_sojourn.count > 0) && (cbfifo_sojourn.marks[cbfifo_sojourn.first].end <= cbfifo_sojourn.dequeued)) {
+		sojourn_record(cbfifo_sojourn.hist, now - cbfifo_sojourn.marks[cbfifo_sojourn.first].enqueued_ns);
+		cbfifo_sojourn.first = (cbfifo_sojourn.first + 1) % CB_SOJOURN_MARKS;
+		cbfifo_sojourn.count--;
+	}
+}
+
+/**
+ * \fn int cbfifo_set_sojourn(sojourn_hist_t* hist)
+ * \brief Attaches a histogram that records how long each enqueue batch waits in the buffer. A batch is every byte one cbfifo_enqueue call added, and its wait runs until its last byte is dequeued. Bytes already queued when it is attached are not recorded. Only built with FIFO_SOJOURN, so builds without it carry no bookkeeping at all
+ *
+ * \param hist Histogram to record into. NULL detaches + stops stamping
+ *
+ * \return EXIT_SUCCESS (0)
+ */
+int cbfifo_set_sojourn(sojourn_hist_t* hist) {
+
+	cbfifo_sojourn.hist = hist;
+	cbfifo_sojourn.enqueued = 0;
+	cbfifo_sojourn.dequeued = 0;
+	cbfifo_sojourn.first = 0;
+	cbfifo_sojourn.count = 0;
+
+	return EXIT_SUCCESS;
+}
+#endif
+
 /**
  * \fn size_t cbfifo_enqueue(void* buf, size_t nbyte)
  * \brief Enqueues data onto the FIFO, up to the limit of the available FIFO capacity.
@@ -102,6 +237,12 @@ size_t cbfifo_enqueue(void* buf, size_t nbyte) {
 		}
 	}
 
+#ifdef FIFO_SOJOURN
+	if ((cbfifo_sojourn.hist != NULL) && (bytes_enqueued > 0)) {
+		cbfifo_sojourn_enqueued(bytes_enqueued);
+	}
+#endif
+
 	return (bytes_enqueued);
 }
 
@@ -125,6 +266,9 @@ size_t cbfifo_dequeue(void* buf, size_t nbyte) {
 
 	size_t bytes_dequeued = 0;
 	size_t i;
+#ifdef FIFO_SOJOURN
+	size_t length_before = cbfifo.length;
+#endif
 
 	// Ensure buf is a valid buffer to write to
 	if (buf == NULL) {
@@ -171,6 +315,12 @@ size_t cbfifo_dequeue(void* buf, size_t nbyte) {
 		}
 	}
 
+#ifdef FIFO_SOJOURN
+	if ((cbfifo_sojourn.hist != NULL) && (bytes_dequeued > 0)) {
+		cbfifo_sojourn_dequeued(bytes_dequeued, length_before);
+	}
+#endif
+
 	return (bytes_dequeued);
 }
 
@@ -0,0 +1,364 @@
+/**
+ * \file drrsched.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <stdlib.h>
+#include "drrsched.h"
+#include "ilfifo.h"
+#include "llfifo.h"
+#include "llfifo_ext.h"
+
+#define EXIT_FAILURE_N ((size_t)(-1))
+
+/**
+ * \struct drrsched_flow_s
+ * \brief One attached llfifo. Links onto the scheduler's active list through an embedded ilfifo_link_t, so activating a queue never allocates
+ *
+ * \detail ilfifo_link_t link - Link on the scheduler's active list
+ * \detail llfifo_t* queue - The caller's llfifo. NULL once detached while still on the active list, in which case drrsched_dispatch frees the flow when it reaches it
+ * \detail size_t quantum - Deficit added each time the queue's turn comes around
+ * \detail size_t deficit - Cost the queue may still dispatch this turn, carried over to its next turn if the oldest element costs more than is left
+ * \detail int active - Nonzero while the flow is on the active list or is the scheduler's current flow
+ * \detail drrsched_flow_t* previous - Flow attached before this one, for the list drrsched_destroy walks. If NULL then this is the first
+ * \detail drrsched_flow_t* next - Flow attached after this one. If NULL then this is the last
+ */
+struct drrsched_flow_s {
+	ilfifo_link_t link;
+	llfifo_t* queue;
+	size_t quantum;
+	size_t deficit;
+	int active;
+	drrsched_flow_t* previous;
+	drrsched_flow_t* next;
+};
+
+/**
+ * \struct drrsched_s
+ * \brief Active list + the flow whose turn it is. Flows with empty queues are on neither, so they are never looked at until an enqueue wakes them
+ *
+ * \detail ilfifo_t active - Flows with queued elements waiting for their turn, oldest turn first
+ * \detail drrsched_flow_t* current - Flow whose turn it is, taken off active. If NULL then the next dispatch starts a new turn
+ * \detail drrsched_flow_t* flows - Every attached flow, so drrsched_destroy can free them
+ * \detail drrsched_cost_t cost - What each element costs against its queue's deficit. If NULL every element costs 1
+ * \detail void* ctx - Passed to cost
+ * \detail size_t detached - Flows detached while still on the active list, waiting for drrsched_dispatch to free them
+ */
+struct drrsched_s {
+	ilfifo_t active;
+	drrsched_flow_t* current;
+	drrsched_flow_t* flows;
+	drrsched_cost_t cost;
+	void* ctx;
+	size_t detached;
+};
+
+/**
+ * \fn static void drrsched_activate(drrsched_t* sched, drrsched_flow_t* flow)
+ * \brief Puts a flow at the back of the active list with a fresh deficit, unless it is already active
+ *
+ * \param sched The scheduler in question
+ * \param flow The flow in question
+ *
+ * \return N/A
+ */
+static void drrsched_activate(drrsched_t* sched, drrsched_flow_t* flow) {
+
+	if (flow->active) {
+		return;
+	}
+
+	flow->active = 1;
+	flow->deficit = 0;
+	ilfifo_enqueue(&(sched->active), &(flow->link));
+}
+
+/**
+ * \fn drrsched_t* drrsched_create(drrsched_cost_t cost, void* ctx)
+ * \brief Creates and initializes a scheduler with no flows
+ *
+ * \param cost What each element costs against its queue's deficit. NULL makes every element cost 1, so each queue dispatches up to quantum elements per turn
+ * \param ctx Passed to cost
+ *
+ * \return If successful, returns pointer to a newly-created drrsched_t instance. In the case of an error, the function returns NULL
+ */
+drrsched_t* drrsched_create(drrsched_cost_t cost, void* ctx) {
+
+	drrsched_t* sched;
+
+	sched = (drrsched_t*)malloc(sizeof(drrsched_t));
+	if (sched == NULL) {
+		return NULL;
+	}
+
+	ilfifo_init(&(sched->active));
+	sched->current = NULL;
+	sched->flows = NULL;
+	sched->cost = cost;
+	sched->ctx = ctx;
+	sched->detached = 0;
+
+	return sched;
+}
+
+/**
+ * \fn drrsched_flow_t* drrsched_attach(drrsched_t* sched, llfifo_t* queue, size_t quantum)
+ * \brief Attaches an llfifo to the scheduler. From then on, elements must be added through drrsched_enqueue so the scheduler sees the queue become non-empty. A queue that already holds elements joins the active list straight away
+ *
+ * \param sched The scheduler in question
+ * \param queue The llfifo to attach. Still owned by the caller, and may only be attached to one scheduler at a time
+ * \param quantum Deficit the queue earns each turn, at least 1. When no quantum is smaller than the costliest element, every turn dispatches at least once, which keeps drrsched_dispatch O(1)
+ *
+ * \return If successful, returns the new flow. In the case of an error, the function returns NULL
+ */
+drrsched_flow_t* drrsched_attach(drrsched_t* sched, llfifo_t* queue, size_t quantum) {
+
+	drrsched_flow_t* flow;
+
+	if ((sched == NULL) || (queue == NULL) || (quantum == 0)) {
+		return NULL;
+	}
+
+	flow = (drrsched_flow_t*)malloc(sizeof(drrsched_flow_t));
+	if (flow == NULL) {
+		return NULL;
+	}
+
+	flow->queue = queue;
+	flow->quantum = quantum;
+	flow->deficit = 0;
+	flow->active = 0;
+
+	// Link in as the first attached flow
+	flow->previous = NULL;
+	flow->next = sched->flows;
+	if (sched->flows != NULL) {
+		sched->flows->previous = flow;
+	}
+	sched->flows = flow;
+
+	if (llfifo_length_sz(queue) > 0) {
+		drrsched_activate(sched, flow);
+	}
+
+	return flow;
+}
+
+/**
+ * \fn int drrsched_detach(drrsched_t* sched, drrsched_flow_t* flow)
+ * \brief Detaches a flow, handing its llfifo back to the caller as-is, elements and all. After calling this function, the flow should not be used again!
+ *
+ * \param sched The scheduler in question
+ * \param flow The flow to detach
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int drrsched_detach(drrsched_t* sched, drrsched_flow_t* flow) {
+
+	if ((sched == NULL) || (flow == NULL) || (flow->queue == NULL)) {
+		return EXIT_FAILURE;
+	}
+
+	// Unlink from the list of attached flows
+	if (flow->previous != NULL) {
+		flow->previous->next = flow->next;
+	}
+	else {
+		sched->flows = flow->next;
+	}
+	if (flow->next != NULL) {
+		flow->next->previous = flow->previous;
+	}
+
+	// The current flow isn't on the active list, so it can go now
+	if (flow == sched->current) {
+		sched->current = NULL;
+		free(flow);
+	}
+
+	// ilfifo can't remove from the middle, so an active flow is left for drrsched_dispatch to free when it reaches the front
+	else if (flow->active) {
+		flow->queue = NULL;
+		sched->detached++;
+	}
+
+	else {
+		free(flow);
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn size_t drrsched_enqueue(drrsched_t* sched, drrsched_flow_t* flow, void* element)
+ * \brief Enqueues an element onto a flow's llfifo, putting the flow on the active list if it was idle
+ *
+ * \param sched The scheduler in question
+ * \param flow The flow in question
+ * \param element The element to enqueue, which cannot be NULL
+ *
+ * \return If successful, returns the new length of the flow's llfifo. If the llfifo is bounded and at its limit, returns LLFIFO_FULL_SZ. In the case of an error, the function returns (size_t)(-1)
+ */
+size_t drrsched_enqueue(drrsched_t* sched, drrsched_flow_t* flow, void* element) {
+
+	size_t length;
+
+	if ((sched == NULL) || (flow == NULL) || (flow->queue == NULL)) {
+		return EXIT_FAILURE_N;
+	}
+
+	length = llfifo_enqueue_sz(flow->queue, element);
+	if ((length != EXIT_FAILURE_N) && (length != LLFIFO_FULL_SZ)) {
+		drrsched_activate(sched, flow);
+	}
+
+	return length;
+}
+
+/**
+ * \fn void* drrsched_dispatch(drrsched_t* sched, drrsched_flow_t** flow)
+ * \brief Dequeues the next element in deficit round-robin order. Each turn adds a queue's quantum to its deficit, then the queue dispatches oldest first while its oldest element costs no more than the deficit left. A queue that runs dry leaves the active list with its deficit reset. One that can't afford its oldest element goes to the back, keeping the deficit for next turn. Elements the llfifo discards on the way out (CoDel drops, expired deadlines) are never dispatched
+ *
+ * \param sched The scheduler in question
+ * \param flow If not NULL, set to the flow the element came from
+ *
+ * \return If successful, returns the dispatched element, or NULL if every attached queue is empty
+ */
+void* drrsched_dispatch(drrsched_t* sched, drrsched_flow_t** flow) {
+
+	size_t cost;
+	void* element;
+	void* taken;
+	ilfifo_link_t* link;
+	drrsched_flow_t* turn;
+
+	if (sched == NULL) {
+		return NULL;
+	}
+
+	for (;;) {
+
+		// Start the next queue's turn
+		if (sched->current == NULL) {
+
+			link = ilfifo_dequeue(&(sched->active));
+			if (link == NULL) {
+				return NULL;
+			}
+
+			turn = ILFIFO_ENTRY(link, drrsched_flow_t, link);
+
+			// Detached while waiting for its turn
+			if (turn->queue == NULL) {
+				sched->detached--;
+				free(turn);
+				continue;
+			}
+
+			turn->deficit += turn->quantum;
+			sched->current = turn;
+		}
+
+		turn = sched->current;
+		element = llfifo_peek(turn->queue);
+
+		// Queue was drained behind the scheduler's back, so it drops out like any other empty queue
+		if (element == NULL) {
+			turn->active = 0;
+			turn->deficit = 0;
+			sched->current = NULL;
+			continue;
+		}
+
+		cost = (sched->cost != NULL) ? (sched->cost(element, sched->ctx)) : (1);
+
+		// Not enough deficit left this turn. Go to the back + keep it for next time
+		if (cost > turn->deficit) {
+			ilfifo_enqueue(&(sched->active), &(turn->link));
+			sched->current = NULL;
+			continue;
+		}
+
+		// CoDel or an expired deadline may discard the peeked element (+ more behind it) on the way out, so charge for what actually comes out
+		taken = llfifo_dequeue(turn->queue);
+		if (taken != element) {
+			element = taken;
+			cost = ((element != NULL) && (sched->cost != NULL)) ? (sched->cost(element, sched->ctx)) : (1);
+		}
+
+		// Nothing live was left behind the discarded elements
+		if (element == NULL) {
+			turn->active = 0;
+			turn->deficit = 0;
+			sched->current = NULL;
+			continue;
+		}
+
+		turn->deficit = (cost < turn->deficit) ? (turn->deficit - cost) : (0);
+
+		// An empty queue's unused deficit doesn't carry over, or it could burst after sitting idle
+		if (llfifo_length_sz(turn->queue) == 0) {
+			turn->active = 0;
+			turn->deficit = 0;
+			sched->current = NULL;
+		}
+
+		if (flow != NULL) {
+			*flow = turn;
+		}
+
+		return element;
+	}
+}
+
+/**
+ * \fn size_t drrsched_active(drrsched_t* sched)
+ * \brief Returns the number of attached queues currently holding elements
+ *
+ * \param sched The scheduler in question
+ *
+ * \return The number of active queues, or (size_t)(-1) if sched is NULL
+ */
+size_t drrsched_active(drrsched_t* sched) {
+
+	if (sched == NULL) {
+		return EXIT_FAILURE_N;
+	}
+
+	// Flows detached while still queued for a turn aren't counted
+	return (size_t)(sched->active.length) + ((sched->current != NULL) ? (1) : (0)) - sched->detached;
+}
+
+/**
+ * \fn void drrsched_destroy(drrsched_t* sched)
+ * \brief Teardown function: Frees the scheduler + every flow. Attached llfifo instances are left to the caller. After calling this function, the scheduler should not be used again!
+ *
+ * \param sched The scheduler in question
+ *
+ * \return N/A
+ */
+void drrsched_destroy(drrsched_t* sched) {
+
+	ilfifo_link_t* link;
+	drrsched_flow_t* flow;
+
+	if (sched == NULL) {
+		return;
+	}
+
+	// Detached flows still on the active list are only reachable from there
+	while ((link = ilfifo_dequeue(&(sched->active))) != NULL) {
+		flow = ILFIFO_ENTRY(link, drrsched_flow_t, link);
+		if (flow->queue == NULL) {
+			free(flow);
+		}
+	}
+
+	while (sched->flows != NULL) {
+		flow = sched->flows;
+		sched->flows = flow->next;
+		free(flow);
+	}
+
+	free(sched);
+}
@@ -0,0 +1,687 @@
+/**
+ * \file executor.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include "executor.h"
+#include "llfifo.h"
+#include "llfifo_ext.h"
+#include "nodepool.h"
+#include "wsdeque.h"
+
+#define EXECUTOR_MAX_BATCH (256)
+
+/**
+ * \typedef executor_task_t
+ * \brief Allows struct executor_task_s to be instantiated as executor_task_t
+ */
+typedef struct executor_task_s executor_task_t;
+
+/**
+ * \struct executor_task_s
+ * \brief What actually sits in the queues. Drawn from the executor's nodepool so submitting doesn't call malloc
+ *
+ * \detail executor_fn_t fn - Function to run
+ * \detail void* arg - Argument to run it with
+ * \detail uint64_t submitted_ns - When the task was submitted, for the latency metrics
+ */
+struct executor_task_s {
+	executor_fn_t fn;
+	void* arg;
+	uint64_t submitted_ns;
+};
+
+/**
+ * \typedef executor_worker_t
+ * \brief Allows struct executor_worker_s to be instantiated as executor_worker_t
+ */
+typedef struct executor_worker_s executor_worker_t;
+
+/**
+ * \struct executor_worker_s
+ * \brief One worker thread + its local queue + its metrics. Metrics are only written by the worker itself, and are atomic so executor_stats can read them from any thread
+ *
+ * \detail executor_t* executor - The executor this worker belongs to
+ * \detail int id - Index of this worker
+ * \detail unsigned int seed - State for picking random victims to steal from
+ * \detail pthread_t thread - The worker thread
+ * \detail wsdeque_t* local - Tasks submitted by tasks running on this worker. Popped newest first by this worker, stolen oldest first by the others
+ * \detail _Atomic(uint64_t) executed - Tasks run
+ * \detail _Atomic(uint64_t) stolen - Tasks run that were stolen from another worker
+ * \detail _Atomic(size_t) local_depth_max - Most tasks ever seen in local
+ * \detail _Atomic(uint64_t) latency_total_ns - Sum of submit-to-start times
+ * \detail _Atomic(uint64_t) latency_max_ns - Longest submit-to-start time
+ */
+struct executor_worker_s {
+	_Alignas(64) executor_t* executor;
+	int id;
+	unsigned int seed;
+	pthread_t thread;
+	wsdeque_t* local;
+	_Atomic(uint64_t) executed;
+	_Atomic(uint64_t) stolen;
+	_Atomic(size_t) local_depth_max;
+	_Atomic(uint64_t) latency_total_ns;
+	_Atomic(uint64_t) latency_max_ns;
+};
+
+/**
+ * \struct executor_s
+ * \brief The whole pool
+ *
+ * \detail int workers - Number of worker threads
+ * \detail int started - Number of worker threads actually started, so a failed create or a second shutdown only joins those
+ * \detail executor_worker_t* worker - Array of workers
+ * \detail llfifo_t* injection - Synchronized llfifo every submit from outside the pool goes through
+ * \detail nodepool_t* tasks - Pool the executor_task_t objects come from
+ * \detail _Atomic(size_t) pending - Tasks submitted but not finished yet, including running ones. Shutdown drains until this hits 0
+ * \detail atomic_int closing - Set by executor_shutdown. Workers exit once it is set and pending is 0
+ * \detail atomic_int idle - Workers parked (or about to park) on idle_cond. Lets submitters skip idle_lock when nobody is asleep
+ * \detail pthread_mutex_t idle_lock - Protects the last look for work before a worker parks against the wakeup that would have woken it
+ * \detail pthread_cond_t idle_cond - Idle workers park here. Signaled for new work on any queue, and broadcast once a closing executor has drained
+ */
+struct executor_s {
+	int workers;
+	int started;
+	executor_worker_t* worker;
+	llfifo_t* injection;
+	nodepool_t* tasks;
+	_Atomic(size_t) pending;
+	atomic_int closing;
+	atomic_int idle;
+	pthread_mutex_t idle_lock;
+	pthread_cond_t idle_cond;
+};
+
+/**
+ * \var static _Thread_local executor_worker_t* executor_current
+ * \brief Worker running on this thread, or NULL on threads outside any executor. Lets submits from inside a task go to the local queue
+ */
+static _Thread_local executor_worker_t* executor_current;
+
+/**
+ * \fn static uint64_t executor_now_ns()
+ * \brief Returns a monotonic timestamp in nanoseconds
+ *
+ * \return Nanoseconds since an arbitrary fixed point
+ */
+static uint64_t executor_now_ns() {
+
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t)(now.tv_sec) * 1000000000ull) + (uint64_t)(now.tv_nsec);
+}
+
+/**
+ * \fn static void executor_wake(executor_t* executor, int all)
+ * \brief Wakes one parked worker, or all of them. Callers must have made the work (or the drained state) visible first. The fence pairs with the one in executor_park: either the worker's last look sees the work, or this sees the worker in idle
+ *
+ * \param executor The executor in question
+ * \param all 0 to wake one worker, anything else to wake every worker
+ *
+ * \return N/A
+ */
+static void executor_wake(executor_t* executor, int all) {
+
+	atomic_thread_fence(memory_order_seq_cst);
+	if (atomic_load_explicit(&(executor->idle), memory_order_relaxed) == 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&(executor->idle_lock));
+	if (all) {
+		pthread_cond_broadcast(&(executor->idle_cond));
+	}
+	else {
+		pthread_cond_signal(&(executor->idle_cond));
+	}
+	pthread_mutex_unlock(&(executor->idle_lock));
+}
+
+/**
+ * \fn static int executor_has_work(executor_t* executor)
+ * \brief Last look before parking: is there a task on any queue, or has a closing executor drained?
+ *
+ * \param executor The executor in question
+ *
+ * \return 1 if the caller should go around again instead of parking, 0 otherwise
+ */
+static int executor_has_work(executor_t* executor) {
+
+	int i;
+
+	if (atomic_load_explicit(&(executor->closing), memory_order_acquire) && (atomic_load_explicit(&(executor->pending), memory_order_acquire) == 0)) {
+		return 1;
+	}
+
+	if (llfifo_length(executor->injection) > 0) {
+		return 1;
+	}
+
+	for (i = 0; i < executor->workers; i++) {
+		if (wsdeque_length(executor->worker[i].local) > 0) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * \fn static void executor_park(executor_t* executor)
+ * \brief Puts an idle worker to sleep on idle_cond until executor_wake. Announces itself in idle before the last look for work, so a task published in between is either seen here or followed by a wakeup
+ *
+ * \param executor The executor in question
+ *
+ * \return N/A
+ */
+static void executor_park(executor_t* executor) {
+
+	pthread_mutex_lock(&(executor->idle_lock));
+
+	atomic_fetch_add_explicit(&(executor->idle), 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+
+	if (executor_has_work(executor) == 0) {
+		pthread_cond_wait(&(executor->idle_cond), &(executor->idle_lock));
+	}
+
+	atomic_fetch_sub_explicit(&(executor->idle), 1, memory_order_relaxed);
+
+	pthread_mutex_unlock(&(executor->idle_lock));
+}
+
+/**
+ * \fn static void executor_unpend(executor_t* executor, size_t n)
+ * \brief Takes n tasks off pending, whether they finished or were never queued after all. Whoever takes a closing executor's pending to 0 wakes every parked worker, since nothing else will
+ *
+ * \param executor The executor in question
+ * \param n Number of tasks
+ *
+ * \return N/A
+ */
+static void executor_unpend(executor_t* executor, size_t n) {
+
+	// Release so whoever sees pending hit 0 also sees everything the tasks did
+	if ((atomic_fetch_sub_explicit(&(executor->pending), n, memory_order_acq_rel) == n) && atomic_load_explicit(&(executor->closing), memory_order_acquire)) {
+		executor_wake(executor, 1);
+	}
+}
+
+/**
+ * \fn static executor_task_t* executor_task_new(executor_t* executor, executor_fn_t fn, void* arg, uint64_t now_ns)
+ * \brief Takes a task object from the pool and fills it in
+ *
+ * \param executor The executor in question
+ * \param fn Function to run
+ * \param arg Argument to run it with
+ * \param now_ns Submit timestamp
+ *
+ * \return The task, or NULL if the pool couldn't grow
+ */
+static executor_task_t* executor_task_new(executor_t* executor, executor_fn_t fn, void* arg, uint64_t now_ns) {
+
+	executor_task_t* task;
+
+	task = (executor_task_t*)nodepool_get(executor->tasks);
+	if (task == NULL) {
+		return NULL;
+	}
+
+	task->fn = fn;
+	task->arg = arg;
+	task->submitted_ns = now_ns;
+
+	return task;
+}
+
+/**
+ * \fn static int executor_push_local(executor_worker_t* self, executor_task_t* task)
+ * \brief Pushes a task onto the calling worker's own local queue
+ *
+ * \param self The calling worker
+ * \param task The task
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+static int executor_push_local(executor_worker_t* self, executor_task_t* task) {
+
+	size_t depth;
+
+	depth = wsdeque_push(self->local, task);
+	if (depth == (size_t)(-1)) {
+		return EXIT_FAILURE;
+	}
+
+	if (depth > atomic_load_explicit(&(self->local_depth_max), memory_order_relaxed)) {
+		atomic_store_explicit(&(self->local_depth_max), depth, memory_order_relaxed);
+	}
+
+	// A parked worker would otherwise only find this once something else woke it
+	executor_wake(self->executor, 0);
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn static executor_task_t* executor_steal(executor_worker_t* self)
+ * \brief Tries every other worker's local queue once, starting from a random one
+ *
+ * \param self The stealing worker
+ *
+ * \return A stolen task, or NULL if every queue came back empty
+ */
+static executor_task_t* executor_steal(executor_worker_t* self) {
+
+	int i;
+	int victim;
+	executor_t* executor = self->executor;
+	executor_task_t* task;
+
+	if (executor->workers < 2) {
+		return NULL;
+	}
+
+	victim = (int)(rand_r(&(self->seed)) % (unsigned int)(executor->workers));
+	for (i = 0; i < executor->workers; i++, victim = (victim + 1) % executor->workers) {
+
+		if (victim == self->id) {
+			continue;
+		}
+
+		task = (executor_task_t*)wsdeque_steal(executor->worker[victim].local);
+		if (task != NULL) {
+			atomic_fetch_add_explicit(&(self->stolen), 1, memory_order_relaxed);
+			return task;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \fn static void executor_run(executor_worker_t* self, executor_task_t* task)
+ * \brief Runs a task, records its metrics, and recycles the task object
+ *
+ * \param self The worker running the task
+ * \param task The task
+ *
+ * \return N/A
+ */
+static void executor_run(executor_worker_t* self, executor_task_t* task) {
+
+	uint64_t latency_ns;
+	executor_fn_t fn;
+	void* arg;
+
+	latency_ns = executor_now_ns() - task->submitted_ns;
+	fn = task->fn;
+	arg = task->arg;
+
+	// Recycle before running so a task that submits more can reuse it straight away
+	nodepool_put(self->executor->tasks, task);
+
+	atomic_fetch_add_explicit(&(self->latency_total_ns), latency_ns, memory_order_relaxed);
+	if (latency_ns > atomic_load_explicit(&(self->latency_max_ns), memory_order_relaxed)) {
+		atomic_store_explicit(&(self->latency_max_ns), latency_ns, memory_order_relaxed);
+	}
+
+	fn(arg);
+
+	atomic_fetch_add_explicit(&(self->executed), 1, memory_order_relaxed);
+
+	executor_unpend(self->executor, 1);
+}
+
+/**
+ * \fn static void* executor_worker_main(void* arg)
+ * \brief Worker thread body. Looks for work in order of cheapest first: own local queue, injection queue, other workers' local queues. Parks on idle_cond when there is none. Exits once shutdown has started and every task has finished
+ *
+ * \param arg The executor_worker_t for this thread
+ *
+ * \return NULL
+ */
+static void* executor_worker_main(void* arg) {
+
+	executor_worker_t* self = (executor_worker_t*)arg;
+	executor_t* executor = self->executor;
+	executor_task_t* task;
+
+	executor_current = self;
+
+	while (1) {
+
+		task = (executor_task_t*)wsdeque_pop(self->local);
+
+		if (task == NULL) {
+			task = (executor_task_t*)llfifo_dequeue(executor->injection);
+		}
+
+		if (task == NULL) {
+			task = executor_steal(self);
+		}
+
+		if (task == NULL) {
+
+			if (atomic_load_explicit(&(executor->closing), memory_order_acquire) && (atomic_load_explicit(&(executor->pending), memory_order_acquire) == 0)) {
+				break;
+			}
+
+			executor_park(executor);
+			continue;
+		}
+
+		executor_run(self, task);
+	}
+
+	executor_current = NULL;
+
+	return NULL;
+}
+
+/**
+ * \fn executor_t* executor_create(int workers)
+ * \brief Creates the executor and starts its worker threads
+ *
+ * \param workers Number of worker threads, at least 1
+ *
+ * \return If successful, returns pointer to a newly-created executor_t instance. In the case of an error, the function returns NULL
+ */
+executor_t* executor_create(int workers) {
+
+	int i;
+	executor_t* executor;
+
+	if (workers < 1) {
+		return NULL;
+	}
+
+	executor = (executor_t*)calloc(1, sizeof(executor_t));
+	if (executor == NULL) {
+		return NULL;
+	}
+
+	executor->workers = workers;
+	executor->started = 0;
+	atomic_init(&(executor->pending), 0);
+	atomic_init(&(executor->closing), 0);
+	atomic_init(&(executor->idle), 0);
+
+	if (pthread_mutex_init(&(executor->idle_lock), NULL) != 0) {
+		free(executor);
+		return NULL;
+	}
+
+	if (pthread_cond_init(&(executor->idle_cond), NULL) != 0) {
+		pthread_mutex_destroy(&(executor->idle_lock));
+		free(executor);
+		return NULL;
+	}
+
+	executor->worker = (executor_worker_t*)aligned_alloc(64, sizeof(executor_worker_t) * (size_t)(workers));
+	if (executor->worker == NULL) {
+		pthread_cond_destroy(&(executor->idle_cond));
+		pthread_mutex_destroy(&(executor->idle_lock));
+		free(executor);
+		return NULL;
+	}
+
+	for (i = 0; i < workers; i++) {
+		executor->worker[i].executor = executor;
+		executor->worker[i].id = i;
+		executor->worker[i].seed = (unsigned int)(i + 1);
+		executor->worker[i].local = wsdeque_create(0);
+		atomic_init(&(executor->worker[i].executed), 0);
+		atomic_init(&(executor->worker[i].stolen), 0);
+		atomic_init(&(executor->worker[i].local_depth_max), 0);
+		atomic_init(&(executor->worker[i].latency_total_ns), 0);
+		atomic_init(&(executor->worker[i].latency_max_ns), 0);
+	}
+
+	executor->injection = llfifo_create(0);
+	executor->tasks = nodepool_create(sizeof(executor_task_t), 0);
+	if ((executor->injection == NULL) || (executor->tasks == NULL) || (llfifo_enable_sync(executor->injection) != EXIT_SUCCESS)) {
+		executor_destroy(executor);
+		return NULL;
+	}
+
+	// Every local queue has to exist before any worker starts stealing from it
+	for (i = 0; i < workers; i++) {
+		if (executor->worker[i].local == NULL) {
+			executor_destroy(executor);
+			return NULL;
+		}
+	}
+
+	for (i = 0; i < workers; i++) {
+		if (pthread_create(&(executor->worker[i].thread), NULL, executor_worker_main, &(executor->worker[i])) != 0) {
+			executor_destroy(executor);
+			return NULL;
+		}
+		executor->started++;
+	}
+
+	return executor;
+}
+
+/**
+ * \fn int executor_submit(executor_t* executor, executor_fn_t fn, void* arg)
+ * \brief Submits a task. From inside a task running on this executor it goes to the worker's local queue, otherwise to the injection queue
+ *
+ * \param executor The executor in question
+ * \param fn Function to run, which cannot be NULL
+ * \param arg Argument to run it with, which may be NULL
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). If the executor is shutting down (and the caller isn't one of its tasks), or in the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int executor_submit(executor_t* executor, executor_fn_t fn, void* arg) {
+
+	return executor_submit_batch(executor, fn, &arg, 1);
+}
+
+/**
+ * \fn int executor_submit_batch(executor_t* executor, executor_fn_t fn, void** args, int n)
+ * \brief Submits n tasks that run the same function on different arguments. From outside the executor they go to the injection queue with one llfifo_enqueue_batch per EXECUTOR_MAX_BATCH tasks, so the queue lock is taken + idle workers are woken once per chunk instead of once per task
+ *
+ * \param executor The executor in question
+ * \param fn Function to run, which cannot be NULL
+ * \param args Array of n arguments, each of which may be NULL
+ * \param n Number of tasks
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, no further tasks are submitted and the function returns EXIT_FAILURE (1). Tasks from chunks already submitted still run
+ */
+int executor_submit_batch(executor_t* executor, executor_fn_t fn, void** args, int n) {
+
+	int i;
+	int chunk;
+	int done;
+	uint64_t now_ns;
+	executor_worker_t* self;
+	executor_task_t* tasks[EXECUTOR_MAX_BATCH];
+
+	if ((executor == NULL) || (fn == NULL) || (args == NULL) || (n < 0)) {
+		return EXIT_FAILURE;
+	}
+
+	now_ns = executor_now_ns();
+	self = ((executor_current != NULL) && (executor_current->executor == executor)) ? (executor_current) : (NULL);
+
+	for (done = 0; done < n; done += chunk) {
+
+		chunk = ((n - done) > EXECUTOR_MAX_BATCH) ? (EXECUTOR_MAX_BATCH) : (n - done);
+
+		for (i = 0; i < chunk; i++) {
+			tasks[i] = executor_task_new(executor, fn, args[done + i], now_ns);
+			if (tasks[i] == NULL) {
+				while (i-- > 0) {
+					nodepool_put(executor->tasks, tasks[i]);
+				}
+				return EXIT_FAILURE;
+			}
+		}
+
+		// Count tasks as pending before any worker can finish them
+		atomic_fetch_add_explicit(&(executor->pending), (size_t)(chunk), memory_order_relaxed);
+
+		// Tasks spawned by a task stay on that worker, where they are cheapest to run + easiest to steal
+		if (self != NULL) {
+			for (i = 0; i < chunk; i++) {
+				if (executor_push_local(self, tasks[i]) != EXIT_SUCCESS) {
+					executor_unpend(executor, (size_t)(chunk - i));
+					while (i < chunk) {
+						nodepool_put(executor->tasks, tasks[i++]);
+					}
+					return EXIT_FAILURE;
+				}
+			}
+		}
+
+		// Injection queue refuses everything once it is closed, so submits racing shutdown fail cleanly. Workers may have parked again through shutdown's wakeup while these counted as pending, so executor_unpend wakes them if the rollback drains the executor
+		else if (llfifo_enqueue_batch(executor->injection, (void**)(tasks), chunk) < 0) {
+			for (i = 0; i < chunk; i++) {
+				nodepool_put(executor->tasks, tasks[i]);
+			}
+			executor_unpend(executor, (size_t)(chunk));
+			return EXIT_FAILURE;
+		}
+
+		else {
+			executor_wake(executor, (chunk > 1));
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn size_t executor_pending(executor_t* executor)
+ * \brief Returns how many tasks have been submitted but not finished, across every queue plus the ones running right now
+ *
+ * \param executor The executor in question
+ *
+ * \return Returns the number of unfinished tasks, or (size_t)(-1) if executor is NULL
+ */
+size_t executor_pending(executor_t* executor) {
+
+	if (executor == NULL) {
+		return (size_t)(-1);
+	}
+
+	return atomic_load_explicit(&(executor->pending), memory_order_acquire);
+}
+
+/**
+ * \fn int executor_workers(executor_t* executor)
+ * \brief Returns the number of worker threads
+ *
+ * \param executor The executor in question
+ *
+ * \return Returns the number of workers, or -1 if executor is NULL
+ */
+int executor_workers(executor_t* executor) {
+
+	if (executor == NULL) {
+		return -1;
+	}
+
+	return executor->workers;
+}
+
+/**
+ * \fn int executor_stats(executor_t* executor, int worker, executor_stats_t* stats)
+ * \brief Takes a snapshot of one worker's metrics. Safe to call from any thread at any time
+ *
+ * \param executor The executor in question
+ * \param worker Index of the worker, from 0 to executor_workers() - 1
+ * \param stats Filled in with the snapshot
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int executor_stats(executor_t* executor, int worker, executor_stats_t* stats) {
+
+	executor_worker_t* w;
+
+	if ((executor == NULL) || (stats == NULL) || (worker < 0) || (worker >= executor->workers)) {
+		return EXIT_FAILURE;
+	}
+
+	w = &(executor->worker[worker]);
+
+	stats->executed = atomic_load_explicit(&(w->executed), memory_order_relaxed);
+	stats->stolen = atomic_load_explicit(&(w->stolen), memory_order_relaxed);
+	stats->local_depth = wsdeque_length(w->local);
+	stats->local_depth_max = atomic_load_explicit(&(w->local_depth_max), memory_order_relaxed);
+	stats->latency_avg_ns = (stats->executed > 0) ? (atomic_load_explicit(&(w->latency_total_ns), memory_order_relaxed) / stats->executed) : (0);
+	stats->latency_max_ns = atomic_load_explicit(&(w->latency_max_ns), memory_order_relaxed);
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn void executor_shutdown(executor_t* executor)
+ * \brief Graceful drain: stops accepting tasks from outside, lets the workers finish everything already submitted (including tasks those tasks submit), then joins the workers. Must not be called from one of the executor's own tasks. Calling it again does nothing
+ *
+ * \param executor The executor in question
+ *
+ * \return N/A
+ */
+void executor_shutdown(executor_t* executor) {
+
+	int i;
+
+	if (executor == NULL) {
+		return;
+	}
+
+	atomic_store_explicit(&(executor->closing), 1, memory_order_release);
+	if (executor->injection != NULL) {
+		llfifo_close(executor->injection);
+	}
+
+	// Workers parked on an already drained executor have nothing left to wake them
+	executor_wake(executor, 1);
+
+	for (i = 0; i < executor->started; i++) {
+		pthread_join(executor->worker[i].thread, NULL);
+	}
+	executor->started = 0;
+}
+
+/**
+ * \fn void executor_destroy(executor_t* executor)
+ * \brief Teardown function: drains + joins via executor_shutdown if that hasn't happened yet, then frees everything. After calling this function, the executor should not be used again!
+ *
+ * \param executor The executor in question
+ *
+ * \return N/A
+ */
+void executor_destroy(executor_t* executor) {
+
+	int i;
+
+	if (executor == NULL) {
+		return;
+	}
+
+	executor_shutdown(executor);
+
+	if (executor->worker != NULL) {
+		for (i = 0; i < executor->workers; i++) {
+			wsdeque_destroy(executor->worker[i].local);
+		}
+		free(executor->worker);
+	}
+
+	llfifo_destroy(executor->injection);
+	nodepool_destroy(executor->tasks);
+	pthread_cond_destroy(&(executor->idle_cond));
+	pthread_mutex_destroy(&(executor->idle_lock));
+	free(executor);
+}
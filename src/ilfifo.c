@@ -0,0 +1,121 @@
+/**
+ * \file ilfifo.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <stdlib.h>
+#include "ilfifo.h"
+
+#define EXIT_FAILURE_N ((int)(-1))
+
+/**
+ * \fn void ilfifo_init(ilfifo_t* fifo)
+ * \brief Initializes a caller-owned intrusive FIFO to be empty. No memory is allocated
+ *
+ * \param fifo The fifo in question
+ *
+ * \return N/A
+ */
+void ilfifo_init(ilfifo_t* fifo) {
+
+	if (fifo == NULL) {
+		return;
+	}
+
+	fifo->head = NULL;
+	fifo->tail = NULL;
+	fifo->length = 0;
+}
+
+/**
+ * \fn int ilfifo_enqueue(ilfifo_t* fifo, ilfifo_link_t* link)
+ * \brief Enqueues the caller's struct (via the link embedded in it) onto the FIFO. A link may only be on one FIFO at a time
+ *
+ * \param fifo The fifo in question
+ * \param link The link to enqueue, which cannot be NULL
+ *
+ * \return If successful, returns the new length of the FIFO. In the case of an error, the function returns -1
+ */
+int ilfifo_enqueue(ilfifo_t* fifo, ilfifo_link_t* link) {
+
+	// Ensure the fifo to enqueue to is valid
+	if (fifo == NULL) {
+		return EXIT_FAILURE_N;
+	}
+
+	// Ensure the link to enqueue is valid
+	if (link == NULL) {
+		return EXIT_FAILURE_N;
+	}
+
+	link->next = NULL;
+
+	// Special case of inserting into empty FIFO
+	if (fifo->length == 0) {
+		fifo->tail = link;
+	}
+
+	// Generic case of inserting into FIFO containing at least 1 link
+	else {
+		fifo->head->next = link;
+	}
+
+	fifo->head = link;
+	fifo->length++;
+
+	return fifo->length;
+}
+
+/**
+ * \fn ilfifo_link_t* ilfifo_dequeue(ilfifo_t* fifo)
+ * \brief Removes ("dequeues") the oldest link from the FIFO, and returns it. Use ILFIFO_ENTRY to get back to the caller's struct
+ *
+ * \param fifo The fifo in question
+ *
+ * \return If successful, returns the dequeued link, or NULL if the FIFO was empty
+ */
+ilfifo_link_t* ilfifo_dequeue(ilfifo_t* fifo) {
+
+	ilfifo_link_t* link;
+
+	// Ensure the fifo to dequeue from is valid
+	if (fifo == NULL) {
+		return NULL;
+	}
+
+	// Ensure at least 1 link exists in FIFO to dequeue
+	if (fifo->length == 0) {
+		return NULL;
+	}
+
+	link = fifo->tail;
+	fifo->tail = link->next;
+
+	// Special case of FIFO becoming empty after grabbing this link
+	if (fifo->tail == NULL) {
+		fifo->head = NULL;
+	}
+
+	link->next = NULL;
+	fifo->length--;
+
+	return link;
+}
+
+/**
+ * \fn int ilfifo_length(ilfifo_t* fifo)
+ * \brief Returns the number of links currently on the FIFO.
+ *
+ * \param fifo The fifo in question
+ *
+ * \return Returns the number of links currently on the FIFO, or -1 if fifo is NULL
+ */
+int ilfifo_length(ilfifo_t* fifo) {
+
+	if (fifo != NULL) {
+		return fifo->length;
+	}
+	else {
+		return EXIT_FAILURE_N;
+	}
+}
@@ -4,11 +4,24 @@
  */
 
 #include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "fifo_allocator.h"
 #include "llfifo.h"
+#include "llfifo_ext.h"
+#include "nodepool.h"
+#include "sojourn.h"
 
 #define EXIT_FAILURE_N ((int)(-1))
+#define EXIT_FAILURE_SZ ((size_t)(-1))
+
+#define LLFIFO_SYNC_SPINS (100)
+#define LLFIFO_GROW_MAX ((size_t)(4096))
 
 /**
  * \typedef llnode_t
@@ -23,11 +36,53 @@ typedef struct llnode_s llnode_t;
  * \detail void* data - Points to data
  * \detail llnode_t* - previous Points to node before in the linked list (towards the tail). If NULL then the node is the tail
  * \detail llnode_t* - next Points to node next in the linked list (towards the head). If NULL then the node is the head
+ * \detail uint64_t enqueued_ns - FIFO_SOJOURN + FIFO_CODEL builds only. sojourn_now_ns() when data was enqueued, or 0 if neither a histogram nor CoDel was on at the time
+ * \detail uint64_t deadline_ns - FIFO_DEADLINE builds only. sojourn_now_ns() time after which data is no longer worth handing out, set by llfifo_enqueue_deadline. 0 means no deadline
  */
 struct llnode_s {
 	void* data;
 	llnode_t* previous;
 	llnode_t* next;
+#ifdef LLFIFO_STAMPED
+	uint64_t enqueued_ns;
+#endif
+#ifdef FIFO_DEADLINE
+	uint64_t deadline_ns;
+#endif
+};
+
+/**
+ * \typedef llfifo_sync_t
+ * \brief Allows struct llfifo_sync_s to be instantiated as llfifo_sync_t
+ */
+typedef struct llfifo_sync_s llfifo_sync_t;
+
+#ifdef FIFO_CODEL
+/**
+ * \typedef llfifo_codel_t
+ * \brief Allows struct llfifo_codel_s to be instantiated as llfifo_codel_t
+ */
+typedef struct llfifo_codel_s llfifo_codel_t;
+#endif
+
+/**
+ * \typedef llblock_t
+ * \brief Allows struct llblock_s to be instantiated as llblock_t
+ */
+typedef struct llblock_s llblock_t;
+
+/**
+ * \struct llblock_s
+ * \brief Nodes are allocated in contiguous blocks rather than one malloc per node. Every node in the FIFO lives in exactly one block
+ *
+ * \detail llblock_t* next - Points to the next block owned by the same FIFO. If NULL then this is the last block
+ * \detail size_t count - The number of nodes in this block
+ * \detail llnode_t nodes[] - The nodes themselves, laid out back to back
+ */
+struct llblock_s {
+	llblock_t* next;
+	size_t count;
+	llnode_t nodes[];
 };
 
 /**
@@ -38,377 +93,2708 @@ struct llnode_s {
   * \detail llnode_t* tail_free - Points to tail node of free list. If NULL then the list of free nodes is empty
   * \detail llnode_t* head_used - Points to head node of used list. If NULL then the list of used nodes is empty
   * \detail llnode_t* tail_used - Points to tail node of used list. If NULL then the list of used nodes is empty
-  * \detail int capacity - The total number of nodes between both free list + used list that memory has been allocated for
-  * \detail int length - The number of nodes currently in the used list
+  * \detail size_t capacity - The total number of nodes between both free list + used list that memory has been allocated for. size_t so queues past INT_MAX elements work
+  * \detail size_t length - The number of nodes currently in the used list
+  * \detail llblock_t* blocks - Points to the most recently allocated block of nodes. Blocks are what actually get freed on destroy
+  * \detail llblock_t* blocks_last - Points to the oldest block, the end of the chain starting at blocks, so llfifo_splice can hand the whole chain to another FIFO without walking it. If NULL then the FIFO owns no blocks
+  * \detail nodepool_t* pool - Shared pool that nodes are drawn from + returned to. If NULL then the FIFO owns its nodes. If not NULL then the free list + blocks are always empty and capacity always equals length
+  * \detail fifo_allocator_t allocator - Where the FIFO itself + its blocks come from. llfifo_create uses malloc/free
+  * \detail llfifo_sync_t* sync - Lock + wakeup state set up by llfifo_enable_sync. If NULL then the FIFO is not thread-safe and every call runs unlocked
+  * \detail size_t limit - Most elements the FIFO may hold, set by llfifo_set_limit. Once length reaches it, enqueues report LLFIFO_FULL instead of allocating. If 0 then the FIFO is unbounded
+  * \detail sojourn_hist_t* sojourn - FIFO_SOJOURN builds only. Histogram that dequeues record each element's wait into, set by llfifo_set_sojourn. If NULL then nothing is stamped or recorded
+  * \detail llfifo_codel_t* codel - FIFO_CODEL builds only. CoDel state set up by llfifo_set_codel. If NULL then dequeues never drop
+  * \detail llfifo_drop_t reject - FIFO_DEADLINE builds only. Called with each element discarded for missing its deadline, set by llfifo_set_reject. May be NULL
+  * \detail void* reject_ctx - FIFO_DEADLINE builds only. Passed to reject
+  * \detail uint64_t tagged - FIFO_DEADLINE builds only. Elements enqueued with a deadline
+  * \detail uint64_t expired - FIFO_DEADLINE builds only. Elements discarded at dequeue because their deadline had passed
  */
 struct llfifo_s {
 	llnode_t* head_free;
 	llnode_t* tail_free;
 	llnode_t* head_used;
 	llnode_t* tail_used;
-	int capacity;
-	int length;
+	size_t capacity;
+	size_t length;
+	llblock_t* blocks;
+	llblock_t* blocks_last;
+	nodepool_t* pool;
+	fifo_allocator_t allocator;
+	llfifo_sync_t* sync;
+	size_t limit;
+#ifdef FIFO_SOJOURN
+	sojourn_hist_t* sojourn;
+#endif
+#ifdef FIFO_CODEL
+	llfifo_codel_t* codel;
+#endif
+#ifdef FIFO_DEADLINE
+	llfifo_drop_t reject;
+	void* reject_ctx;
+	uint64_t tagged;
+	uint64_t expired;
+#endif
 };
 
- /**
-  * \fn llfifo_t* llfifo_create(int capacity)
-  * \brief Creates and initializes the FIFO
-  *
-  * \param capacity Initial size of the FIFO, in number of elements. Valid values are in the range of 0 to the limits of memory
-  *
-  * \return If successful, returns pointer to a newly-created llfifo_t instance. In the case of an error, the function returns NULL
-  */
-llfifo_t* llfifo_create(int capacity) {
+/**
+ * \struct llfifo_sync_s
+ * \brief Everything a synchronized FIFO needs beyond the lists themselves. Every public llfifo call takes mutex for its whole duration
+ *
+ * \detail pthread_mutex_t mutex - Protects the whole llfifo_t, including waiters + closed
+ * \detail pthread_cond_t not_empty - Consumers in llfifo_dequeue_wait park here. Uses CLOCK_MONOTONIC so timeouts ignore wall clock changes
+ * \detail pthread_cond_t not_full - Producers in llfifo_enqueue_wait park here while a bounded FIFO is at its limit. Also CLOCK_MONOTONIC
+ * \detail int waiters - Number of consumers currently parked on not_empty. Producers only signal when this is nonzero
+ * \detail int full_waiters - Number of producers currently parked on not_full. Consumers only signal when this is nonzero
+ * \detail int closed - Nonzero once llfifo_close has been called
+ * \detail int spins - How many times a waiter re-checks the FIFO before parking. 0 on single CPU machines, where the other side can't run while we spin
+ */
+struct llfifo_sync_s {
+	pthread_mutex_t mutex;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+	int waiters;
+	int full_waiters;
+	int closed;
+	int spins;
+};
 
-	int i;
-	llfifo_t* fifo;
-	llnode_t* new_free_node;
+#ifdef FIFO_CODEL
+/**
+ * \struct llfifo_codel_s
+ * \brief CoDel (RFC 8289) state. Variable names follow the RFC's reference code
+ *
+ * \detail uint64_t target_ns - Sojourn time the queue is allowed to settle at
+ * \detail uint64_t interval_ns - How long sojourn times must stay above target_ns before dropping starts. Should be about one worst-case consumer round trip
+ * \detail llfifo_drop_t drop - Called with each dropped element, so the caller can free it or fail it back to whoever sent it. May be NULL
+ * \detail void* ctx - Passed to drop
+ * \detail uint64_t first_above_ns - When sojourn times will have been above target_ns for a whole interval, or 0 if the last one was below it
+ * \detail uint64_t drop_next_ns - When the next drop is due while dropping
+ * \detail uint64_t count - Drops since entering the dropping state. The gap between drops shrinks as interval_ns / sqrt(count)
+ * \detail uint64_t lastcount - count when the dropping state was last left, so re-entering soon after resumes near the old drop rate
+ * \detail int dropping - Nonzero while in the dropping state
+ * \detail size_t dropped - Total elements dropped, for llfifo_codel_dropped
+ */
+struct llfifo_codel_s {
+	uint64_t target_ns;
+	uint64_t interval_ns;
+	llfifo_drop_t drop;
+	void* ctx;
+	uint64_t first_above_ns;
+	uint64_t drop_next_ns;
+	uint64_t count;
+	uint64_t lastcount;
+	int dropping;
+	size_t dropped;
+};
+#endif
 
-	// Ensure amount of free nodes to allocate space for is valid
-	if (capacity < 0) {
-		return NULL;
+/**
+ * \fn static void* llfifo_malloc(void* ctx, size_t size)
+ * \brief Default allocator hook, backed by malloc
+ *
+ * \param ctx Unused
+ * \param size Number of bytes to allocate
+ *
+ * \return Pointer to the allocated memory, or NULL on failure
+ */
+static void* llfifo_malloc(void* ctx, size_t size) {
+
+	(void)(ctx);
+
+	return malloc(size);
+}
+
+/**
+ * \fn static void llfifo_free(void* ctx, void* ptr, size_t size)
+ * \brief Default free hook, backed by free
+ *
+ * \param ctx Unused
+ * \param ptr Memory to release
+ * \param size Unused
+ *
+ * \return N/A
+ */
+static void llfifo_free(void* ctx, void* ptr, size_t size) {
+
+	(void)(ctx);
+	(void)(size);
+
+	free(ptr);
+}
+
+/**
+ * \var static const fifo_allocator_t llfifo_default_allocator
+ * \brief Allocator used by every create function that doesn't take one
+ */
+static const fifo_allocator_t llfifo_default_allocator = { llfifo_malloc, llfifo_free, NULL };
+
+/**
+ * \fn static void llfifo_release(llfifo_t* fifo, void* ptr, size_t size)
+ * \brief Hands memory back to the FIFO's allocator. Arena allocators may have no free hook, in which case this does nothing
+ *
+ * \param fifo The fifo whose allocator returned ptr
+ * \param ptr Memory to release
+ * \param size Number of bytes that were allocated for ptr
+ *
+ * \return N/A
+ */
+static void llfifo_release(llfifo_t* fifo, void* ptr, size_t size) {
+
+	if (fifo->allocator.free != NULL) {
+		fifo->allocator.free(fifo->allocator.ctx, ptr, size);
 	}
+}
 
-	// Ensure malloc is successful for a new FIFO list
-	fifo = (llfifo_t*)malloc(sizeof(llfifo_t));
-	if (fifo == NULL) {
-		return NULL;
+/**
+ * \fn static void llfifo_lock(llfifo_t* fifo)
+ * \brief Takes the FIFO's lock if it is in synchronized mode, otherwise does nothing
+ *
+ * \param fifo The fifo in question, which cannot be NULL
+ *
+ * \return N/A
+ */
+static void llfifo_lock(llfifo_t* fifo) {
+
+	if (fifo->sync != NULL) {
+		pthread_mutex_lock(&(fifo->sync->mutex));
 	}
+}
 
-	// Initialize FIFO for size 0
-	fifo->head_free = NULL;
-	fifo->tail_free = NULL;
-	fifo->head_used = NULL;
-	fifo->tail_used = NULL;
-	fifo->capacity = 0;
-	fifo->length = 0;
+/**
+ * \fn static void llfifo_unlock(llfifo_t* fifo)
+ * \brief Releases the FIFO's lock if it is in synchronized mode, otherwise does nothing
+ *
+ * \param fifo The fifo in question, which cannot be NULL
+ *
+ * \return N/A
+ */
+static void llfifo_unlock(llfifo_t* fifo) {
+
+	if (fifo->sync != NULL) {
+		pthread_mutex_unlock(&(fifo->sync->mutex));
+	}
+}
+
+/**
+ * \fn static void llfifo_signal(pthread_cond_t* cond, int waiters, size_t count)
+ * \brief Wakes up to count of the threads parked on cond, and skips the syscall entirely when nobody is parked
+ *
+ * \param cond Condition variable the threads are parked on
+ * \param waiters Number of threads parked on cond
+ * \param count Number of threads that could make progress now
+ *
+ * \return N/A
+ */
+static void llfifo_signal(pthread_cond_t* cond, int waiters, size_t count) {
+
+	if ((waiters == 0) || (count == 0)) {
+		return;
+	}
+
+	if (count >= (size_t)(waiters)) {
+		pthread_cond_broadcast(cond);
+	}
+	else {
+		while (count-- > 0) {
+			pthread_cond_signal(cond);
+		}
+	}
+}
+
+/**
+ * \fn static void llfifo_wake(llfifo_t* fifo, size_t added)
+ * \brief Called with the lock held after elements were added. Wakes one parked consumer per added element
+ *
+ * \param fifo The fifo in question, which cannot be NULL
+ * \param added Number of elements just enqueued
+ *
+ * \return N/A
+ */
+static void llfifo_wake(llfifo_t* fifo, size_t added) {
+
+	if (fifo->sync != NULL) {
+		llfifo_signal(&(fifo->sync->not_empty), fifo->sync->waiters, added);
+	}
+}
+
+/**
+ * \fn static void llfifo_wake_producers(llfifo_t* fifo, size_t removed)
+ * \brief Called with the lock held after elements were removed. Wakes one producer parked on a full FIFO per removed element
+ *
+ * \param fifo The fifo in question, which cannot be NULL
+ * \param removed Number of elements just dequeued
+ *
+ * \return N/A
+ */
+static void llfifo_wake_producers(llfifo_t* fifo, size_t removed) {
+
+	if (fifo->sync != NULL) {
+		llfifo_signal(&(fifo->sync->not_full), fifo->sync->full_waiters, removed);
+	}
+}
+
+/**
+ * \fn static int llfifo_full(llfifo_t* fifo, size_t n)
+ * \brief Called with the lock held to check whether n more elements would push a bounded FIFO past its limit
+ *
+ * \param fifo The fifo in question, which cannot be NULL
+ * \param n Number of elements about to be enqueued
+ *
+ * \return 1 if they don't fit, 0 if they do or the FIFO is unbounded
+ */
+static int llfifo_full(llfifo_t* fifo, size_t n) {
+
+	return ((fifo->limit != 0) && ((fifo->length >= fifo->limit) || (n > (fifo->limit - fifo->length))));
+}
+
+/**
+ * \fn static void llfifo_deadline(struct timespec* deadline, long long timeout_ns)
+ * \brief Converts a relative timeout into an absolute CLOCK_MONOTONIC deadline for pthread_cond_timedwait
+ *
+ * \param deadline Filled in with the deadline
+ * \param timeout_ns Timeout in nanoseconds, which must be positive
+ *
+ * \return N/A
+ */
+static void llfifo_deadline(struct timespec* deadline, long long timeout_ns) {
+
+	clock_gettime(CLOCK_MONOTONIC, deadline);
+	deadline->tv_sec += (time_t)(timeout_ns / 1000000000LL);
+	deadline->tv_nsec += (long)(timeout_ns % 1000000000LL);
+	if (deadline->tv_nsec >= 1000000000L) {
+		deadline->tv_sec++;
+		deadline->tv_nsec -= 1000000000L;
+	}
+}
+
+/**
+ * \fn static int llfifo_accepting(llfifo_t* fifo)
+ * \brief Called with the lock held to check whether enqueues are still allowed
+ *
+ * \param fifo The fifo in question, which cannot be NULL
+ *
+ * \return 1 if the FIFO is open, 0 if llfifo_close has been called
+ */
+static int llfifo_accepting(llfifo_t* fifo) {
+
+	return ((fifo->sync == NULL) || !(fifo->sync->closed));
+}
+
+/**
+ * \fn static void llfifo_cpu_relax()
+ * \brief Tells the CPU we are in a spin loop, so a sibling hyperthread gets the core for a moment
+ *
+ * \return N/A
+ */
+static void llfifo_cpu_relax() {
+
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * \fn static void llfifo_prefetch(const void* ptr)
+ * \brief Asks the CPU to start loading ptr into cache for reading. Walks over long queues touch one cold node per element, so this overlaps the next miss with work on the current node
+ *
+ * \param ptr Address about to be read. May be NULL
+ *
+ * \return N/A
+ */
+static void llfifo_prefetch(const void* ptr) {
+
+#if defined(__GNUC__)
+	__builtin_prefetch(ptr, 0, 1);
+#else
+	(void)(ptr);
+#endif
+}
+
+#ifdef LLFIFO_STAMPED
+/**
+ * \fn static uint64_t llfifo_stamp_clock(llfifo_t* fifo)
+ * \brief Reads the clock for stamping a node on enqueue, but only if something will look at the stamp
+ *
+ * \param fifo The fifo in question
+ *
+ * \return sojourn_now_ns(), or 0 if the FIFO has neither a histogram attached nor CoDel on
+ */
+static uint64_t llfifo_stamp_clock(llfifo_t* fifo) {
+
+	int stamping = 0;
+
+#ifdef FIFO_SOJOURN
+	stamping |= (fifo->sojourn != NULL);
+#endif
+#ifdef FIFO_CODEL
+	stamping |= (fifo->codel != NULL);
+#endif
+
+	return (stamping) ? (sojourn_now_ns()) : (0);
+}
+#endif
+
+#ifdef FIFO_SOJOURN
+/**
+ * \fn static uint64_t llfifo_sojourn_clock(llfifo_t* fifo)
+ * \brief Reads the clock for recording on dequeue, but only if the FIFO has a histogram attached
+ *
+ * \param fifo The fifo in question
+ *
+ * \return sojourn_now_ns(), or 0 if fifo->sojourn is NULL
+ */
+static uint64_t llfifo_sojourn_clock(llfifo_t* fifo) {
+
+	return (fifo->sojourn != NULL) ? (sojourn_now_ns()) : (0);
+}
+
+/**
+ * \fn static void llfifo_sojourn_record(llfifo_t* fifo, uint64_t enqueued_ns, uint64_t now)
+ * \brief Records how long an element handed to the caller waited. Elements CoDel drops or that miss their deadline are never recorded, so the histogram shows the wait of work actually done. Nodes enqueued before a histogram was attached carry no stamp and are skipped
+ *
+ * \param fifo The fifo in question
+ * \param enqueued_ns Stamp of the node being handed out
+ * \param now Result of llfifo_sojourn_clock, read once per dequeue call
+ *
+ * \return N/A
+ */
+static void llfifo_sojourn_record(llfifo_t* fifo, uint64_t enqueued_ns, uint64_t now) {
+
+	if ((fifo->sojourn != NULL) && (enqueued_ns != 0)) {
+		sojourn_record(fifo->sojourn, now - enqueued_ns);
+	}
+}
+#endif
+
+#ifdef FIFO_DEADLINE
+/**
+ * \fn static int llfifo_reject_expired(llfifo_t* fifo, llnode_t* node, uint64_t* now)
+ * \brief Checks a node on its way out of the FIFO against its deadline. If it has passed, hands the element to the reject callback + counts it. The clock is only read once a node with a deadline turns up, then reused for the rest of the call
+ *
+ * \param fifo The fifo in question
+ * \param node The node being dequeued
+ * \param now Clock reading shared across one dequeue call. Start it at 0
+ *
+ * \return 1 if the element was rejected + must not be handed out, 0 otherwise
+ */
+static int llfifo_reject_expired(llfifo_t* fifo, llnode_t* node, uint64_t* now) {
+
+	if (node->deadline_ns == 0) {
+		return 0;
+	}
+
+	if (*now == 0) {
+		*now = sojourn_now_ns();
+	}
+
+	if (*now < node->deadline_ns) {
+		return 0;
+	}
+
+	if (fifo->reject != NULL) {
+		fifo->reject(node->data, fifo->reject_ctx);
+	}
+
+	fifo->expired++;
+
+	return 1;
+}
+#endif
+
+/**
+ * \fn static int llfifo_hand_out(llfifo_t* fifo, llnode_t* node, uint64_t now, uint64_t* expiry_now)
+ * \brief Decides whether a node leaving the FIFO in a batch reaches the caller. In FIFO_DEADLINE builds an expired element is discarded, otherwise in FIFO_SOJOURN builds its wait is recorded
+ *
+ * \param fifo The fifo in question
+ * \param node The node being dequeued
+ * \param now Result of llfifo_sojourn_clock, read once per dequeue call
+ * \param expiry_now Clock reading for llfifo_reject_expired, shared across one dequeue call. Start it at 0
+ *
+ * \return 1 if the element is handed out, 0 if it was discarded
+ */
+static int llfifo_hand_out(llfifo_t* fifo, llnode_t* node, uint64_t now, uint64_t* expiry_now) {
+
+#ifdef FIFO_DEADLINE
+	if (llfifo_reject_expired(fifo, node, expiry_now)) {
+		return 0;
+	}
+#endif
+
+#ifdef FIFO_SOJOURN
+	llfifo_sojourn_record(fifo, node->enqueued_ns, now);
+#endif
+
+	return 1;
+}
+
+/**
+ * \fn static int llfifo_add_free_nodes(llfifo_t* fifo, size_t count)
+ * \brief Allocates count new free nodes as one contiguous block, links them to each other in one pass, then appends the whole run to the free head
+ *
+ * \param fifo The fifo in question
+ * \param count Number of free nodes to add. Must be at least 1
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, nothing is added and the function returns EXIT_FAILURE (1)
+ */
+static int llfifo_add_free_nodes(llfifo_t* fifo, size_t count) {
+
+	size_t i;
+	llblock_t* new_block;
+	llnode_t* nodes;
+
+	// Ensure the block size can be represented without overflowing
+	if (count > ((SIZE_MAX - sizeof(llblock_t)) / sizeof(llnode_t))) {
+		return EXIT_FAILURE;
+	}
+
+	// Ensure the allocator is successful for a new block of free nodes
+	new_block = (llblock_t*)fifo->allocator.alloc(fifo->allocator.ctx, sizeof(llblock_t) + (count * sizeof(llnode_t)));
+	if (new_block == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	new_block->count = count;
+	new_block->next = fifo->blocks;
+	fifo->blocks = new_block;
+
+	// First block is the end of the chain
+	if (fifo->blocks_last == NULL) {
+		fifo->blocks_last = new_block;
+	}
+
+	// Link the new nodes to each other, tail to head
+	nodes = new_block->nodes;
+	for (i = 0; i < count; i++) {
+		nodes[i].data = NULL;
+		nodes[i].previous = (i == 0) ? (fifo->head_free) : (&nodes[i - 1]);
+		nodes[i].next = (i == (count - 1)) ? (NULL) : (&nodes[i + 1]);
+	}
+
+	// Special case of inserting run into empty free list
+	if (fifo->head_free == NULL) {
+		fifo->tail_free = &nodes[0];
+	}
+
+	// Generic case of inserting run into free list containing at least 1 free node
+	else {
+		fifo->head_free->next = &nodes[0];
+	}
+
+	fifo->head_free = &nodes[count - 1];
+
+	// FIFO has gotten new free nodes so capacity has increased
+	fifo->capacity += count;
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn static int llfifo_grow(llfifo_t* fifo, size_t needed)
+ * \brief On-demand growth for enqueues that found too few free nodes. Adds at least needed nodes, but rounds up to doubling the capacity (at most LLFIFO_GROW_MAX nodes per block), so a FIFO grown one element at a time pays for a block header + an allocation O(log n) times instead of once per element. A bounded FIFO never grows past its limit, and if the bigger block can't be allocated only needed nodes are tried
+ *
+ * \param fifo The fifo in question
+ * \param needed Number of free nodes the enqueue is short of. Must be at least 1
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, nothing is added and the function returns EXIT_FAILURE (1)
+ */
+static int llfifo_grow(llfifo_t* fifo, size_t needed) {
+
+	size_t count;
+
+	count = (fifo->capacity > 0) ? (fifo->capacity) : (1);
+	if (count > LLFIFO_GROW_MAX) {
+		count = LLFIFO_GROW_MAX;
+	}
+
+	if ((fifo->limit > fifo->capacity) && (count > (fifo->limit - fifo->capacity))) {
+		count = fifo->limit - fifo->capacity;
+	}
+
+	if ((count > needed) && (llfifo_add_free_nodes(fifo, count) == EXIT_SUCCESS)) {
+		return EXIT_SUCCESS;
+	}
+
+	return llfifo_add_free_nodes(fifo, needed);
+}
+
+/**
+ * \fn static void llfifo_push_used(llfifo_t* fifo, llnode_t* node)
+ * \brief Links a node (with data already filled in) onto the used head. Used by pooled FIFOs, whose nodes never sit on a free list
+ *
+ * \param fifo The fifo in question
+ * \param node The node to link
+ *
+ * \return N/A
+ */
+static void llfifo_push_used(llfifo_t* fifo, llnode_t* node) {
+
+	node->previous = fifo->head_used;
+	node->next = NULL;
+
+	// Special case of inserting into empty used list
+	if (fifo->length == 0) {
+		fifo->tail_used = node;
+	}
+
+	// Generic case of inserting into used list containing at least 1 used node
+	else {
+		fifo->head_used->next = node;
+	}
+
+	fifo->head_used = node;
+	fifo->length++;
+}
+
+/**
+ * \fn static llnode_t* llfifo_pop_used(llfifo_t* fifo)
+ * \brief Unlinks the used tail and returns it. Caller must make sure the used list isn't empty
+ *
+ * \param fifo The fifo in question
+ *
+ * \return The node that was the used tail
+ */
+static llnode_t* llfifo_pop_used(llfifo_t* fifo) {
+
+	llnode_t* node;
+
+	node = fifo->tail_used;
+	fifo->tail_used = node->next;
+
+	// Special case of used list becoming empty after grabbing this used node
+	if (fifo->tail_used == NULL) {
+		fifo->head_used = NULL;
+	}
+
+	// Generic case of used list having at least 1 used node left after grabbing this used node
+	else {
+		fifo->tail_used->previous = NULL;
+	}
+
+	fifo->length--;
+
+	return node;
+}
+
+/**
+ * \fn static int llfifo_int_size(size_t size)
+ * \brief Converts a length or capacity for the int API in llfifo.h. Sizes past INT_MAX saturate rather than overflow; use the _sz functions to see the real value
+ *
+ * \param size The length or capacity in question
+ *
+ * \return size, or INT_MAX if it doesn't fit in an int
+ */
+static int llfifo_int_size(size_t size) {
+
+	return (size > (size_t)(INT_MAX)) ? (INT_MAX) : ((int)(size));
+}
+
+ /**
+  * \fn llfifo_t* llfifo_create(int capacity)
+  * \brief Creates and initializes the FIFO
+  *
+  * \param capacity Initial size of the FIFO, in number of elements. Valid values are in the range of 0 to the limits of memory
+  *
+  * \return If successful, returns pointer to a newly-created llfifo_t instance. In the case of an error, the function returns NULL
+  */
+llfifo_t* llfifo_create(int capacity) {
+
+	// Ensure amount of free nodes to allocate space for is valid
+	if (capacity < 0) {
+		return NULL;
+	}
+
+	return llfifo_create_sz((size_t)(capacity));
+}
+
+/**
+ * \fn llfifo_t* llfifo_create_sz(size_t capacity)
+ * \brief Creates and initializes the FIFO. Same as llfifo_create but takes a size_t, so the initial capacity can exceed INT_MAX
+ *
+ * \param capacity Initial size of the FIFO, in number of elements
+ *
+ * \return If successful, returns pointer to a newly-created llfifo_t instance. In the case of an error, the function returns NULL
+ */
+llfifo_t* llfifo_create_sz(size_t capacity) {
+
+	return llfifo_create_with_allocator(capacity, &llfifo_default_allocator);
+}
+
+/**
+ * \fn llfifo_t* llfifo_create_with_allocator(size_t capacity, const fifo_allocator_t* allocator)
+ * \brief Creates and initializes the FIFO, taking the FIFO itself + every block of nodes from allocator instead of malloc. Pair it with an arena to make create/destroy of short-lived FIFOs cheap, or to keep a subsystem's queues in its own heap
+ *
+ * \param capacity Initial size of the FIFO, in number of elements
+ * \param allocator Memory hooks to use for the lifetime of the FIFO. Copied, so only allocator->ctx needs to outlive the FIFO
+ *
+ * \return If successful, returns pointer to a newly-created llfifo_t instance. In the case of an error, the function returns NULL
+ */
+llfifo_t* llfifo_create_with_allocator(size_t capacity, const fifo_allocator_t* allocator) {
+
+	llfifo_t* fifo;
+
+	// Ensure the allocator can at least allocate
+	if ((allocator == NULL) || (allocator->alloc == NULL)) {
+		return NULL;
+	}
+
+	// Ensure the allocator is successful for a new FIFO list
+	fifo = (llfifo_t*)allocator->alloc(allocator->ctx, sizeof(llfifo_t));
+	if (fifo == NULL) {
+		return NULL;
+	}
+
+	// Initialize FIFO for size 0
+	fifo->head_free = NULL;
+	fifo->tail_free = NULL;
+	fifo->head_used = NULL;
+	fifo->tail_used = NULL;
+	fifo->capacity = 0;
+	fifo->length = 0;
+	fifo->blocks = NULL;
+	fifo->blocks_last = NULL;
+	fifo->pool = NULL;
+	fifo->allocator = *allocator;
+	fifo->sync = NULL;
+	fifo->limit = 0;
+#ifdef FIFO_SOJOURN
+	fifo->sojourn = NULL;
+#endif
+#ifdef FIFO_CODEL
+	fifo->codel = NULL;
+#endif
+#ifdef FIFO_DEADLINE
+	fifo->reject = NULL;
+	fifo->reject_ctx = NULL;
+	fifo->tagged = 0;
+	fifo->expired = 0;
+#endif
+
+	// Allocate memory for capacity number of free nodes in one block
+	if (capacity > 0) {
+		if (llfifo_add_free_nodes(fifo, capacity) != EXIT_SUCCESS) {
+			llfifo_release(fifo, fifo, sizeof(llfifo_t));
+			return NULL;
+		}
+	}
+
+	return fifo;
+}
+
+/**
+ * \fn int llfifo_enqueue(llfifo_t* fifo, void* element)
+ * \brief Enqueues an element onto the FIFO, growing the FIFO by adding additional elements, if necessary. It is an error to attempt to enqueue the NULL pointer.
+ *
+ * \param fifo The fifo in question
+ * \param element The element to enqueue, which cannot be NULL
+ *
+ * \return If successful, returns the new length of the FIFO on success, saturated at INT_MAX. If the FIFO is bounded and at its limit, returns LLFIFO_FULL (-2) without allocating. In the case of an error, the function returns -1
+ */
+int llfifo_enqueue(llfifo_t* fifo, void* element) {
+
+	size_t length;
+
+	length = llfifo_enqueue_sz(fifo, element);
+	if (length == EXIT_FAILURE_SZ) {
+		return EXIT_FAILURE_N;
+	}
+	if (length == LLFIFO_FULL_SZ) {
+		return LLFIFO_FULL;
+	}
+
+	return llfifo_int_size(length);
+}
+
+/**
+ * \fn static size_t llfifo_enqueue_unlocked(llfifo_t* fifo, void* element)
+ * \brief Does the work of llfifo_enqueue_sz. In synchronized mode the caller holds the lock
+ *
+ * \param fifo The fifo in question
+ * \param element The element to enqueue, which cannot be NULL
+ *
+ * \return If successful, returns the new length of the FIFO. In the case of an error, the function returns (size_t)(-1)
+ */
+static size_t llfifo_enqueue_unlocked(llfifo_t* fifo, void* element) {
+
+	llnode_t* new_used_node;
+
+	// Ensure the fifo to enqueue to is valid
+	if (fifo == NULL) {
+		return EXIT_FAILURE_SZ;
+	}
+
+	// Ensure the element to enqueue is valid
+	if (element == NULL) {
+		return EXIT_FAILURE_SZ;
+	}
+
+	// Ensure a bounded FIFO has room, rather than allocating past its limit
+	if (llfifo_full(fifo, 1)) {
+		return LLFIFO_FULL_SZ;
+	}
+
+	// Pooled FIFOs take the node straight from the shared pool
+	if (fifo->pool != NULL) {
+		new_used_node = (llnode_t*)nodepool_get(fifo->pool);
+		if (new_used_node == NULL) {
+			return EXIT_FAILURE_SZ;
+		}
+
+		new_used_node->data = element;
+#ifdef LLFIFO_STAMPED
+		new_used_node->enqueued_ns = llfifo_stamp_clock(fifo);
+#endif
+#ifdef FIFO_DEADLINE
+		new_used_node->deadline_ns = 0;
+#endif
+		llfifo_push_used(fifo, new_used_node);
+		fifo->capacity++;
+
+		return fifo->length;
+	}
+
+	// Allocate memory for more free nodes if no free nodes are available
+	if (fifo->length == fifo->capacity) {
+		if (llfifo_grow(fifo, 1) != EXIT_SUCCESS) {
+			return EXIT_FAILURE_SZ;
+		}
+	}
+
+	// Grab the free tail to enqueue into used list
+	new_used_node = fifo->tail_free;
+
+	// Special case of inserting used node into empty used list
+	if (fifo->length == 0) {
+
+		// Special case of free list becoming empty after grabbing this free node
+		if (fifo->capacity - fifo->length == 1) {
+			fifo->head_free = NULL;
+			fifo->tail_free = NULL;
+		}
+
+		// Generic case of free list having at least 1 free node left after grabbing this free node
+		else
+		{
+			// Unlink new used node from free list
+			fifo->tail_free->next->previous = NULL;
+
+			// Set new free node as free head only (do not touch free tail since there would be other nodes)
+			fifo->tail_free = fifo->tail_free->next;
+		}
+
+		// Special case of inserting into empty used list
+		new_used_node->data = element;
+		new_used_node->previous = NULL;
+		new_used_node->next = NULL;
+
+		// Set new used node as both used head & used tail in this special case
+		fifo->head_used = new_used_node;
+		fifo->tail_used = new_used_node;
+	}
+
+	// Generic case of inserting into used list containing at least 1 used node
+	else {
+
+		// Special case of free list becoming empty after grabbing this free node
+		if (fifo->capacity - fifo->length == 1) {
+			fifo->head_free = NULL;
+			fifo->tail_free = NULL;
+		}
+
+		// Generic case of free list having at least 1 free node left after grabbing this free node
+		else
+		{
+			// Set new used tail node
+			fifo->tail_free->next->previous = NULL;
+
+			// Set new free node as free head only (do not touch free tail since there would be other nodes)
+			fifo->tail_free = fifo->tail_free->next;
+		}
+
+		// Generic case of inserting into used list containing at least 1 node
+		new_used_node->data = element;
+		new_used_node->previous = fifo->head_used;
+		new_used_node->next = NULL;
+
+		// Link old used head to new used node
+		fifo->head_used->next = new_used_node;
+
+		// Set new used node as used head only (do not touch used tail since there would be other nodes)
+		fifo->head_used = new_used_node;
+	}
+
+#ifdef LLFIFO_STAMPED
+	new_used_node->enqueued_ns = llfifo_stamp_clock(fifo);
+#endif
+#ifdef FIFO_DEADLINE
+	new_used_node->deadline_ns = 0;
+#endif
+
+	// Used node has been added to fifo
+	fifo->length++;
+
+	return fifo->length;
+}
+
+/**
+ * \fn size_t llfifo_enqueue_sz(llfifo_t* fifo, void* element)
+ * \brief Enqueues an element onto the FIFO, growing the FIFO by adding additional elements, if necessary. Same as llfifo_enqueue but reports the length as a size_t, so it stays exact past INT_MAX elements
+ *
+ * \param fifo The fifo in question
+ * \param element The element to enqueue, which cannot be NULL
+ *
+ * \return If successful, returns the new length of the FIFO. If the FIFO is bounded and at its limit, returns LLFIFO_FULL_SZ. In the case of an error, or if the FIFO has been closed, the function returns (size_t)(-1)
+ */
+size_t llfifo_enqueue_sz(llfifo_t* fifo, void* element) {
+
+	size_t length;
+
+	// Ensure the fifo to enqueue to is valid
+	if (fifo == NULL) {
+		return EXIT_FAILURE_SZ;
+	}
+
+	llfifo_lock(fifo);
+
+	length = (llfifo_accepting(fifo)) ? (llfifo_enqueue_unlocked(fifo, element)) : (EXIT_FAILURE_SZ);
+	if ((length != EXIT_FAILURE_SZ) && (length != LLFIFO_FULL_SZ)) {
+		llfifo_wake(fifo, 1);
+	}
+
+	llfifo_unlock(fifo);
+
+	return length;
+}
+
+/**
+ * \fn static void* llfifo_dequeue_unlocked(llfifo_t* fifo)
+ * \brief Unlinks the used tail. Records no sojourn, since the caller may be discarding the element. In synchronized mode the caller holds the lock
+ *
+ * \param fifo The fifo in question
+ *
+ * \return If successful, returns the dequeued element, or NULL if the FIFO was empty.
+ */
+static void* llfifo_dequeue_unlocked(llfifo_t* fifo) {
+
+	void* element;
+	llnode_t* new_free_node;
+
+	// Ensure the fifo to dequeue to is valid
+	if (fifo == NULL) {
+		return NULL;
+	}
+
+	// Ensure at least 1 used note exists in FIFO to dequeue
+	if (fifo->length == 0) {
+		return NULL;
+	}
+
+	// Pooled FIFOs hand the node straight back to the shared pool
+	if (fifo->pool != NULL) {
+		new_free_node = llfifo_pop_used(fifo);
+		element = new_free_node->data;
+		fifo->capacity--;
+		nodepool_put(fifo->pool, new_free_node);
+
+		return element;
+	}
+
+	// Grab the used tail to dequeue
+	new_free_node = fifo->tail_used;
+
+	// Special case of used list becoming empty after grabbing this used node
+	if (fifo->length == 1) {
+		fifo->head_used = NULL;
+		fifo->tail_used = NULL;
+	}
+
+	// Generic case of used list having at least 1 used node left after grabbing this used node
+	else
+	{
+		// Unlink new free node from used list
+		fifo->tail_used->next->previous = NULL;
+
+		// Set new used tail node
+		fifo->tail_used = fifo->tail_used->next;
+
+	}
+
+	// Special case of inserting used node into empty free list
+	if (fifo->capacity == fifo->length) {
+		new_free_node->previous = NULL;
+		new_free_node->next = NULL;
+
+		// Set new free node as both free head & free tail in this special case
+		fifo->head_free = new_free_node;
+		fifo->tail_free = new_free_node;
+	}
+
+	// Generic case of inserting into used list containing at least 1 node
+	else {
+		new_free_node->previous = fifo->head_free;
+		new_free_node->previous->next = new_free_node;
+
+		// Unlink new free node from used list
+		new_free_node->next = NULL;
+
+		// Set new free node as free head only (do not touch free tail since there would be other nodes)
+		fifo->head_free = new_free_node;
+	}
+
+	// Used node has been dequeued from FIFO
+	fifo->length--;
+
+	return new_free_node->data;
+}
+
+#ifdef FIFO_DEADLINE
+/**
+ * \fn static void llfifo_expire_unlocked(llfifo_t* fifo)
+ * \brief Discards elements from the used tail for as long as their deadline has passed, so the next dequeue hands out live work. Only the tail is looked at: an expired element behind a live one waits its turn. In synchronized mode the caller holds the lock
+ *
+ * \param fifo The fifo in question, which cannot be NULL
+ *
+ * \return N/A
+ */
+static void llfifo_expire_unlocked(llfifo_t* fifo) {
+
+	uint64_t now = 0;
+
+	while ((fifo->length > 0) && (llfifo_reject_expired(fifo, fifo->tail_used, &now))) {
+		llfifo_dequeue_unlocked(fifo);
+	}
+}
+#endif
+
+#ifdef FIFO_CODEL
+/**
+ * \fn static uint64_t llfifo_isqrt(uint64_t value)
+ * \brief Integer square root by Newton's method, so the control law doesn't need libm
+ *
+ * \param value Value in question
+ *
+ * \return floor(sqrt(value))
+ */
+static uint64_t llfifo_isqrt(uint64_t value) {
+
+	uint64_t x = value;
+	uint64_t y = (value / 2) + (value & 1);
+
+	while (y < x) {
+		x = y;
+		y = (x + (value / x)) / 2;
+	}
+
+	return x;
+}
+
+/**
+ * \fn static uint64_t llfifo_codel_control_law(llfifo_codel_t* codel, uint64_t t)
+ * \brief CoDel's control law: the next drop is due interval_ns / sqrt(count) after t. Worked in 1/1024ths so small counts keep their precision
+ *
+ * \param codel CoDel state of the fifo in question
+ * \param t Time to count from
+ *
+ * \return When the next drop is due
+ */
+static uint64_t llfifo_codel_control_law(llfifo_codel_t* codel, uint64_t t) {
+
+	return t + ((codel->interval_ns * 1024) / llfifo_isqrt(codel->count << 20));
+}
+
+/**
+ * \fn static void* llfifo_codel_take(llfifo_t* fifo, uint64_t now, int* ok_to_drop, uint64_t* stamp)
+ * \brief Dequeues the oldest element + works out whether sojourn times have now been above target for a whole interval. The RFC's dodequeue
+ *
+ * \param fifo The fifo in question, with CoDel on
+ * \param now Time of this llfifo_dequeue call
+ * \param ok_to_drop Set nonzero if the element may be dropped
+ * \param stamp Set to the element's enqueue stamp, or 0 if the FIFO was empty
+ *
+ * \return The dequeued element, or NULL if the FIFO was empty
+ */
+static void* llfifo_codel_take(llfifo_t* fifo, uint64_t now, int* ok_to_drop, uint64_t* stamp) {
+
+	void* element;
+	llfifo_codel_t* codel = fifo->codel;
+
+	*ok_to_drop = 0;
+	*stamp = 0;
+
+	// Expired elements never reach CoDel, so they neither count as sojourn samples nor get dropped twice
+#ifdef FIFO_DEADLINE
+	llfifo_expire_unlocked(fifo);
+#endif
+
+	if (fifo->length == 0) {
+		codel->first_above_ns = 0;
+		return NULL;
+	}
+
+	*stamp = fifo->tail_used->enqueued_ns;
+	element = llfifo_dequeue_unlocked(fifo);
+
+	// Elements queued before CoDel was on carry no stamp + count as fresh. So does a queue down to its last element, which isn't a standing queue (the RFC's MAXPACKET check)
+	if ((*stamp == 0) || ((now - *stamp) < codel->target_ns) || (fifo->length <= 1)) {
+		codel->first_above_ns = 0;
+	}
+	else if (codel->first_above_ns == 0) {
+		codel->first_above_ns = now + codel->interval_ns;
+	}
+	else if (now >= codel->first_above_ns) {
+		*ok_to_drop = 1;
+	}
+
+	return element;
+}
+
+/**
+ * \fn static void llfifo_codel_drop(llfifo_t* fifo, void* element)
+ * \brief Hands a dropped element to the drop callback + counts it
+ *
+ * \param fifo The fifo in question, with CoDel on
+ * \param element The element being dropped
+ *
+ * \return N/A
+ */
+static void llfifo_codel_drop(llfifo_t* fifo, void* element) {
+
+	if (fifo->codel->drop != NULL) {
+		fifo->codel->drop(element, fifo->codel->ctx);
+	}
+
+	fifo->codel->dropped++;
+}
+
+/**
+ * \fn static void* llfifo_codel_dequeue_unlocked(llfifo_t* fifo)
+ * \brief Dequeue with CoDel on. Once sojourn times have stayed above target for a whole interval, drops an element and enters the dropping state, then keeps dropping at intervals that shrink as interval / sqrt(drops) until sojourn times fall back below target. In synchronized mode the caller holds the lock
+ *
+ * \param fifo The fifo in question, with CoDel on
+ *
+ * \return The element to hand to the consumer, or NULL if the FIFO was empty or everything left in it was dropped
+ */
+static void* llfifo_codel_dequeue_unlocked(llfifo_t* fifo) {
+
+	int ok_to_drop;
+	void* element;
+	uint64_t delta;
+	uint64_t stamp;
+	uint64_t now = sojourn_now_ns();
+	llfifo_codel_t* codel = fifo->codel;
+
+	element = llfifo_codel_take(fifo, now, &ok_to_drop, &stamp);
+
+	if (codel->dropping) {
+
+		// Sojourn time fell below target, so leave the dropping state
+		if (!ok_to_drop) {
+			codel->dropping = 0;
+		}
+
+		// Drop every element that is due, each drop bringing the next one closer
+		while ((codel->dropping) && (now >= codel->drop_next_ns)) {
+
+			llfifo_codel_drop(fifo, element);
+			codel->count++;
+
+			element = llfifo_codel_take(fifo, now, &ok_to_drop, &stamp);
+
+			if (!ok_to_drop) {
+				codel->dropping = 0;
+			}
+			else {
+				codel->drop_next_ns = llfifo_codel_control_law(codel, codel->drop_next_ns);
+			}
+		}
+	}
+
+	// Sojourn time has been above target for a whole interval, so drop one + enter the dropping state
+	else if (ok_to_drop) {
+
+		llfifo_codel_drop(fifo, element);
+
+		element = llfifo_codel_take(fifo, now, &ok_to_drop, &stamp);
+		codel->dropping = 1;
+
+		// Re-entering soon after leaving resumes at about the drop rate that worked last time
+		delta = codel->count - codel->lastcount;
+		codel->count = ((delta > 1) && (now < (codel->drop_next_ns + (16 * codel->interval_ns)))) ? (delta) : (1);
+		codel->drop_next_ns = llfifo_codel_control_law(codel, now);
+		codel->lastcount = codel->count;
+	}
+
+	// Only the survivor's wait is recorded, so drops don't pull the histogram up
+#ifdef FIFO_SOJOURN
+	if (element != NULL) {
+		llfifo_sojourn_record(fifo, stamp, now);
+	}
+#endif
+
+	return element;
+}
+#endif
+
+/**
+ * \fn static void* llfifo_dequeue_managed_unlocked(llfifo_t* fifo, size_t* removed)
+ * \brief Dequeue as llfifo_dequeue + llfifo_dequeue_wait do it: through CoDel if it is on, straight from the used list otherwise. In FIFO_DEADLINE builds expired elements are discarded from the tail on the way. In synchronized mode the caller holds the lock
+ *
+ * \param fifo The fifo in question
+ * \param removed Set to the number of elements that left the FIFO, including any CoDel dropped or discarded as expired
+ *
+ * \return The dequeued element, or NULL if there was none to hand out
+ */
+static void* llfifo_dequeue_managed_unlocked(llfifo_t* fifo, size_t* removed) {
+
+	void* element;
+	size_t length;
+
+	*removed = 0;
+
+	if (fifo == NULL) {
+		return NULL;
+	}
+
+	length = fifo->length;
+
+#ifdef FIFO_CODEL
+	if (fifo->codel != NULL) {
+		element = llfifo_codel_dequeue_unlocked(fifo);
+		*removed = length - fifo->length;
+
+		return element;
+	}
+#endif
+
+#ifdef FIFO_DEADLINE
+	llfifo_expire_unlocked(fifo);
+#endif
+
+	// Recorded after the expired elements are gone, so only the one handed out counts
+#ifdef FIFO_SOJOURN
+	if (fifo->length > 0) {
+		llfifo_sojourn_record(fifo, fifo->tail_used->enqueued_ns, llfifo_sojourn_clock(fifo));
+	}
+#endif
+
+	element = llfifo_dequeue_unlocked(fifo);
+	*removed = length - fifo->length;
+
+	return element;
+}
+
+/**
+ * \fn void* llfifo_dequeue(llfifo_t* fifo)
+ * \brief Removes ("dequeues") an element from the FIFO, and returns it
+ *
+ * \param fifo The fifo in question
+ *
+ * \return If successful, returns the dequeued element, or NULL if the FIFO was empty.
+ */
+void* llfifo_dequeue(llfifo_t* fifo) {
+
+	void* element;
+	size_t removed;
+
+	// Ensure the fifo to dequeue to is valid
+	if (fifo == NULL) {
+		return NULL;
+	}
+
+	llfifo_lock(fifo);
+
+	element = llfifo_dequeue_managed_unlocked(fifo, &removed);
+	if (removed > 0) {
+		llfifo_wake_producers(fifo, removed);
+	}
+
+	llfifo_unlock(fifo);
+
+	return element;
+}
+
+/**
+ * \fn int llfifo_length(llfifo_t* fifo)
+ * \brief Returns the number of elements currently on the FIFO.
+ *
+ * \param fifo The fifo in question
+ *
+ * \return Returns the number of elements currently on the FIFO, saturated at INT_MAX
+ */
+int llfifo_length(llfifo_t* fifo) {
+
+	size_t length;
+
+	if (fifo != NULL) {
+		llfifo_lock(fifo);
+		length = fifo->length;
+		llfifo_unlock(fifo);
+
+		return llfifo_int_size(length);
+	}
+	else {
+		return EXIT_FAILURE_N;
+	}
+}
+
+/**
+ * \fn int llfifo_capacity(llfifo_t* fifo)
+ * \brief Returns the FIFO's current capacity
+ *
+ * \param fifo The fifo in question
+ *
+ * \return Returns the current capacity, in number of elements, for the FIFO, saturated at INT_MAX
+ */
+int llfifo_capacity(llfifo_t* fifo) {
+
+	size_t capacity;
+
+	if (fifo != NULL) {
+		llfifo_lock(fifo);
+		capacity = fifo->capacity;
+		llfifo_unlock(fifo);
+
+		return llfifo_int_size(capacity);
+	}
+	else {
+		return EXIT_FAILURE_N;
+	}
+}
+
+/**
+ * \fn static size_t llfifo_release_blocks(llfifo_t* fifo)
+ * \brief Hands every block back to the allocator. Free + used nodes both live inside these, so neither list is walked. Caller resets the lists afterwards
+ *
+ * \param fifo The fifo in question
+ *
+ * \return The number of nodes that were freed
+ */
+static size_t llfifo_release_blocks(llfifo_t* fifo) {
+
+	size_t freed_nodes;
+	llblock_t* block_to_destroy;
+
+	freed_nodes = 0;
+	while (fifo->blocks != NULL) {
+
+		block_to_destroy = fifo->blocks;
+
+		// Save next block to destroy
+		fifo->blocks = fifo->blocks->next;
+
+		freed_nodes += block_to_destroy->count;
+		llfifo_release(fifo, block_to_destroy, sizeof(llblock_t) + (block_to_destroy->count * sizeof(llnode_t)));
+	}
+
+	fifo->blocks_last = NULL;
+
+	return freed_nodes;
+}
+
+/**
+ * \fn static size_t llfifo_drop_used(llfifo_t* fifo, llfifo_dtor_t dtor)
+ * \brief Runs dtor over every queued element in one pass from tail to head, clearing each node's data behind it. Pooled FIFOs hand each node back to the pool in the same pass, leaving the used list empty. Otherwise the used list is left linked for the caller to recycle or free in bulk
+ *
+ * \param fifo The fifo in question
+ * \param dtor Called on each element, oldest first. If NULL, only the pooled nodes are handed back
+ *
+ * \return The number of elements that were queued
+ */
+static size_t llfifo_drop_used(llfifo_t* fifo, llfifo_dtor_t dtor) {
+
+	size_t dropped;
+	llnode_t* node;
+
+	dropped = fifo->length;
+
+	// Pooled FIFOs own no blocks. Hand each node back to the pool as it is visited
+	if (fifo->pool != NULL) {
+		while (fifo->length > 0) {
+			node = llfifo_pop_used(fifo);
+			fifo->capacity--;
+			if (dtor != NULL) {
+				dtor(node->data);
+			}
+			nodepool_put(fifo->pool, node);
+		}
+
+		return dropped;
+	}
+
+	if (dtor != NULL) {
+		for (node = fifo->tail_used; node != NULL; node = node->next) {
+
+			// Start loading the next node while dtor works on this one
+			llfifo_prefetch(node->next);
+
+			// Don't leave kept nodes pointing at destroyed payloads
+			dtor(node->data);
+			node->data = NULL;
+		}
+	}
+
+	return dropped;
+}
+
+/**
+ * \fn void llfifo_destroy(llfifo_t* fifo)
+ * \brief Teardown function: Frees all dynamically allocated memory. After calling this function, the fifo should not be used again!
+ *
+ * \param fifo The fifo in question
+ *
+ * \return N/A
+ */
+void llfifo_destroy(llfifo_t* fifo) {
+
+	llfifo_destroy_with(fifo, NULL);
+}
+
+/**
+ * \fn void llfifo_destroy_with(llfifo_t* fifo, llfifo_dtor_t dtor)
+ * \brief Same as llfifo_destroy, but first runs dtor over every element still queued, so payloads can be freed without draining the FIFO beforehand. After calling this function, the fifo should not be used again!
+ *
+ * \param fifo The fifo in question
+ * \param dtor Called once on each queued element, oldest first. If NULL, behaves exactly like llfifo_destroy
+ *
+ * \return N/A
+ */
+void llfifo_destroy_with(llfifo_t* fifo, llfifo_dtor_t dtor) {
+
+	size_t freed_nodes;
+
+	if (fifo == NULL) {
+		return;
+	}
+
+	// Single pass over the used list. Pooled nodes go back to the pool along the way
+	llfifo_drop_used(fifo, dtor);
+
+	// Destroy all blocks
+	freed_nodes = llfifo_release_blocks(fifo);
+
+	// Ensure all nodes have been destroyed
+	assert(freed_nodes == fifo->capacity);
+
+	// Tear down synchronized mode. No other thread may be using the FIFO by now
+	if (fifo->sync != NULL) {
+		pthread_mutex_destroy(&(fifo->sync->mutex));
+		pthread_cond_destroy(&(fifo->sync->not_empty));
+		pthread_cond_destroy(&(fifo->sync->not_full));
+		llfifo_release(fifo, fifo->sync, sizeof(llfifo_sync_t));
+	}
+
+#ifdef FIFO_CODEL
+	if (fifo->codel != NULL) {
+		llfifo_release(fifo, fifo->codel, sizeof(llfifo_codel_t));
+	}
+#endif
+
+	// Destroy FIFO only after all nodes have been destroyed
+	llfifo_release(fifo, fifo, sizeof(llfifo_t));
+}
+
+/**
+ * \fn static int llfifo_enqueue_batch_unlocked(llfifo_t* fifo, void** elements, int n)
+ * \brief Does the work of llfifo_enqueue_batch. In synchronized mode the caller holds the lock
+ *
+ * \param fifo The fifo in question
+ * \param elements Array of n elements to enqueue, oldest first
+ * \param n Number of elements in the array
+ *
+ * \return If successful, returns the new length of the FIFO. In the case of an error, the function returns -1
+ */
+static int llfifo_enqueue_batch_unlocked(llfifo_t* fifo, void** elements, int n) {
+
+	int i;
+	llnode_t* first_node;
+	llnode_t* last_node;
+#ifdef LLFIFO_STAMPED
+	uint64_t now;
+#endif
+
+	// Ensure the fifo to enqueue to is valid
+	if (fifo == NULL) {
+		return EXIT_FAILURE_N;
+	}
+
+	// Ensure the elements to enqueue are valid
+	if ((elements == NULL) || (n < 0)) {
+		return EXIT_FAILURE_N;
+	}
+
+	// Check every element up front so the batch is all-or-nothing
+	for (i = 0; i < n; i++) {
+		if (elements[i] == NULL) {
+			return EXIT_FAILURE_N;
+		}
+	}
+
+	if (n == 0) {
+		return llfifo_int_size(fifo->length);
+	}
+
+	// Ensure a bounded FIFO has room for the whole batch
+	if (llfifo_full(fifo, (size_t)(n))) {
+		return LLFIFO_FULL;
+	}
+
+	// The whole batch shares one timestamp
+#ifdef LLFIFO_STAMPED
+	now = llfifo_stamp_clock(fifo);
+#endif
+
+	// Pooled FIFOs take each node from the shared pool. Any taken before a failure go back so the batch stays all-or-nothing
+	if (fifo->pool != NULL) {
+		for (i = 0; i < n; i++) {
+
+			last_node = (llnode_t*)nodepool_get(fifo->pool);
+			if (last_node == NULL) {
+				while (i > 0) {
+					first_node = fifo->head_used;
+					fifo->head_used = first_node->previous;
+					nodepool_put(fifo->pool, first_node);
+					fifo->length--;
+					fifo->capacity--;
+					i--;
+				}
+
+				if (fifo->length == 0) {
+					fifo->head_used = NULL;
+					fifo->tail_used = NULL;
+				}
+				else {
+					fifo->head_used->next = NULL;
+				}
+
+				return EXIT_FAILURE_N;
+			}
+
+			last_node->data = elements[i];
+#ifdef LLFIFO_STAMPED
+			last_node->enqueued_ns = now;
+#endif
+#ifdef FIFO_DEADLINE
+			last_node->deadline_ns = 0;
+#endif
+			llfifo_push_used(fifo, last_node);
+			fifo->capacity++;
+		}
+
+		return llfifo_int_size(fifo->length);
+	}
+
+	// Allocate memory for at least as many extra free nodes as the batch needs beyond the current free list
+	if ((fifo->capacity - fifo->length) < (size_t)(n)) {
+		if (llfifo_grow(fifo, (size_t)(n) - (fifo->capacity - fifo->length)) != EXIT_SUCCESS) {
+			return EXIT_FAILURE_N;
+		}
+	}
+
+	// Walk n nodes from the free tail, filling in data as we go
+	first_node = fifo->tail_free;
+	last_node = first_node;
+	last_node->data = elements[0];
+#ifdef LLFIFO_STAMPED
+	last_node->enqueued_ns = now;
+#endif
+#ifdef FIFO_DEADLINE
+	last_node->deadline_ns = 0;
+#endif
+
+	for (i = 1; i < n; i++) {
+		last_node = last_node->next;
+		last_node->data = elements[i];
+#ifdef LLFIFO_STAMPED
+		last_node->enqueued_ns = now;
+#endif
+#ifdef FIFO_DEADLINE
+		last_node->deadline_ns = 0;
+#endif
+	}
+
+	// Unlink the whole run from the free list
+	fifo->tail_free = last_node->next;
+
+	// Special case of free list becoming empty after grabbing these free nodes
+	if (fifo->tail_free == NULL) {
+		fifo->head_free = NULL;
+	}
+
+	// Generic case of free list having at least 1 free node left after grabbing these free nodes
+	else {
+		fifo->tail_free->previous = NULL;
+	}
+
+	// Special case of inserting run into empty used list
+	if (fifo->length == 0) {
+		first_node->previous = NULL;
+		fifo->tail_used = first_node;
+	}
+
+	// Generic case of inserting run into used list containing at least 1 used node
+	else {
+		first_node->previous = fifo->head_used;
+		fifo->head_used->next = first_node;
+	}
+
+	// Set last node of run as used head
+	last_node->next = NULL;
+	fifo->head_used = last_node;
+
+	// Used nodes have been added to fifo
+	fifo->length += n;
+
+	return llfifo_int_size(fifo->length);
+}
+
+/**
+ * \fn int llfifo_enqueue_batch(llfifo_t* fifo, void** elements, int n)
+ * \brief Enqueues n elements onto the FIFO in order. All needed free nodes are taken from the free list and spliced onto the used list in one pass. It is an error for any element to be NULL, in which case nothing is enqueued
+ *
+ * \param fifo The fifo in question
+ * \param elements Array of n elements to enqueue, oldest first
+ * \param n Number of elements in the array
+ *
+ * \return If successful, returns the new length of the FIFO. If the FIFO is bounded and the whole batch doesn't fit, returns LLFIFO_FULL (-2) and enqueues nothing. In the case of an error, or if the FIFO has been closed, the function returns -1
+ */
+int llfifo_enqueue_batch(llfifo_t* fifo, void** elements, int n) {
+
+	int length;
+
+	// Ensure the fifo to enqueue to is valid
+	if (fifo == NULL) {
+		return EXIT_FAILURE_N;
+	}
+
+	llfifo_lock(fifo);
+
+	length = (llfifo_accepting(fifo)) ? (llfifo_enqueue_batch_unlocked(fifo, elements, n)) : (EXIT_FAILURE_N);
+	if (length >= 0) {
+		llfifo_wake(fifo, (size_t)(n));
+	}
+
+	llfifo_unlock(fifo);
+
+	return length;
+}
+
+/**
+ * \fn static int llfifo_dequeue_batch_unlocked(llfifo_t* fifo, void** out, int max)
+ * \brief Does the work of llfifo_dequeue_batch. In synchronized mode the caller holds the lock
+ *
+ * \param fifo The fifo in question
+ * \param out Destination array with room for at least max elements
+ * \param max Max number of elements to dequeue
+ *
+ * \return If successful, returns the number of elements written to out, which could be 0. In FIFO_DEADLINE builds expired elements are taken off the FIFO but not written, so this can be less than the number removed. In the case of an error, the function returns -1
+ */
+static int llfifo_dequeue_batch_unlocked(llfifo_t* fifo, void** out, int max) {
+
+	int i;
+	int count;
+	int kept = 0;
+	llnode_t* first_node;
+	llnode_t* last_node;
+	uint64_t now = 0;
+	uint64_t expiry_now = 0;
+
+	// Ensure the fifo to dequeue from is valid
+	if (fifo == NULL) {
+		return EXIT_FAILURE_N;
+	}
+
+	// Ensure the destination is valid
+	if ((out == NULL) || (max < 0)) {
+		return EXIT_FAILURE_N;
+	}
+
+	count = ((size_t)(max) < fifo->length) ? (max) : ((int)(fifo->length));
+
+	if (count == 0) {
+		return 0;
+	}
+
+#ifdef FIFO_SOJOURN
+	now = llfifo_sojourn_clock(fifo);
+#endif
+
+	// Pooled FIFOs hand each node straight back to the shared pool
+	if (fifo->pool != NULL) {
+		for (i = 0; i < count; i++) {
+			first_node = llfifo_pop_used(fifo);
+			out[kept] = first_node->data;
+			kept += llfifo_hand_out(fifo, first_node, now, &expiry_now);
+			nodepool_put(fifo->pool, first_node);
+		}
+
+		fifo->capacity -= count;
+
+		return kept;
+	}
+
+	// Walk count nodes from the used tail, copying data out as we go. Expired elements are checked in the same walk + overwritten by the next one kept
+	first_node = fifo->tail_used;
+	last_node = first_node;
+	out[kept] = last_node->data;
+	kept += llfifo_hand_out(fifo, last_node, now, &expiry_now);
+
+	for (i = 1; i < count; i++) {
+		last_node = last_node->next;
+		out[kept] = last_node->data;
+		kept += llfifo_hand_out(fifo, last_node, now, &expiry_now);
+	}
+
+	// Unlink the whole run from the used list
+	fifo->tail_used = last_node->next;
+
+	// Special case of used list becoming empty after grabbing these used nodes
+	if (fifo->tail_used == NULL) {
+		fifo->head_used = NULL;
+	}
+
+	// Generic case of used list having at least 1 used node left after grabbing these used nodes
+	else {
+		fifo->tail_used->previous = NULL;
+	}
+
+	// Special case of inserting run into empty free list
+	if (fifo->head_free == NULL) {
+		first_node->previous = NULL;
+		fifo->tail_free = first_node;
+	}
+
+	// Generic case of inserting run into free list containing at least 1 free node
+	else {
+		first_node->previous = fifo->head_free;
+		fifo->head_free->next = first_node;
+	}
+
+	// Set last node of run as free head
+	last_node->next = NULL;
+	fifo->head_free = last_node;
+
+	// Used nodes have been dequeued from FIFO
+	fifo->length -= count;
+
+	return kept;
+}
+
+/**
+ * \fn int llfifo_dequeue_batch(llfifo_t* fifo, void** out, int max)
+ * \brief Removes ("dequeues") up to max elements from the FIFO into out, oldest first. The dequeued nodes are spliced onto the free list in one pass
+ *
+ * \param fifo The fifo in question
+ * \param out Destination array with room for at least max elements
+ * \param max Max number of elements to dequeue
+ *
+ * \return If successful, returns the number of elements dequeued, which could be 0. In FIFO_DEADLINE builds elements discarded as expired are not counted. In the case of an error, the function returns -1
+ */
+int llfifo_dequeue_batch(llfifo_t* fifo, void** out, int max) {
+
+	int count;
+	size_t length;
+
+	// Ensure the fifo to dequeue from is valid
+	if (fifo == NULL) {
+		return EXIT_FAILURE_N;
+	}
+
+	llfifo_lock(fifo);
+
+	// Wake producers for every element that left, including any discarded as expired
+	length = fifo->length;
+	count = llfifo_dequeue_batch_unlocked(fifo, out, max);
+	if (fifo->length < length) {
+		llfifo_wake_producers(fifo, length - fifo->length);
+	}
+
+	llfifo_unlock(fifo);
+
+	return count;
+}
+
+/**
+ * \fn static int llfifo_reserve_unlocked(llfifo_t* fifo, int n)
+ * \brief Does the work of llfifo_reserve. In synchronized mode the caller holds the lock
+ *
+ * \param fifo The fifo in question, which cannot be NULL
+ * \param n Number of free nodes that should be available after the call, which cannot be negative
+ *
+ * \return If successful, returns the new capacity of the FIFO. In the case of an error, the function returns -1
+ */
+static int llfifo_reserve_unlocked(llfifo_t* fifo, int n) {
+
+	size_t free_nodes;
+
+	// Pooled FIFOs have no free list of their own, so grow the shared pool instead
+	if (fifo->pool != NULL) {
+		if (nodepool_reserve(fifo->pool, n) != EXIT_SUCCESS) {
+			return EXIT_FAILURE_N;
+		}
+
+		return llfifo_int_size(fifo->capacity);
+	}
+
+	// Only allocate the shortfall, if any
+	free_nodes = fifo->capacity - fifo->length;
+	if (free_nodes < (size_t)(n)) {
+		if (llfifo_add_free_nodes(fifo, (size_t)(n) - free_nodes) != EXIT_SUCCESS) {
+			return EXIT_FAILURE_N;
+		}
+	}
+
+	return llfifo_int_size(fifo->capacity);
+}
+
+/**
+ * \fn int llfifo_reserve(llfifo_t* fifo, int n)
+ * \brief Grows the FIFO up front so at least n free nodes are available, allocating whatever is missing as one contiguous block. Call this at startup or when idle so enqueue doesn't have to malloc during a burst
+ *
+ * \param fifo The fifo in question
+ * \param n Number of free nodes that should be available after the call
+ *
+ * \return If successful, returns the new capacity of the FIFO. In the case of an error, the function returns -1
+ */
+int llfifo_reserve(llfifo_t* fifo, int n) {
+
+	int capacity;
+
+	// Ensure the fifo to reserve for is valid
+	if ((fifo == NULL) || (n < 0)) {
+		return EXIT_FAILURE_N;
+	}
+
+	llfifo_lock(fifo);
+	capacity = llfifo_reserve_unlocked(fifo, n);
+	llfifo_unlock(fifo);
+
+	return capacity;
+}
+
+/**
+ * \fn nodepool_t* llfifo_pool_create(int block_nodes)
+ * \brief Creates a node pool that any number of llfifo instances can share via llfifo_create_pooled. Nodes freed by one FIFO can then be reused by any other, so total node memory follows the total number of queued elements instead of the sum of each FIFO's peak
+ *
+ * \param block_nodes Number of nodes to allocate at a time when the pool runs dry. 0 picks a default
+ *
+ * \return If successful, returns pointer to a newly-created pool. Destroy it with nodepool_destroy after every FIFO using it. In the case of an error, the function returns NULL
+ */
+nodepool_t* llfifo_pool_create(int block_nodes) {
+
+	return nodepool_create(sizeof(llnode_t), block_nodes);
+}
+
+/**
+ * \fn llfifo_t* llfifo_create_pooled(nodepool_t* pool)
+ * \brief Creates and initializes a FIFO that draws its nodes from a shared pool instead of owning them. Such a FIFO keeps no free nodes of its own, so its capacity always equals its length
+ *
+ * \param pool Pool created by llfifo_pool_create
+ *
+ * \return If successful, returns pointer to a newly-created llfifo_t instance. In the case of an error, the function returns NULL
+ */
+llfifo_t* llfifo_create_pooled(nodepool_t* pool) {
+
+	llfifo_t* fifo;
+
+	// Ensure the pool hands out objects big enough to be nodes
+	if (nodepool_object_size(pool) < sizeof(llnode_t)) {
+		return NULL;
+	}
+
+	fifo = llfifo_create(0);
+	if (fifo == NULL) {
+		return NULL;
+	}
+
+	fifo->pool = pool;
+
+	return fifo;
+}
+
+/**
+ * \fn size_t llfifo_length_sz(llfifo_t* fifo)
+ * \brief Returns the number of elements currently on the FIFO. Same as llfifo_length but exact past INT_MAX elements
+ *
+ * \param fifo The fifo in question
+ *
+ * \return Returns the number of elements currently on the FIFO, or (size_t)(-1) if fifo is NULL
+ */
+size_t llfifo_length_sz(llfifo_t* fifo) {
+
+	size_t length;
+
+	if (fifo != NULL) {
+		llfifo_lock(fifo);
+		length = fifo->length;
+		llfifo_unlock(fifo);
+
+		return length;
+	}
+	else {
+		return EXIT_FAILURE_SZ;
+	}
+}
+
+/**
+ * \fn size_t llfifo_capacity_sz(llfifo_t* fifo)
+ * \brief Returns the FIFO's current capacity. Same as llfifo_capacity but exact past INT_MAX elements
+ *
+ * \param fifo The fifo in question
+ *
+ * \return Returns the current capacity, in number of elements, or (size_t)(-1) if fifo is NULL
+ */
+size_t llfifo_capacity_sz(llfifo_t* fifo) {
+
+	size_t capacity;
+
+	if (fifo != NULL) {
+		llfifo_lock(fifo);
+		capacity = fifo->capacity;
+		llfifo_unlock(fifo);
+
+		return capacity;
+	}
+	else {
+		return EXIT_FAILURE_SZ;
+	}
+}
+/**
+ * \fn int llfifo_enable_sync(llfifo_t* fifo)
+ * \brief Switches the FIFO into synchronized mode, after which any number of threads may call any llfifo function on it (except destroy) at the same time, and consumers may block in llfifo_dequeue_wait. Call this right after creating the FIFO, before sharing it with other threads
+ *
+ * \param fifo The fifo in question
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). If the FIFO is NULL, already synchronized, or the lock can't be set up, the function returns EXIT_FAILURE (1)
+ */
+int llfifo_enable_sync(llfifo_t* fifo) {
+
+	llfifo_sync_t* sync;
+	pthread_condattr_t attr;
+
+	// Ensure the fifo is valid + not already synchronized
+	if ((fifo == NULL) || (fifo->sync != NULL)) {
+		return EXIT_FAILURE;
+	}
+
+	sync = (llfifo_sync_t*)fifo->allocator.alloc(fifo->allocator.ctx, sizeof(llfifo_sync_t));
+	if (sync == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	if (pthread_mutex_init(&(sync->mutex), NULL) != 0) {
+		llfifo_release(fifo, sync, sizeof(llfifo_sync_t));
+		return EXIT_FAILURE;
+	}
+
+	// Timeouts are measured on the monotonic clock
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	if (pthread_cond_init(&(sync->not_empty), &attr) != 0) {
+		pthread_condattr_destroy(&attr);
+		pthread_mutex_destroy(&(sync->mutex));
+		llfifo_release(fifo, sync, sizeof(llfifo_sync_t));
+		return EXIT_FAILURE;
+	}
+	if (pthread_cond_init(&(sync->not_full), &attr) != 0) {
+		pthread_condattr_destroy(&attr);
+		pthread_cond_destroy(&(sync->not_empty));
+		pthread_mutex_destroy(&(sync->mutex));
+		llfifo_release(fifo, sync, sizeof(llfifo_sync_t));
+		return EXIT_FAILURE;
+	}
+	pthread_condattr_destroy(&attr);
+
+	sync->waiters = 0;
+	sync->full_waiters = 0;
+	sync->closed = 0;
+
+	// Spinning only helps if the producer can run on another CPU meanwhile
+	sync->spins = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? (LLFIFO_SYNC_SPINS) : (0);
+
+	fifo->sync = sync;
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn void* llfifo_dequeue_wait(llfifo_t* fifo, long long timeout_ns)
+ * \brief Removes ("dequeues") an element from the FIFO, waiting for one to arrive if it is empty. Re-checks the FIFO a few times before parking, since handing off to a consumer that is still awake is much cheaper than waking one up. Elements still queued when the FIFO is closed are handed out before this starts returning NULL
+ *
+ * \param fifo The fifo in question. If it isn't synchronized this behaves exactly like llfifo_dequeue
+ * \param timeout_ns Longest time to wait, in nanoseconds. 0 doesn't wait at all, negative waits forever
+ *
+ * \return If successful, returns the dequeued element. Returns NULL if the timeout expired, or if the FIFO is closed and empty. Use llfifo_closed to tell the two apart
+ */
+void* llfifo_dequeue_wait(llfifo_t* fifo, long long timeout_ns) {
+
+	int rc;
+	int spins;
+	int timed;
+	void* element;
+	size_t removed;
+	struct timespec deadline;
+	llfifo_sync_t* sync;
+
+	// Ensure the fifo to dequeue to is valid
+	if (fifo == NULL) {
+		return NULL;
+	}
+
+	// Nothing can arrive while an unsynchronized FIFO is being used by this thread
+	sync = fifo->sync;
+	if ((sync == NULL) || (timeout_ns == 0)) {
+		return llfifo_dequeue(fifo);
+	}
+
+	pthread_mutex_lock(&(sync->mutex));
+
+	// Hot path: briefly give the producer a chance before paying for a sleep + wakeup
+	for (spins = sync->spins; (spins > 0) && (fifo->length == 0) && !(sync->closed); spins--) {
+		pthread_mutex_unlock(&(sync->mutex));
+		llfifo_cpu_relax();
+		pthread_mutex_lock(&(sync->mutex));
+	}
+
+	rc = 0;
+	timed = 0;
+
+	for (;;) {
+
+		if ((fifo->length == 0) && !(sync->closed) && (rc != ETIMEDOUT)) {
+
+			// The deadline is fixed on the first wait, so retries below don't extend the timeout
+			if ((timeout_ns > 0) && !timed) {
+				llfifo_deadline(&deadline, timeout_ns);
+				timed = 1;
+			}
+
+			// Producers only signal while waiters is nonzero
+			sync->waiters++;
+
+			while ((fifo->length == 0) && !(sync->closed) && (rc != ETIMEDOUT)) {
+				if (timeout_ns > 0) {
+					rc = pthread_cond_timedwait(&(sync->not_empty), &(sync->mutex), &deadline);
+				}
+				else {
+					rc = pthread_cond_wait(&(sync->not_empty), &(sync->mutex));
+				}
+			}
+
+			sync->waiters--;
+		}
+
+		element = llfifo_dequeue_managed_unlocked(fifo, &removed);
+		if (removed > 0) {
+			llfifo_wake_producers(fifo, removed);
+		}
+
+		// CoDel drops + expired deadlines can empty the FIFO without handing anything out. That is neither closed nor timed out, so keep waiting
+		if ((element != NULL) || (sync->closed) || (rc == ETIMEDOUT)) {
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&(sync->mutex));
+
+	return element;
+}
+
+/**
+ * \fn int llfifo_close(llfifo_t* fifo)
+ * \brief Shuts a synchronized FIFO down: every later enqueue fails, and every consumer blocked in llfifo_dequeue_wait + producer blocked in llfifo_enqueue_wait wakes up. Elements already queued can still be dequeued
+ *
+ * \param fifo The fifo in question, which must be synchronized
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). If the FIFO is NULL or not synchronized, the function returns EXIT_FAILURE (1)
+ */
+int llfifo_close(llfifo_t* fifo) {
+
+	if ((fifo == NULL) || (fifo->sync == NULL)) {
+		return EXIT_FAILURE;
+	}
+
+	pthread_mutex_lock(&(fifo->sync->mutex));
+
+	fifo->sync->closed = 1;
+	if (fifo->sync->waiters > 0) {
+		pthread_cond_broadcast(&(fifo->sync->not_empty));
+	}
+	if (fifo->sync->full_waiters > 0) {
+		pthread_cond_broadcast(&(fifo->sync->not_full));
+	}
+
+	pthread_mutex_unlock(&(fifo->sync->mutex));
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int llfifo_closed(llfifo_t* fifo)
+ * \brief Reports whether llfifo_close has been called, so a consumer that got NULL from llfifo_dequeue_wait can tell shutdown from a timeout
+ *
+ * \param fifo The fifo in question
+ *
+ * \return 1 if the FIFO has been closed, 0 if not (always 0 for unsynchronized FIFOs), or -1 if fifo is NULL
+ */
+int llfifo_closed(llfifo_t* fifo) {
+
+	int closed;
+
+	if (fifo == NULL) {
+		return EXIT_FAILURE_N;
+	}
+
+	llfifo_lock(fifo);
+	closed = !(llfifo_accepting(fifo));
+	llfifo_unlock(fifo);
+
+	return closed;
+}
+
+/**
+ * \fn int llfifo_set_limit(llfifo_t* fifo, size_t limit)
+ * \brief Bounds the FIFO: once it holds limit elements, enqueues report LLFIFO_FULL (or block, in llfifo_enqueue_wait) instead of allocating more nodes. Lowering the limit below the current length drops nothing, it just refuses enqueues until consumers catch up
+ *
+ * \param fifo The fifo in question
+ * \param limit Most elements the FIFO may hold. 0 removes the limit, which is the default
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). If the FIFO is NULL, the function returns EXIT_FAILURE (1)
+ */
+int llfifo_set_limit(llfifo_t* fifo, size_t limit) {
+
+	if (fifo == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	llfifo_lock(fifo);
+
+	fifo->limit = limit;
+
+	// Producers parked on the old limit may fit now
+	if ((fifo->sync != NULL) && (fifo->sync->full_waiters > 0)) {
+		pthread_cond_broadcast(&(fifo->sync->not_full));
+	}
+
+	llfifo_unlock(fifo);
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn size_t llfifo_limit(llfifo_t* fifo)
+ * \brief Returns the limit set by llfifo_set_limit
+ *
+ * \param fifo The fifo in question
+ *
+ * \return Returns the most elements the FIFO may hold, 0 if it is unbounded, or (size_t)(-1) if fifo is NULL
+ */
+size_t llfifo_limit(llfifo_t* fifo) {
+
+	size_t limit;
+
+	if (fifo == NULL) {
+		return EXIT_FAILURE_SZ;
+	}
+
+	llfifo_lock(fifo);
+	limit = fifo->limit;
+	llfifo_unlock(fifo);
+
+	return limit;
+}
+
+/**
+ * \fn int llfifo_enqueue_wait(llfifo_t* fifo, void* element, long long timeout_ns)
+ * \brief Enqueues an element onto the FIFO, waiting for room if a bounded FIFO is at its limit. This is what gives a slow consumer real backpressure on its producers
+ *
+ * \param fifo The fifo in question. If it isn't synchronized this behaves exactly like llfifo_enqueue
+ * \param element The element to enqueue, which cannot be NULL
+ * \param timeout_ns Longest time to wait, in nanoseconds. 0 doesn't wait at all, negative waits forever
+ *
+ * \return If successful, returns the new length of the FIFO, saturated at INT_MAX. Returns LLFIFO_FULL (-2) if the timeout expired first. In the case of an error, or if the FIFO has been closed, the function returns -1
+ */
+int llfifo_enqueue_wait(llfifo_t* fifo, void* element, long long timeout_ns) {
+
+	int rc;
+	int spins;
+	size_t length;
+	struct timespec deadline;
+	llfifo_sync_t* sync;
+
+	// Ensure the fifo to enqueue to is valid
+	if (fifo == NULL) {
+		return EXIT_FAILURE_N;
+	}
+
+	// Nothing can be dequeued while an unsynchronized FIFO is being used by this thread
+	sync = fifo->sync;
+	if ((sync == NULL) || (timeout_ns == 0)) {
+		return llfifo_enqueue(fifo, element);
+	}
+
+	pthread_mutex_lock(&(sync->mutex));
+
+	// Hot path: briefly give the consumer a chance before paying for a sleep + wakeup
+	for (spins = sync->spins; (spins > 0) && llfifo_full(fifo, 1) && !(sync->closed); spins--) {
+		pthread_mutex_unlock(&(sync->mutex));
+		llfifo_cpu_relax();
+		pthread_mutex_lock(&(sync->mutex));
+	}
+
+	if (llfifo_full(fifo, 1) && !(sync->closed)) {
+
+		if (timeout_ns > 0) {
+			llfifo_deadline(&deadline, timeout_ns);
+		}
+
+		// Consumers only signal while full_waiters is nonzero
+		sync->full_waiters++;
+
+		rc = 0;
+		while (llfifo_full(fifo, 1) && !(sync->closed) && (rc != ETIMEDOUT)) {
+			if (timeout_ns > 0) {
+				rc = pthread_cond_timedwait(&(sync->not_full), &(sync->mutex), &deadline);
+			}
+			else {
+				rc = pthread_cond_wait(&(sync->not_full), &(sync->mutex));
+			}
+		}
+
+		sync->full_waiters--;
+	}
+
+	length = (sync->closed) ? (EXIT_FAILURE_SZ) : (llfifo_enqueue_unlocked(fifo, element));
+	if ((length != EXIT_FAILURE_SZ) && (length != LLFIFO_FULL_SZ)) {
+		llfifo_wake(fifo, 1);
+	}
+
+	pthread_mutex_unlock(&(sync->mutex));
+
+	if (length == EXIT_FAILURE_SZ) {
+		return EXIT_FAILURE_N;
+	}
+	if (length == LLFIFO_FULL_SZ) {
+		return LLFIFO_FULL;
+	}
+
+	return llfifo_int_size(length);
+}
+
+/**
+ * \fn static int llfifo_splice_compatible(llfifo_t* dst, llfifo_t* src)
+ * \brief Checks whether src's nodes can change owner to dst. Blocks must go back to the allocator they came from, and pooled nodes to the pool they came from, so both FIFOs have to share those
+ *
+ * \param dst The fifo that would take the nodes
+ * \param src The fifo that would give them up
+ *
+ * \return 1 if the nodes can be moved, 0 if not
+ */
+static int llfifo_splice_compatible(llfifo_t* dst, llfifo_t* src) {
+
+	return ((dst->pool == src->pool) &&
+		(dst->allocator.alloc == src->allocator.alloc) &&
+		(dst->allocator.free == src->allocator.free) &&
+		(dst->allocator.ctx == src->allocator.ctx));
+}
+
+/**
+ * \fn static size_t llfifo_splice_unlocked(llfifo_t* dst, llfifo_t* src)
+ * \brief Does the work of llfifo_splice. In synchronized mode the caller holds both locks
+ *
+ * \param dst The fifo to append to
+ * \param src The fifo to empty
+ *
+ * \return If successful, returns the new length of dst. Returns LLFIFO_FULL_SZ if dst is bounded and src's elements don't fit. In the case of an error, the function returns (size_t)(-1)
+ */
+static size_t llfifo_splice_unlocked(llfifo_t* dst, llfifo_t* src) {
+
+	size_t moved;
+
+	// Ensure dst still takes elements + src's nodes may change owner
+	if (!llfifo_accepting(dst) || !llfifo_splice_compatible(dst, src)) {
+		return EXIT_FAILURE_SZ;
+	}
 
-	// Begin allocating memory for capacity number of free nodes
-	for (i = 0; i < capacity; i++) {
+	// Ensure a bounded dst has room for everything, since splicing only part of src would take O(n)
+	if ((src->length > 0) && llfifo_full(dst, src->length)) {
+		return LLFIFO_FULL_SZ;
+	}
 
-		// Ensure malloc is successful for a new free node
-		new_free_node = (llnode_t*)malloc(sizeof(llnode_t));
-		if (new_free_node == NULL) {
-			return NULL;
-		}
+	moved = src->length;
 
-		// Special case of inserting free node into empty free list
-		if (i == 0) {
-			new_free_node->data = NULL;
-			new_free_node->previous = NULL;
-			new_free_node->next = NULL;
+	// Append src's used list after dst's used head, so src's elements come out after dst's
+	if (src->length > 0) {
 
-			// Set new free node as both free head & free tail
-			fifo->head_free = new_free_node;
-			fifo->tail_free = new_free_node;
+		// Special case of splicing into empty used list
+		if (dst->length == 0) {
+			dst->tail_used = src->tail_used;
 		}
 
-		// Generic case of insert into free list containing at least 1 free node
+		// Generic case of splicing into used list containing at least 1 used node
 		else {
-			new_free_node->data = NULL;
-			new_free_node->previous = fifo->head_free;
-			new_free_node->next = NULL;
+			dst->head_used->next = src->tail_used;
+			src->tail_used->previous = dst->head_used;
+		}
+
+		dst->head_used = src->head_used;
+	}
 
-			// Link old free head to new free node
-			fifo->head_free->next = new_free_node;
+	// Append src's free list after dst's free head
+	if (src->head_free != NULL) {
 
-			// Set new free node as free head only (do not touch free tail since there would be other nodes)
-			fifo->head_free = new_free_node;
+		// Special case of splicing into empty free list
+		if (dst->head_free == NULL) {
+			dst->tail_free = src->tail_free;
 		}
 
-		// FIFO has gotten a new free node so capacity has increased
-		fifo->capacity++;
+		// Generic case of splicing into free list containing at least 1 free node
+		else {
+			dst->head_free->next = src->tail_free;
+			src->tail_free->previous = dst->head_free;
+		}
+
+		dst->head_free = src->head_free;
 	}
 
-	return fifo;
+	// Hand over the blocks the moved nodes live in by putting src's whole chain in front of dst's
+	if (src->blocks != NULL) {
+
+		src->blocks_last->next = dst->blocks;
+		dst->blocks = src->blocks;
+
+		// Special case of dst owning no blocks yet
+		if (dst->blocks_last == NULL) {
+			dst->blocks_last = src->blocks_last;
+		}
+	}
+
+	dst->length += src->length;
+	dst->capacity += src->capacity;
+
+	// src now owns nothing, same as a FIFO created with capacity 0
+	src->head_free = NULL;
+	src->tail_free = NULL;
+	src->head_used = NULL;
+	src->tail_used = NULL;
+	src->blocks = NULL;
+	src->blocks_last = NULL;
+	src->length = 0;
+	src->capacity = 0;
+
+	llfifo_wake(dst, moved);
+	llfifo_wake_producers(src, moved);
+
+	return dst->length;
 }
 
 /**
- * \fn int llfifo_enqueue(llfifo_t* fifo, void* element)
- * \brief Enqueues an element onto the FIFO, growing the FIFO by adding additional elements, if necessary. It is an error to attempt to enqueue the NULL pointer.
+ * \fn size_t llfifo_splice(llfifo_t* dst, llfifo_t* src)
+ * \brief Moves every element queued on src onto the end of dst in constant time, keeping their order, by relinking nodes rather than copying them. src's free nodes + the blocks all its nodes live in move with them, so dst's capacity grows by src's capacity and src is left empty with capacity 0, still usable. Both FIFOs must use the same allocator, and be pooled from the same pool or not pooled at all
  *
- * \param fifo The fifo in question
- * \param element The element to enqueue, which cannot be NULL
+ * \param dst The fifo to append to
+ * \param src The fifo to empty, which cannot be dst
  *
- * \return If successful, returns the new length of the FIFO on success. In the case of an error, the function returns -1
+ * \return If successful, returns the new length of dst. If dst is bounded and src's elements don't fit, nothing moves and the function returns LLFIFO_FULL_SZ. In the case of an error, including a closed dst or FIFOs with different allocators or pools, the function returns (size_t)(-1)
  */
-int llfifo_enqueue(llfifo_t* fifo, void* element) {
+size_t llfifo_splice(llfifo_t* dst, llfifo_t* src) {
 
-	llnode_t* new_used_node;
+	size_t length;
+	llfifo_t* first;
+	llfifo_t* second;
 
-	// Ensure the fifo to enqueue to is valid
-	if (fifo == NULL) {
-		return EXIT_FAILURE_N;
+	// Ensure both fifos are valid + distinct
+	if ((dst == NULL) || (src == NULL) || (dst == src)) {
+		return EXIT_FAILURE_SZ;
 	}
 
-	// Ensure the element to enqueue is valid
-	if (element == NULL) {
-		return EXIT_FAILURE_N;
-	}
+	// Always lock in address order, so two threads splicing the same pair in opposite directions can't deadlock
+	first = ((uintptr_t)(dst) < (uintptr_t)(src)) ? (dst) : (src);
+	second = (first == dst) ? (src) : (dst);
 
-	// Allocate memory for an extra free node if no free nodes are available
-	if (fifo->length == fifo->capacity) {
-		new_used_node = (llnode_t*)malloc(sizeof(llnode_t));
-		if (new_used_node == NULL) {
-			return EXIT_FAILURE_N;
-		}
+	llfifo_lock(first);
+	llfifo_lock(second);
 
-		// Special case of inserting into empty free list
-		new_used_node->data = NULL;
-		new_used_node->previous = NULL;
-		new_used_node->next = NULL;
+	length = llfifo_splice_unlocked(dst, src);
 
-		// Set new free node as both free head & free tail
-		fifo->head_free = new_used_node;
-		fifo->tail_free = new_used_node;
+	llfifo_unlock(second);
+	llfifo_unlock(first);
 
-		// Free node has been added to fifo
-		fifo->capacity++;
-	}
+	return length;
+}
 
-	// Grab the free tail to enqueue into used list
-	new_used_node = fifo->tail_free;
+/**
+ * \fn void* llfifo_peek(llfifo_t* fifo)
+ * \brief Returns the oldest element, the one llfifo_dequeue would return next, without removing it
+ *
+ * \param fifo The fifo in question
+ *
+ * \return Returns the oldest element, or NULL if the FIFO is empty or NULL
+ */
+void* llfifo_peek(llfifo_t* fifo) {
 
-	// Special case of inserting used node into empty used list
-	if (fifo->length == 0) {
+	void* element;
 
-		// Special case of free list becoming empty after grabbing this free node
-		if (fifo->capacity - fifo->length == 1) {
-			fifo->head_free = NULL;
-			fifo->tail_free = NULL;
-		}
+	if (fifo == NULL) {
+		return NULL;
+	}
 
-		// Generic case of free list having at least 1 free node left after grabbing this free node
-		else
-		{
-			// Unlink new used node from free list
-			fifo->tail_free->next->previous = NULL;
+	llfifo_lock(fifo);
+	element = (fifo->length > 0) ? (fifo->tail_used->data) : (NULL);
+	llfifo_unlock(fifo);
 
-			// Set new free node as free head only (do not touch free tail since there would be other nodes)
-			fifo->tail_free = fifo->tail_free->next;
-		}
+	return element;
+}
 
-		// Special case of inserting into empty used list
-		new_used_node->data = element;
-		new_used_node->previous = NULL;
-		new_used_node->next = NULL;
+/**
+ * \fn static size_t llfifo_foreach_unlocked(llfifo_t* fifo, llfifo_visit_t visit, void* ctx)
+ * \brief Does the work of llfifo_foreach. In synchronized mode the caller holds the lock
+ *
+ * \param fifo The fifo in question
+ * \param visit Called once per element, oldest first
+ * \param ctx Passed through to visit
+ *
+ * \return Returns the number of elements visit was called on
+ */
+static size_t llfifo_foreach_unlocked(llfifo_t* fifo, llfifo_visit_t visit, void* ctx) {
 
-		// Set new used node as both used head & used tail in this special case
-		fifo->head_used = new_used_node;
-		fifo->tail_used = new_used_node;
-	}
+	size_t visited;
+	llnode_t* node;
 
-	// Generic case of inserting into used list containing at least 1 used node
-	else {
+	visited = 0;
+	node = fifo->tail_used;
 
-		// Special case of free list becoming empty after grabbing this free node
-		if (fifo->capacity - fifo->length == 1) {
-			fifo->head_free = NULL;
-			fifo->tail_free = NULL;
-		}
+	while (node != NULL) {
 
-		// Generic case of free list having at least 1 free node left after grabbing this free node
-		else
-		{
-			// Set new used tail node
-			fifo->tail_free->next->previous = NULL;
+		// Start loading the next node while visit works on this one
+		llfifo_prefetch(node->next);
 
-			// Set new free node as free head only (do not touch free tail since there would be other nodes)
-			fifo->tail_free = fifo->tail_free->next;
+		visited++;
+		if (visit(node->data, ctx) != 0) {
+			break;
 		}
 
-		// Generic case of inserting into used list containing at least 1 node
-		new_used_node->data = element;
-		new_used_node->previous = fifo->head_used;
-		new_used_node->next = NULL;
+		node = node->next;
+	}
 
-		// Link old used head to new used node
-		fifo->head_used->next = new_used_node;
+	return visited;
+}
 
-		// Set new used node as used head only (do not touch used tail since there would be other nodes)
-		fifo->head_used = new_used_node;
+/**
+ * \fn size_t llfifo_foreach(llfifo_t* fifo, llfifo_visit_t visit, void* ctx)
+ * \brief Calls visit on every queued element from oldest to newest, the order they would be dequeued in, without removing any of them. In synchronized mode the lock is held for the whole walk, so visit must not call llfifo functions on the same FIFO
+ *
+ * \param fifo The fifo in question
+ * \param visit Called once per element with the element + ctx. Returning nonzero stops the walk after that element
+ * \param ctx Passed through to visit
+ *
+ * \return If successful, returns the number of elements visit was called on. In the case of an error, the function returns (size_t)(-1)
+ */
+size_t llfifo_foreach(llfifo_t* fifo, llfifo_visit_t visit, void* ctx) {
+
+	size_t visited;
+
+	// Ensure the fifo + callback are valid
+	if ((fifo == NULL) || (visit == NULL)) {
+		return EXIT_FAILURE_SZ;
 	}
 
-	// Used node has been added to fifo
-	fifo->length++;
+	llfifo_lock(fifo);
+	visited = llfifo_foreach_unlocked(fifo, visit, ctx);
+	llfifo_unlock(fifo);
 
-	return fifo->length;
+	return visited;
 }
 
 /**
- * \fn void* llfifo_dequeue(llfifo_t* fifo)
- * \brief Removes ("dequeues") an element from the FIFO, and returns it
+ * \fn static size_t llfifo_clear_unlocked(llfifo_t* fifo, llfifo_dtor_t dtor, int keep_free)
+ * \brief Does the work of llfifo_clear. In synchronized mode the caller holds the lock
  *
  * \param fifo The fifo in question
+ * \param dtor Called once on each queued element, oldest first. May be NULL
+ * \param keep_free Nonzero to keep every node as a free node, zero to free them all
  *
- * \return If successful, returns the dequeued element, or NULL if the FIFO was empty.
+ * \return Returns the number of elements that were removed
  */
-void* llfifo_dequeue(llfifo_t* fifo) {
+static size_t llfifo_clear_unlocked(llfifo_t* fifo, llfifo_dtor_t dtor, int keep_free) {
 
-	llnode_t* new_free_node;
+	size_t cleared;
 
-	// Ensure the fifo to dequeue to is valid
-	if (fifo == NULL) {
-		return NULL;
-	}
+	cleared = llfifo_drop_used(fifo, dtor);
 
-	// Ensure at least 1 used note exists in FIFO to dequeue
-	if (fifo->length == 0) {
-		return NULL;
+	// Pooled FIFOs are already empty, with their nodes back in the pool
+	if (fifo->pool != NULL) {
+		llfifo_wake_producers(fifo, cleared);
+		return cleared;
 	}
 
-	// Grab the used tail to dequeue
-	new_free_node = fifo->tail_used;
+	// Keep every node by moving the whole used list onto the free head in one step
+	if (keep_free) {
 
-	// Special case of used list becoming empty after grabbing this used node
-	if (fifo->length == 1) {
-		fifo->head_used = NULL;
-		fifo->tail_used = NULL;
-	}
+		if (fifo->length > 0) {
 
-	// Generic case of used list having at least 1 used node left after grabbing this used node
-	else
-	{
-		// Unlink new free node from used list
-		fifo->tail_used->next->previous = NULL;
+			// Special case of moving used list into empty free list
+			if (fifo->head_free == NULL) {
+				fifo->tail_free = fifo->tail_used;
+			}
 
-		// Set new used tail node
-		fifo->tail_used = fifo->tail_used->next;
+			// Generic case of moving used list into free list containing at least 1 free node
+			else {
+				fifo->head_free->next = fifo->tail_used;
+				fifo->tail_used->previous = fifo->head_free;
+			}
 
+			fifo->head_free = fifo->head_used;
+		}
 	}
 
-	// Special case of inserting used node into empty free list
-	if (fifo->capacity == fifo->length) {
-		new_free_node->previous = NULL;
-		new_free_node->next = NULL;
+	// Free every node in bulk, block by block
+	else {
+		llfifo_release_blocks(fifo);
 
-		// Set new free node as both free head & free tail in this special case
-		fifo->head_free = new_free_node;
-		fifo->tail_free = new_free_node;
+		fifo->head_free = NULL;
+		fifo->tail_free = NULL;
+		fifo->capacity = 0;
 	}
 
-	// Generic case of inserting into used list containing at least 1 node
-	else {
-		new_free_node->previous = fifo->head_free;
-		new_free_node->previous->next = new_free_node;
+	fifo->head_used = NULL;
+	fifo->tail_used = NULL;
+	fifo->length = 0;
 
-		// Unlink new free node from used list
-		new_free_node->next = NULL;
+	llfifo_wake_producers(fifo, cleared);
 
-		// Set new free node as free head only (do not touch free tail since there would be other nodes)
-		fifo->head_free = new_free_node;
+	return cleared;
+}
+
+/**
+ * \fn size_t llfifo_clear(llfifo_t* fifo, llfifo_dtor_t dtor, int keep_free)
+ * \brief Removes every queued element in one pass, running dtor over each. Either keeps all nodes on the free list so the FIFO refills without allocating, or frees them in bulk so it shrinks back to capacity 0. In synchronized mode dtor runs with the lock held, so it must not call llfifo functions on the same FIFO
+ *
+ * \param fifo The fifo in question
+ * \param dtor Called once on each queued element, oldest first. If NULL, elements are just dropped
+ * \param keep_free Nonzero to keep capacity as it is, zero to free every node. Pooled FIFOs always hand their nodes back to the pool
+ *
+ * \return If successful, returns the number of elements that were removed. In the case of an error, the function returns (size_t)(-1)
+ */
+size_t llfifo_clear(llfifo_t* fifo, llfifo_dtor_t dtor, int keep_free) {
+
+	size_t cleared;
+
+	if (fifo == NULL) {
+		return EXIT_FAILURE_SZ;
 	}
 
-	// Used node has been dequeued from FIFO
-	fifo->length--;
+	llfifo_lock(fifo);
+	cleared = llfifo_clear_unlocked(fifo, dtor, keep_free);
+	llfifo_unlock(fifo);
 
-	return new_free_node;
+	return cleared;
 }
 
+#ifdef FIFO_SOJOURN
 /**
- * \fn int llfifo_length(llfifo_t* fifo)
- * \brief Returns the number of elements currently on the FIFO.
+ * \fn int llfifo_set_sojourn(llfifo_t* fifo, sojourn_hist_t* hist)
+ * \brief Attaches a histogram that records how long each element waits between enqueue + dequeue. Once attached, every enqueue stamps its node and every dequeue (single or batch) records now minus that stamp for each element it hands out. Elements CoDel drops or that miss their deadline are not recorded. Elements already queued when it is attached carry no stamp and are not recorded. The histogram may be shared with other FIFOs + threads. Only built with FIFO_SOJOURN, so FIFOs built without it carry no timestamp at all
  *
  * \param fifo The fifo in question
+ * \param hist Histogram to record into, which must outlive the FIFO or be detached first. NULL detaches + stops stamping
  *
- * \return Returns the number of elements currently on the FIFO
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
  */
-int llfifo_length(llfifo_t* fifo) {
+int llfifo_set_sojourn(llfifo_t* fifo, sojourn_hist_t* hist) {
 
-	if (fifo != NULL) {
-		return fifo->length;
-	}
-	else {
-		return EXIT_FAILURE_N;
+	if (fifo == NULL) {
+		return EXIT_FAILURE;
 	}
+
+	llfifo_lock(fifo);
+	fifo->sojourn = hist;
+	llfifo_unlock(fifo);
+
+	return EXIT_SUCCESS;
 }
+#endif
 
+#ifdef FIFO_CODEL
 /**
- * \fn int llfifo_capacity(llfifo_t* fifo)
- * \brief Returns the FIFO's current capacity
+ * \fn int llfifo_set_codel(llfifo_t* fifo, uint64_t target_ns, uint64_t interval_ns, llfifo_drop_t drop, void* ctx)
+ * \brief Turns on CoDel active queue management (RFC 8289). Every enqueue stamps its node, and llfifo_dequeue + llfifo_dequeue_wait watch how long elements waited. Once the shortest wait over interval_ns stays above target_ns, they start dropping the oldest elements through drop, faster the longer the queue stays bad, until waits fall back below target_ns. Keeps latency bounded without a hand-tuned length limit. llfifo_dequeue_batch, llfifo_peek + llfifo_foreach are unaffected. Only built with FIFO_CODEL, so builds without it carry no timestamp at all
  *
  * \param fifo The fifo in question
+ * \param target_ns Acceptable standing wait, typically 5-10% of interval_ns. 0 turns CoDel off
+ * \param interval_ns Window a wait must stay above target_ns in before dropping starts, about one worst-case consumer round trip. Ignored if target_ns is 0
+ * \param drop Called once with each dropped element + ctx, e.g. to free it or fail it back to its sender. In synchronized mode it runs with the lock held, so it must not call llfifo functions on the same FIFO. May be NULL
+ * \param ctx Passed to drop
  *
- * \return Returns the current capacity, in number of elements, for the FIFO
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
  */
-int llfifo_capacity(llfifo_t* fifo) {
+int llfifo_set_codel(llfifo_t* fifo, uint64_t target_ns, uint64_t interval_ns, llfifo_drop_t drop, void* ctx) {
 
-	if (fifo != NULL) {
-		return fifo->capacity;
+	llfifo_codel_t* codel;
+
+	if (fifo == NULL) {
+		return EXIT_FAILURE;
 	}
-	else {
-		return EXIT_FAILURE_N;
+
+	// Ensure the control law's fixed point math can't overflow
+	if ((target_ns != 0) && ((interval_ns == 0) || (interval_ns > (UINT64_MAX / 1024)))) {
+		return EXIT_FAILURE;
+	}
+
+	llfifo_lock(fifo);
+
+	if (target_ns == 0) {
+		if (fifo->codel != NULL) {
+			llfifo_release(fifo, fifo->codel, sizeof(llfifo_codel_t));
+			fifo->codel = NULL;
+		}
+
+		llfifo_unlock(fifo);
+
+		return EXIT_SUCCESS;
+	}
+
+	codel = fifo->codel;
+	if (codel == NULL) {
+		codel = (llfifo_codel_t*)fifo->allocator.alloc(fifo->allocator.ctx, sizeof(llfifo_codel_t));
+		if (codel == NULL) {
+			llfifo_unlock(fifo);
+			return EXIT_FAILURE;
+		}
+
+		codel->dropped = 0;
 	}
+
+	codel->target_ns = target_ns;
+	codel->interval_ns = interval_ns;
+	codel->drop = drop;
+	codel->ctx = ctx;
+	codel->first_above_ns = 0;
+	codel->drop_next_ns = 0;
+	codel->count = 0;
+	codel->lastcount = 0;
+	codel->dropping = 0;
+
+	fifo->codel = codel;
+
+	llfifo_unlock(fifo);
+
+	return EXIT_SUCCESS;
 }
 
 /**
- * \fn void llfifo_destroy(llfifo_t* fifo)
- * \brief Teardown function: Frees all dynamically allocated memory. After calling this function, the fifo should not be used again!
+ * \fn size_t llfifo_codel_dropped(llfifo_t* fifo)
+ * \brief Returns how many elements CoDel has dropped since it was turned on
  *
  * \param fifo The fifo in question
  *
- * \return N/A
+ * \return The number of elements dropped, 0 if CoDel is off, or (size_t)(-1) if fifo is NULL
  */
-void llfifo_destroy(llfifo_t* fifo) {
+size_t llfifo_codel_dropped(llfifo_t* fifo) {
 
-	int i;
-	llnode_t* node_to_destroy;
+	size_t dropped;
 
 	if (fifo == NULL) {
-		return;
+		return EXIT_FAILURE_SZ;
 	}
 
-	// Check if there are any nodes to destroy
-	if (fifo->capacity > 0) {
-		
-		// Destroy all used nodes
-		if (fifo->length > 0) {
+	llfifo_lock(fifo);
+	dropped = (fifo->codel != NULL) ? (fifo->codel->dropped) : (0);
+	llfifo_unlock(fifo);
+
+	return dropped;
+}
+#endif
 
-			for (i = 1; i <= fifo->length; i++) {
+#ifdef FIFO_DEADLINE
+/**
+ * \fn int llfifo_enqueue_deadline(llfifo_t* fifo, void* element, uint64_t deadline_ns)
+ * \brief Same as llfifo_enqueue, but tags the element with a deadline. llfifo_dequeue, llfifo_dequeue_wait + llfifo_dequeue_batch discard it instead of handing it out once the deadline has passed, as part of the dequeue they were already doing, so consumers never see expired work. Only built with FIFO_DEADLINE
+ *
+ * \param fifo The fifo in question
+ * \param element The element to enqueue, which cannot be NULL
+ * \param deadline_ns Time on the sojourn_now_ns() clock after which the element is no longer wanted, e.g. sojourn_now_ns() + budget. 0 means no deadline
+ *
+ * \return If successful, returns the new length of the FIFO, saturated at INT_MAX. If the FIFO is bounded and at its limit, returns LLFIFO_FULL (-2). In the case of an error, or if the FIFO has been closed, the function returns -1
+ */
+int llfifo_enqueue_deadline(llfifo_t* fifo, void* element, uint64_t deadline_ns) {
 
-				node_to_destroy = fifo->tail_used;
+	size_t length;
 
-				// Save next node to destroy
-				fifo->tail_used = fifo->tail_used->next;
+	// Ensure the fifo to enqueue to is valid
+	if (fifo == NULL) {
+		return EXIT_FAILURE_N;
+	}
 
-				free(node_to_destroy);
-			}
+	llfifo_lock(fifo);
 
-			// Ensure all used nodes have been destroyed
-			--i;
-			assert(fifo->length == i);
+	length = (llfifo_accepting(fifo)) ? (llfifo_enqueue_unlocked(fifo, element)) : (EXIT_FAILURE_SZ);
+	if ((length != EXIT_FAILURE_SZ) && (length != LLFIFO_FULL_SZ)) {
 
-			// Update FIFO to reflect destroying all used nodes
-			fifo->capacity = (fifo->capacity - i);
-			fifo->length = (fifo->length - i);
+		// The element just enqueued is always the used head
+		fifo->head_used->deadline_ns = deadline_ns;
+		if (deadline_ns != 0) {
+			fifo->tagged++;
 		}
 
-		// Destroy all free nodes
-		if (fifo->capacity > 0) {
+		llfifo_wake(fifo, 1);
+	}
 
-			for (i = 1; i <= fifo->capacity; i++) {
+	llfifo_unlock(fifo);
 
-				node_to_destroy = fifo->tail_free;
+	if (length == EXIT_FAILURE_SZ) {
+		return EXIT_FAILURE_N;
+	}
+	if (length == LLFIFO_FULL_SZ) {
+		return LLFIFO_FULL;
+	}
 
-				// Save next node to destroy
-				fifo->tail_free = fifo->tail_free->next;
+	return llfifo_int_size(length);
+}
 
-				free(node_to_destroy);
-			}
+/**
+ * \fn int llfifo_set_reject(llfifo_t* fifo, llfifo_drop_t reject, void* ctx)
+ * \brief Sets the callback that receives elements discarded for missing their deadline, e.g. to free them or fail them back to whoever sent them
+ *
+ * \param fifo The fifo in question
+ * \param reject Called once with each expired element + ctx. In synchronized mode it runs with the lock held, so it must not call llfifo functions on the same FIFO. NULL discards silently
+ * \param ctx Passed to reject
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int llfifo_set_reject(llfifo_t* fifo, llfifo_drop_t reject, void* ctx) {
+
+	if (fifo == NULL) {
+		return EXIT_FAILURE;
+	}
 
-			// Ensure all free nodes have been destroyed
-			--i;
-			assert(fifo->capacity == i);
+	llfifo_lock(fifo);
+	fifo->reject = reject;
+	fifo->reject_ctx = ctx;
+	llfifo_unlock(fifo);
 
-			// Update FIFO to reflect destroying all free nodes
-			fifo->capacity = (fifo->capacity - i);
-		}
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int llfifo_deadline_stats(llfifo_t* fifo, llfifo_deadline_stats_t* stats)
+ * \brief Reads the FIFO's deadline counters
+ *
+ * \param fifo The fifo in question
+ * \param stats Filled in with the counters
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int llfifo_deadline_stats(llfifo_t* fifo, llfifo_deadline_stats_t* stats) {
 
+	if ((fifo == NULL) || (stats == NULL)) {
+		return EXIT_FAILURE;
 	}
 
-	// Ensure all nodes have been destroyed
-	assert(fifo->capacity == 0);
+	llfifo_lock(fifo);
+	stats->tagged = fifo->tagged;
+	stats->expired = fifo->expired;
+	llfifo_unlock(fifo);
 
-	// Destroy FIFO only after all nodes have been destroyed
-	free(fifo);
-}
\ No newline at end of file
+	return EXIT_SUCCESS;
+}
+#endif
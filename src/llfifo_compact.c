@@ -0,0 +1,287 @@
+/**
+ * \file llfifo_compact.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "llfifo_compact.h"
+
+#define EXIT_FAILURE_N ((size_t)(-1))
+
+#define LLFIFO_COMPACT_NONE ((uint32_t)(UINT32_MAX))
+#define LLFIFO_COMPACT_MAX_NODES ((size_t)(UINT32_MAX))
+
+/**
+ * \struct llfifo_compact_s
+ * \brief Same free list + used list scheme as llfifo_s, but nodes are slots in two parallel arrays instead of separately allocated structs. Slot i's element is data[i] and the slot after it (towards the head) is next[i]. There are no previous links
+ *
+ * \detail void** data - Element stored in each slot
+ * \detail uint32_t* next - Index of the slot next in the list (towards the head). If LLFIFO_COMPACT_NONE then the slot is the head of its list
+ * \detail uint32_t head_free - Index of head slot of free list. If LLFIFO_COMPACT_NONE then the list of free slots is empty
+ * \detail uint32_t tail_free - Index of tail slot of free list, which is the next one to be used. If LLFIFO_COMPACT_NONE then the list of free slots is empty
+ * \detail uint32_t head_used - Index of head slot of used list. If LLFIFO_COMPACT_NONE then the list of used slots is empty
+ * \detail uint32_t tail_used - Index of tail slot of used list, which is the next one to be dequeued. If LLFIFO_COMPACT_NONE then the list of used slots is empty
+ * \detail size_t capacity - The total number of slots between both free list + used list that memory has been allocated for
+ * \detail size_t length - The number of slots currently in the used list
+ */
+struct llfifo_compact_s {
+	void** data;
+	uint32_t* next;
+	uint32_t head_free;
+	uint32_t tail_free;
+	uint32_t head_used;
+	uint32_t tail_used;
+	size_t capacity;
+	size_t length;
+};
+
+/**
+ * \fn static int llfifo_compact_grow(llfifo_compact_t* fifo, size_t new_capacity)
+ * \brief Grows both slot arrays to new_capacity and appends the new slots to the free head. Existing indices stay valid since slots are addressed by index, not pointer
+ *
+ * \param fifo The fifo in question
+ * \param new_capacity Total number of slots wanted. Must be greater than the current capacity
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the FIFO is left as it was and the function returns EXIT_FAILURE (1)
+ */
+static int llfifo_compact_grow(llfifo_compact_t* fifo, size_t new_capacity) {
+
+	size_t i;
+	void** new_data;
+	uint32_t* new_next;
+
+	// Ensure every slot stays addressable by a 32-bit index, with one value left over for LLFIFO_COMPACT_NONE
+	if (new_capacity > LLFIFO_COMPACT_MAX_NODES) {
+		return EXIT_FAILURE;
+	}
+
+	new_data = (void**)realloc(fifo->data, new_capacity * sizeof(void*));
+	if (new_data == NULL) {
+		return EXIT_FAILURE;
+	}
+	fifo->data = new_data;
+
+	new_next = (uint32_t*)realloc(fifo->next, new_capacity * sizeof(uint32_t));
+	if (new_next == NULL) {
+		return EXIT_FAILURE;
+	}
+	fifo->next = new_next;
+
+	// Link the new slots to each other, tail to head
+	for (i = fifo->capacity; i < new_capacity; i++) {
+		fifo->data[i] = NULL;
+		fifo->next[i] = (i == (new_capacity - 1)) ? (LLFIFO_COMPACT_NONE) : ((uint32_t)(i + 1));
+	}
+
+	// Special case of inserting run into empty free list
+	if (fifo->head_free == LLFIFO_COMPACT_NONE) {
+		fifo->tail_free = (uint32_t)(fifo->capacity);
+	}
+
+	// Generic case of inserting run into free list containing at least 1 free slot
+	else {
+		fifo->next[fifo->head_free] = (uint32_t)(fifo->capacity);
+	}
+
+	fifo->head_free = (uint32_t)(new_capacity - 1);
+	fifo->capacity = new_capacity;
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn llfifo_compact_t* llfifo_compact_create(size_t capacity)
+ * \brief Creates and initializes the FIFO
+ *
+ * \param capacity Initial size of the FIFO, in number of elements. Valid values are in the range of 0 to UINT32_MAX
+ *
+ * \return If successful, returns pointer to a newly-created llfifo_compact_t instance. In the case of an error, the function returns NULL
+ */
+llfifo_compact_t* llfifo_compact_create(size_t capacity) {
+
+	llfifo_compact_t* fifo;
+
+	fifo = (llfifo_compact_t*)malloc(sizeof(llfifo_compact_t));
+	if (fifo == NULL) {
+		return NULL;
+	}
+
+	// Initialize FIFO for size 0
+	fifo->data = NULL;
+	fifo->next = NULL;
+	fifo->head_free = LLFIFO_COMPACT_NONE;
+	fifo->tail_free = LLFIFO_COMPACT_NONE;
+	fifo->head_used = LLFIFO_COMPACT_NONE;
+	fifo->tail_used = LLFIFO_COMPACT_NONE;
+	fifo->capacity = 0;
+	fifo->length = 0;
+
+	if (capacity > 0) {
+		if (llfifo_compact_grow(fifo, capacity) != EXIT_SUCCESS) {
+			llfifo_compact_destroy(fifo);
+			return NULL;
+		}
+	}
+
+	return fifo;
+}
+
+/**
+ * \fn size_t llfifo_compact_enqueue(llfifo_compact_t* fifo, void* element)
+ * \brief Enqueues an element onto the FIFO. When no free slots are left the slot arrays double in size, since growing them one slot at a time would copy the whole queue on every enqueue
+ *
+ * \param fifo The fifo in question
+ * \param element The element to enqueue, which cannot be NULL
+ *
+ * \return If successful, returns the new length of the FIFO. In the case of an error, the function returns (size_t)(-1)
+ */
+size_t llfifo_compact_enqueue(llfifo_compact_t* fifo, void* element) {
+
+	size_t new_capacity;
+	uint32_t slot;
+
+	// Ensure the fifo + element are valid
+	if ((fifo == NULL) || (element == NULL)) {
+		return EXIT_FAILURE_N;
+	}
+
+	// Grow the slot arrays if no free slots are available
+	if (fifo->length == fifo->capacity) {
+
+		new_capacity = (fifo->capacity == 0) ? (1) : (fifo->capacity * 2);
+		if (new_capacity > LLFIFO_COMPACT_MAX_NODES) {
+			new_capacity = LLFIFO_COMPACT_MAX_NODES;
+		}
+
+		if ((new_capacity == fifo->capacity) || (llfifo_compact_grow(fifo, new_capacity) != EXIT_SUCCESS)) {
+			return EXIT_FAILURE_N;
+		}
+	}
+
+	// Grab the free tail
+	slot = fifo->tail_free;
+	fifo->tail_free = fifo->next[slot];
+
+	// Special case of free list becoming empty after grabbing this free slot
+	if (fifo->tail_free == LLFIFO_COMPACT_NONE) {
+		fifo->head_free = LLFIFO_COMPACT_NONE;
+	}
+
+	fifo->data[slot] = element;
+	fifo->next[slot] = LLFIFO_COMPACT_NONE;
+
+	// Special case of inserting into empty used list
+	if (fifo->length == 0) {
+		fifo->tail_used = slot;
+	}
+
+	// Generic case of inserting into used list containing at least 1 used slot
+	else {
+		fifo->next[fifo->head_used] = slot;
+	}
+
+	fifo->head_used = slot;
+	fifo->length++;
+
+	return fifo->length;
+}
+
+/**
+ * \fn void* llfifo_compact_dequeue(llfifo_compact_t* fifo)
+ * \brief Removes ("dequeues") an element from the FIFO, and returns it
+ *
+ * \param fifo The fifo in question
+ *
+ * \return If successful, returns the dequeued element, or NULL if the FIFO was empty
+ */
+void* llfifo_compact_dequeue(llfifo_compact_t* fifo) {
+
+	uint32_t slot;
+
+	// Ensure the fifo is valid + has at least 1 used slot to dequeue
+	if ((fifo == NULL) || (fifo->length == 0)) {
+		return NULL;
+	}
+
+	// Grab the used tail
+	slot = fifo->tail_used;
+	fifo->tail_used = fifo->next[slot];
+
+	// Special case of used list becoming empty after grabbing this used slot
+	if (fifo->tail_used == LLFIFO_COMPACT_NONE) {
+		fifo->head_used = LLFIFO_COMPACT_NONE;
+	}
+
+	fifo->next[slot] = LLFIFO_COMPACT_NONE;
+
+	// Special case of inserting into empty free list
+	if (fifo->head_free == LLFIFO_COMPACT_NONE) {
+		fifo->tail_free = slot;
+	}
+
+	// Generic case of inserting into free list containing at least 1 free slot
+	else {
+		fifo->next[fifo->head_free] = slot;
+	}
+
+	fifo->head_free = slot;
+	fifo->length--;
+
+	return fifo->data[slot];
+}
+
+/**
+ * \fn size_t llfifo_compact_length(llfifo_compact_t* fifo)
+ * \brief Returns the number of elements currently on the FIFO.
+ *
+ * \param fifo The fifo in question
+ *
+ * \return Returns the number of elements currently on the FIFO, or (size_t)(-1) if fifo is NULL
+ */
+size_t llfifo_compact_length(llfifo_compact_t* fifo) {
+
+	if (fifo != NULL) {
+		return fifo->length;
+	}
+	else {
+		return EXIT_FAILURE_N;
+	}
+}
+
+/**
+ * \fn size_t llfifo_compact_capacity(llfifo_compact_t* fifo)
+ * \brief Returns the FIFO's current capacity
+ *
+ * \param fifo The fifo in question
+ *
+ * \return Returns the current capacity, in number of elements, or (size_t)(-1) if fifo is NULL
+ */
+size_t llfifo_compact_capacity(llfifo_compact_t* fifo) {
+
+	if (fifo != NULL) {
+		return fifo->capacity;
+	}
+	else {
+		return EXIT_FAILURE_N;
+	}
+}
+
+/**
+ * \fn void llfifo_compact_destroy(llfifo_compact_t* fifo)
+ * \brief Teardown function: Frees all dynamically allocated memory. After calling this function, the fifo should not be used again!
+ *
+ * \param fifo The fifo in question
+ *
+ * \return N/A
+ */
+void llfifo_compact_destroy(llfifo_compact_t* fifo) {
+
+	if (fifo == NULL) {
+		return;
+	}
+
+	free(fifo->data);
+	free(fifo->next);
+	free(fifo);
+}
@@ -2,11 +2,32 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include "cbfifo.h"
+#include "drrsched.h"
+#include "executor.h"
+#include "ilfifo.h"
 #include "llfifo.h"
+#include "llfifo_compact.h"
+#include "llfifo_static.h"
+#include "mcring.h"
+#include "nodepool.h"
+#include "priofifo.h"
+#include "wsdeque.h"
 #include "test_cbfifo.h"
+#include "test_drrsched.h"
+#include "test_executor.h"
+#include "test_ilfifo.h"
 #include "test_llfifo.h"
+#include "test_llfifo_compact.h"
+#include "test_llfifo_static.h"
+#include "test_mcring.h"
+#include "test_nodepool.h"
+#include "test_priofifo.h"
+#include "test_sojourn.h"
+#include "test_wsdeque.h"
 
+#ifndef CB_SIZE
 #define CB_SIZE ((size_t)(128))
+#endif
 #define LL_SIZE ((int)(3))
 
 /**
@@ -48,6 +69,16 @@ int main(void) {
 	// might be tough to see the success/error messages for the first of llfifo or cbfifo between them
 	test_llfifo();
 	test_cbfifo();
+	test_ilfifo();
+	test_nodepool();
+	test_llfifo_compact();
+	test_llfifo_static();
+	test_wsdeque();
+	test_executor();
+	test_sojourn();
+	test_priofifo();
+	test_drrsched();
+	test_mcring();
 
 	return EXIT_SUCCESS;
 }
\ No newline at end of file
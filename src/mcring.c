@@ -0,0 +1,451 @@
+/**
+ * \file mcring.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mcring.h"
+
+#define EXIT_FAILURE_N ((size_t)(-1))
+
+// States of a consumer slot. Only the producer moves a slot to DETACHED, and only the consumer moves it out of READING
+#define MCRING_FREE ((int)(0))
+#define MCRING_CLAIMED ((int)(1))
+#define MCRING_ACTIVE ((int)(2))
+#define MCRING_READING ((int)(3))
+#define MCRING_GONE ((int)(4))
+
+/**
+ * \typedef mcring_cursor_t
+ * \brief Allows struct mcring_cursor_s to be instantiated as mcring_cursor_t
+ */
+typedef struct mcring_cursor_s mcring_cursor_t;
+
+/**
+ * \struct mcring_cursor_s
+ * \brief One consumer's read cursor, on a cache line of its own so consumers advancing side by side don't slow each other down
+ *
+ * \detail _Atomic uint64_t position - Total bytes this consumer has read since the ring was created. Only its consumer writes this
+ * \detail _Atomic int state - MCRING_FREE, MCRING_CLAIMED (being subscribed), MCRING_ACTIVE, MCRING_READING (copying out, so the producer can't detach it) or MCRING_GONE (detached)
+ */
+struct mcring_cursor_s {
+	_Alignas(64) _Atomic uint64_t position;
+	_Atomic int state;
+};
+
+/**
+ * \struct mcring_s
+ * \brief Byte buffer + one write position + one read position per consumer. Positions only ever increase, and byte i of the stream lives at buf[i & mask]
+ *
+ * \detail uint8_t* buf - The buffer. capacity bytes large
+ * \detail size_t capacity - Bytes the buffer holds. Always a power of 2
+ * \detail size_t mask - capacity - 1
+ * \detail mcring_policy_t policy - What mcring_enqueue does when the slowest consumer hasn't made room yet
+ * \detail uint64_t slowest - Producer only. Position of the slowest consumer when the cursors were last looked at. Cursors only move forward, so this is never ahead of any of them, and the cursors are only looked at again once it doesn't leave room for a write
+ * \detail _Atomic uint64_t head - Total bytes written since the ring was created. Only the producer writes this
+ * \detail mcring_cursor_t cursors[MCRING_MAX_CONSUMERS] - One slot per consumer, found by index
+ */
+struct mcring_s {
+	uint8_t* buf;
+	size_t capacity;
+	size_t mask;
+	mcring_policy_t policy;
+	uint64_t slowest;
+	_Alignas(64) _Atomic uint64_t head;
+	mcring_cursor_t cursors[MCRING_MAX_CONSUMERS];
+};
+
+/**
+ * \fn static void mcring_cpu_relax()
+ * \brief Tells the CPU we are in a spin loop, so a sibling hyperthread gets the core for a moment
+ *
+ * \return N/A
+ */
+static void mcring_cpu_relax() {
+
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * \fn static int mcring_live(int state)
+ * \brief Whether a slot in this state holds the producer back
+ *
+ * \param state State of the slot
+ *
+ * \return 1 if the slot is MCRING_ACTIVE or MCRING_READING, else 0
+ */
+static int mcring_live(int state) {
+
+	return (state == MCRING_ACTIVE) || (state == MCRING_READING);
+}
+
+/**
+ * \fn static uint64_t mcring_slowest(mcring_t* ring, uint64_t head)
+ * \brief Producer only: finds the position of the slowest subscribed consumer
+ *
+ * \param ring The ring in question
+ * \param head The producer's current write position
+ *
+ * \return Position of the slowest consumer, or head if there are none
+ */
+static uint64_t mcring_slowest(mcring_t* ring, uint64_t head) {
+
+	int i;
+	uint64_t position;
+	uint64_t slowest = head;
+
+	// Pairs with mcring_subscribe: a consumer this scan misses is guaranteed to see the head written before it
+	atomic_thread_fence(memory_order_seq_cst);
+
+	for (i = 0; i < MCRING_MAX_CONSUMERS; i++) {
+		if (mcring_live(atomic_load_explicit(&(ring->cursors[i].state), memory_order_acquire))) {
+			position = atomic_load_explicit(&(ring->cursors[i].position), memory_order_acquire);
+			if ((head - position) > (head - slowest)) {
+				slowest = position;
+			}
+		}
+	}
+
+	return slowest;
+}
+
+/**
+ * \fn static void mcring_detach_slow(mcring_t* ring, uint64_t head, size_t nbyte)
+ * \brief Producer only: detaches every consumer too far behind for nbyte more bytes to fit. A consumer in the middle of a read is waited for, since it may catch up, and its bytes can't be overwritten under it
+ *
+ * \param ring The ring in question
+ * \param head The producer's current write position
+ * \param nbyte Bytes about to be written, no more than capacity
+ *
+ * \return N/A
+ */
+static void mcring_detach_slow(mcring_t* ring, uint64_t head, size_t nbyte) {
+
+	int i;
+	int state;
+	uint64_t position;
+
+	for (i = 0; i < MCRING_MAX_CONSUMERS; i++) {
+		for (;;) {
+			state = atomic_load_explicit(&(ring->cursors[i].state), memory_order_acquire);
+			if (!mcring_live(state)) {
+				break;
+			}
+
+			position = atomic_load_explicit(&(ring->cursors[i].position), memory_order_acquire);
+			if ((head + nbyte - position) <= ring->capacity) {
+				break;
+			}
+
+			if ((state == MCRING_ACTIVE) && atomic_compare_exchange_strong_explicit(&(ring->cursors[i].state), &state, MCRING_GONE, memory_order_acq_rel, memory_order_acquire)) {
+				break;
+			}
+
+			mcring_cpu_relax();
+		}
+	}
+}
+
+/**
+ * \fn mcring_t* mcring_create(size_t capacity, mcring_policy_t policy)
+ * \brief Creates and initializes an empty ring with no consumers
+ *
+ * \param capacity Bytes the ring can hold, at least 1. Rounded up to a power of 2
+ * \param policy MCRING_WAIT_SLOWEST or MCRING_DETACH_SLOW
+ *
+ * \return If successful, returns pointer to a newly-created mcring_t instance. In the case of an error, the function returns NULL
+ */
+mcring_t* mcring_create(size_t capacity, mcring_policy_t policy) {
+
+	int i;
+	size_t size = 1;
+	mcring_t* ring;
+
+	if ((capacity == 0) || ((policy != MCRING_WAIT_SLOWEST) && (policy != MCRING_DETACH_SLOW))) {
+		return NULL;
+	}
+
+	// Round up to a power of 2 so indexing is a mask instead of a modulo
+	while (size < capacity) {
+		if (size > (SIZE_MAX / 2)) {
+			return NULL;
+		}
+		size *= 2;
+	}
+
+	ring = (mcring_t*)aligned_alloc(64, (sizeof(mcring_t) + 63) & ~((size_t)(63)));
+	if (ring == NULL) {
+		return NULL;
+	}
+
+	ring->buf = (uint8_t*)malloc(size);
+	if (ring->buf == NULL) {
+		free(ring);
+		return NULL;
+	}
+
+	ring->capacity = size;
+	ring->mask = size - 1;
+	ring->policy = policy;
+	ring->slowest = 0;
+	atomic_init(&(ring->head), 0);
+
+	for (i = 0; i < MCRING_MAX_CONSUMERS; i++) {
+		atomic_init(&(ring->cursors[i].position), 0);
+		atomic_init(&(ring->cursors[i].state), MCRING_FREE);
+	}
+
+	return ring;
+}
+
+/**
+ * \fn int mcring_subscribe(mcring_t* ring)
+ * \brief Registers a consumer. It starts at the current write position, so it reads every byte written from now on. Safe to call while the producer is writing
+ *
+ * \param ring The ring in question
+ *
+ * \return If successful, returns the consumer's index, from 0 to MCRING_MAX_CONSUMERS - 1. If ring is NULL or every slot is taken, returns -1
+ */
+int mcring_subscribe(mcring_t* ring) {
+
+	int i;
+	int state;
+
+	if (ring == NULL) {
+		return -1;
+	}
+
+	for (i = 0; i < MCRING_MAX_CONSUMERS; i++) {
+		state = MCRING_FREE;
+		if (atomic_compare_exchange_strong_explicit(&(ring->cursors[i].state), &state, MCRING_CLAIMED, memory_order_acquire, memory_order_relaxed)) {
+
+			atomic_store_explicit(&(ring->cursors[i].position), atomic_load_explicit(&(ring->head), memory_order_acquire), memory_order_relaxed);
+			atomic_store_explicit(&(ring->cursors[i].state), MCRING_ACTIVE, memory_order_seq_cst);
+
+			// A write that looked at the cursors before this one went live may still publish. Start after whatever it publishes, which the producer's fence guarantees this load sees
+			atomic_store_explicit(&(ring->cursors[i].position), atomic_load_explicit(&(ring->head), memory_order_seq_cst), memory_order_release);
+
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * \fn int mcring_unsubscribe(mcring_t* ring, int consumer)
+ * \brief Releases a consumer's slot, whether it is still subscribed or was detached. The producer stops waiting on it straight away. Only the consumer itself should call this
+ *
+ * \param ring The ring in question
+ * \param consumer Index returned by mcring_subscribe
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int mcring_unsubscribe(mcring_t* ring, int consumer) {
+
+	int state;
+
+	if ((ring == NULL) || (consumer < 0) || (consumer >= MCRING_MAX_CONSUMERS)) {
+		return EXIT_FAILURE;
+	}
+
+	// The producer may detach it in between, so try both
+	state = MCRING_ACTIVE;
+	if (atomic_compare_exchange_strong_explicit(&(ring->cursors[consumer].state), &state, MCRING_FREE, memory_order_release, memory_order_relaxed)) {
+		return EXIT_SUCCESS;
+	}
+
+	state = MCRING_GONE;
+	if (atomic_compare_exchange_strong_explicit(&(ring->cursors[consumer].state), &state, MCRING_FREE, memory_order_release, memory_order_relaxed)) {
+		return EXIT_SUCCESS;
+	}
+
+	return EXIT_FAILURE;
+}
+
+/**
+ * \fn size_t mcring_enqueue(mcring_t* ring, void* buf, size_t nbyte)
+ * \brief Producer only: writes data once for every consumer. Under MCRING_WAIT_SLOWEST, writes only as much as the slowest consumer has made room for. Under MCRING_DETACH_SLOW, first detaches any consumer too far behind for all of it to fit. Never writes more than the capacity
+ *
+ * \param ring The ring in question
+ * \param buf Pointer to the data
+ * \param nbyte Max number of bytes to write
+ *
+ * \return If successful, returns the number of bytes actually written, which could be 0. In case of an error, returns (size_t)(-1)
+ */
+size_t mcring_enqueue(mcring_t* ring, void* buf, size_t nbyte) {
+
+	size_t first;
+	size_t offset;
+	uint64_t head;
+
+	if ((ring == NULL) || (buf == NULL)) {
+		return EXIT_FAILURE_N;
+	}
+
+	head = atomic_load_explicit(&(ring->head), memory_order_relaxed);
+	nbyte = (nbyte < ring->capacity) ? (nbyte) : (ring->capacity);
+
+	// The cursors are only looked at when the last known slowest one doesn't leave room
+	if ((ring->capacity - (size_t)(head - ring->slowest)) < nbyte) {
+		if (ring->policy == MCRING_DETACH_SLOW) {
+			mcring_detach_slow(ring, head, nbyte);
+		}
+		ring->slowest = mcring_slowest(ring, head);
+	}
+
+	if ((ring->capacity - (size_t)(head - ring->slowest)) < nbyte) {
+		nbyte = ring->capacity - (size_t)(head - ring->slowest);
+	}
+
+	// Copy in up to the end of buf, then wrap around to the start
+	offset = (size_t)(head) & ring->mask;
+	first = (nbyte < (ring->capacity - offset)) ? (nbyte) : (ring->capacity - offset);
+	memcpy(ring->buf + offset, buf, first);
+	memcpy(ring->buf, (uint8_t*)(buf) + first, nbyte - first);
+
+	atomic_store_explicit(&(ring->head), head + nbyte, memory_order_release);
+
+	return nbyte;
+}
+
+/**
+ * \fn size_t mcring_dequeue(mcring_t* ring, int consumer, void* buf, size_t nbyte)
+ * \brief Reads data through one consumer's cursor, without affecting any other consumer. Each consumer may run on its own thread, but only one thread may read through a given cursor
+ *
+ * \param ring The ring in question
+ * \param consumer Index returned by mcring_subscribe
+ * \param buf Destination for the data
+ * \param nbyte Max number of bytes to read
+ *
+ * \return If successful, returns the number of bytes actually read, which could be 0. If the producer detached the consumer, returns MCRING_DETACHED. In case of an error, returns (size_t)(-1)
+ */
+size_t mcring_dequeue(mcring_t* ring, int consumer, void* buf, size_t nbyte) {
+
+	int state;
+	size_t first;
+	size_t offset;
+	size_t length;
+	uint64_t position;
+	mcring_cursor_t* cursor;
+
+	if ((ring == NULL) || (consumer < 0) || (consumer >= MCRING_MAX_CONSUMERS) || (buf == NULL)) {
+		return EXIT_FAILURE_N;
+	}
+
+	cursor = &(ring->cursors[consumer]);
+
+	// Hold the cursor for the copy, so the producer can't detach it + overwrite the bytes being read
+	state = MCRING_ACTIVE;
+	if (!atomic_compare_exchange_strong_explicit(&(cursor->state), &state, MCRING_READING, memory_order_acquire, memory_order_acquire)) {
+		return (state == MCRING_GONE) ? (MCRING_DETACHED) : (EXIT_FAILURE_N);
+	}
+
+	position = atomic_load_explicit(&(cursor->position), memory_order_relaxed);
+	length = (size_t)(atomic_load_explicit(&(ring->head), memory_order_acquire) - position);
+	nbyte = (nbyte < length) ? (nbyte) : (length);
+
+	// Copy out up to the end of buf, then wrap around to the start
+	offset = (size_t)(position) & ring->mask;
+	first = (nbyte < (ring->capacity - offset)) ? (nbyte) : (ring->capacity - offset);
+	memcpy(buf, ring->buf + offset, first);
+	memcpy((uint8_t*)(buf) + first, ring->buf, nbyte - first);
+
+	atomic_store_explicit(&(cursor->position), position + nbyte, memory_order_release);
+	atomic_store_explicit(&(cursor->state), MCRING_ACTIVE, memory_order_release);
+
+	return nbyte;
+}
+
+/**
+ * \fn size_t mcring_length(mcring_t* ring, int consumer)
+ * \brief Returns the number of bytes one consumer has yet to read
+ *
+ * \param ring The ring in question
+ * \param consumer Index returned by mcring_subscribe
+ *
+ * \return The consumer's unread bytes. If the producer detached the consumer, returns MCRING_DETACHED. In case of an error, returns (size_t)(-1)
+ */
+size_t mcring_length(mcring_t* ring, int consumer) {
+
+	int state;
+
+	if ((ring == NULL) || (consumer < 0) || (consumer >= MCRING_MAX_CONSUMERS)) {
+		return EXIT_FAILURE_N;
+	}
+
+	state = atomic_load_explicit(&(ring->cursors[consumer].state), memory_order_acquire);
+	if (state == MCRING_GONE) {
+		return MCRING_DETACHED;
+	}
+	if (!mcring_live(state)) {
+		return EXIT_FAILURE_N;
+	}
+
+	return (size_t)(atomic_load_explicit(&(ring->head), memory_order_acquire) - atomic_load_explicit(&(ring->cursors[consumer].position), memory_order_relaxed));
+}
+
+/**
+ * \fn size_t mcring_space(mcring_t* ring)
+ * \brief Producer only: returns how many bytes mcring_enqueue could write right now without detaching anyone, as allowed by the slowest consumer
+ *
+ * \param ring The ring in question
+ *
+ * \return The free space in bytes, or (size_t)(-1) if ring is NULL
+ */
+size_t mcring_space(mcring_t* ring) {
+
+	uint64_t head;
+
+	if (ring == NULL) {
+		return EXIT_FAILURE_N;
+	}
+
+	head = atomic_load_explicit(&(ring->head), memory_order_relaxed);
+	ring->slowest = mcring_slowest(ring, head);
+
+	return ring->capacity - (size_t)(head - ring->slowest);
+}
+
+/**
+ * \fn size_t mcring_capacity(mcring_t* ring)
+ * \brief Returns the number of bytes the ring can hold
+ *
+ * \param ring The ring in question
+ *
+ * \return The capacity after rounding up to a power of 2, or (size_t)(-1) if ring is NULL
+ */
+size_t mcring_capacity(mcring_t* ring) {
+
+	if (ring != NULL) {
+		return ring->capacity;
+	}
+	else {
+		return EXIT_FAILURE_N;
+	}
+}
+
+/**
+ * \fn void mcring_destroy(mcring_t* ring)
+ * \brief Teardown function: Frees all dynamically allocated memory. The producer + every consumer must be done with the ring first. After calling this function, the ring should not be used again!
+ *
+ * \param ring The ring in question
+ *
+ * \return N/A
+ */
+void mcring_destroy(mcring_t* ring) {
+
+	if (ring == NULL) {
+		return;
+	}
+
+	free(ring->buf);
+	free(ring);
+}
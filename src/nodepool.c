@@ -0,0 +1,541 @@
+/**
+ * \file nodepool.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "nodepool.h"
+
+#define EXIT_FAILURE_N ((int)(-1))
+
+#define NODEPOOL_MAGAZINE ((int)(64))
+#define NODEPOOL_CACHES ((int)(4))
+#define NODEPOOL_DEFAULT_BLOCK ((int)(256))
+
+/**
+ * \typedef nodepool_object_t
+ * \brief Allows struct nodepool_object_s to be instantiated as nodepool_object_t
+ */
+typedef struct nodepool_object_s nodepool_object_t;
+
+/**
+ * \struct nodepool_object_s
+ * \brief Overlay on a free object. While an object sits in the depot its first word links it to the next free object
+ *
+ * \detail nodepool_object_t* next - Points to next free object in the depot. If NULL then this is the last one
+ */
+struct nodepool_object_s {
+	nodepool_object_t* next;
+};
+
+/**
+ * \typedef nodepool_block_t
+ * \brief Allows struct nodepool_block_s to be instantiated as nodepool_block_t
+ */
+typedef struct nodepool_block_s nodepool_block_t;
+
+/**
+ * \struct nodepool_block_s
+ * \brief Header in front of each contiguous block of objects. Blocks are only ever freed when the pool is destroyed
+ *
+ * \detail nodepool_block_t* next - Points to the next block owned by the pool. If NULL then this is the last block
+ */
+struct nodepool_block_s {
+	nodepool_block_t* next;
+};
+
+/**
+ * \struct nodepool_s
+ * \brief Shared depot of free objects. Threads normally go through their own magazine cache for the pool and only touch the depot (under lock) to refill or flush half a magazine at a time
+ *
+ * \detail pthread_mutex_t lock - Protects every field below except object_size, block_objects + id, which never change
+ * \detail nodepool_object_t* depot - Points to first free object in the depot. If NULL then the depot is empty
+ * \detail nodepool_block_t* blocks - Points to the most recently allocated block
+ * \detail size_t object_size - Size of each object, rounded up so every object is pointer aligned
+ * \detail int block_objects - Number of objects allocated at a time when the depot runs dry
+ * \detail size_t allocated - Total number of objects ever allocated by the pool
+ * \detail unsigned long id - Unique id, so a thread cache can tell a live pool from a destroyed one reusing the same address
+ * \detail nodepool_t* next_live - Points to next pool in the list of live pools
+ */
+struct nodepool_s {
+	pthread_mutex_t lock;
+	nodepool_object_t* depot;
+	nodepool_block_t* blocks;
+	size_t object_size;
+	int block_objects;
+	size_t allocated;
+	unsigned long id;
+	nodepool_t* next_live;
+};
+
+/**
+ * \typedef nodepool_cache_t
+ * \brief Allows struct nodepool_cache_s to be instantiated as nodepool_cache_t
+ */
+typedef struct nodepool_cache_s nodepool_cache_t;
+
+/**
+ * \struct nodepool_cache_s
+ * \brief Per-thread magazine of free objects for one pool. Each thread keeps NODEPOOL_CACHES of them, so a thread moving between a few pools keeps a warm magazine for each. Get + put hit only this, with no locking
+ *
+ * \detail nodepool_t* pool - The pool these objects belong to. If NULL then the cache is unused
+ * \detail unsigned long id - Id of that pool when the cache was filled
+ * \detail unsigned long used - Value of nodepool_cache_clock when the magazine was last bound, so the least recently used one is evicted first
+ * \detail int count - Number of objects currently in the magazine
+ * \detail void* objects[NODEPOOL_MAGAZINE] - The cached objects
+ */
+struct nodepool_cache_s {
+	nodepool_t* pool;
+	unsigned long id;
+	unsigned long used;
+	int count;
+	void* objects[NODEPOOL_MAGAZINE];
+};
+
+/**
+ * \var nodepool_cache_t nodepool_cache[NODEPOOL_CACHES]
+ * \brief This thread's magazines, one per pool it used most recently
+ */
+static _Thread_local nodepool_cache_t nodepool_cache[NODEPOOL_CACHES];
+
+/**
+ * \var unsigned long nodepool_cache_clock
+ * \brief Bumped on every bind, to order this thread's magazines by last use
+ */
+static _Thread_local unsigned long nodepool_cache_clock;
+
+/**
+ * \var nodepool_cache_key
+ * \brief Key whose destructor hands an exiting thread's magazines back, created once by the first thread to bind a magazine. nodepool_cache_registered records whether this thread has set it yet
+ */
+static pthread_once_t nodepool_cache_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t nodepool_cache_key;
+static int nodepool_cache_key_ok = 0;
+static _Thread_local int nodepool_cache_registered = 0;
+
+/**
+ * \var nodepool_live
+ * \brief All pools that have been created and not yet destroyed, along with the lock protecting the list + id counter
+ */
+static pthread_mutex_t nodepool_live_lock = PTHREAD_MUTEX_INITIALIZER;
+static nodepool_t* nodepool_live = NULL;
+static unsigned long nodepool_next_id = 1;
+
+/**
+ * \fn static int nodepool_grow(nodepool_t* pool, int count)
+ * \brief Allocates a block of count objects and pushes them all onto the depot. Caller must hold pool->lock
+ *
+ * \param pool The pool in question
+ * \param count Number of objects to add
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+static int nodepool_grow(nodepool_t* pool, int count) {
+
+	int i;
+	nodepool_block_t* new_block;
+	nodepool_object_t* object;
+	char* objects;
+
+	// Ensure the block size can be represented without overflowing
+	if ((size_t)(count) > ((SIZE_MAX - sizeof(nodepool_block_t)) / pool->object_size)) {
+		return EXIT_FAILURE;
+	}
+
+	new_block = (nodepool_block_t*)malloc(sizeof(nodepool_block_t) + ((size_t)(count) * pool->object_size));
+	if (new_block == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	new_block->next = pool->blocks;
+	pool->blocks = new_block;
+
+	// Objects start right after the header, which is pointer sized so they stay pointer aligned
+	objects = (char*)(new_block + 1);
+	for (i = 0; i < count; i++) {
+		object = (nodepool_object_t*)(objects + ((size_t)(i) * pool->object_size));
+		object->next = pool->depot;
+		pool->depot = object;
+	}
+
+	pool->allocated += count;
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn static void nodepool_cache_flush(nodepool_cache_t* cache, int count)
+ * \brief Moves count objects from the top of the magazine back to the depot of the magazine's pool. Caller must hold that pool's lock
+ *
+ * \param cache The magazine in question
+ * \param count Number of objects to move
+ *
+ * \return N/A
+ */
+static void nodepool_cache_flush(nodepool_cache_t* cache, int count) {
+
+	nodepool_object_t* object;
+
+	while (count > 0) {
+		object = (nodepool_object_t*)(cache->objects[--(cache->count)]);
+		object->next = cache->pool->depot;
+		cache->pool->depot = object;
+		count--;
+	}
+}
+
+/**
+ * \fn static void nodepool_cache_release(nodepool_cache_t* cache)
+ * \brief Gives everything in a magazine back to its pool, but only if that pool is still alive. Objects cached for a pool that has since been destroyed are dropped, since their memory went away with that pool. Leaves the magazine unused
+ *
+ * \param cache The magazine in question
+ *
+ * \return N/A
+ */
+static void nodepool_cache_release(nodepool_cache_t* cache) {
+
+	nodepool_t* live;
+
+	if ((cache->pool != NULL) && (cache->count > 0)) {
+
+		pthread_mutex_lock(&nodepool_live_lock);
+
+		for (live = nodepool_live; live != NULL; live = live->next_live) {
+			if ((live == cache->pool) && (live->id == cache->id)) {
+				pthread_mutex_lock(&live->lock);
+				nodepool_cache_flush(cache, cache->count);
+				pthread_mutex_unlock(&live->lock);
+				break;
+			}
+		}
+
+		pthread_mutex_unlock(&nodepool_live_lock);
+	}
+
+	cache->pool = NULL;
+	cache->count = 0;
+}
+
+/**
+ * \fn static void nodepool_cache_exit(void* arg)
+ * \brief Destructor for nodepool_cache_key. Runs as a thread exits, so a pool shared by short-lived threads gets their cached objects back instead of growing with every thread that ever used it
+ *
+ * \param arg The exiting thread's nodepool_cache array
+ *
+ * \return N/A
+ */
+static void nodepool_cache_exit(void* arg) {
+
+	int i;
+	nodepool_cache_t* caches = (nodepool_cache_t*)arg;
+
+	for (i = 0; i < NODEPOOL_CACHES; i++) {
+		nodepool_cache_release(&caches[i]);
+	}
+}
+
+/**
+ * \fn static void nodepool_cache_key_create()
+ * \brief Creates nodepool_cache_key. Run once through pthread_once
+ *
+ * \param N/A
+ *
+ * \return N/A
+ */
+static void nodepool_cache_key_create() {
+
+	nodepool_cache_key_ok = (pthread_key_create(&nodepool_cache_key, nodepool_cache_exit) == 0);
+}
+
+/**
+ * \fn static nodepool_cache_t* nodepool_cache_bind(nodepool_t* pool)
+ * \brief Returns this thread's magazine for pool. If the thread has none yet, takes over an unused magazine or else the least recently used one, first handing back anything it cached for its old pool. The first bind on a thread also registers its magazines to be handed back when it exits
+ *
+ * \param pool The pool the caller is about to use
+ *
+ * \return This thread's magazine, bound to pool
+ */
+static nodepool_cache_t* nodepool_cache_bind(nodepool_t* pool) {
+
+	int i;
+	nodepool_cache_t* cache;
+
+	nodepool_cache_clock++;
+
+	// Fast path: thread already has a magazine for this pool
+	for (i = 0; i < NODEPOOL_CACHES; i++) {
+		if ((nodepool_cache[i].pool == pool) && (nodepool_cache[i].id == pool->id)) {
+			nodepool_cache[i].used = nodepool_cache_clock;
+			return &nodepool_cache[i];
+		}
+	}
+
+	// Slow path: evict an unused magazine if there is one, the least recently used otherwise. One left over from a destroyed pool at this address is as good as unused
+	cache = &nodepool_cache[0];
+	for (i = 0; i < NODEPOOL_CACHES; i++) {
+		if ((nodepool_cache[i].pool == NULL) || (nodepool_cache[i].pool == pool)) {
+			cache = &nodepool_cache[i];
+			break;
+		}
+		if (nodepool_cache[i].used < cache->used) {
+			cache = &nodepool_cache[i];
+		}
+	}
+
+	// A magazine left over from a destroyed pool at this address can't be live, so it is only dropped
+	if (cache->pool != pool) {
+		nodepool_cache_release(cache);
+	}
+
+	// Register once per thread, so its magazines go back to their pools when it exits
+	if (!nodepool_cache_registered) {
+		pthread_once(&nodepool_cache_key_once, nodepool_cache_key_create);
+		if (nodepool_cache_key_ok) {
+			pthread_setspecific(nodepool_cache_key, nodepool_cache);
+		}
+		nodepool_cache_registered = 1;
+	}
+
+	cache->pool = pool;
+	cache->id = pool->id;
+	cache->used = nodepool_cache_clock;
+	cache->count = 0;
+
+	return cache;
+}
+
+/**
+ * \fn nodepool_t* nodepool_create(size_t object_size, int block_objects)
+ * \brief Creates a pool of fixed-size objects that any number of FIFOs, on any number of threads, can draw from
+ *
+ * \param object_size Size of each object in bytes. Rounded up to a multiple of the pointer size
+ * \param block_objects Number of objects to allocate at a time when the pool runs dry. 0 picks a default
+ *
+ * \return If successful, returns pointer to a newly-created nodepool_t instance. In the case of an error, the function returns NULL
+ */
+nodepool_t* nodepool_create(size_t object_size, int block_objects) {
+
+	nodepool_t* pool;
+
+	// Ensure arguments are valid
+	if ((object_size == 0) || (block_objects < 0)) {
+		return NULL;
+	}
+
+	pool = (nodepool_t*)malloc(sizeof(nodepool_t));
+	if (pool == NULL) {
+		return NULL;
+	}
+
+	if (pthread_mutex_init(&pool->lock, NULL) != 0) {
+		free(pool);
+		return NULL;
+	}
+
+	pool->depot = NULL;
+	pool->blocks = NULL;
+	pool->object_size = (object_size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+	pool->block_objects = (block_objects == 0) ? (NODEPOOL_DEFAULT_BLOCK) : (block_objects);
+	pool->allocated = 0;
+
+	// Publish the pool as live
+	pthread_mutex_lock(&nodepool_live_lock);
+	pool->id = nodepool_next_id++;
+	pool->next_live = nodepool_live;
+	nodepool_live = pool;
+	pthread_mutex_unlock(&nodepool_live_lock);
+
+	return pool;
+}
+
+/**
+ * \fn void* nodepool_get(nodepool_t* pool)
+ * \brief Takes a free object from the pool. Comes from this thread's magazine without locking unless the magazine is empty
+ *
+ * \param pool The pool in question
+ *
+ * \return If successful, returns a pointer to an uninitialized object. In the case of an error, the function returns NULL
+ */
+void* nodepool_get(nodepool_t* pool) {
+
+	int i;
+	nodepool_cache_t* cache;
+
+	if (pool == NULL) {
+		return NULL;
+	}
+
+	cache = nodepool_cache_bind(pool);
+
+	// Refill up to half a magazine from the depot. Only grow the pool if the depot had nothing at all, so memory isn't allocated just to fill caches
+	if (cache->count == 0) {
+
+		pthread_mutex_lock(&pool->lock);
+
+		for (i = 0; i < (NODEPOOL_MAGAZINE / 2); i++) {
+
+			if (pool->depot == NULL) {
+				if ((cache->count > 0) || (nodepool_grow(pool, pool->block_objects) != EXIT_SUCCESS)) {
+					break;
+				}
+			}
+
+			cache->objects[cache->count++] = pool->depot;
+			pool->depot = pool->depot->next;
+		}
+
+		pthread_mutex_unlock(&pool->lock);
+
+		if (cache->count == 0) {
+			return NULL;
+		}
+	}
+
+	return cache->objects[--(cache->count)];
+}
+
+/**
+ * \fn void nodepool_put(nodepool_t* pool, void* object)
+ * \brief Returns an object to the pool. Goes to this thread's magazine without locking unless the magazine is full
+ *
+ * \param pool The pool the object was taken from
+ * \param object The object to return
+ *
+ * \return N/A
+ */
+void nodepool_put(nodepool_t* pool, void* object) {
+
+	nodepool_cache_t* cache;
+
+	if ((pool == NULL) || (object == NULL)) {
+		return;
+	}
+
+	cache = nodepool_cache_bind(pool);
+
+	// Flush half a magazine to the depot so other threads can reuse it
+	if (cache->count == NODEPOOL_MAGAZINE) {
+		pthread_mutex_lock(&pool->lock);
+		nodepool_cache_flush(cache, NODEPOOL_MAGAZINE / 2);
+		pthread_mutex_unlock(&pool->lock);
+	}
+
+	cache->objects[cache->count++] = object;
+}
+
+/**
+ * \fn int nodepool_reserve(nodepool_t* pool, int n)
+ * \brief Allocates n more free objects up front, as one contiguous block, so gets during a burst don't have to malloc
+ *
+ * \param pool The pool in question
+ * \param n Number of objects to add
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns -1
+ */
+int nodepool_reserve(nodepool_t* pool, int n) {
+
+	int result;
+
+	if ((pool == NULL) || (n < 0)) {
+		return EXIT_FAILURE_N;
+	}
+
+	if (n == 0) {
+		return EXIT_SUCCESS;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	result = nodepool_grow(pool, n);
+	pthread_mutex_unlock(&pool->lock);
+
+	return (result == EXIT_SUCCESS) ? (EXIT_SUCCESS) : (EXIT_FAILURE_N);
+}
+
+/**
+ * \fn size_t nodepool_object_size(nodepool_t* pool)
+ * \brief Returns the size of each object in the pool
+ *
+ * \param pool The pool in question
+ *
+ * \return The object size in bytes, or 0 if pool is NULL
+ */
+size_t nodepool_object_size(nodepool_t* pool) {
+
+	if (pool != NULL) {
+		return pool->object_size;
+	}
+	else {
+		return 0;
+	}
+}
+
+/**
+ * \fn size_t nodepool_allocated(nodepool_t* pool)
+ * \brief Returns how many objects the pool has allocated in total. This follows the peak number of objects in use across every FIFO sharing the pool
+ *
+ * \param pool The pool in question
+ *
+ * \return The number of objects allocated, or 0 if pool is NULL
+ */
+size_t nodepool_allocated(nodepool_t* pool) {
+
+	size_t allocated;
+
+	if (pool == NULL) {
+		return 0;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	allocated = pool->allocated;
+	pthread_mutex_unlock(&pool->lock);
+
+	return allocated;
+}
+
+/**
+ * \fn void nodepool_destroy(nodepool_t* pool)
+ * \brief Teardown function: Frees every block the pool allocated. Every FIFO drawing from the pool must be destroyed first. After calling this function, the pool should not be used again!
+ *
+ * \param pool The pool in question
+ *
+ * \return N/A
+ */
+void nodepool_destroy(nodepool_t* pool) {
+
+	int i;
+	nodepool_t** link;
+	nodepool_block_t* block_to_destroy;
+
+	if (pool == NULL) {
+		return;
+	}
+
+	// Unpublish the pool so no thread cache flushes into it any more
+	pthread_mutex_lock(&nodepool_live_lock);
+	for (link = &nodepool_live; *link != NULL; link = &((*link)->next_live)) {
+		if (*link == pool) {
+			*link = pool->next_live;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&nodepool_live_lock);
+
+	// This thread's magazine can be dropped right away. Other threads drop theirs once it is evicted or they exit
+	for (i = 0; i < NODEPOOL_CACHES; i++) {
+		if (nodepool_cache[i].pool == pool) {
+			nodepool_cache[i].pool = NULL;
+			nodepool_cache[i].count = 0;
+		}
+	}
+
+	while (pool->blocks != NULL) {
+		block_to_destroy = pool->blocks;
+		pool->blocks = pool->blocks->next;
+		free(block_to_destroy);
+	}
+
+	pthread_mutex_destroy(&pool->lock);
+	free(pool);
+}
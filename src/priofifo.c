@@ -0,0 +1,343 @@
+/**
+ * \file priofifo.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "llfifo.h"
+#include "llfifo_ext.h"
+#include "nodepool.h"
+#include "priofifo.h"
+
+#define EXIT_FAILURE_N ((size_t)(-1))
+
+/**
+ * \typedef priofifo_lane_t
+ * \brief Allows struct priofifo_lane_s to be instantiated as priofifo_lane_t
+ */
+typedef struct priofifo_lane_s priofifo_lane_t;
+
+/**
+ * \struct priofifo_lane_s
+ * \brief One lane + its metrics
+ *
+ * \detail llfifo_t* fifo - The lane's elements. Draws its nodes from the priofifo's shared pool
+ * \detail unsigned int weight - Dequeues in a row this lane gets per round under PRIOFIFO_WEIGHTED. At least 1
+ * \detail size_t length - Elements currently queued, kept here so the bitmap can be updated without asking the llfifo
+ * \detail size_t length_max - Most elements ever queued at once
+ * \detail uint64_t enqueued - Elements enqueued onto this lane
+ * \detail uint64_t dequeued - Elements dequeued from this lane
+ */
+struct priofifo_lane_s {
+	llfifo_t* fifo;
+	unsigned int weight;
+	size_t length;
+	size_t length_max;
+	uint64_t enqueued;
+	uint64_t dequeued;
+};
+
+/**
+ * \struct priofifo_s
+ * \brief Lanes plus a bitmap of which ones hold elements, so picking the next lane to serve is one find-first-set rather than a scan
+ *
+ * \detail priofifo_lane_t* lanes - Array of lane_count lanes, lane 0 first
+ * \detail int lane_count - Number of lanes, from 1 to PRIOFIFO_MAX_LANES
+ * \detail priofifo_policy_t policy - How priofifo_dequeue chooses a lane
+ * \detail nodepool_t* pool - Node pool shared by every lane, so node memory follows the total queued rather than each lane's peak
+ * \detail uint64_t ready - Bit i is set while lane i is non-empty
+ * \detail int current - PRIOFIFO_WEIGHTED only. Lane being served this round
+ * \detail unsigned int credit - PRIOFIFO_WEIGHTED only. Dequeues current has left this round
+ * \detail size_t length - Elements queued across every lane
+ */
+struct priofifo_s {
+	priofifo_lane_t* lanes;
+	int lane_count;
+	priofifo_policy_t policy;
+	nodepool_t* pool;
+	uint64_t ready;
+	int current;
+	unsigned int credit;
+	size_t length;
+};
+
+/**
+ * \fn static int priofifo_first(uint64_t mask)
+ * \brief Position of the lowest set bit
+ *
+ * \param mask Value in question, which cannot be 0
+ *
+ * \return Index of the lowest set bit, from 0 to 63
+ */
+static int priofifo_first(uint64_t mask) {
+
+#ifdef __GNUC__
+	return __builtin_ctzll(mask);
+#else
+	int bit = 0;
+
+	while ((mask & 1) == 0) {
+		mask >>= 1;
+		bit++;
+	}
+
+	return bit;
+#endif
+}
+
+/**
+ * \fn static int priofifo_pick(priofifo_t* fifo)
+ * \brief Chooses the lane priofifo_dequeue serves next according to the policy
+ *
+ * \param fifo The fifo in question, which cannot be empty
+ *
+ * \return Index of a non-empty lane
+ */
+static int priofifo_pick(priofifo_t* fifo) {
+
+	uint64_t later;
+
+	if (fifo->policy == PRIOFIFO_STRICT) {
+		return priofifo_first(fifo->ready);
+	}
+
+	// Keep serving the current lane while it has credit + elements left
+	if ((fifo->credit > 0) && (fifo->ready & ((uint64_t)(1) << fifo->current))) {
+		return fifo->current;
+	}
+
+	// Otherwise move on to the next non-empty lane above current, wrapping around to the lowest. 2 << 63 is 0, so current == 63 leaves nothing above
+	later = fifo->ready & ~(((uint64_t)(2) << fifo->current) - 1);
+	fifo->current = priofifo_first((later != 0) ? (later) : (fifo->ready));
+	fifo->credit = fifo->lanes[fifo->current].weight;
+
+	return fifo->current;
+}
+
+/**
+ * \fn priofifo_t* priofifo_create(int lanes, priofifo_policy_t policy)
+ * \brief Creates and initializes the FIFO with every lane empty + weighted 1
+ *
+ * \param lanes Number of lanes, from 1 to PRIOFIFO_MAX_LANES
+ * \param policy PRIOFIFO_STRICT or PRIOFIFO_WEIGHTED
+ *
+ * \return If successful, returns pointer to a newly-created priofifo_t instance. In the case of an error, the function returns NULL
+ */
+priofifo_t* priofifo_create(int lanes, priofifo_policy_t policy) {
+
+	int i;
+	priofifo_t* fifo;
+
+	// Ensure every lane gets a bit in the bitmap
+	if ((lanes < 1) || (lanes > PRIOFIFO_MAX_LANES)) {
+		return NULL;
+	}
+
+	if ((policy != PRIOFIFO_STRICT) && (policy != PRIOFIFO_WEIGHTED)) {
+		return NULL;
+	}
+
+	fifo = (priofifo_t*)malloc(sizeof(priofifo_t));
+	if (fifo == NULL) {
+		return NULL;
+	}
+
+	fifo->lanes = (priofifo_lane_t*)calloc((size_t)(lanes), sizeof(priofifo_lane_t));
+	fifo->pool = llfifo_pool_create(0);
+	fifo->lane_count = lanes;
+	fifo->policy = policy;
+	fifo->ready = 0;
+	fifo->current = PRIOFIFO_MAX_LANES - 1;
+	fifo->credit = 0;
+	fifo->length = 0;
+
+	if ((fifo->lanes == NULL) || (fifo->pool == NULL)) {
+		priofifo_destroy(fifo);
+		return NULL;
+	}
+
+	for (i = 0; i < lanes; i++) {
+		fifo->lanes[i].weight = 1;
+		fifo->lanes[i].fifo = llfifo_create_pooled(fifo->pool);
+		if (fifo->lanes[i].fifo == NULL) {
+			priofifo_destroy(fifo);
+			return NULL;
+		}
+	}
+
+	return fifo;
+}
+
+/**
+ * \fn int priofifo_set_weight(priofifo_t* fifo, int lane, unsigned int weight)
+ * \brief Sets how many dequeues in a row a lane gets per round under PRIOFIFO_WEIGHTED. Takes effect the next time the lane's turn comes around. Has no effect under PRIOFIFO_STRICT
+ *
+ * \param fifo The fifo in question
+ * \param lane Index of the lane
+ * \param weight Dequeues per round, at least 1
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int priofifo_set_weight(priofifo_t* fifo, int lane, unsigned int weight) {
+
+	if ((fifo == NULL) || (lane < 0) || (lane >= fifo->lane_count) || (weight == 0)) {
+		return EXIT_FAILURE;
+	}
+
+	fifo->lanes[lane].weight = weight;
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn size_t priofifo_enqueue(priofifo_t* fifo, int lane, void* element)
+ * \brief Enqueues an element onto one lane
+ *
+ * \param fifo The fifo in question
+ * \param lane Index of the lane, 0 being the highest priority
+ * \param element The element to enqueue, which cannot be NULL
+ *
+ * \return If successful, returns the new length of the whole FIFO. In the case of an error, the function returns (size_t)(-1)
+ */
+size_t priofifo_enqueue(priofifo_t* fifo, int lane, void* element) {
+
+	priofifo_lane_t* target;
+
+	// Ensure the fifo + lane are valid
+	if ((fifo == NULL) || (lane < 0) || (lane >= fifo->lane_count)) {
+		return EXIT_FAILURE_N;
+	}
+
+	target = &(fifo->lanes[lane]);
+
+	// llfifo rejects NULL elements
+	if (llfifo_enqueue_sz(target->fifo, element) == EXIT_FAILURE_N) {
+		return EXIT_FAILURE_N;
+	}
+
+	target->length++;
+	target->enqueued++;
+	if (target->length > target->length_max) {
+		target->length_max = target->length;
+	}
+
+	fifo->ready |= (uint64_t)(1) << lane;
+	fifo->length++;
+
+	return fifo->length;
+}
+
+/**
+ * \fn void* priofifo_dequeue(priofifo_t* fifo, int* lane)
+ * \brief Removes ("dequeues") an element from the lane chosen by the FIFO's policy, and returns it
+ *
+ * \param fifo The fifo in question
+ * \param lane If not NULL, set to the index of the lane the element came from
+ *
+ * \return If successful, returns the dequeued element, or NULL if the FIFO was empty
+ */
+void* priofifo_dequeue(priofifo_t* fifo, int* lane) {
+
+	int chosen;
+	priofifo_lane_t* source;
+
+	// Ensure the fifo is valid + has at least 1 element to dequeue
+	if ((fifo == NULL) || (fifo->ready == 0)) {
+		return NULL;
+	}
+
+	chosen = priofifo_pick(fifo);
+	source = &(fifo->lanes[chosen]);
+
+	source->length--;
+	source->dequeued++;
+	if (source->length == 0) {
+		fifo->ready &= ~((uint64_t)(1) << chosen);
+	}
+
+	if (fifo->credit > 0) {
+		fifo->credit--;
+	}
+
+	fifo->length--;
+
+	if (lane != NULL) {
+		*lane = chosen;
+	}
+
+	return llfifo_dequeue(source->fifo);
+}
+
+/**
+ * \fn size_t priofifo_length(priofifo_t* fifo)
+ * \brief Returns the number of elements currently queued across every lane
+ *
+ * \param fifo The fifo in question
+ *
+ * \return Returns the number of elements currently on the FIFO, or (size_t)(-1) if fifo is NULL
+ */
+size_t priofifo_length(priofifo_t* fifo) {
+
+	if (fifo != NULL) {
+		return fifo->length;
+	}
+	else {
+		return EXIT_FAILURE_N;
+	}
+}
+
+/**
+ * \fn int priofifo_stats(priofifo_t* fifo, int lane, priofifo_stats_t* stats)
+ * \brief Reads one lane's metrics
+ *
+ * \param fifo The fifo in question
+ * \param lane Index of the lane
+ * \param stats Filled in with the lane's metrics
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int priofifo_stats(priofifo_t* fifo, int lane, priofifo_stats_t* stats) {
+
+	priofifo_lane_t* source;
+
+	if ((fifo == NULL) || (lane < 0) || (lane >= fifo->lane_count) || (stats == NULL)) {
+		return EXIT_FAILURE;
+	}
+
+	source = &(fifo->lanes[lane]);
+	stats->enqueued = source->enqueued;
+	stats->dequeued = source->dequeued;
+	stats->length = source->length;
+	stats->length_max = source->length_max;
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn void priofifo_destroy(priofifo_t* fifo)
+ * \brief Teardown function: Frees all dynamically allocated memory. Elements still queued are not freed. After calling this function, the fifo should not be used again!
+ *
+ * \param fifo The fifo in question
+ *
+ * \return N/A
+ */
+void priofifo_destroy(priofifo_t* fifo) {
+
+	int i;
+
+	if (fifo == NULL) {
+		return;
+	}
+
+	// Lanes hand their nodes back to the pool, so they go first
+	if (fifo->lanes != NULL) {
+		for (i = 0; i < fifo->lane_count; i++) {
+			llfifo_destroy(fifo->lanes[i].fifo);
+		}
+	}
+
+	nodepool_destroy(fifo->pool);
+	free(fifo->lanes);
+	free(fifo);
+}
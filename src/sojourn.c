@@ -0,0 +1,280 @@
+/**
+ * \file sojourn.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include "sojourn.h"
+
+#define SOJOURN_SUB_COUNT ((uint64_t)(1) << SOJOURN_SUB_BITS)
+
+/**
+ * \struct sojourn_hist_s
+ * \brief Bucket counters plus running totals. Every field is updated with relaxed atomics, since nothing else is ordered against them
+ *
+ * \detail _Atomic uint64_t sum_ns - Total of every wait recorded
+ * \detail _Atomic uint64_t max_ns - Longest wait recorded
+ * \detail _Atomic uint64_t counts[SOJOURN_BUCKETS] - Waits recorded in each bucket, see sojourn_bucket
+ */
+struct sojourn_hist_s {
+	_Atomic uint64_t sum_ns;
+	_Atomic uint64_t max_ns;
+	_Atomic uint64_t counts[SOJOURN_BUCKETS];
+};
+
+/**
+ * \fn static int sojourn_log2(uint64_t value)
+ * \brief Position of the highest set bit
+ *
+ * \param value Value in question, which cannot be 0
+ *
+ * \return floor(log2(value))
+ */
+static int sojourn_log2(uint64_t value) {
+
+#ifdef __GNUC__
+	return 63 - __builtin_clzll(value);
+#else
+	int bit = 0;
+
+	while (value >>= 1) {
+		bit++;
+	}
+
+	return bit;
+#endif
+}
+
+/**
+ * \fn size_t sojourn_bucket(uint64_t wait_ns)
+ * \brief Maps a wait onto its bucket. Values below 2^SOJOURN_SUB_BITS get a bucket each. Above that, each power of 2 is split into 2^SOJOURN_SUB_BITS buckets of equal width, so the width of a bucket grows with the values in it
+ *
+ * \param wait_ns The wait in question
+ *
+ * \return Index of the bucket, less than SOJOURN_BUCKETS
+ */
+size_t sojourn_bucket(uint64_t wait_ns) {
+
+	int shift;
+
+	if (wait_ns < SOJOURN_SUB_COUNT) {
+		return (size_t)(wait_ns);
+	}
+
+	// The top SOJOURN_SUB_BITS + 1 bits pick the bucket. The leading 1 is implied by shift
+	shift = sojourn_log2(wait_ns) - SOJOURN_SUB_BITS;
+
+	return (size_t)(((uint64_t)(shift + 1) * SOJOURN_SUB_COUNT) + ((wait_ns >> shift) - SOJOURN_SUB_COUNT));
+}
+
+/**
+ * \fn uint64_t sojourn_bucket_lower(size_t bucket)
+ * \brief Returns the smallest wait that lands in a bucket
+ *
+ * \param bucket Index of the bucket, less than SOJOURN_BUCKETS
+ *
+ * \return The bucket's lower bound, in ns
+ */
+uint64_t sojourn_bucket_lower(size_t bucket) {
+
+	uint64_t shift;
+
+	if (bucket < SOJOURN_SUB_COUNT) {
+		return (uint64_t)(bucket);
+	}
+
+	shift = ((uint64_t)(bucket) / SOJOURN_SUB_COUNT) - 1;
+
+	return (SOJOURN_SUB_COUNT + ((uint64_t)(bucket) % SOJOURN_SUB_COUNT)) << shift;
+}
+
+/**
+ * \fn uint64_t sojourn_bucket_upper(size_t bucket)
+ * \brief Returns the largest wait that lands in a bucket
+ *
+ * \param bucket Index of the bucket, less than SOJOURN_BUCKETS
+ *
+ * \return The bucket's upper bound, in ns
+ */
+uint64_t sojourn_bucket_upper(size_t bucket) {
+
+	if (bucket < SOJOURN_SUB_COUNT) {
+		return (uint64_t)(bucket);
+	}
+
+	return sojourn_bucket_lower(bucket) + (((uint64_t)(1) << (((uint64_t)(bucket) / SOJOURN_SUB_COUNT) - 1)) - 1);
+}
+
+/**
+ * \fn uint64_t sojourn_now_ns()
+ * \brief Returns the monotonic timestamp FIFOs stamp data with
+ *
+ * \param N/A
+ *
+ * \return Nanoseconds since an arbitrary fixed point. Never 0, so 0 can mean "not stamped"
+ */
+uint64_t sojourn_now_ns() {
+
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t)(now.tv_sec) * 1000000000ull) + (uint64_t)(now.tv_nsec) + 1;
+}
+
+/**
+ * \fn sojourn_hist_t* sojourn_create()
+ * \brief Creates an empty histogram
+ *
+ * \param N/A
+ *
+ * \return If successful, returns pointer to a newly-created sojourn_hist_t instance. In the case of an error, the function returns NULL
+ */
+sojourn_hist_t* sojourn_create() {
+
+	sojourn_hist_t* hist;
+
+	hist = (sojourn_hist_t*)malloc(sizeof(sojourn_hist_t));
+	if (hist == NULL) {
+		return NULL;
+	}
+
+	sojourn_reset(hist);
+
+	return hist;
+}
+
+/**
+ * \fn void sojourn_record(sojourn_hist_t* hist, uint64_t wait_ns)
+ * \brief Records one wait. Lock-free: one atomic add for the bucket + one for the total, plus a compare-and-swap only when the wait is a new maximum
+ *
+ * \param hist The histogram in question
+ * \param wait_ns How long the data waited
+ *
+ * \return N/A
+ */
+void sojourn_record(sojourn_hist_t* hist, uint64_t wait_ns) {
+
+	uint64_t max;
+
+	if (hist == NULL) {
+		return;
+	}
+
+	atomic_fetch_add_explicit(&(hist->counts[sojourn_bucket(wait_ns)]), 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&(hist->sum_ns), wait_ns, memory_order_relaxed);
+
+	max = atomic_load_explicit(&(hist->max_ns), memory_order_relaxed);
+	while ((wait_ns > max) && !atomic_compare_exchange_weak_explicit(&(hist->max_ns), &max, wait_ns, memory_order_relaxed, memory_order_relaxed)) {
+		// max was reloaded by the failed compare-and-swap
+	}
+}
+
+/**
+ * \fn int sojourn_snapshot(sojourn_hist_t* hist, sojourn_snapshot_t* snapshot)
+ * \brief Copies the histogram without stopping anyone recording into it. Waits recorded during the copy may or may not make it in, and sum_ns + max_ns may include a few that the bucket counts don't
+ *
+ * \param hist The histogram in question
+ * \param snapshot Filled in with the copy
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int sojourn_snapshot(sojourn_hist_t* hist, sojourn_snapshot_t* snapshot) {
+
+	size_t i;
+
+	if ((hist == NULL) || (snapshot == NULL)) {
+		return EXIT_FAILURE;
+	}
+
+	snapshot->count = 0;
+	for (i = 0; i < SOJOURN_BUCKETS; i++) {
+		snapshot->counts[i] = atomic_load_explicit(&(hist->counts[i]), memory_order_relaxed);
+		snapshot->count += snapshot->counts[i];
+	}
+
+	snapshot->sum_ns = atomic_load_explicit(&(hist->sum_ns), memory_order_relaxed);
+	snapshot->max_ns = atomic_load_explicit(&(hist->max_ns), memory_order_relaxed);
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn uint64_t sojourn_percentile(const sojourn_snapshot_t* snapshot, double p)
+ * \brief Nearest-rank percentile of a snapshot. Reported as the upper bound of the bucket it falls in, capped at max_ns, so it never understates the wait
+ *
+ * \param snapshot The snapshot in question
+ * \param p Percentile wanted, from 0 to 100. 100 gives max_ns
+ *
+ * \return The wait at that percentile in ns, or 0 if the snapshot is empty
+ */
+uint64_t sojourn_percentile(const sojourn_snapshot_t* snapshot, double p) {
+
+	size_t i;
+	uint64_t rank;
+	uint64_t seen = 0;
+	uint64_t upper;
+	double scaled;
+
+	if ((snapshot == NULL) || (snapshot->count == 0)) {
+		return 0;
+	}
+
+	// Number of waits at or below the percentile is ceil(p / 100 * count), rounded up by hand so this doesn't need libm. At least 1
+	scaled = (p / 100.0) * (double)(snapshot->count);
+	rank = (scaled > 0.0) ? ((uint64_t)(scaled)) : (0);
+	if ((double)(rank) < scaled) {
+		rank++;
+	}
+	rank = (rank < 1) ? (1) : ((rank > snapshot->count) ? (snapshot->count) : (rank));
+
+	for (i = 0; i < SOJOURN_BUCKETS; i++) {
+		seen += snapshot->counts[i];
+		if (seen >= rank) {
+			upper = sojourn_bucket_upper(i);
+			return (upper < snapshot->max_ns) ? (upper) : (snapshot->max_ns);
+		}
+	}
+
+	return snapshot->max_ns;
+}
+
+/**
+ * \fn void sojourn_reset(sojourn_hist_t* hist)
+ * \brief Empties the histogram. Waits recorded while this runs may survive it
+ *
+ * \param hist The histogram in question
+ *
+ * \return N/A
+ */
+void sojourn_reset(sojourn_hist_t* hist) {
+
+	size_t i;
+
+	if (hist == NULL) {
+		return;
+	}
+
+	for (i = 0; i < SOJOURN_BUCKETS; i++) {
+		atomic_store_explicit(&(hist->counts[i]), 0, memory_order_relaxed);
+	}
+
+	atomic_store_explicit(&(hist->sum_ns), 0, memory_order_relaxed);
+	atomic_store_explicit(&(hist->max_ns), 0, memory_order_relaxed);
+}
+
+/**
+ * \fn void sojourn_destroy(sojourn_hist_t* hist)
+ * \brief Teardown function: Frees the histogram. Any FIFO still recording into it must be detached first
+ *
+ * \param hist The histogram in question
+ *
+ * \return N/A
+ */
+void sojourn_destroy(sojourn_hist_t* hist) {
+
+	free(hist);
+}
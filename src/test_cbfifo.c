@@ -12,7 +12,9 @@
 #include "cbfifo.h"
 #include "test_cbfifo.h"
 
+#ifndef CB_SIZE
 #define CB_SIZE ((size_t)(128))
+#endif
 
 #define GREEN "\x1B[32m"
 #define RESET "\x1B[0m"
@@ -0,0 +1,397 @@
+/**
+ * \file test_drrsched.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "drrsched.h"
+#include "llfifo.h"
+#include "llfifo_ext.h"
+#include "test_drrsched.h"
+
+#define GREEN "\x1B[32m"
+#define RESET "\x1B[0m"
+
+#define EXIT_FAILURE_N ((size_t)(-1))
+
+#define MANY_QUEUES ((int)(1000))
+
+#define TEST_DRRSCHED_ATTACH
+#define TEST_DRRSCHED_QUANTUM
+#define TEST_DRRSCHED_COST
+#define TEST_DRRSCHED_DETACH
+#define TEST_DRRSCHED_MANY
+
+/**
+ * \fn static size_t test_drrsched_strlen(void* element, void* ctx)
+ * \brief Cost callback for drrsched_create: each string element costs its length, standing in for a message size in bytes
+ *
+ * \param element The element being dispatched
+ * \param ctx Unused
+ *
+ * \return Length of the element
+ */
+static size_t test_drrsched_strlen(void* element, void* ctx) {
+
+	(void)(ctx);
+
+	return strlen((const char*)(element));
+}
+
+/**
+ * \fn void test_drrsched()
+ * \brief Runs unit tests for happy cases + failure cases + boundary cases for each drrsched function
+ *
+ * \param N/A
+ *
+ * \return N/A
+ */
+void test_drrsched() {
+#ifdef TEST_DRRSCHED_ATTACH
+	char element1_attach[16] = "element1_attach";
+#ifdef FIFO_DEADLINE
+	char element2_attach[16] = "element2_attach";
+#endif
+
+	drrsched_t* drrsched_attach_sched;
+	drrsched_flow_t* drrsched_attach_flow;
+	llfifo_t* llfifo_attach;
+
+	drrsched_attach_sched = drrsched_create(NULL, NULL);
+	llfifo_attach = llfifo_create(1);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Create drrsched + attach an empty llfifo. Nothing is active yet
+	assert(drrsched_attach_sched != NULL);
+	drrsched_attach_flow = drrsched_attach(drrsched_attach_sched, llfifo_attach, 1);
+	assert(drrsched_attach_flow != NULL);
+	assert(drrsched_active(drrsched_attach_sched) == 0);
+	//		Enqueueing through the scheduler makes it active
+	assert(drrsched_enqueue(drrsched_attach_sched, drrsched_attach_flow, element1_attach) == 1);
+	assert(drrsched_active(drrsched_attach_sched) == 1);
+	assert(test_drrsched_dispatch(drrsched_attach_sched, element1_attach, drrsched_attach_flow) == EXIT_SUCCESS);
+	assert(drrsched_active(drrsched_attach_sched) == 0);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to attach to NULL drrsched, attach NULL llfifo + attach with quantum 0
+	assert(drrsched_attach(NULL, llfifo_attach, 1) == NULL);
+	assert(drrsched_attach(drrsched_attach_sched, NULL, 1) == NULL);
+	assert(drrsched_attach(drrsched_attach_sched, llfifo_attach, 0) == NULL);
+	//		Attempt to enqueue to NULL drrsched, NULL flow + NULL element
+	assert(drrsched_enqueue(NULL, drrsched_attach_flow, element1_attach) == EXIT_FAILURE_N);
+	assert(drrsched_enqueue(drrsched_attach_sched, NULL, element1_attach) == EXIT_FAILURE_N);
+	assert(drrsched_enqueue(drrsched_attach_sched, drrsched_attach_flow, NULL) == EXIT_FAILURE_N);
+	assert(drrsched_active(drrsched_attach_sched) == 0);
+	//		Attempt to dispatch from + count active queues of NULL drrsched
+	assert(test_drrsched_dispatch(NULL, NULL, NULL) == EXIT_FAILURE);
+	assert(drrsched_active(NULL) == EXIT_FAILURE_N);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Attempt to dispatch when every queue is empty
+	assert(test_drrsched_dispatch(drrsched_attach_sched, NULL, NULL) == EXIT_FAILURE);
+#ifdef FIFO_DEADLINE
+	//		Expired element at the front is discarded by the llfifo, + the live one behind it is what gets dispatched
+	assert(llfifo_enqueue_deadline(llfifo_attach, element1_attach, 1) == 1);
+	assert(drrsched_enqueue(drrsched_attach_sched, drrsched_attach_flow, element2_attach) == 2);
+	assert(test_drrsched_dispatch(drrsched_attach_sched, element2_attach, drrsched_attach_flow) == EXIT_SUCCESS);
+	assert(llfifo_length(llfifo_attach) == 0);
+	//		Queue holding nothing but expired elements drops out like an empty one
+	assert(llfifo_enqueue_deadline(llfifo_attach, element1_attach, 1) == 1);
+	assert(drrsched_enqueue(drrsched_attach_sched, drrsched_attach_flow, element2_attach) == 2);
+	assert(llfifo_enqueue_deadline(llfifo_attach, element1_attach, 1) == 3);
+	assert(test_drrsched_dispatch(drrsched_attach_sched, element2_attach, drrsched_attach_flow) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_attach_sched, NULL, NULL) == EXIT_FAILURE);
+	assert(drrsched_active(drrsched_attach_sched) == 0);
+#endif
+	//		Destroy drrsched with a flow still attached. The llfifo is left to the caller
+	drrsched_destroy(drrsched_attach_sched);
+	assert(llfifo_length(llfifo_attach) == 0);
+	llfifo_destroy(llfifo_attach);
+#endif
+
+#ifdef TEST_DRRSCHED_QUANTUM
+	// Set first parameter to drrsched to test with
+	// Set second parameter to element expected to be dispatched (NULL if the dispatch should fail)
+	// Set third parameter to flow the element is expected to come from
+
+	int i_quantum;
+	char a_quantum[2] = "a";
+	char b_quantum[2] = "b";
+
+	drrsched_t* drrsched_quantum;
+	drrsched_flow_t* flow_a_quantum;
+	drrsched_flow_t* flow_b_quantum;
+	llfifo_t* llfifo_a_quantum;
+	llfifo_t* llfifo_b_quantum;
+
+	drrsched_quantum = drrsched_create(NULL, NULL);
+	llfifo_a_quantum = llfifo_create(4);
+	llfifo_b_quantum = llfifo_create(4);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Every element costs 1. Queue a earns 2 per turn, queue b earns 1
+	flow_a_quantum = drrsched_attach(drrsched_quantum, llfifo_a_quantum, 2);
+	flow_b_quantum = drrsched_attach(drrsched_quantum, llfifo_b_quantum, 1);
+	for (i_quantum = 0; i_quantum < 4; i_quantum++) {
+		assert(drrsched_enqueue(drrsched_quantum, flow_a_quantum, a_quantum) == (size_t)(i_quantum + 1));
+		assert(drrsched_enqueue(drrsched_quantum, flow_b_quantum, b_quantum) == (size_t)(i_quantum + 1));
+	}
+	//		a gets 2 dispatches for every 1 of b until it runs dry, then b has the scheduler to itself
+	assert(test_drrsched_dispatch(drrsched_quantum, a_quantum, flow_a_quantum) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_quantum, a_quantum, flow_a_quantum) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_quantum, b_quantum, flow_b_quantum) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_quantum, a_quantum, flow_a_quantum) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_quantum, a_quantum, flow_a_quantum) == EXIT_SUCCESS);
+	assert(drrsched_active(drrsched_quantum) == 1);
+	assert(test_drrsched_dispatch(drrsched_quantum, b_quantum, flow_b_quantum) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_quantum, b_quantum, flow_b_quantum) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_quantum, b_quantum, flow_b_quantum) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to dispatch once both queues are drained
+	assert(test_drrsched_dispatch(drrsched_quantum, NULL, NULL) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		An llfifo that already holds elements is active as soon as it is attached
+	drrsched_destroy(drrsched_quantum);
+	drrsched_quantum = drrsched_create(NULL, NULL);
+	assert(llfifo_enqueue(llfifo_a_quantum, a_quantum) == 1);
+	flow_a_quantum = drrsched_attach(drrsched_quantum, llfifo_a_quantum, 1);
+	assert(drrsched_active(drrsched_quantum) == 1);
+	assert(test_drrsched_dispatch(drrsched_quantum, a_quantum, flow_a_quantum) == EXIT_SUCCESS);
+
+	drrsched_destroy(drrsched_quantum);
+	llfifo_destroy(llfifo_a_quantum);
+	llfifo_destroy(llfifo_b_quantum);
+#endif
+
+#ifdef TEST_DRRSCHED_COST
+	// Set first parameter to drrsched to test with
+	// Set second parameter to element expected to be dispatched (NULL if the dispatch should fail)
+	// Set third parameter to flow the element is expected to come from
+
+	char big_cost[8] = "aaaaaaa";
+	char small_cost[2] = "a";
+	char pair1_cost[3] = "b1";
+	char pair2_cost[3] = "b2";
+	char pair3_cost[3] = "b3";
+
+	drrsched_t* drrsched_cost;
+	drrsched_flow_t* flow_a_cost;
+	drrsched_flow_t* flow_b_cost;
+	llfifo_t* llfifo_a_cost;
+	llfifo_t* llfifo_b_cost;
+
+	drrsched_cost = drrsched_create(test_drrsched_strlen, NULL);
+	llfifo_a_cost = llfifo_create(2);
+	llfifo_b_cost = llfifo_create(3);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Both queues earn 5 per turn. Queue a holds a 7 byte element then a 1 byte one, queue b three 2 byte elements
+	flow_a_cost = drrsched_attach(drrsched_cost, llfifo_a_cost, 5);
+	flow_b_cost = drrsched_attach(drrsched_cost, llfifo_b_cost, 5);
+	assert(drrsched_enqueue(drrsched_cost, flow_a_cost, big_cost) == 1);
+	assert(drrsched_enqueue(drrsched_cost, flow_a_cost, small_cost) == 2);
+	assert(drrsched_enqueue(drrsched_cost, flow_b_cost, pair1_cost) == 1);
+	assert(drrsched_enqueue(drrsched_cost, flow_b_cost, pair2_cost) == 2);
+	assert(drrsched_enqueue(drrsched_cost, flow_b_cost, pair3_cost) == 3);
+	//		a can't afford 7 with 5, so b goes first + sends 4 bytes, keeping 1 over
+	assert(test_drrsched_dispatch(drrsched_cost, pair1_cost, flow_b_cost) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_cost, pair2_cost, flow_b_cost) == EXIT_SUCCESS);
+	//		a's deficit carried over to 10, enough for both its elements
+	assert(test_drrsched_dispatch(drrsched_cost, big_cost, flow_a_cost) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_cost, small_cost, flow_a_cost) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_cost, pair3_cost, flow_b_cost) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to dispatch once both queues are drained
+	assert(test_drrsched_dispatch(drrsched_cost, NULL, NULL) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		A queue that drains forfeits its leftover deficit, so it can't burst when it comes back
+	assert(drrsched_enqueue(drrsched_cost, flow_a_cost, big_cost) == 1);
+	assert(drrsched_enqueue(drrsched_cost, flow_b_cost, pair1_cost) == 1);
+	assert(test_drrsched_dispatch(drrsched_cost, pair1_cost, flow_b_cost) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_cost, big_cost, flow_a_cost) == EXIT_SUCCESS);
+
+	drrsched_destroy(drrsched_cost);
+	llfifo_destroy(llfifo_a_cost);
+	llfifo_destroy(llfifo_b_cost);
+#endif
+
+#ifdef TEST_DRRSCHED_DETACH
+	char a_detach[2] = "a";
+	char b_detach[2] = "b";
+	char c_detach[2] = "c";
+
+	drrsched_t* drrsched_detach_sched;
+	drrsched_flow_t* flow_a_detach;
+	drrsched_flow_t* flow_b_detach;
+	drrsched_flow_t* flow_c_detach;
+	llfifo_t* llfifo_a_detach;
+	llfifo_t* llfifo_b_detach;
+	llfifo_t* llfifo_c_detach;
+
+	drrsched_detach_sched = drrsched_create(NULL, NULL);
+	llfifo_a_detach = llfifo_create(2);
+	llfifo_b_detach = llfifo_create(2);
+	llfifo_c_detach = llfifo_create(2);
+	flow_a_detach = drrsched_attach(drrsched_detach_sched, llfifo_a_detach, 1);
+	flow_b_detach = drrsched_attach(drrsched_detach_sched, llfifo_b_detach, 1);
+	flow_c_detach = drrsched_attach(drrsched_detach_sched, llfifo_c_detach, 1);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	assert(drrsched_enqueue(drrsched_detach_sched, flow_a_detach, a_detach) == 1);
+	assert(drrsched_enqueue(drrsched_detach_sched, flow_a_detach, a_detach) == 2);
+	assert(drrsched_enqueue(drrsched_detach_sched, flow_b_detach, b_detach) == 1);
+	assert(drrsched_enqueue(drrsched_detach_sched, flow_c_detach, c_detach) == 1);
+	//		Detach b while it waits for its turn. Its element stays in its llfifo + the scheduler skips it
+	assert(drrsched_detach(drrsched_detach_sched, flow_b_detach) == EXIT_SUCCESS);
+	assert(drrsched_active(drrsched_detach_sched) == 2);
+	assert(test_drrsched_dispatch(drrsched_detach_sched, a_detach, flow_a_detach) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_detach_sched, c_detach, flow_c_detach) == EXIT_SUCCESS);
+	assert(llfifo_length(llfifo_b_detach) == 1);
+	//		Detach a while its turn is in progress
+	assert(drrsched_enqueue(drrsched_detach_sched, flow_c_detach, c_detach) == 1);
+	assert(drrsched_enqueue(drrsched_detach_sched, flow_a_detach, a_detach) == 2);
+	assert(test_drrsched_dispatch(drrsched_detach_sched, a_detach, flow_a_detach) == EXIT_SUCCESS);
+	assert(drrsched_detach(drrsched_detach_sched, flow_a_detach) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_detach_sched, c_detach, flow_c_detach) == EXIT_SUCCESS);
+	assert(llfifo_length(llfifo_a_detach) == 1);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to detach from NULL drrsched + detach NULL flow
+	assert(drrsched_detach(NULL, flow_c_detach) == EXIT_FAILURE);
+	assert(drrsched_detach(drrsched_detach_sched, NULL) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Detach an idle flow
+	assert(drrsched_active(drrsched_detach_sched) == 0);
+	assert(drrsched_detach(drrsched_detach_sched, flow_c_detach) == EXIT_SUCCESS);
+	assert(drrsched_active(drrsched_detach_sched) == 0);
+
+	drrsched_destroy(drrsched_detach_sched);
+	llfifo_destroy(llfifo_a_detach);
+	llfifo_destroy(llfifo_b_detach);
+	llfifo_destroy(llfifo_c_detach);
+#endif
+
+#ifdef TEST_DRRSCHED_MANY
+	int i_many;
+	char element_many[13] = "element_many";
+
+	drrsched_t* drrsched_many;
+	drrsched_flow_t* flows_many[MANY_QUEUES];
+	llfifo_t* llfifos_many[MANY_QUEUES];
+
+	drrsched_many = drrsched_create(NULL, NULL);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Attach 1000 queues but only give elements to 3 of them. Only those 3 are ever visited
+	for (i_many = 0; i_many < MANY_QUEUES; i_many++) {
+		llfifos_many[i_many] = llfifo_create(0);
+		flows_many[i_many] = drrsched_attach(drrsched_many, llfifos_many[i_many], 1);
+		assert(flows_many[i_many] != NULL);
+	}
+	assert(drrsched_active(drrsched_many) == 0);
+	assert(drrsched_enqueue(drrsched_many, flows_many[999], element_many) == 1);
+	assert(drrsched_enqueue(drrsched_many, flows_many[0], element_many) == 1);
+	assert(drrsched_enqueue(drrsched_many, flows_many[500], element_many) == 1);
+	assert(drrsched_active(drrsched_many) == 3);
+	//		Queues are served in the order they became active
+	assert(test_drrsched_dispatch(drrsched_many, element_many, flows_many[999]) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_many, element_many, flows_many[0]) == EXIT_SUCCESS);
+	assert(test_drrsched_dispatch(drrsched_many, element_many, flows_many[500]) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to dispatch with every queue idle
+	assert(test_drrsched_dispatch(drrsched_many, NULL, NULL) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Destroy drrsched with 1000 flows attached
+	drrsched_destroy(drrsched_many);
+	for (i_many = 0; i_many < MANY_QUEUES; i_many++) {
+		llfifo_destroy(llfifos_many[i_many]);
+	}
+#endif
+
+	printf("\n");
+
+#ifdef TEST_DRRSCHED_ATTACH
+	printf(GREEN "Asserts for all test cases against drrsched_attach + drrsched_enqueue have passed\n" RESET);
+#endif
+#ifdef TEST_DRRSCHED_QUANTUM
+	printf(GREEN "Asserts for all test cases against drrsched_dispatch quanta have passed\n" RESET);
+#endif
+#ifdef TEST_DRRSCHED_COST
+	printf(GREEN "Asserts for all test cases against drrsched_dispatch costs have passed\n" RESET);
+#endif
+#ifdef TEST_DRRSCHED_DETACH
+	printf(GREEN "Asserts for all test cases against drrsched_detach have passed\n" RESET);
+#endif
+#ifdef TEST_DRRSCHED_MANY
+	printf(GREEN "Asserts for all test cases against drrsched with many idle queues have passed\n" RESET);
+#endif
+}
+
+/**
+ * \fn int test_drrsched_dispatch(drrsched_t* sched, void* expected, drrsched_flow_t* expected_flow)
+ * \brief Dispatches the next element and checks it is the expected one, from the expected flow
+ *
+ * \param sched The scheduler in question
+ * \param expected Element that should be dispatched
+ * \param expected_flow Flow it should come from
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_drrsched_dispatch(drrsched_t* sched, void* expected, drrsched_flow_t* expected_flow) {
+
+	void* data;
+	drrsched_flow_t* flow = NULL;
+
+	data = drrsched_dispatch(sched, &flow);
+
+	printf("\tdrrsched at %p : dispatch %s from flow %p -> %d active\n", (void*)sched, (data == NULL) ? "NULL" : (char*)data, (void*)flow, (int)drrsched_active(sched));
+
+	if (data == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	assert(data == expected);
+	assert(flow == expected_flow);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,462 @@
+/**
+ * \file test_executor.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "executor.h"
+#include "test_executor.h"
+
+#define GREEN "\x1B[32m"
+#define RESET "\x1B[0m"
+
+#define EXECUTOR_WORKERS ((int)(4))
+#define EXECUTOR_TASKS ((int)(1000))
+#define EXECUTOR_RACES ((int)(200))
+#define EXECUTOR_SUBMITTERS ((int)(4))
+
+#define TEST_EXECUTOR_SUBMIT
+#define TEST_EXECUTOR_SPAWN
+#define TEST_EXECUTOR_SHUTDOWN
+
+/**
+ * \var static atomic_int test_executor_counter
+ * \brief Incremented once by every task the tests submit, so the tests can tell how many actually ran
+ */
+static atomic_int test_executor_counter;
+
+/**
+ * \fn static void test_executor_count(void* arg)
+ * \brief Task body: adds arg (a small integer cast to a pointer, or 1 if NULL) to test_executor_counter
+ *
+ * \param arg Amount to add
+ *
+ * \return N/A
+ */
+static void test_executor_count(void* arg) {
+
+	atomic_fetch_add(&test_executor_counter, (arg == NULL) ? (1) : ((int)(uintptr_t)(arg)));
+}
+
+/**
+ * \fn static void test_executor_slow_count(void* arg)
+ * \brief Task body: sleeps for a moment, then counts like test_executor_count. Keeps tasks queued long enough for shutdown to race them
+ *
+ * \param arg Amount to add
+ *
+ * \return N/A
+ */
+static void test_executor_slow_count(void* arg) {
+
+	struct timespec delay = { .tv_sec = 0, .tv_nsec = 100000L };
+
+	nanosleep(&delay, NULL);
+	test_executor_count(arg);
+}
+
+/**
+ * \var static executor_t* test_executor_spawner
+ * \brief Executor test_executor_tree submits its children to
+ */
+static executor_t* test_executor_spawner;
+
+/**
+ * \fn static void test_executor_tree(void* arg)
+ * \brief Task body: counts itself, then submits 2 children with depth one less, forming a binary tree of 2^(depth+1) - 1 tasks
+ *
+ * \param arg Remaining depth, as a small integer cast to a pointer
+ *
+ * \return N/A
+ */
+static void test_executor_tree(void* arg) {
+
+	uintptr_t depth = (uintptr_t)(arg);
+	void* children[2] = { (void*)(depth - 1), (void*)(depth - 1) };
+
+	atomic_fetch_add(&test_executor_counter, 1);
+
+	if (depth > 0) {
+		assert(executor_submit_batch(test_executor_spawner, test_executor_tree, children, 2) == EXIT_SUCCESS);
+	}
+}
+
+/**
+ * \fn void test_executor()
+ * \brief Runs unit tests for happy cases + failure cases + boundary cases for each executor function
+ *
+ * \param N/A
+ *
+ * \return N/A
+ */
+void test_executor() {
+#ifdef TEST_EXECUTOR_SUBMIT
+	// Set first parameter to executor to test with
+	// Set second parameter to number of tasks to submit
+	// Set third parameter to 0 to submit one at a time, or 1 to submit as one batch
+
+	executor_t* executor_submit_test;
+	executor_stats_t stats_submit;
+	executor_submit_test = executor_create(EXECUTOR_WORKERS);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Submit tasks one at a time, then as a batch. Every task runs exactly once
+	assert(executor_submit_test != NULL);
+	assert(executor_workers(executor_submit_test) == EXECUTOR_WORKERS);
+	assert(test_executor_submit(executor_submit_test, EXECUTOR_TASKS, 0) == EXIT_SUCCESS);
+	assert(test_executor_submit(executor_submit_test, EXECUTOR_TASKS, 1) == EXIT_SUCCESS);
+	executor_dump_state(executor_submit_test);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to create executor with no workers
+	assert(executor_create(0) == NULL);
+	//		Attempt to submit to NULL executor + submit NULL function + batch with NULL args
+	assert(executor_submit(NULL, test_executor_count, NULL) == EXIT_FAILURE);
+	assert(executor_submit(executor_submit_test, NULL, NULL) == EXIT_FAILURE);
+	assert(executor_submit_batch(executor_submit_test, test_executor_count, NULL, 1) == EXIT_FAILURE);
+	//		Attempt to read stats of worker that doesn't exist
+	assert(executor_stats(executor_submit_test, EXECUTOR_WORKERS, &stats_submit) == EXIT_FAILURE);
+	assert(executor_stats(executor_submit_test, -1, &stats_submit) == EXIT_FAILURE);
+	assert(executor_stats(NULL, 0, &stats_submit) == EXIT_FAILURE);
+	assert(executor_pending(NULL) == (size_t)(-1));
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Empty batch is fine + runs nothing
+	assert(test_executor_submit(executor_submit_test, 0, 1) == EXIT_SUCCESS);
+	//		Executor with a single worker has nobody to steal from
+	executor_destroy(executor_submit_test);
+	executor_submit_test = executor_create(1);
+	assert(test_executor_submit(executor_submit_test, EXECUTOR_TASKS, 1) == EXIT_SUCCESS);
+	assert(executor_stats(executor_submit_test, 0, &stats_submit) == EXIT_SUCCESS);
+	assert(stats_submit.executed == (uint64_t)(EXECUTOR_TASKS));
+	assert(stats_submit.stolen == 0);
+	executor_destroy(executor_submit_test);
+#endif
+
+#ifdef TEST_EXECUTOR_SPAWN
+	// Set first parameter to executor to test with
+	// Set second parameter to depth of the binary tree of tasks to spawn
+
+	executor_t* executor_spawn;
+	executor_spawn = executor_create(EXECUTOR_WORKERS);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Tasks submitting tasks go to local queues + get stolen. All 2^11 - 1 tasks run
+	assert(test_executor_spawn(executor_spawn, 10) == EXIT_SUCCESS);
+	executor_dump_state(executor_spawn);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Tree of a single task
+	assert(test_executor_spawn(executor_spawn, 0) == EXIT_SUCCESS);
+	executor_destroy(executor_spawn);
+#endif
+
+#ifdef TEST_EXECUTOR_SHUTDOWN
+	// Set first parameter to number of workers
+	// Set second parameter to number of slow tasks queued when shutdown starts
+
+	executor_t* executor_shutdown_test;
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Shutdown waits for every queued task before returning
+	assert(test_executor_drain(EXECUTOR_WORKERS, 200) == EXIT_SUCCESS);
+	assert(test_executor_drain(1, 50) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to submit after shutdown
+	executor_shutdown_test = executor_create(EXECUTOR_WORKERS);
+	executor_shutdown(executor_shutdown_test);
+	assert(executor_submit(executor_shutdown_test, test_executor_count, NULL) == EXIT_FAILURE);
+	assert(executor_pending(executor_shutdown_test) == 0);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Second shutdown + destroy after shutdown do nothing more
+	executor_shutdown(executor_shutdown_test);
+	executor_destroy(executor_shutdown_test);
+	//		Shutdown + destroy of NULL executor
+	executor_shutdown(NULL);
+	executor_destroy(NULL);
+	//		Submits racing shutdown. Shutdown must return every time, and every submit that succeeded must have run
+	assert(test_executor_shutdown_race(EXECUTOR_WORKERS, EXECUTOR_RACES) == EXIT_SUCCESS);
+	assert(test_executor_shutdown_race(1, EXECUTOR_RACES) == EXIT_SUCCESS);
+#endif
+
+	printf("\n");
+
+#ifdef TEST_EXECUTOR_SUBMIT
+	printf(GREEN "Asserts for all test cases against executor_submit + executor_submit_batch have passed\n" RESET);
+#endif
+#ifdef TEST_EXECUTOR_SPAWN
+	printf(GREEN "Asserts for all test cases against executor tasks spawning tasks have passed\n" RESET);
+#endif
+#ifdef TEST_EXECUTOR_SHUTDOWN
+	printf(GREEN "Asserts for all test cases against executor_shutdown have passed\n" RESET);
+#endif
+}
+
+/**
+ * \fn static void test_executor_wait_idle(executor_t* executor)
+ * \brief Waits until every submitted task has finished
+ *
+ * \param executor The executor in question
+ *
+ * \return N/A
+ */
+static void test_executor_wait_idle(executor_t* executor) {
+
+	struct timespec delay = { .tv_sec = 0, .tv_nsec = 100000L };
+
+	while (executor_pending(executor) != 0) {
+		nanosleep(&delay, NULL);
+	}
+}
+
+/**
+ * \fn int test_executor_submit(executor_t* executor, int tasks, int batch)
+ * \brief Submits tasks that each count 1, waits for them, and checks every one ran exactly once + shows up in the per-worker stats
+ *
+ * \param executor The executor in question
+ * \param tasks Number of tasks to submit
+ * \param batch 0 to submit one at a time, 1 to submit as one batch
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_executor_submit(executor_t* executor, int tasks, int batch) {
+
+	int i;
+	int result = EXIT_SUCCESS;
+	uint64_t executed_before = 0;
+	uint64_t executed_after = 0;
+	void** args;
+	executor_stats_t stats;
+
+	args = (void**)calloc((size_t)(tasks) + 1, sizeof(void*));
+	if (args == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < executor_workers(executor); i++) {
+		executor_stats(executor, i, &stats);
+		executed_before += stats.executed;
+	}
+
+	atomic_store(&test_executor_counter, 0);
+
+	if (batch) {
+		result = executor_submit_batch(executor, test_executor_count, args, tasks);
+	}
+	else {
+		for (i = 0; (i < tasks) && (result == EXIT_SUCCESS); i++) {
+			result = executor_submit(executor, test_executor_count, NULL);
+		}
+	}
+
+	test_executor_wait_idle(executor);
+
+	for (i = 0; i < executor_workers(executor); i++) {
+		executor_stats(executor, i, &stats);
+		executed_after += stats.executed;
+	}
+
+	free(args);
+
+	if ((result != EXIT_SUCCESS) || (atomic_load(&test_executor_counter) != tasks) || ((executed_after - executed_before) != (uint64_t)(tasks))) {
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int test_executor_spawn(executor_t* executor, int depth)
+ * \brief Submits one test_executor_tree task and checks the whole tree of tasks it spawns runs
+ *
+ * \param executor The executor in question
+ * \param depth Depth of the tree
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_executor_spawn(executor_t* executor, int depth) {
+
+	test_executor_spawner = executor;
+	atomic_store(&test_executor_counter, 0);
+
+	if (executor_submit(executor, test_executor_tree, (void*)(uintptr_t)(depth)) != EXIT_SUCCESS) {
+		return EXIT_FAILURE;
+	}
+
+	test_executor_wait_idle(executor);
+
+	if (atomic_load(&test_executor_counter) != ((1 << (depth + 1)) - 1)) {
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int test_executor_drain(int workers, int tasks)
+ * \brief Creates an executor, queues slow tasks, and shuts it down straight away. Every task must still have run by the time shutdown returns
+ *
+ * \param workers Number of workers
+ * \param tasks Number of tasks
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_executor_drain(int workers, int tasks) {
+
+	int i;
+	executor_t* executor;
+
+	executor = executor_create(workers);
+	if (executor == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	atomic_store(&test_executor_counter, 0);
+
+	for (i = 0; i < tasks; i++) {
+		assert(executor_submit(executor, test_executor_slow_count, NULL) == EXIT_SUCCESS);
+	}
+
+	executor_shutdown(executor);
+
+	printf("\texecutor at %p drained %d of %d tasks on shutdown\n", (void*)executor, atomic_load(&test_executor_counter), tasks);
+
+	i = atomic_load(&test_executor_counter);
+	executor_destroy(executor);
+
+	return (i == tasks) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+}
+
+/**
+ * \fn static void* test_executor_submitter(void* arg)
+ * \brief Submits tasks that each count 1 from outside the executor until a submit fails
+ *
+ * \param arg The executor to submit to
+ *
+ * \return The number of successful submits, cast to void*
+ */
+static void* test_executor_submitter(void* arg) {
+
+	uintptr_t submitted = 0;
+	executor_t* executor = (executor_t*)arg;
+
+	while (executor_submit(executor, test_executor_count, NULL) == EXIT_SUCCESS) {
+		submitted++;
+	}
+
+	return (void*)(submitted);
+}
+
+/**
+ * \fn int test_executor_shutdown_race(int workers, int rounds)
+ * \brief Creates an executor, starts EXECUTOR_SUBMITTERS threads submitting to it from outside, and shuts it down while they are still submitting. Several submitters contending for the injection queue's lock widen the gap between a submit counting its task as pending and finding the queue closed. Repeated so that gap lands at every point of the shutdown
+ *
+ * \param workers Number of workers
+ * \param rounds Number of executors to create + shut down
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_executor_shutdown_race(int workers, int rounds) {
+
+	int r;
+	int t;
+	int started;
+	int result = EXIT_SUCCESS;
+	void* submitted;
+	uintptr_t submitted_total;
+	pthread_t submitter[EXECUTOR_SUBMITTERS];
+	executor_t* executor;
+
+	for (r = 0; r < rounds; r++) {
+
+		executor = executor_create(workers);
+		if (executor == NULL) {
+			return EXIT_FAILURE;
+		}
+
+		atomic_store(&test_executor_counter, 0);
+
+		for (started = 0; started < EXECUTOR_SUBMITTERS; started++) {
+			if (pthread_create(&submitter[started], NULL, test_executor_submitter, executor) != 0) {
+				result = EXIT_FAILURE;
+				break;
+			}
+		}
+
+		executor_shutdown(executor);
+
+		submitted_total = 0;
+		for (t = 0; t < started; t++) {
+			pthread_join(submitter[t], &submitted);
+			submitted_total += (uintptr_t)(submitted);
+		}
+
+		if ((executor_pending(executor) != 0) || ((uintptr_t)(atomic_load(&test_executor_counter)) != submitted_total)) {
+			result = EXIT_FAILURE;
+		}
+
+		executor_destroy(executor);
+	}
+
+	printf("	%d executors with %d workers shut down under racing submits\n", rounds, workers);
+
+	return result;
+}
+
+/**
+ * \fn void executor_dump_state(executor_t* executor)
+ * \brief Dumps each worker's metrics
+ *
+ * \param executor The executor in question
+ *
+ * \return N/A
+ */
+void executor_dump_state(executor_t* executor) {
+
+	int i;
+	executor_stats_t stats;
+
+	printf("\n***************************NEW EXECUTOR***************************\n");
+
+	if (executor == NULL) {
+		printf("\texecutor at NULL\n");
+		return;
+	}
+
+	printf("\texecutor at %p with %d workers, %u tasks pending\n", (void*)executor, executor_workers(executor), (unsigned int)executor_pending(executor));
+
+	for (i = 0; i < executor_workers(executor); i++) {
+		executor_stats(executor, i, &stats);
+		printf("\t\tWORKER[%d] : executed %llu, stolen %llu, local depth %u (max %u), latency avg %llu ns (max %llu ns)\n",
+			i,
+			(unsigned long long)(stats.executed),
+			(unsigned long long)(stats.stolen),
+			(unsigned int)(stats.local_depth),
+			(unsigned int)(stats.local_depth_max),
+			(unsigned long long)(stats.latency_avg_ns),
+			(unsigned long long)(stats.latency_max_ns));
+	}
+}
@@ -0,0 +1,294 @@
+/**
+ * \file test_ilfifo.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ilfifo.h"
+#include "test_ilfifo.h"
+
+#define GREEN "\x1B[32m"
+#define RESET "\x1B[0m"
+
+#define EXIT_FAILURE_N ((int)(-1))
+
+#define TEST_ILFIFO_ENQUEUE
+#define TEST_ILFIFO_DEQUEUE
+#define TEST_ILFIFO_LENGTH
+
+/**
+ * \typedef test_element_t
+ * \brief Allows struct test_element_s to be instantiated as test_element_t
+ */
+typedef struct test_element_s test_element_t;
+
+/**
+ * \struct test_element_s
+ * \brief A caller-owned struct with an embedded link, the way real users of ilfifo would queue their objects
+ *
+ * \detail char name[18] - Printable payload so the dump is readable
+ * \detail ilfifo_link_t link - Embedded link used by the FIFO
+ */
+struct test_element_s {
+	char name[18];
+	ilfifo_link_t link;
+};
+
+/**
+ * \fn void test_ilfifo()
+ * \brief Runs unit tests for happy cases + failure cases + boundary cases for each ilfifo function
+ *
+ * \param N/A
+ *
+ * \return N/A
+ */
+void test_ilfifo() {
+#ifdef TEST_ILFIFO_ENQUEUE
+	// Set first parameter to ilfifo to test with
+	// Set second parameter to the link embedded in the element to enqueue
+	// Set third parameter to how many links you want to dump
+
+	test_element_t element1_enqueue = { .name = "element1_enqueue" };
+	test_element_t element2_enqueue = { .name = "element2_enqueue" };
+	test_element_t element3_enqueue = { .name = "element3_enqueue" };
+
+	ilfifo_t ilfifo_enqueue;
+	ilfifo_init(&ilfifo_enqueue);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Enqueue element1 to ilfifo length 0. Resulting length will be 1
+	assert(test_ilfifo_enqueue(&ilfifo_enqueue, &element1_enqueue.link, 3) == EXIT_SUCCESS);
+	//		Enqueue element2 to ilfifo length 1. Resulting length will be 2
+	assert(test_ilfifo_enqueue(&ilfifo_enqueue, &element2_enqueue.link, 3) == EXIT_SUCCESS);
+	//		Enqueue element3 to ilfifo length 2. Resulting length will be 3
+	assert(test_ilfifo_enqueue(&ilfifo_enqueue, &element3_enqueue.link, 3) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to enqueue element1 to NULL ilfifo
+	assert(test_ilfifo_enqueue(NULL, &element1_enqueue.link, 3) == EXIT_FAILURE);
+	//		Attempt to enqueue NULL link to ilfifo
+	assert(test_ilfifo_enqueue(&ilfifo_enqueue, NULL, 3) == EXIT_FAILURE);
+#endif
+
+#ifdef TEST_ILFIFO_DEQUEUE
+	// Set first parameter to ilfifo to test with
+	// Set second parameter to the name of the element expected to come out, or NULL if the dequeue should fail
+	// Set third parameter to how many links you want to dump
+
+	test_element_t element1_dequeue = { .name = "element1_dequeue" };
+	test_element_t element2_dequeue = { .name = "element2_dequeue" };
+	test_element_t element3_dequeue = { .name = "element3_dequeue" };
+
+	ilfifo_t ilfifo_dequeue;
+	ilfifo_init(&ilfifo_dequeue);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	assert(test_ilfifo_enqueue(&ilfifo_dequeue, &element1_dequeue.link, 3) == EXIT_SUCCESS);
+	assert(test_ilfifo_enqueue(&ilfifo_dequeue, &element2_dequeue.link, 3) == EXIT_SUCCESS);
+	assert(test_ilfifo_enqueue(&ilfifo_dequeue, &element3_dequeue.link, 3) == EXIT_SUCCESS);
+	//		Dequeue element1 from ilfifo length 3. Resulting length will be 2
+	assert(test_ilfifo_dequeue(&ilfifo_dequeue, "element1_dequeue", 3) == EXIT_SUCCESS);
+	//		Re-enqueue element1 to ilfifo length 2. Resulting length will be 3
+	assert(test_ilfifo_enqueue(&ilfifo_dequeue, &element1_dequeue.link, 3) == EXIT_SUCCESS);
+	//		Dequeue element2, element3, element1 in that order. Resulting length will be 0
+	assert(test_ilfifo_dequeue(&ilfifo_dequeue, "element2_dequeue", 3) == EXIT_SUCCESS);
+	assert(test_ilfifo_dequeue(&ilfifo_dequeue, "element3_dequeue", 3) == EXIT_SUCCESS);
+	assert(test_ilfifo_dequeue(&ilfifo_dequeue, "element1_dequeue", 3) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to dequeue element from NULL ilfifo
+	assert(test_ilfifo_dequeue(NULL, NULL, 3) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Attempt to dequeue element from empty ilfifo
+	assert(test_ilfifo_dequeue(&ilfifo_dequeue, NULL, 3) == EXIT_FAILURE);
+	//		Enqueue + dequeue a single element so the FIFO goes from empty to empty again
+	assert(test_ilfifo_enqueue(&ilfifo_dequeue, &element2_dequeue.link, 3) == EXIT_SUCCESS);
+	assert(test_ilfifo_dequeue(&ilfifo_dequeue, "element2_dequeue", 3) == EXIT_SUCCESS);
+	assert(test_ilfifo_dequeue(&ilfifo_dequeue, NULL, 3) == EXIT_FAILURE);
+#endif
+
+#ifdef TEST_ILFIFO_LENGTH
+	// Set first parameter to ilfifo to test with
+	// Set second parameter to the expected length
+	// Set third parameter to how many links you want to dump
+
+	test_element_t element1_length = { .name = "element1_length" };
+	test_element_t element2_length = { .name = "element2_length" };
+
+	ilfifo_t ilfifo_length;
+	ilfifo_init(&ilfifo_length);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	assert(test_ilfifo_length(&ilfifo_length, 0, 2) == EXIT_SUCCESS);
+	assert(test_ilfifo_enqueue(&ilfifo_length, &element1_length.link, 2) == EXIT_SUCCESS);
+	assert(test_ilfifo_length(&ilfifo_length, 1, 2) == EXIT_SUCCESS);
+	assert(test_ilfifo_enqueue(&ilfifo_length, &element2_length.link, 2) == EXIT_SUCCESS);
+	assert(test_ilfifo_length(&ilfifo_length, 2, 2) == EXIT_SUCCESS);
+	assert(test_ilfifo_dequeue(&ilfifo_length, "element1_length", 2) == EXIT_SUCCESS);
+	assert(test_ilfifo_length(&ilfifo_length, 1, 2) == EXIT_SUCCESS);
+	assert(test_ilfifo_dequeue(&ilfifo_length, "element2_length", 2) == EXIT_SUCCESS);
+	assert(test_ilfifo_length(&ilfifo_length, 0, 2) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to grab length from NULL ilfifo
+	assert(test_ilfifo_length(NULL, EXIT_FAILURE_N, 2) == EXIT_FAILURE);
+#endif
+
+	printf("\n");
+
+#ifdef TEST_ILFIFO_ENQUEUE
+	printf(GREEN "Asserts for all test cases against ilfifo_enqueue have passed\n" RESET);
+#endif
+#ifdef TEST_ILFIFO_DEQUEUE
+	printf(GREEN "Asserts for all test cases against ilfifo_dequeue have passed\n" RESET);
+#endif
+#ifdef TEST_ILFIFO_LENGTH
+	printf(GREEN "Asserts for all test cases against ilfifo_length have passed\n" RESET);
+#endif
+}
+
+/**
+ * \fn int test_ilfifo_enqueue(ilfifo_t* fifo, ilfifo_link_t* link, int max_links)
+ * \brief Enqueues a link onto the FIFO
+ *
+ * \param fifo The fifo in question
+ * \param link The link to enqueue, which cannot be NULL
+ * \param max_links The number of links to dump from the FIFO
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_ilfifo_enqueue(ilfifo_t* fifo, ilfifo_link_t* link, int max_links) {
+
+	int length;
+
+	length = ilfifo_enqueue(fifo, link);
+	ilfifo_dump_state(fifo, max_links);
+
+	if (length != EXIT_FAILURE_N) {
+		return EXIT_SUCCESS;
+	}
+	else {
+		return EXIT_FAILURE;
+	}
+}
+
+/**
+ * \fn int test_ilfifo_dequeue(ilfifo_t* fifo, const char* expected, int max_links)
+ * \brief Removes ("dequeues") a link from the FIFO and checks it belongs to the expected element
+ *
+ * \param fifo The fifo in question
+ * \param expected Name of the element that should be dequeued
+ * \param max_links The number of links to dump from the FIFO
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_ilfifo_dequeue(ilfifo_t* fifo, const char* expected, int max_links) {
+
+	ilfifo_link_t* link;
+
+	link = ilfifo_dequeue(fifo);
+	ilfifo_dump_state(fifo, max_links);
+
+	if (link == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	// Ensure FIFO order was preserved
+	assert(strcmp(ILFIFO_ENTRY(link, test_element_t, link)->name, expected) == 0);
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int test_ilfifo_length(ilfifo_t* fifo, int expected, int max_links)
+ * \brief Returns the number of links currently on the FIFO and checks it against the expected length
+ *
+ * \param fifo The fifo in question
+ * \param expected The length the FIFO should report
+ * \param max_links The number of links to dump from the FIFO
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_ilfifo_length(ilfifo_t* fifo, int expected, int max_links) {
+
+	int length;
+
+	length = ilfifo_length(fifo);
+	ilfifo_dump_state(fifo, max_links);
+
+	assert(length == expected);
+
+	if (length != EXIT_FAILURE_N) {
+		return EXIT_SUCCESS;
+	}
+	else {
+		return EXIT_FAILURE;
+	}
+}
+
+/**
+ * \fn void ilfifo_dump_state(ilfifo_t* fifo, int max_links)
+ * \brief Dumps info about each link in the FIFO
+ *
+ * \param fifo Points to the FIFO for which to dump link info about
+ * \param max_links The number of links to dump, starting from the tail
+ *
+ * \return N/A
+ */
+void ilfifo_dump_state(ilfifo_t* fifo, int max_links) {
+
+	int i;
+	ilfifo_link_t* link;
+
+	printf("\n***************************NEW ILFIFO****************************\n");
+
+	if (fifo == NULL) {
+		printf("\tilfifo at NULL\n");
+		return;
+	}
+
+	printf("\tilfifo at %p\n", (void*)fifo);
+	printf("\tilfifo->head at %p\n", (void*)(fifo->head));
+	printf("\tilfifo->tail at %p\n", (void*)(fifo->tail));
+	printf("\tilfifo->length is %d\n", fifo->length);
+
+	printf("\t\t-----------------------------------------\n");
+
+	if (fifo->length == 0) {
+		printf("\t\tUSED : Empty list\n");
+		return;
+	}
+
+	printf("\t\tDisplaying %d out of %d links\n\n", (max_links > fifo->length) ? (fifo->length) : (max_links), fifo->length);
+
+	link = fifo->tail;
+	for (i = 0; (i < max_links) && (link != NULL); i++) {
+
+		if (i > 0) {
+			printf("\t\t|\n");
+			printf("\t\tV\n");
+		}
+
+		printf("\t\tUSED[%d] at %p : *data = %s\n", i, (void*)(link), ILFIFO_ENTRY(link, test_element_t, link)->name);
+
+		link = link->next;
+	}
+}
@@ -5,14 +5,21 @@
 
 #include <assert.h>
 #include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "llfifo.h"
+#include "llfifo_ext.h"
 #include "test_llfifo.h"
 
 #define LL_SIZE ((int)(3))
 
+#define TEST_LLFIFO_SYNC_ELEMENTS (10000)
+
 #define GREEN "\x1B[32m"
 #define RESET "\x1B[0m"
 
@@ -24,6 +31,22 @@
 #define TEST_LLFIFO_CAPACITY
 #define TEST_LLFIFO_LENGTH
 #define TEST_LLFIFO_DESTROY
+#define TEST_LLFIFO_BATCH
+#define TEST_LLFIFO_RESERVE
+#define TEST_LLFIFO_POOLED
+#define TEST_LLFIFO_SZ
+#define TEST_LLFIFO_ALLOCATOR
+#define TEST_LLFIFO_SYNC
+#define TEST_LLFIFO_LIMIT
+#define TEST_LLFIFO_SPLICE
+#define TEST_LLFIFO_FOREACH
+#define TEST_LLFIFO_CLEAR
+#ifdef FIFO_CODEL
+#define TEST_LLFIFO_CODEL
+#endif
+#ifdef FIFO_DEADLINE
+#define TEST_LLFIFO_DEADLINE
+#endif
 
 /**
  * \typedef llnode_t
@@ -38,13 +61,41 @@ typedef struct llnode_s llnode_t;
  * \detail void* data - Points to data
  * \detail llnode_t* - previous Points to node before in the linked list (towards the tail). If NULL then the node is the tail
  * \detail llnode_t* - next Points to node next in the linked list (towards the head). If NULL then the node is the head
+ * \detail uint64_t enqueued_ns - FIFO_SOJOURN + FIFO_CODEL builds only. sojourn_now_ns() when data was enqueued, or 0 if neither a histogram nor CoDel was on at the time
+ * \detail uint64_t deadline_ns - FIFO_DEADLINE builds only. sojourn_now_ns() time after which data is no longer worth handing out, set by llfifo_enqueue_deadline. 0 means no deadline
  */
 struct llnode_s {
 	void* data;
 	llnode_t* previous;
 	llnode_t* next;
+#ifdef LLFIFO_STAMPED
+	uint64_t enqueued_ns;
+#endif
+#ifdef FIFO_DEADLINE
+	uint64_t deadline_ns;
+#endif
 };
 
+/**
+ * \typedef llfifo_sync_t
+ * \brief Allows struct llfifo_sync_s to be instantiated as llfifo_sync_t. Only llfifo.c needs its layout
+ */
+typedef struct llfifo_sync_s llfifo_sync_t;
+
+#ifdef FIFO_CODEL
+/**
+ * \typedef llfifo_codel_t
+ * \brief Allows struct llfifo_codel_s to be instantiated as llfifo_codel_t. Only llfifo.c needs its layout
+ */
+typedef struct llfifo_codel_s llfifo_codel_t;
+#endif
+
+/**
+ * \typedef llblock_t
+ * \brief Allows struct llblock_s to be instantiated as llblock_t. Only ever handled by pointer here
+ */
+typedef struct llblock_s llblock_t;
+
 /**
   * \struct llfifo_s
   * \brief Keeps track of 2 separate lists of nodes, free + used. Free nodes are available to be enqueued with data while used nodes are available to be dequeued
@@ -53,18 +104,260 @@ struct llnode_s {
   * \detail llnode_t* tail_free - Points to tail node of free list. If NULL then the list of free nodes is empty
   * \detail llnode_t* head_used - Points to head node of used list. If NULL then the list of used nodes is empty
   * \detail llnode_t* tail_used - Points to tail node of used list. If NULL then the list of used nodes is empty
-  * \detail int capacity - The total number of nodes between both free list + used list that memory has been allocated for
-  * \detail int length - The number of nodes currently in the used list
+  * \detail size_t capacity - The total number of nodes between both free list + used list that memory has been allocated for. size_t so queues past INT_MAX elements work
+  * \detail size_t length - The number of nodes currently in the used list
+  * \detail llblock_t* blocks - Points to the most recently allocated block of nodes. Blocks are what actually get freed on destroy
+  * \detail llblock_t* blocks_last - Points to the oldest block, the end of the chain starting at blocks, so llfifo_splice can hand the whole chain to another FIFO without walking it. If NULL then the FIFO owns no blocks
+  * \detail nodepool_t* pool - Shared pool that nodes are drawn from + returned to. If NULL then the FIFO owns its nodes. If not NULL then the free list + blocks are always empty and capacity always equals length
+  * \detail fifo_allocator_t allocator - Where the FIFO itself + its blocks come from. llfifo_create uses malloc/free
+  * \detail llfifo_sync_t* sync - Lock + wakeup state set up by llfifo_enable_sync. If NULL then the FIFO is not thread-safe and every call runs unlocked
+  * \detail size_t limit - Most elements the FIFO may hold, set by llfifo_set_limit. Once length reaches it, enqueues report LLFIFO_FULL instead of allocating. If 0 then the FIFO is unbounded
+  * \detail sojourn_hist_t* sojourn - FIFO_SOJOURN builds only. Histogram that dequeues record each element's wait into, set by llfifo_set_sojourn. If NULL then nothing is stamped or recorded
+  * \detail llfifo_codel_t* codel - FIFO_CODEL builds only. CoDel state set up by llfifo_set_codel. If NULL then dequeues never drop
+  * \detail llfifo_drop_t reject - FIFO_DEADLINE builds only. Called with each element discarded for missing its deadline, set by llfifo_set_reject. May be NULL
+  * \detail void* reject_ctx - FIFO_DEADLINE builds only. Passed to reject
+  * \detail uint64_t tagged - FIFO_DEADLINE builds only. Elements enqueued with a deadline
+  * \detail uint64_t expired - FIFO_DEADLINE builds only. Elements discarded at dequeue because their deadline had passed
  */
 struct llfifo_s {
 	llnode_t* head_free;
 	llnode_t* tail_free;
 	llnode_t* head_used;
 	llnode_t* tail_used;
-	int capacity;
-	int length;
+	size_t capacity;
+	size_t length;
+	llblock_t* blocks;
+	llblock_t* blocks_last;
+	nodepool_t* pool;
+	fifo_allocator_t allocator;
+	llfifo_sync_t* sync;
+	size_t limit;
+#ifdef FIFO_SOJOURN
+	sojourn_hist_t* sojourn;
+#endif
+#ifdef FIFO_CODEL
+	llfifo_codel_t* codel;
+#endif
+#ifdef FIFO_DEADLINE
+	llfifo_drop_t reject;
+	void* reject_ctx;
+	uint64_t tagged;
+	uint64_t expired;
+#endif
+};
+
+/**
+ * \var static char test_llfifo_sync_element[]
+ * \brief Element enqueued by test_llfifo_sync_delayed_enqueue while the main thread waits for it
+ */
+static char test_llfifo_sync_element[] = "element2_sync";
+
+/**
+ * \typedef test_allocator_stats_t
+ * \brief Allows struct test_allocator_stats_s to be instantiated as test_allocator_stats_t
+ */
+typedef struct test_allocator_stats_s test_allocator_stats_t;
+
+/**
+ * \struct test_allocator_stats_s
+ * \brief Context for the counting allocator used to test llfifo_create_with_allocator
+ *
+ * \detail int allocs - Number of successful alloc calls
+ * \detail int frees - Number of free calls
+ * \detail size_t outstanding - Bytes allocated but not yet freed
+ * \detail int fail_after - Number of allocs to allow before returning NULL. Negative to never fail
+ * \detail unsigned char* arena - If not NULL, allocs are bumped out of this buffer instead of coming from malloc
+ * \detail size_t arena_used - Bytes of arena handed out so far
+ */
+struct test_allocator_stats_s {
+	int allocs;
+	int frees;
+	size_t outstanding;
+	int fail_after;
+	unsigned char* arena;
+	size_t arena_used;
+};
+
+/**
+ * \fn static void* test_allocator_alloc(void* ctx, size_t size)
+ * \brief Counting alloc hook backed by malloc, or by bumping through the arena if one is set
+ *
+ * \param ctx The test_allocator_stats_t to update
+ * \param size Number of bytes to allocate
+ *
+ * \return Pointer to the allocated memory, or NULL once fail_after allocs have been made
+ */
+static void* test_allocator_alloc(void* ctx, size_t size) {
+
+	void* ptr;
+	test_allocator_stats_t* stats = (test_allocator_stats_t*)ctx;
+
+	if (stats->allocs == stats->fail_after) {
+		return NULL;
+	}
+
+	stats->allocs++;
+	stats->outstanding += size;
+
+	if (stats->arena != NULL) {
+		ptr = stats->arena + stats->arena_used;
+		stats->arena_used += (size + 15) & ~((size_t)(15));
+		return ptr;
+	}
+
+	return malloc(size);
+}
+
+/**
+ * \fn static void test_allocator_free(void* ctx, void* ptr, size_t size)
+ * \brief Counting free hook backed by free
+ *
+ * \param ctx The test_allocator_stats_t to update
+ * \param ptr Memory to release
+ * \param size Number of bytes that were allocated for ptr
+ *
+ * \return N/A
+ */
+static void test_allocator_free(void* ctx, void* ptr, size_t size) {
+
+	test_allocator_stats_t* stats = (test_allocator_stats_t*)ctx;
+
+	stats->frees++;
+	stats->outstanding -= size;
+
+	free(ptr);
+}
+
+/**
+ * \typedef test_visit_t
+ * \brief Allows struct test_visit_s to be instantiated as test_visit_t
+ */
+typedef struct test_visit_s test_visit_t;
+
+/**
+ * \struct test_visit_s
+ * \brief Context for test_llfifo_visit, recording what llfifo_foreach handed it
+ *
+ * \detail void* seen[8] - Elements visited, in the order they were visited
+ * \detail int count - Number of elements visited
+ * \detail int stop_after - Number of elements to visit before asking the walk to stop. Negative to never stop
+ */
+struct test_visit_s {
+	void* seen[8];
+	int count;
+	int stop_after;
 };
 
+/**
+ * \fn static int test_llfifo_visit(void* element, void* ctx)
+ * \brief llfifo_foreach callback that records each element it is handed
+ *
+ * \param element The element being visited
+ * \param ctx The test_visit_t to record into
+ *
+ * \return Nonzero once stop_after elements have been visited, to stop the walk
+ */
+static int test_llfifo_visit(void* element, void* ctx) {
+
+	test_visit_t* visit = (test_visit_t*)ctx;
+
+	if (visit->count < 8) {
+		visit->seen[visit->count] = element;
+	}
+	visit->count++;
+
+	return (visit->count == visit->stop_after);
+}
+
+/**
+ * \var static int test_llfifo_dtor_calls
+ * \brief Number of times test_llfifo_dtor has run
+ */
+static int test_llfifo_dtor_calls;
+
+/**
+ * \fn static void test_llfifo_dtor(void* element)
+ * \brief Element destructor for llfifo_destroy_with + llfifo_clear: frees a heap-allocated element + counts the call
+ *
+ * \param element Element allocated with malloc
+ *
+ * \return N/A
+ */
+static void test_llfifo_dtor(void* element) {
+
+	test_llfifo_dtor_calls++;
+	free(element);
+}
+
+/**
+ * \fn static void* test_llfifo_heap_element(const char* name)
+ * \brief Copies name into a new heap allocation, standing in for a payload the FIFO's user owns
+ *
+ * \param name Text to copy
+ *
+ * \return The copy
+ */
+static void* test_llfifo_heap_element(const char* name) {
+
+	char* element;
+
+	element = (char*)malloc(strlen(name) + 1);
+	assert(element != NULL);
+	strcpy(element, name);
+
+	return element;
+}
+
+#ifdef FIFO_CODEL
+/**
+ * \fn static void test_llfifo_codel_drop(void* element, void* ctx)
+ * \brief Drop callback for llfifo_set_codel: counts the drop
+ *
+ * \param element The dropped element
+ * \param ctx Points to the int counting drops
+ *
+ * \return N/A
+ */
+static void test_llfifo_codel_drop(void* element, void* ctx) {
+
+	(void)(element);
+	(*(int*)(ctx))++;
+}
+
+/**
+ * \fn static void test_llfifo_sleep_ms(long ms)
+ * \brief Sleeps so queued elements age by at least ms milliseconds
+ *
+ * \param ms Milliseconds to sleep
+ *
+ * \return N/A
+ */
+static void test_llfifo_sleep_ms(long ms) {
+
+	struct timespec delay = { .tv_sec = 0, .tv_nsec = ms * 1000000L };
+
+	nanosleep(&delay, NULL);
+}
+
+#endif
+
+#ifdef FIFO_DEADLINE
+/**
+ * \fn static void test_llfifo_reject(void* element, void* ctx)
+ * \brief Reject callback for llfifo_set_reject: counts the expired element
+ *
+ * \param element The expired element
+ * \param ctx Points to the int counting rejects
+ *
+ * \return N/A
+ */
+static void test_llfifo_reject(void* element, void* ctx) {
+
+	(void)(element);
+	(*(int*)(ctx))++;
+}
+#endif
+
 /**
  * \fn void test_llfifo()
  * \brief Runs unit tests for happy cases + failure cases + boundary cases for each llfifo function
@@ -107,150 +400,1013 @@ void test_llfifo() {
 	assert(test_llfifo_create(INT_MIN, 1) == EXIT_FAILURE);
 #endif
 
-#ifdef TEST_LLFIFO_ENQUEUE
+#ifdef TEST_LLFIFO_BATCH
 	// Set first parameter to llfifo to test with
-	// Set second parameter to char* pointer (technically this can be any pointer but the dump function only prints %s in printf so for nice input stick with char*)
+	// Set second parameter to array of char* pointers to enqueue (or array to dequeue into)
+	// Set third parameter to number of elements in the batch
+	// Set fourth parameter to how many nodes you want to dump from each of free list + used list
+
+	char element1_batch[15] = "element1_batch";
+	char element2_batch[15] = "element2_batch";
+	char element3_batch[15] = "element3_batch";
+	char element4_batch[15] = "element4_batch";
+	char element5_batch[15] = "element5_batch";
+	void* elements_batch[5] = { element1_batch, element2_batch, element3_batch, element4_batch, element5_batch };
+	void* elements_null_batch[2] = { element1_batch, NULL };
+	void* out_batch[5];
+
+	llfifo_t* llfifo_batch;
+	llfifo_batch = llfifo_create(LL_SIZE);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Enqueue element1 + element2 to llfifo capacity 3, length 0. Resulting length will be 2
+	assert(test_llfifo_enqueue_batch(llfifo_batch, elements_batch, 2, LL_SIZE) == EXIT_SUCCESS);
+	//		Dequeue 1 element from llfifo capacity 3, length 2. Should be element1. Resulting length will be 1
+	assert(test_llfifo_dequeue_batch(llfifo_batch, out_batch, 1, LL_SIZE) == EXIT_SUCCESS);
+	assert(out_batch[0] == element1_batch);
+	//		Enqueue element3 + element4 + element5 to llfifo capacity 3, length 1. 1 node short, so capacity doubles. Resulting capacity will be 6. Resulting length will be 4
+	assert(test_llfifo_enqueue_batch(llfifo_batch, &elements_batch[2], 3, LL_SIZE + 1) == EXIT_SUCCESS);
+	assert(llfifo_capacity(llfifo_batch) == 2 * LL_SIZE);
+	//		Dequeue up to 5 elements from llfifo capacity 6, length 4. Should be element2 through element5. Resulting length will be 0
+	assert(test_llfifo_dequeue_batch(llfifo_batch, out_batch, 5, LL_SIZE + 1) == EXIT_SUCCESS);
+	assert(out_batch[0] == element2_batch);
+	assert(out_batch[1] == element3_batch);
+	assert(out_batch[2] == element4_batch);
+	assert(out_batch[3] == element5_batch);
+	assert(llfifo_length(llfifo_batch) == 0);
+	//		Batch and single operations interleave. Enqueue element1, then batch of all 5, then dequeue single. Should be element1
+	assert(test_llfifo_enqueue(llfifo_batch, (void*)element1_batch, LL_SIZE + 1) == EXIT_SUCCESS);
+	assert(test_llfifo_enqueue_batch(llfifo_batch, elements_batch, 5, LL_SIZE + 3) == EXIT_SUCCESS);
+	assert(llfifo_dequeue(llfifo_batch) == element1_batch);
+	assert(test_llfifo_dequeue_batch(llfifo_batch, out_batch, 5, LL_SIZE + 3) == EXIT_SUCCESS);
+	assert(out_batch[4] == element5_batch);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to enqueue batch to NULL llfifo
+	assert(test_llfifo_enqueue_batch(NULL, elements_batch, 2, LL_SIZE) == EXIT_FAILURE);
+	//		Attempt to enqueue batch containing a NULL element. Nothing should be enqueued
+	assert(test_llfifo_enqueue_batch(llfifo_batch, elements_null_batch, 2, LL_SIZE) == EXIT_FAILURE);
+	assert(llfifo_length(llfifo_batch) == 0);
+	//		Attempt to dequeue batch from NULL llfifo
+	assert(test_llfifo_dequeue_batch(NULL, out_batch, 2, LL_SIZE) == EXIT_FAILURE);
+	//		Attempt to dequeue batch into NULL array
+	assert(test_llfifo_dequeue_batch(llfifo_batch, NULL, 2, LL_SIZE) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Enqueue empty batch. Resulting length will be 0
+	assert(test_llfifo_enqueue_batch(llfifo_batch, elements_batch, 0, LL_SIZE) == EXIT_SUCCESS);
+	//		Dequeue batch from empty llfifo. Nothing is dequeued
+	assert(test_llfifo_dequeue_batch(llfifo_batch, out_batch, 5, LL_SIZE) == EXIT_FAILURE);
+
+	llfifo_destroy(llfifo_batch);
+#endif
+
+#ifdef TEST_LLFIFO_RESERVE
+	// Set first parameter to llfifo to test with
+	// Set second parameter to number of free nodes that should be available afterwards
 	// Set third parameter to how many nodes you want to dump from each of free list + used list
 
-	char element1_enqueue[17] = "element1_enqueue";
-	char element2_enqueue[17] = "element2_enqueue";
-	char element3_enqueue[17] = "element3_enqueue";
-	char element4_enqueue[17] = "element4_enqueue";
+	char element1_reserve[17] = "element1_reserve";
+	char element2_reserve[17] = "element2_reserve";
 
-	llfifo_t* llfifo_enqueue;
-	llfifo_enqueue = llfifo_create(LL_SIZE);
+	llfifo_t* llfifo_reserve_fifo;
+	llfifo_reserve_fifo = llfifo_create(0);
 
 	// ------------------- //
 	// Happy Test Cases    //
 	// ------------------- //
-	//		Enqueue element1 to llfifo capacity 3, length 0. Resulting length will be 1
-	assert(test_llfifo_enqueue(llfifo_enqueue, (void*)element1_enqueue, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element2 to llfifo capacity 3, length 1. Resulting length will be 2
-	assert(test_llfifo_enqueue(llfifo_enqueue, (void*)element2_enqueue, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element3 to llfifo capacity 3, length 2. Resulting length will be 3
-	assert(test_llfifo_enqueue(llfifo_enqueue, (void*)element3_enqueue, LL_SIZE) == EXIT_SUCCESS);
+	//		Reserve 4 free nodes in llfifo capacity 0, length 0. Resulting capacity will be 4
+	assert(test_llfifo_reserve(llfifo_reserve_fifo, 4, 4) == EXIT_SUCCESS);
+	assert(llfifo_capacity(llfifo_reserve_fifo) == 4);
+	//		Enqueue element1 + element2 to llfifo capacity 4. No growth needed. Resulting capacity will be 4
+	assert(test_llfifo_enqueue(llfifo_reserve_fifo, (void*)element1_reserve, 4) == EXIT_SUCCESS);
+	assert(test_llfifo_enqueue(llfifo_reserve_fifo, (void*)element2_reserve, 4) == EXIT_SUCCESS);
+	assert(llfifo_capacity(llfifo_reserve_fifo) == 4);
+	//		Reserve 2 free nodes in llfifo capacity 4, length 2. Already have 2 free so resulting capacity will be 4
+	assert(test_llfifo_reserve(llfifo_reserve_fifo, 2, 4) == EXIT_SUCCESS);
+	assert(llfifo_capacity(llfifo_reserve_fifo) == 4);
+	//		Reserve 5 free nodes in llfifo capacity 4, length 2. Only the shortfall of 3 is added. Resulting capacity will be 7
+	assert(test_llfifo_reserve(llfifo_reserve_fifo, 5, 4) == EXIT_SUCCESS);
+	assert(llfifo_capacity(llfifo_reserve_fifo) == 7);
+	//		Elements queued before the reserve come out in order
+	assert(llfifo_dequeue(llfifo_reserve_fifo) == element1_reserve);
+	assert(llfifo_dequeue(llfifo_reserve_fifo) == element2_reserve);
 
 	// ------------------- //
 	// Failure Test Cases  //
 	// ------------------- //
-	//		Attempt to enqueue element1 to NULL llfifo
-	assert(test_llfifo_enqueue(NULL, (void*)element1_enqueue, LL_SIZE) == EXIT_FAILURE);
-	//		Attempt to enqueue NULL element to llfifo
-	assert(test_llfifo_enqueue(llfifo_enqueue, NULL, LL_SIZE) == EXIT_FAILURE);
+	//		Attempt to reserve in NULL llfifo
+	assert(test_llfifo_reserve(NULL, 4, 4) == EXIT_FAILURE);
+	//		Attempt to reserve negative number of nodes
+	assert(test_llfifo_reserve(llfifo_reserve_fifo, -1, 4) == EXIT_FAILURE);
 
 	// ------------------- //
 	// Boundary Test Cases //
 	// ------------------- //
-	//		Enqueue element4 to llfifo capacity 3, length 3. Resulting capacity will be 4. Resulting length will be 4
-	assert(test_llfifo_enqueue(llfifo_enqueue, (void*)element4_enqueue, LL_SIZE + 1) == EXIT_SUCCESS);
+	//		Reserve 0 free nodes. Resulting capacity will be 7
+	assert(test_llfifo_reserve(llfifo_reserve_fifo, 0, 4) == EXIT_SUCCESS);
+	assert(llfifo_capacity(llfifo_reserve_fifo) == 7);
 
-	llfifo_destroy(llfifo_enqueue);
+	llfifo_destroy(llfifo_reserve_fifo);
 #endif
 
-#ifdef TEST_LLFIFO_DEQUEUE
+#ifdef TEST_LLFIFO_POOLED
+	// Set first parameter to pool shared by the llfifos under test
+	// Set second parameter to how many nodes you want to dump from each of free list + used list
+
+	char element1_pooled[16] = "element1_pooled";
+	char element2_pooled[16] = "element2_pooled";
+	char element3_pooled[16] = "element3_pooled";
+	void* elements_pooled[3] = { element1_pooled, element2_pooled, element3_pooled };
+	void* out_pooled[3];
+
+	nodepool_t* pool_pooled;
+	llfifo_t* llfifo_pooled_a;
+	llfifo_t* llfifo_pooled_b;
+	pool_pooled = llfifo_pool_create(4);
+	llfifo_pooled_a = llfifo_create_pooled(pool_pooled);
+	llfifo_pooled_b = llfifo_create_pooled(pool_pooled);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Pooled llfifo starts with capacity 0, length 0
+	assert(test_llfifo_pooled(llfifo_pooled_a, 0, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element1 + element2 to llfifo A. Capacity follows length. Resulting capacity 2, length 2
+	assert(test_llfifo_enqueue(llfifo_pooled_a, (void*)element1_pooled, LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_enqueue(llfifo_pooled_a, (void*)element2_pooled, LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_pooled(llfifo_pooled_a, 2, LL_SIZE) == EXIT_SUCCESS);
+	//		Dequeue element1 from llfifo A. Node goes back to the pool. Resulting capacity 1, length 1
+	assert(llfifo_dequeue(llfifo_pooled_a) == element1_pooled);
+	assert(test_llfifo_pooled(llfifo_pooled_a, 1, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue batch of 3 to llfifo B. Reuses the node llfifo A gave back, so the pool stays at 1 block of 4
+	assert(test_llfifo_enqueue_batch(llfifo_pooled_b, elements_pooled, 3, LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_pooled(llfifo_pooled_b, 3, LL_SIZE) == EXIT_SUCCESS);
+	assert(nodepool_allocated(pool_pooled) == 4);
+	//		Dequeue batch from llfifo B. Order is preserved
+	assert(test_llfifo_dequeue_batch(llfifo_pooled_b, out_pooled, 3, LL_SIZE) == EXIT_SUCCESS);
+	assert(out_pooled[0] == element1_pooled);
+	assert(out_pooled[2] == element3_pooled);
+	assert(test_llfifo_pooled(llfifo_pooled_b, 0, LL_SIZE) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to create pooled llfifo from NULL pool
+	assert(llfifo_create_pooled(NULL) == NULL);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Destroy llfifo A while it still holds element2. Its node goes back to the pool
+	llfifo_destroy(llfifo_pooled_a);
+	llfifo_destroy(llfifo_pooled_b);
+	assert(nodepool_allocated(pool_pooled) == 4);
+	nodepool_destroy(pool_pooled);
+#endif
+
+#ifdef TEST_LLFIFO_SZ
 	// Set first parameter to llfifo to test with
-	// Set second parameter to char* pointer (technically this can be any pointer but the dump function only prints %s in printf so for nice input stick with char*)
+	// Set second parameter to element to enqueue
 	// Set third parameter to how many nodes you want to dump from each of free list + used list
 
-	char element1_dequeue[17] = "element1_dequeue";
-	char element2_dequeue[17] = "element2_dequeue";
-	char element3_dequeue[17] = "element3_dequeue";
-	char element4_dequeue[17] = "element4_dequeue";
+	char element1_sz[13] = "element1_sz";
+	char element2_sz[13] = "element2_sz";
 
-	llfifo_t* llfifo_dequeue;
-	llfifo_dequeue = llfifo_create(LL_SIZE);
+	llfifo_t* llfifo_sz;
+	llfifo_sz = llfifo_create_sz((size_t)(LL_SIZE));
 
 	// ------------------- //
 	// Happy Test Cases    //
 	// ------------------- //
-	//		Enqueue element1 to llfifo capacity 3, length 0. Resulting length will be 1
-	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element1_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element2 to llfifo capacity 3, length 1. Resulting length will be 2
-	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element2_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element3 to llfifo capacity 3, length 2. Resulting length will be 3
-	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element3_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Dequeue element1 from llfifo capacity 3, length 3. Resulting length will be 2
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Dequeue element2 from llfifo capacity 3, length 2. Resulting length will be 1
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Dequeue element3 from llfifo capacity 3, length 1. Resulting length will be 0
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element3 to llfifo capacity 3, length 0. Resulting length will be 1
-	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element3_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element2 to llfifo capacity 3, length 1. Resulting length will be 2
-	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element2_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Dequeue element3 from llfifo capacity 3, length 2. Resulting length will be 1
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element1 to llfifo capacity 3, length 1. Resulting length will be 2
-	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element1_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Dequeue element2 from llfifo capacity 3, length 2. Resulting length will be 1
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Dequeue element1 from llfifo capacity 3, length 1. Resulting length will be 0
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element1 + element2 to llfifo capacity 3 through the size_t API. Resulting length will be 2
+	assert(test_llfifo_enqueue_sz(llfifo_sz, (void*)element1_sz, LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_enqueue_sz(llfifo_sz, (void*)element2_sz, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_length_sz(llfifo_sz) == 2);
+	assert(llfifo_capacity_sz(llfifo_sz) == (size_t)(LL_SIZE));
+	//		The int + size_t APIs agree while the FIFO is small
+	assert(llfifo_length(llfifo_sz) == 2);
+	assert(llfifo_dequeue(llfifo_sz) == element1_sz);
 
 	// ------------------- //
 	// Failure Test Cases  //
 	// ------------------- //
-	//		Attempt to dequeue element from NULL llfifo
-	assert(test_llfifo_dequeue(NULL, LL_SIZE) == EXIT_FAILURE);
+	//		Attempt to enqueue to NULL llfifo + enqueue NULL element
+	assert(test_llfifo_enqueue_sz(NULL, (void*)element1_sz, LL_SIZE) == EXIT_FAILURE);
+	assert(test_llfifo_enqueue_sz(llfifo_sz, NULL, LL_SIZE) == EXIT_FAILURE);
+	//		Attempt to grab length + capacity of NULL llfifo
+	assert(llfifo_length_sz(NULL) == (size_t)(-1));
+	assert(llfifo_capacity_sz(NULL) == (size_t)(-1));
 
 	// ------------------- //
 	// Boundary Test Cases //
 	// ------------------- //
-	//		Attempt to dequeue NULL element from llfifo
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_FAILURE);
-	//		Enqueue element1 to llfifo capacity 3, length 0. Resulting length will be 1
-	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element1_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element2 to llfifo capacity 3, length 1. Resulting length will be 2
-	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element2_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element3 to llfifo capacity 3, length 2. Resulting length will be 3
-	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element3_dequeue, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element4 to llfifo capacity 3, length 3. Resulting capacity will be 4. Resulting length will be 4
-	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element4_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Dequeue element1 from llfifo capacity 4, length 4. Resulting length will be 3
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Enqueue element1 to llfifo capacity 4, length 3. Resulting length will be 4
-	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element1_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Dequeue element2 from llfifo capacity 4, length 4. Resulting length will be 3
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Dequeue element3 from llfifo capacity 4, length 3. Resulting length will be 2
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Dequeue element4 from llfifo capacity 4, length 2. Resulting length will be 1
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Dequeue element1 from llfifo capacity 4, length 1. Resulting length will be 0
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Attempt to dequeue NULL element from llfifo
-	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE + 1) == EXIT_FAILURE);
+	//		Pretend the FIFO holds more than INT_MAX elements. The int API saturates instead of overflowing while the size_t API stays exact
+	llfifo_sz->length += (size_t)(INT_MAX);
+	llfifo_sz->capacity += (size_t)(INT_MAX);
+	assert(llfifo_length(llfifo_sz) == INT_MAX);
+	assert(llfifo_capacity(llfifo_sz) == INT_MAX);
+	assert(llfifo_length_sz(llfifo_sz) == (size_t)(INT_MAX) + 1);
+	llfifo_sz->length -= (size_t)(INT_MAX);
+	llfifo_sz->capacity -= (size_t)(INT_MAX);
+
+	llfifo_destroy(llfifo_sz);
+#endif
 
-	llfifo_destroy(llfifo_dequeue);
+#ifdef TEST_LLFIFO_ALLOCATOR
+	// Set first parameter to allocator to create the llfifo with
+	// Set second parameter to initial capacity
+	// Set third parameter to how many elements to enqueue, which grows the llfifo past its initial capacity
+	// Set fourth parameter to how many nodes you want to dump from each of free list + used list
+
+	_Alignas(16) unsigned char arena_allocator[512];
+	test_allocator_stats_t stats_allocator = { .allocs = 0, .frees = 0, .outstanding = 0, .fail_after = -1, .arena = NULL };
+	fifo_allocator_t counting_allocator = { test_allocator_alloc, test_allocator_free, &stats_allocator };
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Create llfifo capacity 2 + grow it to 4, which doubles it in one block. The FIFO + both blocks must come from the allocator and all go back on destroy
+	assert(test_llfifo_allocator(&counting_allocator, 2, 4, LL_SIZE) == EXIT_SUCCESS);
+	assert(stats_allocator.allocs == 3);
+	assert(stats_allocator.frees == 3);
+	assert(stats_allocator.outstanding == 0);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to create llfifo with NULL allocator + allocator without an alloc hook
+	assert(llfifo_create_with_allocator(2, NULL) == NULL);
+	counting_allocator.alloc = NULL;
+	assert(test_llfifo_allocator(&counting_allocator, 2, 0, LL_SIZE) == EXIT_FAILURE);
+	counting_allocator.alloc = test_allocator_alloc;
+	//		Attempt to create llfifo when the allocator fails on the block of nodes. The FIFO itself must be handed back
+	stats_allocator = (test_allocator_stats_t){ .allocs = 0, .frees = 0, .outstanding = 0, .fail_after = 1, .arena = NULL };
+	assert(test_llfifo_allocator(&counting_allocator, 2, 0, LL_SIZE) == EXIT_FAILURE);
+	assert(stats_allocator.outstanding == 0);
 
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Arena allocator with no free hook. Destroy must not try to free anything, the arena going out of scope releases it all at once
+	stats_allocator = (test_allocator_stats_t){ .allocs = 0, .frees = 0, .outstanding = 0, .fail_after = -1, .arena = arena_allocator };
+	counting_allocator.free = NULL;
+	assert(test_llfifo_allocator(&counting_allocator, 0, 1, LL_SIZE) == EXIT_SUCCESS);
+	assert(stats_allocator.allocs == 2);
+	assert(stats_allocator.frees == 0);
+	assert(stats_allocator.arena_used <= sizeof(arena_allocator));
 #endif
 
-#ifdef TEST_LLFIFO_CAPACITY
+#ifdef TEST_LLFIFO_SYNC
 	// Set first parameter to llfifo to test with
-	// Set second parameter to how many nodes you want to dump from each of free list + used list
+	// Set second parameter to how long to wait, in nanoseconds (0 for no wait, negative for forever)
+	// Set third parameter to the element expected to come out, or NULL if the wait should come back empty
+	// Set fourth parameter to how many nodes you want to dump from each of free list + used list
 
-	char element1_capacity[18] = "element1_capacity";
-	char element2_capacity[18] = "element2_capacity";
-	char element3_capacity[18] = "element3_capacity";
-	char element4_capacity[18] = "element4_capacity";
+	char element1_sync[14] = "element1_sync";
+	pthread_t thread_sync[4];
+	int i_sync;
 
-	llfifo_t* llfifo_capacity;
-	llfifo_capacity = llfifo_create(LL_SIZE);
+	llfifo_t* llfifo_sync;
+	llfifo_t* llfifo_unsync;
+	llfifo_t* llfifo_threads;
+	llfifo_sync = llfifo_create(LL_SIZE);
+	llfifo_unsync = llfifo_create(LL_SIZE);
+	assert(llfifo_enable_sync(llfifo_sync) == EXIT_SUCCESS);
 
 	// ------------------- //
 	// Happy Test Cases    //
 	// ------------------- //
-	//		Grab capacity of llfifo capacity 3, length 0. Answer should be 3
-	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element1 to llfifo capacity 3, length 0. Resulting length will be 1
-	assert(test_llfifo_enqueue(llfifo_capacity, (void*)element1_capacity, LL_SIZE) == EXIT_SUCCESS);
-	//		Grab capacity of llfifo capacity 3, length 1. Answer should be 3
-	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element2 to llfifo capacity 3, length 1. Resulting length will be 2
-	assert(test_llfifo_enqueue(llfifo_capacity, (void*)element2_capacity, LL_SIZE) == EXIT_SUCCESS);
-	//		Grab capacity of llfifo capacity 3, length 2. Answer should be 3
-	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE) == EXIT_SUCCESS);
+	//		Element already queued comes straight back without waiting
+	assert(test_llfifo_enqueue(llfifo_sync, (void*)element1_sync, LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_dequeue_wait(llfifo_sync, 0, element1_sync, LL_SIZE) == EXIT_SUCCESS);
+	//		Block forever on empty llfifo until another thread enqueues
+	assert(pthread_create(&thread_sync[0], NULL, test_llfifo_sync_delayed_enqueue, (void*)llfifo_sync) == 0);
+	assert(test_llfifo_dequeue_wait(llfifo_sync, -1, test_llfifo_sync_element, LL_SIZE) == EXIT_SUCCESS);
+	assert(pthread_join(thread_sync[0], NULL) == 0);
+	//		4 producers enqueue concurrently while this thread consumes everything. Elements are integers, so this llfifo is never dumped
+	llfifo_threads = llfifo_create(0);
+	assert(llfifo_enable_sync(llfifo_threads) == EXIT_SUCCESS);
+	for (i_sync = 0; i_sync < 4; i_sync++) {
+		assert(pthread_create(&thread_sync[i_sync], NULL, test_llfifo_sync_producer, (void*)llfifo_threads) == 0);
+	}
+	assert(test_llfifo_sync_consume(llfifo_threads, 4 * TEST_LLFIFO_SYNC_ELEMENTS) == EXIT_SUCCESS);
+	for (i_sync = 0; i_sync < 4; i_sync++) {
+		assert(pthread_join(thread_sync[i_sync], NULL) == 0);
+	}
+	llfifo_destroy(llfifo_threads);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to enable sync on NULL llfifo + on llfifo that is already synchronized
+	assert(llfifo_enable_sync(NULL) == EXIT_FAILURE);
+	assert(llfifo_enable_sync(llfifo_sync) == EXIT_FAILURE);
+	//		Attempt to close NULL llfifo + unsynchronized llfifo
+	assert(llfifo_close(NULL) == EXIT_FAILURE);
+	assert(llfifo_close(llfifo_unsync) == EXIT_FAILURE);
+	assert(llfifo_closed(NULL) == EXIT_FAILURE_N);
+	//		Attempt to wait on NULL llfifo
+	assert(test_llfifo_dequeue_wait(NULL, -1, NULL, LL_SIZE) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Unsynchronized llfifo can never be filled while we wait, so an empty one returns right away even with no timeout
+	assert(test_llfifo_dequeue_wait(llfifo_unsync, -1, NULL, LL_SIZE) == EXIT_FAILURE);
+	//		Wait on empty llfifo times out
+	assert(test_llfifo_dequeue_wait(llfifo_sync, 10000000LL, NULL, LL_SIZE) == EXIT_FAILURE);
+	assert(llfifo_closed(llfifo_sync) == 0);
+	//		Closing wakes a consumer blocked forever
+	assert(pthread_create(&thread_sync[0], NULL, test_llfifo_sync_delayed_close, (void*)llfifo_sync) == 0);
+	assert(test_llfifo_dequeue_wait(llfifo_sync, -1, NULL, LL_SIZE) == EXIT_FAILURE);
+	assert(pthread_join(thread_sync[0], NULL) == 0);
+	assert(llfifo_closed(llfifo_sync) == 1);
+	//		Closed llfifo refuses enqueues
+	assert(test_llfifo_enqueue(llfifo_sync, (void*)element1_sync, LL_SIZE) == EXIT_FAILURE);
+
+	llfifo_destroy(llfifo_sync);
+	llfifo_destroy(llfifo_unsync);
+
+	//		Elements queued before close are still handed out, then the llfifo reads as empty
+	llfifo_sync = llfifo_create(LL_SIZE);
+	assert(llfifo_enable_sync(llfifo_sync) == EXIT_SUCCESS);
+	assert(test_llfifo_enqueue(llfifo_sync, (void*)element1_sync, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_close(llfifo_sync) == EXIT_SUCCESS);
+	assert(test_llfifo_dequeue_wait(llfifo_sync, -1, element1_sync, LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_dequeue_wait(llfifo_sync, -1, NULL, LL_SIZE) == EXIT_FAILURE);
+	llfifo_destroy(llfifo_sync);
+#endif
+
+#ifdef TEST_LLFIFO_LIMIT
+	// Set first parameter to llfifo to test with
+	// Set second parameter to element to enqueue
+	// Set third parameter to how long to wait for room, in nanoseconds (0 for no wait, negative for forever)
+	// Set fourth parameter to the result llfifo_enqueue_wait should return
+	// Set fifth parameter to how many nodes you want to dump from each of free list + used list
+
+	char element1_limit[15] = "element1_limit";
+	char element2_limit[15] = "element2_limit";
+	char element3_limit[15] = "element3_limit";
+	void* elements_limit[2] = { (void*)element1_limit, (void*)element2_limit };
+	pthread_t thread_limit;
+
+	llfifo_t* llfifo_limit_test;
+	llfifo_limit_test = llfifo_create(0);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Bound llfifo capacity 0 to 2 elements, then fill it. Resulting length + capacity will be 2
+	assert(llfifo_limit(llfifo_limit_test) == 0);
+	assert(llfifo_set_limit(llfifo_limit_test, 2) == EXIT_SUCCESS);
+	assert(llfifo_limit(llfifo_limit_test) == 2);
+	assert(test_llfifo_enqueue_wait(llfifo_limit_test, (void*)element1_limit, 0, 1, LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_enqueue_wait(llfifo_limit_test, (void*)element2_limit, 0, 2, LL_SIZE) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to enqueue element3 to full llfifo. Reports full and allocates nothing
+	assert(test_llfifo_enqueue_wait(llfifo_limit_test, (void*)element3_limit, 0, LLFIFO_FULL, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_enqueue_sz(llfifo_limit_test, (void*)element3_limit) == LLFIFO_FULL_SZ);
+	assert(llfifo_enqueue_batch(llfifo_limit_test, elements_limit, 1) == LLFIFO_FULL);
+	assert(llfifo_capacity(llfifo_limit_test) == 2);
+	//		Attempt to bound + read the bound of NULL llfifo
+	assert(llfifo_set_limit(NULL, 2) == EXIT_FAILURE);
+	assert(llfifo_limit(NULL) == (size_t)(-1));
+	assert(test_llfifo_enqueue_wait(NULL, (void*)element1_limit, -1, EXIT_FAILURE_N, LL_SIZE) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Dequeuing makes room again
+	assert(llfifo_dequeue(llfifo_limit_test) == element1_limit);
+	assert(test_llfifo_enqueue_wait(llfifo_limit_test, (void*)element3_limit, 0, 2, LL_SIZE) == EXIT_SUCCESS);
+	//		Batch that would go 1 past the limit is refused whole, even though part of it would fit
+	assert(llfifo_dequeue(llfifo_limit_test) == element2_limit);
+	assert(llfifo_enqueue_batch(llfifo_limit_test, elements_limit, 2) == LLFIFO_FULL);
+	assert(llfifo_length(llfifo_limit_test) == 1);
+	//		Removing the limit lets the llfifo grow again
+	assert(llfifo_set_limit(llfifo_limit_test, 0) == EXIT_SUCCESS);
+	assert(llfifo_enqueue_batch(llfifo_limit_test, elements_limit, 2) == 3);
+	//		Lowering the limit below the current length drops nothing but refuses enqueues
+	assert(llfifo_set_limit(llfifo_limit_test, 1) == EXIT_SUCCESS);
+	assert(llfifo_length(llfifo_limit_test) == 3);
+	assert(test_llfifo_enqueue_wait(llfifo_limit_test, (void*)element3_limit, 0, LLFIFO_FULL, LL_SIZE) == EXIT_SUCCESS);
+	llfifo_destroy(llfifo_limit_test);
+
+	//		Synchronized llfifo at its limit: waiting times out, blocks until a consumer dequeues, and wakes on close
+	llfifo_limit_test = llfifo_create(0);
+	assert(llfifo_enable_sync(llfifo_limit_test) == EXIT_SUCCESS);
+	assert(llfifo_set_limit(llfifo_limit_test, 1) == EXIT_SUCCESS);
+	assert(test_llfifo_enqueue_wait(llfifo_limit_test, (void*)element1_limit, -1, 1, LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_enqueue_wait(llfifo_limit_test, (void*)element2_limit, 10000000LL, LLFIFO_FULL, LL_SIZE) == EXIT_SUCCESS);
+	assert(pthread_create(&thread_limit, NULL, test_llfifo_limit_delayed_dequeue, (void*)llfifo_limit_test) == 0);
+	assert(test_llfifo_enqueue_wait(llfifo_limit_test, (void*)element2_limit, -1, 1, LL_SIZE) == EXIT_SUCCESS);
+	assert(pthread_join(thread_limit, NULL) == 0);
+	assert(pthread_create(&thread_limit, NULL, test_llfifo_sync_delayed_close, (void*)llfifo_limit_test) == 0);
+	assert(test_llfifo_enqueue_wait(llfifo_limit_test, (void*)element3_limit, -1, EXIT_FAILURE_N, LL_SIZE) == EXIT_SUCCESS);
+	assert(pthread_join(thread_limit, NULL) == 0);
+	assert(llfifo_dequeue(llfifo_limit_test) == element2_limit);
+	llfifo_destroy(llfifo_limit_test);
+#endif
+
+#ifdef TEST_LLFIFO_SPLICE
+	// Set first parameter to llfifo to append to
+	// Set second parameter to llfifo to move every element from
+	// Set third parameter to the result llfifo_splice should return
+	// Set fourth parameter to how many nodes you want to dump from each of free list + used list
+
+	char element1_splice[16] = "element1_splice";
+	char element2_splice[16] = "element2_splice";
+	char element3_splice[16] = "element3_splice";
+	char element4_splice[16] = "element4_splice";
+	char element5_splice[16] = "element5_splice";
+	test_allocator_stats_t stats_splice = { .allocs = 0, .frees = 0, .outstanding = 0, .fail_after = -1, .arena = NULL };
+	fifo_allocator_t allocator_splice = { test_allocator_alloc, test_allocator_free, &stats_splice };
+	nodepool_t* pool_splice;
+
+	llfifo_t* llfifo_splice_dst;
+	llfifo_t* llfifo_splice_src;
+	llfifo_t* llfifo_splice_other;
+	llfifo_splice_dst = llfifo_create(2);
+	llfifo_splice_src = llfifo_create(4);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Splice llfifo length 3 capacity 4 onto llfifo length 2 capacity 2. Resulting length will be 5 + capacity will be 6, and src is left empty with capacity 0
+	assert(llfifo_enqueue(llfifo_splice_dst, (void*)element1_splice) == 1);
+	assert(llfifo_enqueue(llfifo_splice_dst, (void*)element2_splice) == 2);
+	assert(llfifo_enqueue(llfifo_splice_src, (void*)element3_splice) == 1);
+	assert(llfifo_enqueue(llfifo_splice_src, (void*)element4_splice) == 2);
+	assert(llfifo_enqueue(llfifo_splice_src, (void*)element5_splice) == 3);
+	assert(test_llfifo_splice(llfifo_splice_dst, llfifo_splice_src, 5, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_capacity(llfifo_splice_dst) == 6);
+	//		Elements come out in order, dst's first
+	assert(llfifo_dequeue(llfifo_splice_dst) == element1_splice);
+	assert(llfifo_dequeue(llfifo_splice_dst) == element2_splice);
+	assert(llfifo_dequeue(llfifo_splice_dst) == element3_splice);
+	//		Emptied src is still usable + grows again from capacity 0
+	assert(llfifo_enqueue(llfifo_splice_src, (void*)element1_splice) == 1);
+	assert(llfifo_capacity(llfifo_splice_src) == 1);
+	//		Splice back the other way. dst's remaining elements land after src's
+	assert(test_llfifo_splice(llfifo_splice_src, llfifo_splice_dst, 3, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_capacity(llfifo_splice_src) == 7);
+	assert(llfifo_dequeue(llfifo_splice_src) == element1_splice);
+	assert(llfifo_dequeue(llfifo_splice_src) == element4_splice);
+	assert(llfifo_dequeue(llfifo_splice_src) == element5_splice);
+	assert(llfifo_dequeue(llfifo_splice_src) == NULL);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to splice NULL llfifo + splice llfifo onto itself
+	assert(test_llfifo_splice(NULL, llfifo_splice_src, (size_t)(-1), LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_splice(llfifo_splice_dst, NULL, (size_t)(-1), LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_splice(llfifo_splice_dst, llfifo_splice_dst, (size_t)(-1), LL_SIZE) == EXIT_SUCCESS);
+	//		Attempt to splice between llfifos with different allocators. Nothing moves
+	assert(llfifo_enqueue(llfifo_splice_src, (void*)element1_splice) == 1);
+	llfifo_splice_other = llfifo_create_with_allocator(1, &allocator_splice);
+	assert(test_llfifo_splice(llfifo_splice_other, llfifo_splice_src, (size_t)(-1), LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_splice(llfifo_splice_src, llfifo_splice_other, (size_t)(-1), LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_length(llfifo_splice_src) == 1);
+	llfifo_destroy(llfifo_splice_other);
+	assert(stats_splice.outstanding == 0);
+	//		Attempt to splice between pooled + unpooled llfifos
+	pool_splice = llfifo_pool_create(4);
+	llfifo_splice_other = llfifo_create_pooled(pool_splice);
+	assert(test_llfifo_splice(llfifo_splice_other, llfifo_splice_src, (size_t)(-1), LL_SIZE) == EXIT_SUCCESS);
+	//		Attempt to splice into closed llfifo
+	assert(llfifo_enable_sync(llfifo_splice_dst) == EXIT_SUCCESS);
+	assert(llfifo_close(llfifo_splice_dst) == EXIT_SUCCESS);
+	assert(test_llfifo_splice(llfifo_splice_dst, llfifo_splice_src, (size_t)(-1), LL_SIZE) == EXIT_SUCCESS);
+	llfifo_destroy(llfifo_splice_dst);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Splice empty llfifo. Nothing moves but its free nodes, even onto a full bounded llfifo
+	llfifo_splice_dst = llfifo_create(0);
+	assert(llfifo_set_limit(llfifo_splice_src, 1) == EXIT_SUCCESS);
+	assert(llfifo_reserve(llfifo_splice_dst, 3) == 3);
+	assert(test_llfifo_splice(llfifo_splice_src, llfifo_splice_dst, 1, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_capacity(llfifo_splice_src) == 10);
+	//		Splice that would go past dst's limit is refused whole
+	assert(llfifo_enqueue(llfifo_splice_dst, (void*)element2_splice) == 1);
+	assert(test_llfifo_splice(llfifo_splice_src, llfifo_splice_dst, LLFIFO_FULL_SZ, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_length(llfifo_splice_dst) == 1);
+	assert(llfifo_set_limit(llfifo_splice_src, 2) == EXIT_SUCCESS);
+	assert(test_llfifo_splice(llfifo_splice_src, llfifo_splice_dst, 2, LL_SIZE) == EXIT_SUCCESS);
+	//		Pooled llfifos sharing a pool move their nodes without touching the pool
+	assert(llfifo_enqueue(llfifo_splice_other, (void*)element3_splice) == 1);
+	llfifo_destroy(llfifo_splice_dst);
+	llfifo_splice_dst = llfifo_create_pooled(pool_splice);
+	assert(llfifo_enqueue(llfifo_splice_dst, (void*)element4_splice) == 1);
+	assert(test_llfifo_splice(llfifo_splice_dst, llfifo_splice_other, 2, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_capacity(llfifo_splice_dst) == 2);
+	assert(llfifo_dequeue(llfifo_splice_dst) == element4_splice);
+	assert(llfifo_dequeue(llfifo_splice_dst) == element3_splice);
+	//		Synchronized llfifos are locked together
+	assert(llfifo_enable_sync(llfifo_splice_other) == EXIT_SUCCESS);
+	assert(llfifo_enqueue(llfifo_splice_other, (void*)element5_splice) == 1);
+	assert(test_llfifo_splice(llfifo_splice_dst, llfifo_splice_other, 1, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_dequeue_wait(llfifo_splice_dst, 0) == element5_splice);
+	llfifo_destroy(llfifo_splice_dst);
+	llfifo_destroy(llfifo_splice_other);
+	llfifo_destroy(llfifo_splice_src);
+	nodepool_destroy(pool_splice);
+#endif
+
+#ifdef TEST_LLFIFO_FOREACH
+	// Set first parameter to llfifo to test with
+	// Set second parameter to the elements expected to be visited, oldest first
+	// Set third parameter to how many elements to visit before stopping the walk, or -1 to visit them all
+	// Set fourth parameter to how many nodes you want to dump from each of free list + used list
+
+	char element1_foreach[17] = "element1_foreach";
+	char element2_foreach[17] = "element2_foreach";
+	char element3_foreach[17] = "element3_foreach";
+	void* expected_foreach[3] = { (void*)element1_foreach, (void*)element2_foreach, (void*)element3_foreach };
+	test_visit_t visit_foreach = { .count = 0, .stop_after = -1 };
+
+	llfifo_t* llfifo_foreach_test;
+	llfifo_foreach_test = llfifo_create(1);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Peek at llfifo length 1. Length stays 1
+	assert(llfifo_enqueue(llfifo_foreach_test, (void*)element1_foreach) == 1);
+	assert(llfifo_peek(llfifo_foreach_test) == element1_foreach);
+	assert(llfifo_length(llfifo_foreach_test) == 1);
+	//		Walk llfifo length 3. Every element is visited oldest first + nothing is dequeued
+	assert(llfifo_enqueue(llfifo_foreach_test, (void*)element2_foreach) == 2);
+	assert(llfifo_enqueue(llfifo_foreach_test, (void*)element3_foreach) == 3);
+	assert(test_llfifo_foreach(llfifo_foreach_test, expected_foreach, 3, -1, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_peek(llfifo_foreach_test) == element1_foreach);
+	//		Peek + walk follow dequeues
+	assert(llfifo_dequeue(llfifo_foreach_test) == element1_foreach);
+	assert(llfifo_peek(llfifo_foreach_test) == element2_foreach);
+	assert(test_llfifo_foreach(llfifo_foreach_test, &expected_foreach[1], 2, -1, LL_SIZE) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to peek at + walk NULL llfifo
+	assert(llfifo_peek(NULL) == NULL);
+	assert(llfifo_foreach(NULL, test_llfifo_visit, &visit_foreach) == (size_t)(-1));
+	//		Attempt to walk llfifo without a callback
+	assert(llfifo_foreach(llfifo_foreach_test, NULL, &visit_foreach) == (size_t)(-1));
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Callback stopping the walk after the first element
+	assert(test_llfifo_foreach(llfifo_foreach_test, &expected_foreach[1], 1, 1, LL_SIZE) == EXIT_SUCCESS);
+	//		Peek at + walk empty llfifo
+	assert(llfifo_dequeue(llfifo_foreach_test) == element2_foreach);
+	assert(llfifo_dequeue(llfifo_foreach_test) == element3_foreach);
+	assert(llfifo_peek(llfifo_foreach_test) == NULL);
+	assert(test_llfifo_foreach(llfifo_foreach_test, NULL, 0, -1, LL_SIZE) == EXIT_SUCCESS);
+	//		Synchronized llfifo is walked under its lock
+	assert(llfifo_enable_sync(llfifo_foreach_test) == EXIT_SUCCESS);
+	assert(llfifo_enqueue(llfifo_foreach_test, (void*)element3_foreach) == 1);
+	assert(llfifo_peek(llfifo_foreach_test) == element3_foreach);
+	assert(test_llfifo_foreach(llfifo_foreach_test, &expected_foreach[2], 1, -1, LL_SIZE) == EXIT_SUCCESS);
+	llfifo_destroy(llfifo_foreach_test);
+#endif
+
+#ifdef TEST_LLFIFO_CLEAR
+	// Set first parameter to llfifo to test with
+	// Set second parameter to destructor to run over each element, or NULL
+	// Set third parameter to nonzero to keep the nodes as free nodes, zero to free them
+	// Set fourth parameter to the number of elements expected to be removed
+	// Set fifth parameter to how many nodes you want to dump from each of free list + used list
+
+	nodepool_t* pool_clear;
+
+	llfifo_t* llfifo_clear_test;
+	llfifo_clear_test = llfifo_create(1);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Clear llfifo length 3 capacity 4 (grown from 1 by doubling), keeping its nodes. Every element is destroyed + resulting length will be 0 with capacity still 4
+	test_llfifo_dtor_calls = 0;
+	assert(llfifo_enqueue(llfifo_clear_test, test_llfifo_heap_element("element1_clear")) == 1);
+	assert(llfifo_enqueue(llfifo_clear_test, test_llfifo_heap_element("element2_clear")) == 2);
+	assert(llfifo_enqueue(llfifo_clear_test, test_llfifo_heap_element("element3_clear")) == 3);
+	assert(test_llfifo_clear(llfifo_clear_test, test_llfifo_dtor, 1, 3, LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_dtor_calls == 3);
+	assert(llfifo_capacity(llfifo_clear_test) == 4);
+	//		Refilling reuses the kept nodes
+	assert(llfifo_enqueue(llfifo_clear_test, test_llfifo_heap_element("element1_clear")) == 1);
+	assert(llfifo_enqueue(llfifo_clear_test, test_llfifo_heap_element("element2_clear")) == 2);
+	assert(llfifo_capacity(llfifo_clear_test) == 4);
+	//		Clear llfifo length 2, freeing its nodes. Resulting capacity will be 0
+	assert(test_llfifo_clear(llfifo_clear_test, test_llfifo_dtor, 0, 2, LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_dtor_calls == 5);
+	assert(llfifo_capacity(llfifo_clear_test) == 0);
+	//		Destroy llfifo length 2 along with its elements
+	assert(llfifo_enqueue(llfifo_clear_test, test_llfifo_heap_element("element1_clear")) == 1);
+	assert(llfifo_enqueue(llfifo_clear_test, test_llfifo_heap_element("element2_clear")) == 2);
+	llfifo_destroy_with(llfifo_clear_test, test_llfifo_dtor);
+	assert(test_llfifo_dtor_calls == 7);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to clear + destroy NULL llfifo
+	assert(test_llfifo_clear(NULL, test_llfifo_dtor, 1, (size_t)(-1), LL_SIZE) == EXIT_SUCCESS);
+	llfifo_destroy_with(NULL, test_llfifo_dtor);
+	assert(test_llfifo_dtor_calls == 7);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Clear empty llfifo + clear without a destructor
+	llfifo_clear_test = llfifo_create(2);
+	assert(test_llfifo_clear(llfifo_clear_test, test_llfifo_dtor, 0, 0, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_enqueue(llfifo_clear_test, (void*)"element1_clear") == 1);
+	assert(test_llfifo_clear(llfifo_clear_test, NULL, 1, 1, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_capacity(llfifo_clear_test) == 1);
+	//		Clear synchronized + bounded llfifo. Frees room under the limit again
+	assert(llfifo_enable_sync(llfifo_clear_test) == EXIT_SUCCESS);
+	assert(llfifo_set_limit(llfifo_clear_test, 1) == EXIT_SUCCESS);
+	assert(llfifo_enqueue(llfifo_clear_test, test_llfifo_heap_element("element1_clear")) == 1);
+	assert(llfifo_enqueue(llfifo_clear_test, (void*)"element2_clear") == LLFIFO_FULL);
+	assert(test_llfifo_clear(llfifo_clear_test, test_llfifo_dtor, 1, 1, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_enqueue(llfifo_clear_test, (void*)"element2_clear") == 1);
+	llfifo_destroy(llfifo_clear_test);
+	//		Pooled llfifo hands its nodes back to the pool whether or not it keeps them
+	pool_clear = llfifo_pool_create(4);
+	llfifo_clear_test = llfifo_create_pooled(pool_clear);
+	assert(llfifo_enqueue(llfifo_clear_test, test_llfifo_heap_element("element1_clear")) == 1);
+	assert(llfifo_enqueue(llfifo_clear_test, test_llfifo_heap_element("element2_clear")) == 2);
+	assert(test_llfifo_clear(llfifo_clear_test, test_llfifo_dtor, 1, 2, LL_SIZE) == EXIT_SUCCESS);
+	assert(llfifo_capacity(llfifo_clear_test) == 0);
+	assert(llfifo_enqueue(llfifo_clear_test, test_llfifo_heap_element("element3_clear")) == 1);
+	llfifo_destroy_with(llfifo_clear_test, test_llfifo_dtor);
+	assert(test_llfifo_dtor_calls == 11);
+	nodepool_destroy(pool_clear);
+#endif
+
+#ifdef TEST_LLFIFO_CODEL
+	// Set first parameter to llfifo to test with
+	// Set second parameter to the element the dequeue should hand out, or NULL if none
+	// Set third parameter to how many elements CoDel should have dropped so far
+	// Set fourth parameter to how many nodes you want to dump from each of free list + used list
+	// Waits are real time: target 2 ms, interval 20 ms, with every sleep leaving at least 10 ms of slack either side of a decision
+
+	int i_codel;
+	int drops_codel = 0;
+	char* elements_codel[10] = { "element0_codel", "element1_codel", "element2_codel", "element3_codel", "element4_codel", "element5_codel", "element6_codel", "element7_codel", "element8_codel", "element9_codel" };
+
+#ifdef FIFO_DEADLINE
+	pthread_t thread_codel;
+#endif
+
+	llfifo_t* llfifo_codel;
+	llfifo_t* llfifo_wait_codel;
+	llfifo_codel = llfifo_create(10);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	assert(llfifo_set_codel(llfifo_codel, 2000000, 20000000, test_llfifo_codel_drop, &drops_codel) == EXIT_SUCCESS);
+	for (i_codel = 0; i_codel < 10; i_codel++) {
+		assert(llfifo_enqueue(llfifo_codel, elements_codel[i_codel]) == (i_codel + 1));
+	}
+	test_llfifo_sleep_ms(5);
+	//		Waits are above target but not yet for a whole interval. Nothing is dropped
+	assert(test_llfifo_codel(llfifo_codel, "element0_codel", 0, 2) == EXIT_SUCCESS);
+	assert(test_llfifo_codel(llfifo_codel, "element1_codel", 0, 2) == EXIT_SUCCESS);
+	//		A whole interval later they still are. element2 is dropped + element3 handed out
+	test_llfifo_sleep_ms(21);
+	assert(test_llfifo_codel(llfifo_codel, "element3_codel", 1, 2) == EXIT_SUCCESS);
+	//		Next drop isn't due for another interval
+	assert(test_llfifo_codel(llfifo_codel, "element4_codel", 1, 2) == EXIT_SUCCESS);
+	//		Once it is, element5 is dropped. The drop after that comes interval / sqrt(2) later
+	test_llfifo_sleep_ms(21);
+	assert(test_llfifo_codel(llfifo_codel, "element6_codel", 2, 2) == EXIT_SUCCESS);
+	assert(drops_codel == 2);
+	//		A fresh element arriving behind the stale ones comes out once they have drained, without being dropped
+	assert(llfifo_enqueue(llfifo_codel, elements_codel[0]) == 4);
+	assert(test_llfifo_codel(llfifo_codel, "element7_codel", 2, 2) == EXIT_SUCCESS);
+	assert(test_llfifo_codel(llfifo_codel, "element8_codel", 2, 2) == EXIT_SUCCESS);
+	assert(test_llfifo_codel(llfifo_codel, "element9_codel", 2, 2) == EXIT_SUCCESS);
+	assert(test_llfifo_codel(llfifo_codel, "element0_codel", 2, 2) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to turn CoDel on for NULL llfifo
+	assert(llfifo_set_codel(NULL, 2000000, 20000000, NULL, NULL) == EXIT_FAILURE);
+	//		Attempt to turn CoDel on with an interval of 0
+	assert(llfifo_set_codel(llfifo_codel, 2000000, 0, NULL, NULL) == EXIT_FAILURE);
+	//		Attempt to read drops from NULL llfifo
+	assert(llfifo_codel_dropped(NULL) == (size_t)(-1));
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Dequeue from empty llfifo with CoDel on
+	assert(test_llfifo_codel(llfifo_codel, NULL, 2, 2) == EXIT_SUCCESS);
+	//		The last element left is never dropped, however long it waited
+	assert(llfifo_enqueue(llfifo_codel, elements_codel[1]) == 1);
+	test_llfifo_sleep_ms(25);
+	assert(test_llfifo_codel(llfifo_codel, "element1_codel", 2, 2) == EXIT_SUCCESS);
+	//		Turning CoDel off stops dropping + resets the count
+	assert(llfifo_set_codel(llfifo_codel, 0, 0, NULL, NULL) == EXIT_SUCCESS);
+	assert(llfifo_codel_dropped(llfifo_codel) == 0);
+	//		Blocking dequeue drops like llfifo_dequeue does, + still hands out the element behind the drop
+	llfifo_wait_codel = llfifo_create(10);
+	assert(llfifo_enable_sync(llfifo_wait_codel) == EXIT_SUCCESS);
+	assert(llfifo_set_codel(llfifo_wait_codel, 2000000, 20000000, test_llfifo_codel_drop, &drops_codel) == EXIT_SUCCESS);
+	for (i_codel = 0; i_codel < 4; i_codel++) {
+		assert(llfifo_enqueue(llfifo_wait_codel, elements_codel[i_codel]) == (i_codel + 1));
+	}
+	test_llfifo_sleep_ms(5);
+	assert(test_llfifo_dequeue_wait(llfifo_wait_codel, -1, elements_codel[0], 2) == EXIT_SUCCESS);
+	test_llfifo_sleep_ms(21);
+	assert(test_llfifo_dequeue_wait(llfifo_wait_codel, -1, elements_codel[2], 2) == EXIT_SUCCESS);
+	assert(llfifo_codel_dropped(llfifo_wait_codel) == 1);
+	assert(test_llfifo_dequeue_wait(llfifo_wait_codel, -1, elements_codel[3], 2) == EXIT_SUCCESS);
+	llfifo_destroy(llfifo_wait_codel);
+#ifdef FIFO_DEADLINE
+	//		CoDel drops an element + everything behind it has expired, which empties an open llfifo. The blocking dequeue keeps waiting for the live element another thread enqueues
+	llfifo_wait_codel = llfifo_create(10);
+	assert(llfifo_enable_sync(llfifo_wait_codel) == EXIT_SUCCESS);
+	assert(llfifo_set_codel(llfifo_wait_codel, 2000000, 20000000, test_llfifo_codel_drop, &drops_codel) == EXIT_SUCCESS);
+	assert(llfifo_enqueue(llfifo_wait_codel, elements_codel[0]) == 1);
+	assert(llfifo_enqueue(llfifo_wait_codel, elements_codel[1]) == 2);
+	assert(llfifo_enqueue_deadline(llfifo_wait_codel, elements_codel[2], 1) == 3);
+	assert(llfifo_enqueue_deadline(llfifo_wait_codel, elements_codel[3], 1) == 4);
+	test_llfifo_sleep_ms(5);
+	assert(test_llfifo_dequeue_wait(llfifo_wait_codel, -1, elements_codel[0], 2) == EXIT_SUCCESS);
+	test_llfifo_sleep_ms(21);
+	assert(pthread_create(&thread_codel, NULL, test_llfifo_sync_delayed_enqueue, (void*)llfifo_wait_codel) == 0);
+	assert(test_llfifo_dequeue_wait(llfifo_wait_codel, -1, test_llfifo_sync_element, 2) == EXIT_SUCCESS);
+	assert(pthread_join(thread_codel, NULL) == 0);
+	assert(llfifo_codel_dropped(llfifo_wait_codel) == 1);
+	assert(llfifo_closed(llfifo_wait_codel) == 0);
+	llfifo_destroy(llfifo_wait_codel);
+#endif
+
+	llfifo_destroy(llfifo_codel);
+#endif
+
+#ifdef TEST_LLFIFO_DEADLINE
+	// Set first parameter to llfifo to test with
+	// Set second parameter to the element the dequeue should hand out, or NULL if none
+	// Set third parameter to how many elements should have been discarded as expired so far
+	// Set fourth parameter to how many nodes you want to dump from each of free list + used list
+	// Deadlines are either long gone (1 ns after the clock's zero) or a minute away, so no test case depends on timing
+
+	int rejects_deadline = 0;
+	uint64_t past_deadline = 1;
+	uint64_t future_deadline = sojourn_now_ns() + 60000000000ull;
+	void* batch_deadline[3];
+	llfifo_deadline_stats_t stats_deadline;
+	char* elements_deadline[6] = { "element0_deadline", "element1_deadline", "element2_deadline", "element3_deadline", "element4_deadline", "element5_deadline" };
+
+	pthread_t thread_deadline;
+
+	llfifo_t* llfifo_deadline;
+	llfifo_t* llfifo_wait_deadline;
+	llfifo_deadline = llfifo_create(2);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	assert(llfifo_set_reject(llfifo_deadline, test_llfifo_reject, &rejects_deadline) == EXIT_SUCCESS);
+	assert(llfifo_enqueue_deadline(llfifo_deadline, elements_deadline[0], past_deadline) == 1);
+	assert(llfifo_enqueue_deadline(llfifo_deadline, elements_deadline[1], future_deadline) == 2);
+	assert(llfifo_enqueue(llfifo_deadline, elements_deadline[2]) == 3);
+	assert(llfifo_enqueue_deadline(llfifo_deadline, elements_deadline[3], past_deadline) == 4);
+	assert(llfifo_enqueue_deadline(llfifo_deadline, elements_deadline[4], past_deadline) == 5);
+	assert(llfifo_enqueue_deadline(llfifo_deadline, elements_deadline[5], future_deadline) == 6);
+	//		element0 has expired, so it goes to the reject callback + element1 is handed out
+	assert(test_llfifo_deadline(llfifo_deadline, "element1_deadline", 1, 6) == EXIT_SUCCESS);
+	//		Elements without a deadline never expire
+	assert(test_llfifo_deadline(llfifo_deadline, "element2_deadline", 1, 6) == EXIT_SUCCESS);
+	//		A batch takes 3 elements off but only hands out the 1 still live
+	assert(llfifo_dequeue_batch(llfifo_deadline, batch_deadline, 3) == 1);
+	assert(batch_deadline[0] == elements_deadline[5]);
+	assert(llfifo_length(llfifo_deadline) == 0);
+	assert(rejects_deadline == 3);
+	assert(llfifo_deadline_stats(llfifo_deadline, &stats_deadline) == EXIT_SUCCESS);
+	assert((stats_deadline.tagged == 5) && (stats_deadline.expired == 3));
+	//		Nodes that held expired elements are reused without their old deadline
+	assert(llfifo_enqueue(llfifo_deadline, elements_deadline[0]) == 1);
+	assert(test_llfifo_deadline(llfifo_deadline, "element0_deadline", 3, 6) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to enqueue with a deadline to NULL llfifo
+	assert(llfifo_enqueue_deadline(NULL, elements_deadline[0], future_deadline) == -1);
+	//		Attempt to enqueue NULL element with a deadline
+	assert(llfifo_enqueue_deadline(llfifo_deadline, NULL, future_deadline) == -1);
+	//		Attempt to set reject callback on NULL llfifo
+	assert(llfifo_set_reject(NULL, test_llfifo_reject, &rejects_deadline) == EXIT_FAILURE);
+	//		Attempt to read stats from NULL llfifo + into NULL stats
+	assert(llfifo_deadline_stats(NULL, &stats_deadline) == EXIT_FAILURE);
+	assert(llfifo_deadline_stats(llfifo_deadline, NULL) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Every queued element has expired, so the dequeue finds nothing to hand out
+	assert(llfifo_enqueue_deadline(llfifo_deadline, elements_deadline[1], past_deadline) == 1);
+	assert(llfifo_enqueue_deadline(llfifo_deadline, elements_deadline[2], past_deadline) == 2);
+	assert(test_llfifo_deadline(llfifo_deadline, NULL, 5, 6) == EXIT_SUCCESS);
+	assert(llfifo_length(llfifo_deadline) == 0);
+	//		Deadline of 0 means none, + is not counted as tagged
+	assert(llfifo_enqueue_deadline(llfifo_deadline, elements_deadline[3], 0) == 1);
+	assert(test_llfifo_deadline(llfifo_deadline, "element3_deadline", 5, 6) == EXIT_SUCCESS);
+	assert(llfifo_deadline_stats(llfifo_deadline, &stats_deadline) == EXIT_SUCCESS);
+	assert(stats_deadline.tagged == 7);
+	//		Expired elements are discarded silently without a reject callback
+	assert(llfifo_set_reject(llfifo_deadline, NULL, NULL) == EXIT_SUCCESS);
+	assert(llfifo_enqueue_deadline(llfifo_deadline, elements_deadline[4], past_deadline) == 1);
+	assert(test_llfifo_deadline(llfifo_deadline, NULL, 6, 6) == EXIT_SUCCESS);
+	assert(rejects_deadline == 5);
+	//		Bounded llfifo at its limit
+	assert(llfifo_set_limit(llfifo_deadline, 1) == EXIT_SUCCESS);
+	assert(llfifo_enqueue_deadline(llfifo_deadline, elements_deadline[5], future_deadline) == 1);
+	assert(llfifo_enqueue_deadline(llfifo_deadline, elements_deadline[0], future_deadline) == LLFIFO_FULL);
+	//		Blocking dequeue on an open llfifo whose only element has expired keeps waiting, + gets the live element another thread enqueues later
+	llfifo_wait_deadline = llfifo_create(LL_SIZE);
+	assert(llfifo_enable_sync(llfifo_wait_deadline) == EXIT_SUCCESS);
+	assert(llfifo_set_reject(llfifo_wait_deadline, test_llfifo_reject, &rejects_deadline) == EXIT_SUCCESS);
+	assert(llfifo_enqueue_deadline(llfifo_wait_deadline, elements_deadline[1], past_deadline) == 1);
+	assert(pthread_create(&thread_deadline, NULL, test_llfifo_sync_delayed_enqueue, (void*)llfifo_wait_deadline) == 0);
+	assert(test_llfifo_dequeue_wait(llfifo_wait_deadline, -1, test_llfifo_sync_element, LL_SIZE) == EXIT_SUCCESS);
+	assert(pthread_join(thread_deadline, NULL) == 0);
+	assert(rejects_deadline == 6);
+	//		Same, but with a timeout that runs out before anything live arrives
+	assert(llfifo_enqueue_deadline(llfifo_wait_deadline, elements_deadline[2], past_deadline) == 1);
+	assert(test_llfifo_dequeue_wait(llfifo_wait_deadline, 10000000LL, NULL, LL_SIZE) == EXIT_FAILURE);
+	assert(llfifo_closed(llfifo_wait_deadline) == 0);
+	assert(rejects_deadline == 7);
+
+	llfifo_destroy(llfifo_wait_deadline);
+	llfifo_destroy(llfifo_deadline);
+#endif
+
+#ifdef TEST_LLFIFO_ENQUEUE
+	// Set first parameter to llfifo to test with
+	// Set second parameter to char* pointer (technically this can be any pointer but the dump function only prints %s in printf so for nice input stick with char*)
+	// Set third parameter to how many nodes you want to dump from each of free list + used list
+
+	char element1_enqueue[17] = "element1_enqueue";
+	char element2_enqueue[17] = "element2_enqueue";
+	char element3_enqueue[17] = "element3_enqueue";
+	char element4_enqueue[17] = "element4_enqueue";
+
+	llfifo_t* llfifo_enqueue;
+	llfifo_enqueue = llfifo_create(LL_SIZE);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Enqueue element1 to llfifo capacity 3, length 0. Resulting length will be 1
+	assert(test_llfifo_enqueue(llfifo_enqueue, (void*)element1_enqueue, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element2 to llfifo capacity 3, length 1. Resulting length will be 2
+	assert(test_llfifo_enqueue(llfifo_enqueue, (void*)element2_enqueue, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element3 to llfifo capacity 3, length 2. Resulting length will be 3
+	assert(test_llfifo_enqueue(llfifo_enqueue, (void*)element3_enqueue, LL_SIZE) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to enqueue element1 to NULL llfifo
+	assert(test_llfifo_enqueue(NULL, (void*)element1_enqueue, LL_SIZE) == EXIT_FAILURE);
+	//		Attempt to enqueue NULL element to llfifo
+	assert(test_llfifo_enqueue(llfifo_enqueue, NULL, LL_SIZE) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Enqueue element4 to llfifo capacity 3, length 3. Capacity doubles. Resulting capacity will be 6. Resulting length will be 4
+	assert(test_llfifo_enqueue(llfifo_enqueue, (void*)element4_enqueue, LL_SIZE + 1) == EXIT_SUCCESS);
+
+	llfifo_destroy(llfifo_enqueue);
+#endif
+
+#ifdef TEST_LLFIFO_DEQUEUE
+	// Set first parameter to llfifo to test with
+	// Set second parameter to char* pointer (technically this can be any pointer but the dump function only prints %s in printf so for nice input stick with char*)
+	// Set third parameter to how many nodes you want to dump from each of free list + used list
+
+	char element1_dequeue[17] = "element1_dequeue";
+	char element2_dequeue[17] = "element2_dequeue";
+	char element3_dequeue[17] = "element3_dequeue";
+	char element4_dequeue[17] = "element4_dequeue";
+
+	llfifo_t* llfifo_dequeue;
+	llfifo_dequeue = llfifo_create(LL_SIZE);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Enqueue element1 to llfifo capacity 3, length 0. Resulting length will be 1
+	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element1_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element2 to llfifo capacity 3, length 1. Resulting length will be 2
+	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element2_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element3 to llfifo capacity 3, length 2. Resulting length will be 3
+	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element3_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Dequeue element1 from llfifo capacity 3, length 3. Resulting length will be 2
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Dequeue element2 from llfifo capacity 3, length 2. Resulting length will be 1
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Dequeue element3 from llfifo capacity 3, length 1. Resulting length will be 0
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element3 to llfifo capacity 3, length 0. Resulting length will be 1
+	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element3_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element2 to llfifo capacity 3, length 1. Resulting length will be 2
+	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element2_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Dequeue element3 from llfifo capacity 3, length 2. Resulting length will be 1
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element1 to llfifo capacity 3, length 1. Resulting length will be 2
+	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element1_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Dequeue element2 from llfifo capacity 3, length 2. Resulting length will be 1
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Dequeue element1 from llfifo capacity 3, length 1. Resulting length will be 0
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to dequeue element from NULL llfifo
+	assert(test_llfifo_dequeue(NULL, LL_SIZE) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Attempt to dequeue NULL element from llfifo
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE) == EXIT_FAILURE);
+	//		Enqueue element1 to llfifo capacity 3, length 0. Resulting length will be 1
+	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element1_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element2 to llfifo capacity 3, length 1. Resulting length will be 2
+	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element2_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element3 to llfifo capacity 3, length 2. Resulting length will be 3
+	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element3_dequeue, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element4 to llfifo capacity 3, length 3. Capacity doubles. Resulting capacity will be 6. Resulting length will be 4
+	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element4_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
+	//		Dequeue element1 from llfifo capacity 6, length 4. Resulting length will be 3
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
+	//		Enqueue element1 to llfifo capacity 6, length 3. Resulting length will be 4
+	assert(test_llfifo_enqueue(llfifo_dequeue, (void*)element1_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
+	//		Dequeue element2 from llfifo capacity 6, length 4. Resulting length will be 3
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
+	//		Dequeue element3 from llfifo capacity 6, length 3. Resulting length will be 2
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
+	//		Dequeue element4 from llfifo capacity 6, length 2. Resulting length will be 1
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
+	//		Dequeue element1 from llfifo capacity 6, length 1. Resulting length will be 0
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE + 1) == EXIT_SUCCESS);
+	//		Attempt to dequeue NULL element from llfifo
+	assert(test_llfifo_dequeue(llfifo_dequeue, LL_SIZE + 1) == EXIT_FAILURE);
+
+	llfifo_destroy(llfifo_dequeue);
+
+#endif
+
+#ifdef TEST_LLFIFO_CAPACITY
+	// Set first parameter to llfifo to test with
+	// Set second parameter to how many nodes you want to dump from each of free list + used list
+
+	char element1_capacity[18] = "element1_capacity";
+	char element2_capacity[18] = "element2_capacity";
+	char element3_capacity[18] = "element3_capacity";
+	char element4_capacity[18] = "element4_capacity";
+
+	llfifo_t* llfifo_capacity;
+	llfifo_capacity = llfifo_create(LL_SIZE);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Grab capacity of llfifo capacity 3, length 0. Answer should be 3
+	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element1 to llfifo capacity 3, length 0. Resulting length will be 1
+	assert(test_llfifo_enqueue(llfifo_capacity, (void*)element1_capacity, LL_SIZE) == EXIT_SUCCESS);
+	//		Grab capacity of llfifo capacity 3, length 1. Answer should be 3
+	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element2 to llfifo capacity 3, length 1. Resulting length will be 2
+	assert(test_llfifo_enqueue(llfifo_capacity, (void*)element2_capacity, LL_SIZE) == EXIT_SUCCESS);
+	//		Grab capacity of llfifo capacity 3, length 2. Answer should be 3
+	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE) == EXIT_SUCCESS);
 	//		Enqueue element3 to llfifo capacity 3, length 2. Resulting length will be 3
 	assert(test_llfifo_enqueue(llfifo_capacity, (void*)element3_capacity, LL_SIZE) == EXIT_SUCCESS);
 	//		Grab capacity of llfifo capacity 3, length 3. Answer should be 3
@@ -283,29 +1439,30 @@ void test_llfifo() {
 	assert(test_llfifo_enqueue(llfifo_capacity, (void*)element3_capacity, LL_SIZE) == EXIT_SUCCESS);
 	//		Grab capacity of llfifo capacity 3, length 3. Answer should be 3
 	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element4 to llfifo capacity 3, length 3. Resulting capacity will be 4. Resulting length will be 4
+	//		Enqueue element4 to llfifo capacity 3, length 3. Capacity doubles. Resulting capacity will be 6. Resulting length will be 4
 	assert(test_llfifo_enqueue(llfifo_capacity, (void*)element4_capacity, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Grab capacity of llfifo capacity 4, length 4. Answer should be 4
+	assert(llfifo_capacity_sz(llfifo_capacity) == (size_t)(2 * LL_SIZE));
+	//		Grab capacity of llfifo capacity 6, length 4. Answer should be 6
 	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Dequeue element1 from llfifo capacity 4, length 4. Resulting length will be 3
+	//		Dequeue element1 from llfifo capacity 6, length 4. Resulting length will be 3
 	assert(test_llfifo_dequeue(llfifo_capacity, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Grab capacity of llfifo capacity 4, length 3. Answer should be 4
+	//		Grab capacity of llfifo capacity 6, length 3. Answer should be 6
 	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Dequeue element2 from llfifo capacity 4, length 3. Resulting length will be 2
+	//		Dequeue element2 from llfifo capacity 6, length 3. Resulting length will be 2
 	assert(test_llfifo_dequeue(llfifo_capacity, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Grab capacity of llfifo capacity 4, length 2. Answer should be 4
+	//		Grab capacity of llfifo capacity 6, length 2. Answer should be 6
 	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Dequeue element3 from llfifo capacity 4, length 2. Resulting length will be 1
+	//		Dequeue element3 from llfifo capacity 6, length 2. Resulting length will be 1
 	assert(test_llfifo_dequeue(llfifo_capacity, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Grab capacity of llfifo capacity 4, length 1. Answer should be 4
+	//		Grab capacity of llfifo capacity 6, length 1. Answer should be 6
 	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Dequeue element4 from llfifo capacity 4, length 1. Resulting length will be 0
+	//		Dequeue element4 from llfifo capacity 6, length 1. Resulting length will be 0
 	assert(test_llfifo_dequeue(llfifo_capacity, LL_SIZE + 1) == EXIT_SUCCESS);
-	//		Grab capacity of llfifo capacity 4, length 0. Answer should be 4
+	//		Grab capacity of llfifo capacity 6, length 0. Answer should be 6
 	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE + 1) == EXIT_SUCCESS);
 	//		Attempt to dequeue NULL element from llfifo
 	assert(test_llfifo_dequeue(llfifo_capacity, LL_SIZE + 1) == EXIT_FAILURE);
-	//		Grab capacity of llfifo capacity 4, length 0. Answer should be 4
+	//		Grab capacity of llfifo capacity 6, length 0. Answer should be 6
 	assert(test_llfifo_capacity(llfifo_capacity, LL_SIZE + 1) == EXIT_SUCCESS);
 
 	// ------------------- //
@@ -381,27 +1538,27 @@ void test_llfifo() {
 	assert(test_llfifo_length(llfifo_length, LL_SIZE) == EXIT_SUCCESS);
 	//		Enqueue element4 to llfifo capacity 3, length 3. Resulting length will be 4
 	assert(test_llfifo_enqueue(llfifo_length, (void*)element4_length, LL_SIZE) == EXIT_SUCCESS);
-	//		Grab length of llfifo capacity 4, length 4. Answer should be 4
+	//		Grab length of llfifo capacity 6, length 4. Answer should be 4
 	assert(test_llfifo_length(llfifo_length, LL_SIZE) == EXIT_SUCCESS);
-	//		Dequeue element1 from llfifo capacity 4, length 4. Resulting length will be 3
+	//		Dequeue element1 from llfifo capacity 6, length 4. Resulting length will be 3
 	assert(test_llfifo_dequeue(llfifo_length, LL_SIZE) == EXIT_SUCCESS);
-	//		Grab length of llfifo capacity 4, length 3. Answer should be 3
+	//		Grab length of llfifo capacity 6, length 3. Answer should be 3
 	assert(test_llfifo_length(llfifo_length, LL_SIZE) == EXIT_SUCCESS);
-	//		Dequeue element2 from llfifo capacity 4, length 3. Resulting length will be 2
+	//		Dequeue element2 from llfifo capacity 6, length 3. Resulting length will be 2
 	assert(test_llfifo_dequeue(llfifo_length, LL_SIZE) == EXIT_SUCCESS);
-	//		Grab length of llfifo capacity 4, length 2. Answer should be 2
+	//		Grab length of llfifo capacity 6, length 2. Answer should be 2
 	assert(test_llfifo_length(llfifo_length, LL_SIZE) == EXIT_SUCCESS);
-	//		Dequeue element3 from llfifo capacity 4, length 2. Resulting length will be 1
+	//		Dequeue element3 from llfifo capacity 6, length 2. Resulting length will be 1
 	assert(test_llfifo_dequeue(llfifo_length, LL_SIZE) == EXIT_SUCCESS);
-	//		Grab length of llfifo capacity 4, length 1. Answer should be 1
+	//		Grab length of llfifo capacity 6, length 1. Answer should be 1
 	assert(test_llfifo_length(llfifo_length, LL_SIZE) == EXIT_SUCCESS);
-	//		Dequeue element4 from llfifo capacity 4, length 1. Resulting length will be 0
+	//		Dequeue element4 from llfifo capacity 6, length 1. Resulting length will be 0
 	assert(test_llfifo_dequeue(llfifo_length, LL_SIZE) == EXIT_SUCCESS);
-	//		Grab length of llfifo capacity 4, length 0. Answer should be 0
+	//		Grab length of llfifo capacity 6, length 0. Answer should be 0
 	assert(test_llfifo_length(llfifo_length, LL_SIZE) == EXIT_SUCCESS);
 	//		Attempt to dequeue NULL element from llfifo
 	assert(test_llfifo_dequeue(llfifo_length, LL_SIZE) == EXIT_FAILURE);
-	//		Grab length of llfifo capacity 4, length 0. Answer should be 0
+	//		Grab length of llfifo capacity 6, length 0. Answer should be 0
 	assert(test_llfifo_length(llfifo_length, LL_SIZE) == EXIT_SUCCESS);
 
 	// ------------------- //
@@ -465,9 +1622,9 @@ void test_llfifo() {
 	assert(test_llfifo_enqueue(llfifo_destroy, (void*)element2_destroy, LL_SIZE) == EXIT_SUCCESS);
 	//		Enqueue element3 to llfifo capacity 3, length 2. Resulting length will be 3
 	assert(test_llfifo_enqueue(llfifo_destroy, (void*)element3_destroy, LL_SIZE) == EXIT_SUCCESS);
-	//		Enqueue element4 to llfifo capacity 3, length 3. Resulting capacity will be 4. Resulting length will be 4
+	//		Enqueue element4 to llfifo capacity 3, length 3. Capacity doubles. Resulting capacity will be 6. Resulting length will be 4
 	assert(test_llfifo_enqueue(llfifo_destroy, (void*)element4_destroy, LL_SIZE) == EXIT_SUCCESS);
-	//		Destroy llfifo with capacity 4, length 4
+	//		Destroy llfifo with capacity 6, length 4
 	assert((test_llfifo_destroy(llfifo_destroy)) == EXIT_SUCCESS);
 	//		Create llfifo with capacity 3, length 0
 	llfifo_destroy = llfifo_create(LL_SIZE);
@@ -511,8 +1668,44 @@ void test_llfifo() {
 #ifdef TEST_LLFIFO_DESTROY
 	printf(GREEN "Asserts for all test cases against llfifo_destroy have passed\n" RESET);
 #endif
-}
-
+#ifdef TEST_LLFIFO_BATCH
+	printf(GREEN "Asserts for all test cases against llfifo_enqueue_batch + llfifo_dequeue_batch have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_RESERVE
+	printf(GREEN "Asserts for all test cases against llfifo_reserve have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_POOLED
+	printf(GREEN "Asserts for all test cases against llfifo_create_pooled have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_SZ
+	printf(GREEN "Asserts for all test cases against llfifo size_t API have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_ALLOCATOR
+	printf(GREEN "Asserts for all test cases against llfifo_create_with_allocator have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_SYNC
+	printf(GREEN "Asserts for all test cases against llfifo synchronized mode have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_LIMIT
+	printf(GREEN "Asserts for all test cases against llfifo bounded mode have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_SPLICE
+	printf(GREEN "Asserts for all test cases against llfifo_splice have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_FOREACH
+	printf(GREEN "Asserts for all test cases against llfifo_peek + llfifo_foreach have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_CLEAR
+	printf(GREEN "Asserts for all test cases against llfifo_clear + llfifo_destroy_with have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_CODEL
+	printf(GREEN "Asserts for all test cases against llfifo_set_codel have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_DEADLINE
+	printf(GREEN "Asserts for all test cases against llfifo_enqueue_deadline have passed\n" RESET);
+#endif
+}
+
 /**
  * \fn int test_llfifo_create(int capacity)
  * \brief Creates and initializes the FIFO
@@ -650,6 +1843,486 @@ int test_llfifo_destroy(llfifo_t* fifo) {
 	return EXIT_SUCCESS;
 }
 
+/**
+ * \fn int test_llfifo_enqueue_batch(llfifo_t* fifo, void** elements, int n, int max_nodes)
+ * \brief Enqueues n elements onto the FIFO in one call
+ *
+ * \param fifo The fifo in question
+ * \param elements Array of elements to enqueue, none of which can be NULL
+ * \param n Number of elements in the array
+ * \param max_nodes The number of nodes to dump from each of free list + used list. If max_node is less than the total nodes in either list, it will dump (max_node - 1) nodes from the tail and then dump the head
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_enqueue_batch(llfifo_t* fifo, void** elements, int n, int max_nodes) {
+
+	int length;
+
+	length = llfifo_enqueue_batch(fifo, elements, n);
+	llfifo_dump_state(fifo, max_nodes);
+
+	if (length != EXIT_FAILURE_N) {
+		return EXIT_SUCCESS;
+	}
+	else {
+		return EXIT_FAILURE;
+	}
+}
+
+/**
+ * \fn int test_llfifo_dequeue_batch(llfifo_t* fifo, void** out, int max, int max_nodes)
+ * \brief Removes ("dequeues") up to max elements from the FIFO in one call
+ *
+ * \param fifo The fifo in question
+ * \param out Destination array for the dequeued elements
+ * \param max Max number of elements to dequeue
+ * \param max_nodes The number of nodes to dump from each of free list + used list. If max_node is less than the total nodes in either list, it will dump (max_node - 1) nodes from the tail and then dump the head
+ *
+ * \return If at least 1 element was dequeued, returns EXIT_SUCCESS (0). Otherwise the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_dequeue_batch(llfifo_t* fifo, void** out, int max, int max_nodes) {
+
+	int count;
+
+	count = llfifo_dequeue_batch(fifo, out, max);
+	llfifo_dump_state(fifo, max_nodes);
+
+	if ((count != EXIT_FAILURE_N) && (count > 0)) {
+		return EXIT_SUCCESS;
+	}
+	else {
+		return EXIT_FAILURE;
+	}
+}
+
+/**
+ * \fn int test_llfifo_reserve(llfifo_t* fifo, int n, int max_nodes)
+ * \brief Grows the FIFO up front so at least n free nodes are available
+ *
+ * \param fifo The fifo in question
+ * \param n Number of free nodes that should be available after the call
+ * \param max_nodes The number of nodes to dump from each of free list + used list. If max_node is less than the total nodes in either list, it will dump (max_node - 1) nodes from the tail and then dump the head
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_reserve(llfifo_t* fifo, int n, int max_nodes) {
+
+	int capacity;
+
+	capacity = llfifo_reserve(fifo, n);
+	llfifo_dump_state(fifo, max_nodes);
+
+	if (capacity != EXIT_FAILURE_N) {
+		return EXIT_SUCCESS;
+	}
+	else {
+		return EXIT_FAILURE;
+	}
+}
+
+/**
+ * \fn int test_llfifo_pooled(llfifo_t* fifo, int expected, int max_nodes)
+ * \brief Checks that a pooled FIFO holds exactly as many nodes as it has queued elements
+ *
+ * \param fifo The fifo in question
+ * \param expected The length (and so capacity) the FIFO should report
+ * \param max_nodes The number of nodes to dump from each of free list + used list. If max_node is less than the total nodes in either list, it will dump (max_node - 1) nodes from the tail and then dump the head
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_pooled(llfifo_t* fifo, int expected, int max_nodes) {
+
+	llfifo_dump_state(fifo, max_nodes);
+
+	if ((fifo != NULL) && (fifo->length == (size_t)(expected)) && (fifo->capacity == (size_t)(expected)) && (fifo->head_free == NULL) && (fifo->blocks == NULL)) {
+		return EXIT_SUCCESS;
+	}
+	else {
+		return EXIT_FAILURE;
+	}
+}
+
+/**
+ * \fn int test_llfifo_enqueue_sz(llfifo_t* fifo, void* element, int max_nodes)
+ * \brief Enqueues an element onto the FIFO through the size_t API
+ *
+ * \param fifo The fifo in question
+ * \param element The element to enqueue, which cannot be NULL
+ * \param max_nodes The number of nodes to dump from each of free list + used list. If max_node is less than the total nodes in either list, it will dump (max_node - 1) nodes from the tail and then dump the head
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_enqueue_sz(llfifo_t* fifo, void* element, int max_nodes) {
+
+	size_t length;
+
+	length = llfifo_enqueue_sz(fifo, element);
+	llfifo_dump_state(fifo, max_nodes);
+
+	if (length != (size_t)(-1)) {
+		return EXIT_SUCCESS;
+	}
+	else {
+		return EXIT_FAILURE;
+	}
+}
+
+/**
+ * \fn int test_llfifo_allocator(fifo_allocator_t* allocator, size_t capacity, int enqueues, int max_nodes)
+ * \brief Creates a FIFO on the given allocator, enqueues + dequeues elements through it, then destroys it
+ *
+ * \param allocator The allocator to create the FIFO with
+ * \param capacity Initial size of the FIFO, in number of elements
+ * \param enqueues Number of elements to enqueue before draining
+ * \param max_nodes The number of nodes to dump from each of free list + used list. If max_node is less than the total nodes in either list, it will dump (max_node - 1) nodes from the tail and then dump the head
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_allocator(fifo_allocator_t* allocator, size_t capacity, int enqueues, int max_nodes) {
+
+	int i;
+	char element[] = "element_allocator";
+	llfifo_t* fifo;
+
+	fifo = llfifo_create_with_allocator(capacity, allocator);
+	if (fifo == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < enqueues; i++) {
+		assert(llfifo_enqueue(fifo, (void*)element) == (i + 1));
+	}
+	llfifo_dump_state(fifo, max_nodes);
+
+	for (i = 0; i < enqueues; i++) {
+		assert(llfifo_dequeue(fifo) == element);
+	}
+	llfifo_destroy(fifo);
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int test_llfifo_dequeue_wait(llfifo_t* fifo, long long timeout_ns, void* expected, int max_nodes)
+ * \brief Dequeues an element, waiting for one if the FIFO is empty, and checks it is the expected one
+ *
+ * \param fifo The fifo in question
+ * \param timeout_ns Longest time to wait, in nanoseconds. 0 doesn't wait at all, negative waits forever
+ * \param expected The element that should come out, or NULL if nothing should
+ * \param max_nodes The number of nodes to dump from each of free list + used list. If max_node is less than the total nodes in either list, it will dump (max_node - 1) nodes from the tail and then dump the head
+ *
+ * \return If an element was dequeued, returns EXIT_SUCCESS (0). If the wait came back empty, the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_dequeue_wait(llfifo_t* fifo, long long timeout_ns, void* expected, int max_nodes) {
+
+	void* element;
+
+	element = llfifo_dequeue_wait(fifo, timeout_ns);
+	llfifo_dump_state(fifo, max_nodes);
+
+	assert(element == expected);
+
+	if (element != NULL) {
+		return EXIT_SUCCESS;
+	}
+	else {
+		return EXIT_FAILURE;
+	}
+}
+
+/**
+ * \fn void* test_llfifo_sync_delayed_enqueue(void* fifo)
+ * \brief Thread body: sleeps a moment so the main thread is already waiting, then enqueues test_llfifo_sync_element
+ *
+ * \param fifo The synchronized llfifo_t to enqueue to
+ *
+ * \return NULL
+ */
+void* test_llfifo_sync_delayed_enqueue(void* fifo) {
+
+	struct timespec delay = { .tv_sec = 0, .tv_nsec = 20000000L };
+
+	nanosleep(&delay, NULL);
+	assert(llfifo_enqueue((llfifo_t*)fifo, test_llfifo_sync_element) > 0);
+
+	return NULL;
+}
+
+/**
+ * \fn void* test_llfifo_sync_delayed_close(void* fifo)
+ * \brief Thread body: sleeps a moment so the main thread is already waiting, then closes the FIFO
+ *
+ * \param fifo The synchronized llfifo_t to close
+ *
+ * \return NULL
+ */
+void* test_llfifo_sync_delayed_close(void* fifo) {
+
+	struct timespec delay = { .tv_sec = 0, .tv_nsec = 20000000L };
+
+	nanosleep(&delay, NULL);
+	assert(llfifo_close((llfifo_t*)fifo) == EXIT_SUCCESS);
+
+	return NULL;
+}
+
+/**
+ * \fn void* test_llfifo_sync_producer(void* fifo)
+ * \brief Thread body: enqueues the values 1..TEST_LLFIFO_SYNC_ELEMENTS (cast to pointers) as fast as it can
+ *
+ * \param fifo The synchronized llfifo_t to enqueue to
+ *
+ * \return NULL
+ */
+void* test_llfifo_sync_producer(void* fifo) {
+
+	uintptr_t i;
+
+	for (i = 1; i <= TEST_LLFIFO_SYNC_ELEMENTS; i++) {
+		assert(llfifo_enqueue((llfifo_t*)fifo, (void*)(i)) > 0);
+	}
+
+	return NULL;
+}
+
+/**
+ * \fn int test_llfifo_sync_consume(llfifo_t* fifo, int count)
+ * \brief Waits for + dequeues count elements written by test_llfifo_sync_producer threads, checking nothing is lost or duplicated
+ *
+ * \param fifo The synchronized fifo in question
+ * \param count Total number of elements the producers will enqueue
+ *
+ * \return If every element arrived, returns EXIT_SUCCESS (0). Otherwise the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_sync_consume(llfifo_t* fifo, int count) {
+
+	int i;
+	uintptr_t element;
+	uintptr_t sum = 0;
+
+	for (i = 0; i < count; i++) {
+		element = (uintptr_t)(llfifo_dequeue_wait(fifo, -1));
+		if ((element == 0) || (element > TEST_LLFIFO_SYNC_ELEMENTS)) {
+			return EXIT_FAILURE;
+		}
+		sum += element;
+	}
+
+	// Each producer wrote 1..TEST_LLFIFO_SYNC_ELEMENTS exactly once
+	if ((sum != ((uintptr_t)(count / TEST_LLFIFO_SYNC_ELEMENTS) * TEST_LLFIFO_SYNC_ELEMENTS * (TEST_LLFIFO_SYNC_ELEMENTS + 1) / 2)) || (llfifo_length(fifo) != 0)) {
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int test_llfifo_enqueue_wait(llfifo_t* fifo, void* element, long long timeout_ns, int expected, int max_nodes)
+ * \brief Enqueues an element, waiting for room if the FIFO is bounded + full, and checks the result
+ *
+ * \param fifo The fifo in question
+ * \param element The element to enqueue, which cannot be NULL
+ * \param timeout_ns Longest time to wait, in nanoseconds. 0 doesn't wait at all, negative waits forever
+ * \param expected What llfifo_enqueue_wait should return: the new length, LLFIFO_FULL, or -1
+ * \param max_nodes The number of nodes to dump from each of free list + used list. If max_node is less than the total nodes in either list, it will dump (max_node - 1) nodes from the tail and then dump the head
+ *
+ * \return If llfifo_enqueue_wait returned expected, returns EXIT_SUCCESS (0). Otherwise the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_enqueue_wait(llfifo_t* fifo, void* element, long long timeout_ns, int expected, int max_nodes) {
+
+	int length;
+
+	length = llfifo_enqueue_wait(fifo, element, timeout_ns);
+	llfifo_dump_state(fifo, max_nodes);
+
+	if (length == expected) {
+		return EXIT_SUCCESS;
+	}
+	else {
+		return EXIT_FAILURE;
+	}
+}
+
+/**
+ * \fn void* test_llfifo_limit_delayed_dequeue(void* fifo)
+ * \brief Thread body: sleeps a moment so the main thread is already blocked on a full FIFO, then dequeues one element to make room
+ *
+ * \param fifo The synchronized llfifo_t to dequeue from
+ *
+ * \return NULL
+ */
+void* test_llfifo_limit_delayed_dequeue(void* fifo) {
+
+	struct timespec delay = { .tv_sec = 0, .tv_nsec = 20000000L };
+
+	nanosleep(&delay, NULL);
+	assert(llfifo_dequeue((llfifo_t*)fifo) != NULL);
+
+	return NULL;
+}
+
+/**
+ * \fn int test_llfifo_splice(llfifo_t* dst, llfifo_t* src, size_t expected, int max_nodes)
+ * \brief Moves every element from src onto dst and checks the result. On success src must be left empty with capacity 0
+ *
+ * \param dst The fifo to append to
+ * \param src The fifo to empty
+ * \param expected The result llfifo_splice should return
+ * \param max_nodes The number of nodes to dump from each of free list + used list of dst
+ *
+ * \return If llfifo_splice returned expected, returns EXIT_SUCCESS (0). Otherwise the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_splice(llfifo_t* dst, llfifo_t* src, size_t expected, int max_nodes) {
+
+	size_t length;
+
+	length = llfifo_splice(dst, src);
+	llfifo_dump_state(dst, max_nodes);
+
+	if (length != expected) {
+		return EXIT_FAILURE;
+	}
+
+	// Ensure src gave up everything it owned
+	if ((length != (size_t)(-1)) && (length != LLFIFO_FULL_SZ)) {
+		assert(llfifo_length_sz(src) == 0);
+		assert(llfifo_capacity_sz(src) == 0);
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int test_llfifo_foreach(llfifo_t* fifo, void** expected, int count, int stop_after, int max_nodes)
+ * \brief Walks the FIFO with llfifo_foreach and checks the elements visited + that the FIFO was left as it was
+ *
+ * \param fifo The fifo in question
+ * \param expected The elements that should be visited, oldest first
+ * \param count Number of elements that should be visited
+ * \param stop_after Number of elements to visit before the callback stops the walk, or -1 to never stop
+ * \param max_nodes The number of nodes to dump from each of free list + used list
+ *
+ * \return If the walk visited exactly the expected elements, returns EXIT_SUCCESS (0). Otherwise the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_foreach(llfifo_t* fifo, void** expected, int count, int stop_after, int max_nodes) {
+
+	int i;
+	int length;
+	size_t visited;
+	test_visit_t visit = { .count = 0, .stop_after = stop_after };
+
+	length = llfifo_length(fifo);
+	visited = llfifo_foreach(fifo, test_llfifo_visit, &visit);
+	llfifo_dump_state(fifo, max_nodes);
+
+	if ((visited != (size_t)(count)) || (visit.count != count) || (llfifo_length(fifo) != length)) {
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (visit.seen[i] != expected[i]) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int test_llfifo_clear(llfifo_t* fifo, llfifo_dtor_t dtor, int keep_free, size_t expected, int max_nodes)
+ * \brief Clears the FIFO and checks how many elements were removed. On success the FIFO must be left empty
+ *
+ * \param fifo The fifo in question
+ * \param dtor Destructor to run over each element, or NULL
+ * \param keep_free Nonzero to keep the nodes as free nodes, zero to free them
+ * \param expected The result llfifo_clear should return
+ * \param max_nodes The number of nodes to dump from each of free list + used list
+ *
+ * \return If llfifo_clear returned expected, returns EXIT_SUCCESS (0). Otherwise the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_clear(llfifo_t* fifo, llfifo_dtor_t dtor, int keep_free, size_t expected, int max_nodes) {
+
+	size_t cleared;
+
+	cleared = llfifo_clear(fifo, dtor, keep_free);
+	llfifo_dump_state(fifo, max_nodes);
+
+	if (cleared != expected) {
+		return EXIT_FAILURE;
+	}
+
+	// Ensure nothing is left to dequeue
+	if (cleared != (size_t)(-1)) {
+		assert(llfifo_length(fifo) == 0);
+		assert(llfifo_dequeue(fifo) == NULL);
+	}
+
+	return EXIT_SUCCESS;
+}
+
+#ifdef FIFO_CODEL
+/**
+ * \fn int test_llfifo_codel(llfifo_t* fifo, const char* expected, size_t expected_dropped, int max_nodes)
+ * \brief Dequeues from a FIFO with CoDel on + checks which element came out and how many have been dropped so far
+ *
+ * \param fifo The fifo in question
+ * \param expected Element the dequeue should hand out, or NULL if none
+ * \param expected_dropped Total drops expected after this dequeue
+ * \param max_nodes The number of nodes to dump from each of free list + used list
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_codel(llfifo_t* fifo, const char* expected, size_t expected_dropped, int max_nodes) {
+
+	void* element;
+
+	element = llfifo_dequeue(fifo);
+	llfifo_dump_state(fifo, max_nodes);
+
+	if (llfifo_codel_dropped(fifo) != expected_dropped) {
+		return EXIT_FAILURE;
+	}
+
+	if ((element == NULL) || (expected == NULL)) {
+		return (element == (void*)(expected)) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+	}
+
+	return (strcmp((const char*)(element), expected) == 0) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+}
+#endif
+
+#ifdef FIFO_DEADLINE
+/**
+ * \fn int test_llfifo_deadline(llfifo_t* fifo, const char* expected, uint64_t expected_expired, int max_nodes)
+ * \brief Dequeues from a FIFO holding deadline-tagged elements + checks which element came out and how many have been discarded as expired so far
+ *
+ * \param fifo The fifo in question
+ * \param expected Element the dequeue should hand out, or NULL if none
+ * \param expected_expired Total elements expected to have been discarded after this dequeue
+ * \param max_nodes The number of nodes to dump from each of free list + used list
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_deadline(llfifo_t* fifo, const char* expected, uint64_t expected_expired, int max_nodes) {
+
+	void* element;
+	llfifo_deadline_stats_t stats;
+
+	element = llfifo_dequeue(fifo);
+	llfifo_dump_state(fifo, max_nodes);
+
+	if ((llfifo_deadline_stats(fifo, &stats) != EXIT_SUCCESS) || (stats.expired != expected_expired)) {
+		return EXIT_FAILURE;
+	}
+
+	if ((element == NULL) || (expected == NULL)) {
+		return (element == (void*)(expected)) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+	}
+
+	return (strcmp((const char*)(element), expected) == 0) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+}
+#endif
+
 /**
  * \fn void llfifo_dump_state(llfifo_t* fifo)
  * \brief Dumps info about each node in the FIFO
@@ -703,20 +2376,20 @@ void llfifo_dump_state(llfifo_t* fifo, int max_nodes) {
 		printf("\tllfifo->tail_used at %p\n", (void*)(fifo->tail_used));
 	}
 
-	printf("\tllfifo->capacity is %d\n", fifo->capacity);
-	printf("\tllfifo->length is %d\n", fifo->length);
+	printf("\tll(int)(fifo->capacity) is %d\n", (int)(fifo->capacity));
+	printf("\tll(int)(fifo->length) is %d\n", (int)(fifo->length));
 
 	printf("\t\t-----------------------------------------\n");
 
 	// Print list of free nodes
-	if ((fifo->capacity - fifo->length) == 0) {
+	if (((int)(fifo->capacity) - (int)(fifo->length)) == 0) {
 		printf("\t\tFREE : Empty list\n");
 	}
 	else if (max_nodes == 0) {
-		printf("\t\tDisplaying %d out of %d free nodes\n", (max_nodes > (fifo->capacity - fifo->length)) ? (fifo->capacity - fifo->length) : (max_nodes), (fifo->capacity - fifo->length));
+		printf("\t\tDisplaying %d out of %d free nodes\n", (max_nodes > ((int)(fifo->capacity) - (int)(fifo->length))) ? ((int)(fifo->capacity) - (int)(fifo->length)) : (max_nodes), ((int)(fifo->capacity) - (int)(fifo->length)));
 	}
 	else if (max_nodes == 1) {
-		printf("\t\tDisplaying %d out of %d free nodes\n", (max_nodes > (fifo->capacity - fifo->length)) ? (fifo->capacity - fifo->length) : (max_nodes), (fifo->capacity - fifo->length));
+		printf("\t\tDisplaying %d out of %d free nodes\n", (max_nodes > ((int)(fifo->capacity) - (int)(fifo->length))) ? ((int)(fifo->capacity) - (int)(fifo->length)) : (max_nodes), ((int)(fifo->capacity) - (int)(fifo->length)));
 
 		node = (fifo->tail_free);
 
@@ -749,9 +2422,9 @@ void llfifo_dump_state(llfifo_t* fifo, int max_nodes) {
 
 		skip_to_head = false;
 
-		printf("\t\tDisplaying %d out of %d free nodes\n\n", (max_nodes > (fifo->capacity - fifo->length)) ? (fifo->capacity - fifo->length) : (max_nodes), (fifo->capacity - fifo->length));
+		printf("\t\tDisplaying %d out of %d free nodes\n\n", (max_nodes > ((int)(fifo->capacity) - (int)(fifo->length))) ? ((int)(fifo->capacity) - (int)(fifo->length)) : (max_nodes), ((int)(fifo->capacity) - (int)(fifo->length)));
 
-		for (i = 0; i < (fifo->capacity - fifo->length); i++) {
+		for (i = 0; i < ((int)(fifo->capacity) - (int)(fifo->length)); i++) {
 
 			if (i == 0) {
 				node = (fifo->tail_free);
@@ -759,7 +2432,7 @@ void llfifo_dump_state(llfifo_t* fifo, int max_nodes) {
 			else {
 				if (((i + 1) >= max_nodes) && (skip_to_head == true)) {
 					node = (fifo->head_free);
-					i = (fifo->capacity - fifo->length) - 1;
+					i = ((int)(fifo->capacity) - (int)(fifo->length)) - 1;
 					printf("\t\t...\n");
 					printf("\t\t|\n");
 					printf("\t\tV\n");
@@ -808,14 +2481,14 @@ void llfifo_dump_state(llfifo_t* fifo, int max_nodes) {
 	printf("\t\t-----------------------------------------\n");
 
 	// Print list of used nodes
-	if ((fifo->length) == 0) {
+	if (((int)(fifo->length)) == 0) {
 		printf("\t\tUSED : Empty list\n");
 	}
 	else if (max_nodes == 0) {
-		printf("\t\tDisplaying %d out of %d used nodes\n", (max_nodes > (fifo->length)) ? (fifo->length) : (max_nodes), (fifo->length));
+		printf("\t\tDisplaying %d out of %d used nodes\n", (max_nodes > ((int)(fifo->length))) ? ((int)(fifo->length)) : (max_nodes), ((int)(fifo->length)));
 	}
 	else if (max_nodes == 1) {
-		printf("\t\tDisplaying %d out of %d used nodes\n", (max_nodes > (fifo->length)) ? (fifo->length) : (max_nodes), (fifo->length));
+		printf("\t\tDisplaying %d out of %d used nodes\n", (max_nodes > ((int)(fifo->length))) ? ((int)(fifo->length)) : (max_nodes), ((int)(fifo->length)));
 
 		node = (fifo->tail_used);
 
@@ -848,9 +2521,9 @@ void llfifo_dump_state(llfifo_t* fifo, int max_nodes) {
 
 		skip_to_head = false;
 
-		printf("\t\tDisplaying %d out of %d used nodes\n\n", (max_nodes > (fifo->length)) ? (fifo->length) : (max_nodes), (fifo->length));
+		printf("\t\tDisplaying %d out of %d used nodes\n\n", (max_nodes > ((int)(fifo->length))) ? ((int)(fifo->length)) : (max_nodes), ((int)(fifo->length)));
 
-		for (i = 0; i < (fifo->length); i++) {
+		for (i = 0; i < ((int)(fifo->length)); i++) {
 
 			if (i == 0) {
 				node = (fifo->tail_used);
@@ -859,7 +2532,7 @@ void llfifo_dump_state(llfifo_t* fifo, int max_nodes) {
 				if ((i + 1) >= max_nodes) {
 					skip_to_head = true;
 					node = (fifo->head_used);
-					i = (fifo->length) - 1;
+					i = ((int)(fifo->length)) - 1;
 					printf("\t\t...\n");
 					printf("\t\t|\n");
 					printf("\t\tV\n");
@@ -0,0 +1,201 @@
+/**
+ * \file test_llfifo_compact.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "llfifo_compact.h"
+#include "test_llfifo_compact.h"
+
+#define GREEN "\x1B[32m"
+#define RESET "\x1B[0m"
+
+#define EXIT_FAILURE_N ((size_t)(-1))
+
+#define LL_SIZE ((size_t)(3))
+#define DEEP_SIZE ((size_t)(100000))
+
+#define TEST_LLFIFO_COMPACT_CREATE
+#define TEST_LLFIFO_COMPACT_ENQUEUE_DEQUEUE
+#define TEST_LLFIFO_COMPACT_DEEP
+
+/**
+ * \fn void test_llfifo_compact()
+ * \brief Runs unit tests for happy cases + failure cases + boundary cases for each llfifo_compact function
+ *
+ * \param N/A
+ *
+ * \return N/A
+ */
+void test_llfifo_compact() {
+#ifdef TEST_LLFIFO_COMPACT_CREATE
+	llfifo_compact_t* llfifo_compact_create_fifo;
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Create llfifo_compact with 3 free slots
+	llfifo_compact_create_fifo = llfifo_compact_create(LL_SIZE);
+	assert(llfifo_compact_create_fifo != NULL);
+	assert(llfifo_compact_capacity(llfifo_compact_create_fifo) == LL_SIZE);
+	assert(llfifo_compact_length(llfifo_compact_create_fifo) == 0);
+	llfifo_compact_destroy(llfifo_compact_create_fifo);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to grab length + capacity of NULL llfifo_compact
+	assert(llfifo_compact_length(NULL) == EXIT_FAILURE_N);
+	assert(llfifo_compact_capacity(NULL) == EXIT_FAILURE_N);
+	//		Attempt to create llfifo_compact with more slots than 32-bit indices can address
+	assert(llfifo_compact_create((size_t)(UINT32_MAX) + 1) == NULL);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Create llfifo_compact with 0 free slots
+	llfifo_compact_create_fifo = llfifo_compact_create(0);
+	assert(llfifo_compact_create_fifo != NULL);
+	assert(llfifo_compact_capacity(llfifo_compact_create_fifo) == 0);
+	llfifo_compact_destroy(llfifo_compact_create_fifo);
+#endif
+
+#ifdef TEST_LLFIFO_COMPACT_ENQUEUE_DEQUEUE
+	// Set first parameter to llfifo_compact to test with
+	// Set second parameter to element to enqueue, or element expected to be dequeued (NULL if the dequeue should fail)
+	// Set third parameter to capacity expected after enqueueing
+
+	char element1_compact[17] = "element1_compact";
+	char element2_compact[17] = "element2_compact";
+	char element3_compact[17] = "element3_compact";
+	char element4_compact[17] = "element4_compact";
+
+	llfifo_compact_t* llfifo_compact_fifo;
+	llfifo_compact_fifo = llfifo_compact_create(LL_SIZE);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Enqueue element1 through element3 to llfifo_compact capacity 3. Resulting length will be 3
+	assert(test_llfifo_compact_enqueue(llfifo_compact_fifo, element1_compact, LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_compact_enqueue(llfifo_compact_fifo, element2_compact, LL_SIZE) == EXIT_SUCCESS);
+	assert(test_llfifo_compact_enqueue(llfifo_compact_fifo, element3_compact, LL_SIZE) == EXIT_SUCCESS);
+	//		Dequeue element1, then enqueue element1 again into the slot it freed. Resulting capacity will be 3
+	assert(test_llfifo_compact_dequeue(llfifo_compact_fifo, element1_compact) == EXIT_SUCCESS);
+	assert(test_llfifo_compact_enqueue(llfifo_compact_fifo, element1_compact, LL_SIZE) == EXIT_SUCCESS);
+	//		Enqueue element4 to full llfifo_compact capacity 3. Slot arrays double. Resulting capacity will be 6
+	assert(test_llfifo_compact_enqueue(llfifo_compact_fifo, element4_compact, LL_SIZE * 2) == EXIT_SUCCESS);
+	//		Dequeue everything. Order is preserved across the growth
+	assert(test_llfifo_compact_dequeue(llfifo_compact_fifo, element2_compact) == EXIT_SUCCESS);
+	assert(test_llfifo_compact_dequeue(llfifo_compact_fifo, element3_compact) == EXIT_SUCCESS);
+	assert(test_llfifo_compact_dequeue(llfifo_compact_fifo, element1_compact) == EXIT_SUCCESS);
+	assert(test_llfifo_compact_dequeue(llfifo_compact_fifo, element4_compact) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to enqueue to NULL llfifo_compact
+	assert(test_llfifo_compact_enqueue(NULL, element1_compact, LL_SIZE) == EXIT_FAILURE);
+	//		Attempt to enqueue NULL element
+	assert(test_llfifo_compact_enqueue(llfifo_compact_fifo, NULL, LL_SIZE * 2) == EXIT_FAILURE);
+	//		Attempt to dequeue from NULL llfifo_compact
+	assert(test_llfifo_compact_dequeue(NULL, NULL) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Attempt to dequeue from empty llfifo_compact
+	assert(test_llfifo_compact_dequeue(llfifo_compact_fifo, NULL) == EXIT_FAILURE);
+
+	llfifo_compact_destroy(llfifo_compact_fifo);
+#endif
+
+#ifdef TEST_LLFIFO_COMPACT_DEEP
+	size_t i;
+	llfifo_compact_t* llfifo_compact_deep;
+	llfifo_compact_deep = llfifo_compact_create(0);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Fill llfifo_compact from capacity 0 to 100000 elements, then drain. Every element comes back in order
+	for (i = 1; i <= DEEP_SIZE; i++) {
+		assert(llfifo_compact_enqueue(llfifo_compact_deep, (void*)(i)) == i);
+	}
+	for (i = 1; i <= DEEP_SIZE; i++) {
+		assert(llfifo_compact_dequeue(llfifo_compact_deep) == (void*)(i));
+	}
+	assert(llfifo_compact_length(llfifo_compact_deep) == 0);
+	printf("\n\tllfifo_compact at %p filled + drained %u elements, capacity %u\n", (void*)llfifo_compact_deep, (unsigned int)DEEP_SIZE, (unsigned int)llfifo_compact_capacity(llfifo_compact_deep));
+
+	llfifo_compact_destroy(llfifo_compact_deep);
+#endif
+
+	printf("\n");
+
+#ifdef TEST_LLFIFO_COMPACT_CREATE
+	printf(GREEN "Asserts for all test cases against llfifo_compact_create have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_COMPACT_ENQUEUE_DEQUEUE
+	printf(GREEN "Asserts for all test cases against llfifo_compact_enqueue + llfifo_compact_dequeue have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_COMPACT_DEEP
+	printf(GREEN "Asserts for all test cases against deep llfifo_compact have passed\n" RESET);
+#endif
+}
+
+/**
+ * \fn int test_llfifo_compact_enqueue(llfifo_compact_t* fifo, void* element, size_t expected_capacity)
+ * \brief Enqueues an element onto the FIFO and checks the resulting capacity
+ *
+ * \param fifo The fifo in question
+ * \param element The element to enqueue, which cannot be NULL
+ * \param expected_capacity Capacity the FIFO should report afterwards
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_compact_enqueue(llfifo_compact_t* fifo, void* element, size_t expected_capacity) {
+
+	size_t length;
+
+	length = llfifo_compact_enqueue(fifo, element);
+
+	printf("\tllfifo_compact at %p : enqueue %s -> length %d, capacity %d\n", (void*)fifo, (element == NULL) ? "NULL" : (char*)element, (int)llfifo_compact_length(fifo), (int)llfifo_compact_capacity(fifo));
+
+	if (length == EXIT_FAILURE_N) {
+		return EXIT_FAILURE;
+	}
+
+	assert(llfifo_compact_capacity(fifo) == expected_capacity);
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int test_llfifo_compact_dequeue(llfifo_compact_t* fifo, void* expected)
+ * \brief Removes ("dequeues") an element from the FIFO and checks it is the expected one
+ *
+ * \param fifo The fifo in question
+ * \param expected Element that should be dequeued
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_compact_dequeue(llfifo_compact_t* fifo, void* expected) {
+
+	void* data;
+
+	data = llfifo_compact_dequeue(fifo);
+
+	printf("\tllfifo_compact at %p : dequeue %s -> length %d\n", (void*)fifo, (data == NULL) ? "NULL" : (char*)data, (int)llfifo_compact_length(fifo));
+
+	if (data == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	assert(data == expected);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+/**
+ * \file test_llfifo_static.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "llfifo_static.h"
+#include "test_llfifo_static.h"
+
+#define GREEN "\x1B[32m"
+#define RESET "\x1B[0m"
+
+#define EXIT_FAILURE_N ((int)(-1))
+
+#define TEST_LLFIFO_STATIC_ENQUEUE_DEQUEUE
+#define TEST_LLFIFO_STATIC_FULL
+
+/**
+ * \var static test_static_fifo_t test_static_global
+ * \brief Instance in static storage, which starts out empty without calling test_static_fifo_init
+ */
+static test_static_fifo_t test_static_global;
+
+/**
+ * \fn void test_llfifo_static()
+ * \brief Runs unit tests for happy cases + failure cases + boundary cases for each function generated by LLFIFO_STATIC_DEFINE
+ *
+ * \param N/A
+ *
+ * \return N/A
+ */
+void test_llfifo_static() {
+#ifdef TEST_LLFIFO_STATIC_ENQUEUE_DEQUEUE
+	// Set first parameter to static llfifo to test with
+	// Set second parameter to element to enqueue, or element expected to be dequeued (NULL if the dequeue should fail)
+	// Set third parameter of enqueue to the result expected
+
+	char element1_static[16] = "element1_static";
+	char element2_static[16] = "element2_static";
+	char element3_static[16] = "element3_static";
+
+	test_static_fifo_t llfifo_static_stack;
+	test_static_fifo_init(&llfifo_static_stack);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Static instance starts out empty with capacity 3
+	assert(test_static_fifo_length(&test_static_global) == 0);
+	assert(test_static_fifo_capacity(&test_static_global) == 3);
+	//		Enqueue element1, element2 to static instance, then dequeue them in order
+	assert(test_llfifo_static_enqueue(&test_static_global, (void*)element1_static, 1) == EXIT_SUCCESS);
+	assert(test_llfifo_static_enqueue(&test_static_global, (void*)element2_static, 2) == EXIT_SUCCESS);
+	assert(test_llfifo_static_dequeue(&test_static_global, (void*)element1_static) == EXIT_SUCCESS);
+	assert(test_llfifo_static_dequeue(&test_static_global, (void*)element2_static) == EXIT_SUCCESS);
+	//		Same on stack instance
+	assert(test_llfifo_static_enqueue(&llfifo_static_stack, (void*)element3_static, 1) == EXIT_SUCCESS);
+	assert(test_llfifo_static_dequeue(&llfifo_static_stack, (void*)element3_static) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to use NULL static llfifo
+	assert(test_llfifo_static_enqueue(NULL, (void*)element1_static, EXIT_FAILURE_N) == EXIT_SUCCESS);
+	assert(test_llfifo_static_dequeue(NULL, NULL) == EXIT_SUCCESS);
+	assert(test_static_fifo_length(NULL) == EXIT_FAILURE_N);
+	assert(test_static_fifo_capacity(NULL) == EXIT_FAILURE_N);
+	//		Attempt to enqueue NULL element
+	assert(test_llfifo_static_enqueue(&llfifo_static_stack, NULL, EXIT_FAILURE_N) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Dequeue from empty static llfifo
+	assert(test_llfifo_static_dequeue(&llfifo_static_stack, NULL) == EXIT_SUCCESS);
+	//		Order is kept as the slots wrap around, starting from tail at slot 2
+	assert(test_llfifo_static_enqueue(&test_static_global, (void*)element3_static, 1) == EXIT_SUCCESS);
+	assert(test_llfifo_static_enqueue(&test_static_global, (void*)element1_static, 2) == EXIT_SUCCESS);
+	assert(test_llfifo_static_enqueue(&test_static_global, (void*)element2_static, 3) == EXIT_SUCCESS);
+	assert(test_llfifo_static_dequeue(&test_static_global, (void*)element3_static) == EXIT_SUCCESS);
+	assert(test_llfifo_static_dequeue(&test_static_global, (void*)element1_static) == EXIT_SUCCESS);
+	assert(test_llfifo_static_dequeue(&test_static_global, (void*)element2_static) == EXIT_SUCCESS);
+	assert(test_llfifo_static_dequeue(&test_static_global, NULL) == EXIT_SUCCESS);
+#endif
+
+#ifdef TEST_LLFIFO_STATIC_FULL
+	// Set first parameter to static llfifo to test with
+	// Set second parameter to element to enqueue
+	// Set third parameter to the result expected
+
+	char element1_full[14] = "element1_full";
+	char element2_full[14] = "element2_full";
+	char element3_full[14] = "element3_full";
+	char element4_full[14] = "element4_full";
+
+	test_static_fifo_t llfifo_static_full;
+	test_static_fifo_init(&llfifo_static_full);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Fill static llfifo capacity 3
+	assert(test_llfifo_static_enqueue(&llfifo_static_full, (void*)element1_full, 1) == EXIT_SUCCESS);
+	assert(test_llfifo_static_enqueue(&llfifo_static_full, (void*)element2_full, 2) == EXIT_SUCCESS);
+	assert(test_llfifo_static_enqueue(&llfifo_static_full, (void*)element3_full, 3) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to enqueue element4 to full static llfifo. Reports full + keeps what it holds
+	assert(test_llfifo_static_enqueue(&llfifo_static_full, (void*)element4_full, LLFIFO_FULL) == EXIT_SUCCESS);
+	assert(test_static_fifo_length(&llfifo_static_full) == 3);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Dequeuing 1 makes room for exactly 1 more
+	assert(test_llfifo_static_dequeue(&llfifo_static_full, (void*)element1_full) == EXIT_SUCCESS);
+	assert(test_llfifo_static_enqueue(&llfifo_static_full, (void*)element4_full, 3) == EXIT_SUCCESS);
+	assert(test_llfifo_static_enqueue(&llfifo_static_full, (void*)element1_full, LLFIFO_FULL) == EXIT_SUCCESS);
+	//		Init empties full static llfifo
+	test_static_fifo_init(&llfifo_static_full);
+	assert(test_static_fifo_length(&llfifo_static_full) == 0);
+	assert(test_llfifo_static_dequeue(&llfifo_static_full, NULL) == EXIT_SUCCESS);
+#endif
+
+	printf("\n");
+
+#ifdef TEST_LLFIFO_STATIC_ENQUEUE_DEQUEUE
+	printf(GREEN "Asserts for all test cases against static llfifo enqueue + dequeue have passed\n" RESET);
+#endif
+#ifdef TEST_LLFIFO_STATIC_FULL
+	printf(GREEN "Asserts for all test cases against full static llfifo have passed\n" RESET);
+#endif
+}
+
+/**
+ * \fn int test_llfifo_static_enqueue(test_static_fifo_t* fifo, void* element, int expected)
+ * \brief Enqueues an element onto the static FIFO and checks the result
+ *
+ * \param fifo The fifo in question
+ * \param element The element to enqueue
+ * \param expected The result enqueue should return
+ *
+ * \return If enqueue returned expected, returns EXIT_SUCCESS (0). Otherwise the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_static_enqueue(test_static_fifo_t* fifo, void* element, int expected) {
+
+	int length;
+
+	length = test_static_fifo_enqueue(fifo, element);
+	printf("\tstatic llfifo at %p enqueued %p : returned %d, length %d\n", (void*)fifo, element, length, test_static_fifo_length(fifo));
+
+	return (length == expected) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+}
+
+/**
+ * \fn int test_llfifo_static_dequeue(test_static_fifo_t* fifo, void* expected)
+ * \brief Dequeues an element from the static FIFO and checks it is the expected one
+ *
+ * \param fifo The fifo in question
+ * \param expected The element that should come out, or NULL if the dequeue should fail
+ *
+ * \return If the expected element came out, returns EXIT_SUCCESS (0). Otherwise the function returns EXIT_FAILURE (1)
+ */
+int test_llfifo_static_dequeue(test_static_fifo_t* fifo, void* expected) {
+
+	void* element;
+
+	element = test_static_fifo_dequeue(fifo);
+	printf("\tstatic llfifo at %p dequeued %p : length %d\n", (void*)fifo, element, test_static_fifo_length(fifo));
+
+	return (element == expected) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+}
@@ -0,0 +1,429 @@
+/**
+ * \file test_mcring.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mcring.h"
+#include "test_mcring.h"
+
+#define GREEN "\x1B[32m"
+#define RESET "\x1B[0m"
+
+#define EXIT_FAILURE_N ((size_t)(-1))
+
+#define MC_SIZE ((size_t)(16))
+#define TEST_MCRING_THREADS_BYTES ((size_t)(1000000))
+#define TEST_MCRING_THREADS_CONSUMERS ((int)(3))
+
+#define TEST_MCRING_CREATE
+#define TEST_MCRING_MULTICAST
+#define TEST_MCRING_SUBSCRIBE
+#define TEST_MCRING_DETACH
+#define TEST_MCRING_THREADS
+
+/**
+ * \typedef test_mcring_reader_t
+ * \brief Allows struct test_mcring_reader_s to be instantiated as test_mcring_reader_t
+ */
+typedef struct test_mcring_reader_s test_mcring_reader_t;
+
+/**
+ * \struct test_mcring_reader_s
+ * \brief Context for one consumer thread in TEST_MCRING_THREADS
+ *
+ * \detail mcring_t* ring - The ring to read from
+ * \detail int consumer - Index returned by mcring_subscribe, done on the main thread so no byte is missed
+ * \detail size_t received - Bytes read that matched the stream
+ */
+struct test_mcring_reader_s {
+	mcring_t* ring;
+	int consumer;
+	size_t received;
+};
+
+/**
+ * \fn static void* test_mcring_writer(void* arg)
+ * \brief Producer thread: writes TEST_MCRING_THREADS_BYTES bytes of the stream 0, 1, ..., 255, 0, ... in uneven chunks, yielding whenever the slowest consumer has left no room
+ *
+ * \param arg The mcring_t to write to
+ *
+ * \return NULL
+ */
+static void* test_mcring_writer(void* arg) {
+
+	mcring_t* ring = (mcring_t*)(arg);
+	uint8_t chunk[37];
+	size_t sent = 0;
+	size_t written;
+	size_t nbyte;
+	size_t i;
+
+	while (sent < TEST_MCRING_THREADS_BYTES) {
+		nbyte = 1 + (sent % sizeof(chunk));
+		nbyte = (nbyte < (TEST_MCRING_THREADS_BYTES - sent)) ? (nbyte) : (TEST_MCRING_THREADS_BYTES - sent);
+		for (i = 0; i < nbyte; i++) {
+			chunk[i] = (uint8_t)(sent + i);
+		}
+
+		written = mcring_enqueue(ring, chunk, nbyte);
+		assert(written != EXIT_FAILURE_N);
+		if (written == 0) {
+			sched_yield();
+		}
+		sent += written;
+	}
+
+	return NULL;
+}
+
+/**
+ * \fn static void* test_mcring_reader(void* arg)
+ * \brief Consumer thread: reads the whole stream through its own cursor, checking every byte arrives once + in order
+ *
+ * \param arg The test_mcring_reader_t for this consumer
+ *
+ * \return NULL
+ */
+static void* test_mcring_reader(void* arg) {
+
+	test_mcring_reader_t* reader = (test_mcring_reader_t*)(arg);
+	uint8_t chunk[23];
+	size_t read;
+	size_t i;
+
+	while (reader->received < TEST_MCRING_THREADS_BYTES) {
+		read = mcring_dequeue(reader->ring, reader->consumer, chunk, sizeof(chunk));
+		assert((read != EXIT_FAILURE_N) && (read != MCRING_DETACHED));
+		if (read == 0) {
+			sched_yield();
+		}
+		for (i = 0; i < read; i++) {
+			assert(chunk[i] == (uint8_t)(reader->received + i));
+		}
+		reader->received += read;
+	}
+
+	return NULL;
+}
+
+/**
+ * \fn void test_mcring()
+ * \brief Runs unit tests for happy cases + failure cases + boundary cases for each mcring function
+ *
+ * \param N/A
+ *
+ * \return N/A
+ */
+void test_mcring() {
+#ifdef TEST_MCRING_CREATE
+	char element1_create[6] = "abcde";
+	char out_create[8];
+
+	mcring_t* mcring_create_ring;
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Create mcring. Capacity is rounded up to a power of 2, and all of it is free
+	mcring_create_ring = mcring_create(MC_SIZE - 3, MCRING_WAIT_SLOWEST);
+	assert(mcring_create_ring != NULL);
+	assert(mcring_capacity(mcring_create_ring) == MC_SIZE);
+	assert(mcring_space(mcring_create_ring) == MC_SIZE);
+	//		Writing with nobody subscribed leaves all the space free, since nobody has to read it
+	assert(mcring_enqueue(mcring_create_ring, element1_create, 5) == 5);
+	assert(mcring_space(mcring_create_ring) == MC_SIZE);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to create mcring with capacity 0 + an unknown policy
+	assert(mcring_create(0, MCRING_WAIT_SLOWEST) == NULL);
+	assert(mcring_create(MC_SIZE, (mcring_policy_t)(7)) == NULL);
+	//		Attempt to use NULL mcring + write from NULL buf
+	assert(mcring_enqueue(NULL, element1_create, 5) == EXIT_FAILURE_N);
+	assert(mcring_enqueue(mcring_create_ring, NULL, 5) == EXIT_FAILURE_N);
+	assert(mcring_dequeue(NULL, 0, out_create, 5) == EXIT_FAILURE_N);
+	assert(mcring_length(NULL, 0) == EXIT_FAILURE_N);
+	assert(mcring_space(NULL) == EXIT_FAILURE_N);
+	assert(mcring_capacity(NULL) == EXIT_FAILURE_N);
+	assert(mcring_subscribe(NULL) == -1);
+	assert(mcring_unsubscribe(NULL, 0) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Capacity 1 is already a power of 2
+	mcring_destroy(mcring_create_ring);
+	mcring_create_ring = mcring_create(1, MCRING_DETACH_SLOW);
+	assert(mcring_capacity(mcring_create_ring) == 1);
+	//		Destroy NULL mcring
+	mcring_destroy(mcring_create_ring);
+	mcring_destroy(NULL);
+#endif
+
+#ifdef TEST_MCRING_MULTICAST
+	// Set first parameter to mcring to test with
+	// Set second parameter to the consumer to read through
+	// Set third parameter to the bytes expected to be read ("" if nothing should be read)
+
+	char element1_multicast[11] = "0123456789";
+	char element2_multicast[13] = "ABCDEFGHIJKL";
+	char out_multicast[MC_SIZE];
+	int logger_multicast;
+	int metrics_multicast;
+	int replicator_multicast;
+
+	mcring_t* mcring_multicast;
+	mcring_multicast = mcring_create(MC_SIZE, MCRING_WAIT_SLOWEST);
+	logger_multicast = mcring_subscribe(mcring_multicast);
+	metrics_multicast = mcring_subscribe(mcring_multicast);
+	replicator_multicast = mcring_subscribe(mcring_multicast);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Write once, every consumer reads every byte
+	assert((logger_multicast >= 0) && (metrics_multicast >= 0) && (replicator_multicast >= 0));
+	assert(mcring_enqueue(mcring_multicast, element1_multicast, 10) == 10);
+	assert(mcring_length(mcring_multicast, logger_multicast) == 10);
+	assert(mcring_length(mcring_multicast, metrics_multicast) == 10);
+	assert(test_mcring_dequeue(mcring_multicast, logger_multicast, "0123456789") == EXIT_SUCCESS);
+	assert(mcring_length(mcring_multicast, logger_multicast) == 0);
+	assert(mcring_length(mcring_multicast, metrics_multicast) == 10);
+	//		Consumers read at their own pace + in their own chunk sizes
+	assert(test_mcring_dequeue(mcring_multicast, metrics_multicast, "0123") == EXIT_SUCCESS);
+	assert(test_mcring_dequeue(mcring_multicast, metrics_multicast, "456789") == EXIT_SUCCESS);
+	//		Free space is governed by the slowest consumer, the replicator, which hasn't read anything yet
+	assert(mcring_space(mcring_multicast) == MC_SIZE - 10);
+	assert(test_mcring_dequeue(mcring_multicast, replicator_multicast, "01234") == EXIT_SUCCESS);
+	assert(mcring_space(mcring_multicast) == MC_SIZE - 5);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to read through a slot nobody subscribed to, an out-of-range consumer + into NULL buf
+	assert(mcring_dequeue(mcring_multicast, 3, out_multicast, 1) == EXIT_FAILURE_N);
+	assert(mcring_dequeue(mcring_multicast, -1, out_multicast, 1) == EXIT_FAILURE_N);
+	assert(mcring_dequeue(mcring_multicast, MCRING_MAX_CONSUMERS, out_multicast, 1) == EXIT_FAILURE_N);
+	assert(mcring_dequeue(mcring_multicast, logger_multicast, NULL, 1) == EXIT_FAILURE_N);
+	assert(mcring_length(mcring_multicast, 3) == EXIT_FAILURE_N);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		The slowest consumer limits the write, so it only partially fits, and the bytes wrap around the end of the buffer
+	assert(mcring_enqueue(mcring_multicast, element2_multicast, 12) == MC_SIZE - 5);
+	assert(mcring_space(mcring_multicast) == 0);
+	assert(mcring_enqueue(mcring_multicast, element2_multicast, 12) == 0);
+	assert(test_mcring_dequeue(mcring_multicast, logger_multicast, "ABCDEFGHIJK") == EXIT_SUCCESS);
+	assert(test_mcring_dequeue(mcring_multicast, replicator_multicast, "56789ABCDEFGHIJK") == EXIT_SUCCESS);
+	assert(mcring_space(mcring_multicast) == MC_SIZE - 11);
+	assert(test_mcring_dequeue(mcring_multicast, metrics_multicast, "ABCDEFGHIJK") == EXIT_SUCCESS);
+	assert(mcring_space(mcring_multicast) == MC_SIZE);
+	//		Read + write 0 bytes, and read with nothing unread
+	assert(mcring_enqueue(mcring_multicast, element1_multicast, 0) == 0);
+	assert(test_mcring_dequeue(mcring_multicast, logger_multicast, "") == EXIT_SUCCESS);
+	//		Writes larger than the whole ring are cut down to the capacity
+	assert(mcring_enqueue(mcring_multicast, "0123456789ABCDEFGHIJ", 20) == MC_SIZE);
+	assert(test_mcring_dequeue(mcring_multicast, logger_multicast, "0123456789ABCDEF") == EXIT_SUCCESS);
+	mcring_destroy(mcring_multicast);
+#endif
+
+#ifdef TEST_MCRING_SUBSCRIBE
+	char element1_subscribe[5] = "abcd";
+	int i_subscribe;
+	int consumer_subscribe;
+	int late_subscribe;
+
+	mcring_t* mcring_subscribe_ring;
+	mcring_subscribe_ring = mcring_create(MC_SIZE, MCRING_WAIT_SLOWEST);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Consumers are handed the lowest free slot
+	consumer_subscribe = mcring_subscribe(mcring_subscribe_ring);
+	assert(consumer_subscribe == 0);
+	assert(mcring_enqueue(mcring_subscribe_ring, element1_subscribe, 4) == 4);
+	//		A late subscriber starts at the write position, so it only sees bytes written after it joined + doesn't hold the producer back
+	late_subscribe = mcring_subscribe(mcring_subscribe_ring);
+	assert(late_subscribe == 1);
+	assert(mcring_length(mcring_subscribe_ring, late_subscribe) == 0);
+	assert(mcring_space(mcring_subscribe_ring) == MC_SIZE - 4);
+	assert(mcring_enqueue(mcring_subscribe_ring, "ef", 2) == 2);
+	assert(test_mcring_dequeue(mcring_subscribe_ring, late_subscribe, "ef") == EXIT_SUCCESS);
+	//		Unsubscribing the slowest consumer frees up the space it was holding
+	assert(mcring_unsubscribe(mcring_subscribe_ring, consumer_subscribe) == EXIT_SUCCESS);
+	assert(mcring_space(mcring_subscribe_ring) == MC_SIZE);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to unsubscribe twice, read through an unsubscribed slot + unsubscribe out of range
+	assert(mcring_unsubscribe(mcring_subscribe_ring, consumer_subscribe) == EXIT_FAILURE);
+	assert(mcring_dequeue(mcring_subscribe_ring, consumer_subscribe, element1_subscribe, 1) == EXIT_FAILURE_N);
+	assert(mcring_unsubscribe(mcring_subscribe_ring, -1) == EXIT_FAILURE);
+	assert(mcring_unsubscribe(mcring_subscribe_ring, MCRING_MAX_CONSUMERS) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Fill every slot. The freed slot 0 is reused first, then subscribing fails
+	for (i_subscribe = 0; i_subscribe < MCRING_MAX_CONSUMERS - 1; i_subscribe++) {
+		assert(mcring_subscribe(mcring_subscribe_ring) == ((i_subscribe == 0) ? (0) : (i_subscribe + 1)));
+	}
+	assert(mcring_subscribe(mcring_subscribe_ring) == -1);
+	//		Every consumer still sees the next write
+	assert(mcring_enqueue(mcring_subscribe_ring, "g", 1) == 1);
+	for (i_subscribe = 0; i_subscribe < MCRING_MAX_CONSUMERS; i_subscribe++) {
+		assert(mcring_length(mcring_subscribe_ring, i_subscribe) == 1);
+	}
+	mcring_destroy(mcring_subscribe_ring);
+#endif
+
+#ifdef TEST_MCRING_DETACH
+	char element1_detach[9] = "01234567";
+	char out_detach[MC_SIZE];
+	int fast_detach;
+	int stalled_detach;
+	int waiting_detach;
+
+	mcring_t* mcring_detach;
+	mcring_t* mcring_wait;
+	mcring_detach = mcring_create(MC_SIZE, MCRING_DETACH_SLOW);
+	mcring_wait = mcring_create(MC_SIZE, MCRING_WAIT_SLOWEST);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		A consumer that stops reading is detached once it stands in the way, and the write goes through in full
+	fast_detach = mcring_subscribe(mcring_detach);
+	stalled_detach = mcring_subscribe(mcring_detach);
+	assert(mcring_enqueue(mcring_detach, element1_detach, 8) == 8);
+	assert(test_mcring_dequeue(mcring_detach, fast_detach, "01234567") == EXIT_SUCCESS);
+	assert(mcring_enqueue(mcring_detach, element1_detach, 8) == 8);
+	assert(mcring_length(mcring_detach, stalled_detach) == 16);
+	assert(mcring_enqueue(mcring_detach, element1_detach, 1) == 1);
+	assert(mcring_length(mcring_detach, stalled_detach) == MCRING_DETACHED);
+	assert(mcring_dequeue(mcring_detach, stalled_detach, out_detach, 1) == MCRING_DETACHED);
+	//		The rest carry on as if nothing happened
+	assert(test_mcring_dequeue(mcring_detach, fast_detach, "012345670") == EXIT_SUCCESS);
+	//		A detached consumer unsubscribes + subscribes again to pick up from the write position
+	assert(mcring_unsubscribe(mcring_detach, stalled_detach) == EXIT_SUCCESS);
+	assert(mcring_subscribe(mcring_detach) == stalled_detach);
+	assert(mcring_length(mcring_detach, stalled_detach) == 0);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		MCRING_WAIT_SLOWEST never detaches. The write is cut short instead
+	waiting_detach = mcring_subscribe(mcring_wait);
+	assert(mcring_enqueue(mcring_wait, element1_detach, 8) == 8);
+	assert(mcring_enqueue(mcring_wait, element1_detach, 8) == 8);
+	assert(mcring_enqueue(mcring_wait, element1_detach, 1) == 0);
+	assert(mcring_length(mcring_wait, waiting_detach) == MC_SIZE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		A consumer lagging by exactly enough for the write to fit is left alone, while one a byte further behind is detached
+	assert(mcring_enqueue(mcring_detach, element1_detach, 8) == 8);
+	assert(mcring_enqueue(mcring_detach, element1_detach, 8) == 8);
+	assert(mcring_length(mcring_detach, fast_detach) == MC_SIZE);
+	assert(test_mcring_dequeue(mcring_detach, fast_detach, "0") == EXIT_SUCCESS);
+	assert(mcring_enqueue(mcring_detach, element1_detach, 1) == 1);
+	assert(mcring_length(mcring_detach, fast_detach) == MC_SIZE);
+	assert(mcring_length(mcring_detach, stalled_detach) == MCRING_DETACHED);
+	//		With every consumer detached, the producer has the whole ring
+	assert(mcring_enqueue(mcring_detach, element1_detach, 1) == 1);
+	assert(mcring_length(mcring_detach, fast_detach) == MCRING_DETACHED);
+	assert(mcring_length(mcring_detach, stalled_detach) == MCRING_DETACHED);
+	assert(mcring_space(mcring_detach) == MC_SIZE);
+	mcring_destroy(mcring_detach);
+	mcring_destroy(mcring_wait);
+#endif
+
+#ifdef TEST_MCRING_THREADS
+	int i_threads;
+	pthread_t writer_threads;
+	pthread_t reader_threads[TEST_MCRING_THREADS_CONSUMERS];
+	test_mcring_reader_t readers_threads[TEST_MCRING_THREADS_CONSUMERS];
+
+	mcring_t* mcring_threads;
+	mcring_threads = mcring_create(256, MCRING_WAIT_SLOWEST);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		One producer thread + 3 consumer threads. Each consumer gets the whole stream, in order, from a single write of each byte
+	for (i_threads = 0; i_threads < TEST_MCRING_THREADS_CONSUMERS; i_threads++) {
+		readers_threads[i_threads].ring = mcring_threads;
+		readers_threads[i_threads].consumer = mcring_subscribe(mcring_threads);
+		readers_threads[i_threads].received = 0;
+		assert(readers_threads[i_threads].consumer >= 0);
+	}
+	for (i_threads = 0; i_threads < TEST_MCRING_THREADS_CONSUMERS; i_threads++) {
+		assert(pthread_create(&reader_threads[i_threads], NULL, test_mcring_reader, (void*)(&readers_threads[i_threads])) == 0);
+	}
+	assert(pthread_create(&writer_threads, NULL, test_mcring_writer, (void*)(mcring_threads)) == 0);
+	assert(pthread_join(writer_threads, NULL) == 0);
+	for (i_threads = 0; i_threads < TEST_MCRING_THREADS_CONSUMERS; i_threads++) {
+		assert(pthread_join(reader_threads[i_threads], NULL) == 0);
+		assert(readers_threads[i_threads].received == TEST_MCRING_THREADS_BYTES);
+		assert(mcring_length(mcring_threads, readers_threads[i_threads].consumer) == 0);
+	}
+	mcring_destroy(mcring_threads);
+#endif
+
+#ifdef TEST_MCRING_CREATE
+	printf(GREEN "Asserts for all test cases against mcring_create have passed\n" RESET);
+#endif
+#ifdef TEST_MCRING_MULTICAST
+	printf(GREEN "Asserts for all test cases against mcring_enqueue + mcring_dequeue have passed\n" RESET);
+#endif
+#ifdef TEST_MCRING_SUBSCRIBE
+	printf(GREEN "Asserts for all test cases against mcring_subscribe + mcring_unsubscribe have passed\n" RESET);
+#endif
+#ifdef TEST_MCRING_DETACH
+	printf(GREEN "Asserts for all test cases against mcring slow consumer detach have passed\n" RESET);
+#endif
+#ifdef TEST_MCRING_THREADS
+	printf(GREEN "Asserts for all test cases against mcring with concurrent consumers have passed\n" RESET);
+#endif
+}
+
+/**
+ * \fn int test_mcring_dequeue(mcring_t* ring, int consumer, const char* expected)
+ * \brief Reads up to a buffer's worth through one consumer and checks exactly the expected bytes came out
+ *
+ * \param ring The ring in question
+ * \param consumer The consumer to read through
+ * \param expected Bytes that should be read, as a string. "" if nothing should be read
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_mcring_dequeue(mcring_t* ring, int consumer, const char* expected) {
+
+	char data[32];
+	size_t read;
+
+	read = mcring_dequeue(ring, consumer, data, strlen(expected));
+
+	printf("\tmcring at %p : consumer %d dequeue %d bytes -> %d left\n", (void*)ring, consumer, (int)read, (int)mcring_length(ring, consumer));
+
+	if ((read == EXIT_FAILURE_N) || (read == MCRING_DETACHED)) {
+		return EXIT_FAILURE;
+	}
+
+	assert(read == strlen(expected));
+	assert(memcmp(data, expected, read) == 0);
+
+	return EXIT_SUCCESS;
+}
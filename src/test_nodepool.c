@@ -0,0 +1,298 @@
+/**
+ * \file test_nodepool.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "nodepool.h"
+#include "test_nodepool.h"
+
+#define GREEN "\x1B[32m"
+#define RESET "\x1B[0m"
+
+#define EXIT_FAILURE_N ((int)(-1))
+
+#define POOL_THREADS ((int)(4))
+#define POOL_ROUNDS ((int)(2000))
+#define POOL_BURST ((int)(100))
+#define POOL_CHURN ((int)(50))
+#define POOL_CHURN_HOLD ((int)(8))
+
+#define TEST_NODEPOOL_GET_PUT
+#define TEST_NODEPOOL_THREADS
+
+/**
+ * \fn void test_nodepool()
+ * \brief Runs unit tests for happy cases + failure cases + boundary cases for each nodepool function
+ *
+ * \param N/A
+ *
+ * \return N/A
+ */
+void test_nodepool() {
+#ifdef TEST_NODEPOOL_GET_PUT
+	// Set first parameter to pool to test with
+	// Set second parameter to how many objects to take out before putting them all back
+
+	int i;
+	void* object_get_put[2];
+	nodepool_t* pool_get_put;
+	nodepool_t* pool_alternate[5];
+	pool_get_put = nodepool_create(24, 8);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Take + return 8 objects from pool with block of 8. Only 1 block is allocated
+	assert(test_nodepool_get_put(pool_get_put, 8) == EXIT_SUCCESS);
+	assert(nodepool_allocated(pool_get_put) == 8);
+	//		Take + return 8 objects again. Objects are reused so still only 1 block is allocated
+	assert(test_nodepool_get_put(pool_get_put, 8) == EXIT_SUCCESS);
+	assert(nodepool_allocated(pool_get_put) == 8);
+	//		Take + return 20 objects. Pool grows by whole blocks. Resulting allocation will be 24
+	assert(test_nodepool_get_put(pool_get_put, 20) == EXIT_SUCCESS);
+	assert(nodepool_allocated(pool_get_put) == 24);
+	//		Reserve 16 more objects up front. Resulting allocation will be 40
+	assert(nodepool_reserve(pool_get_put, 16) == EXIT_SUCCESS);
+	assert(nodepool_allocated(pool_get_put) == 40);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to create pool of 0 byte objects
+	assert(nodepool_create(0, 8) == NULL);
+	//		Attempt to take object from NULL pool
+	assert(nodepool_get(NULL) == NULL);
+	//		Attempt to reserve negative number of objects
+	assert(nodepool_reserve(pool_get_put, -1) == EXIT_FAILURE_N);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Object size is rounded up to pointer size
+	assert(nodepool_object_size(pool_get_put) == 24);
+	nodepool_destroy(pool_get_put);
+	pool_get_put = nodepool_create(1, 0);
+	assert(nodepool_object_size(pool_get_put) == sizeof(void*));
+	//		Take + return 1 object from a fresh pool after the previous pool was destroyed
+	assert(test_nodepool_get_put(pool_get_put, 1) == EXIT_SUCCESS);
+	nodepool_destroy(pool_get_put);
+	//		Alternate between 2 pools. Each keeps its own magazine, so an object put back is the next one handed out
+	pool_alternate[0] = nodepool_create(24, 8);
+	pool_alternate[1] = nodepool_create(24, 8);
+	object_get_put[0] = nodepool_get(pool_alternate[0]);
+	object_get_put[1] = nodepool_get(pool_alternate[1]);
+	nodepool_put(pool_alternate[0], object_get_put[0]);
+	nodepool_put(pool_alternate[1], object_get_put[1]);
+	assert(nodepool_get(pool_alternate[0]) == object_get_put[0]);
+	assert(nodepool_get(pool_alternate[1]) == object_get_put[1]);
+	nodepool_put(pool_alternate[0], object_get_put[0]);
+	nodepool_put(pool_alternate[1], object_get_put[1]);
+	//		Cycle through more pools than a thread has magazines. Evicted magazines go back to their depot
+	for (i = 2; i < 5; i++) {
+		pool_alternate[i] = nodepool_create(24, 8);
+	}
+	for (i = 0; i < 10; i++) {
+		assert(test_nodepool_get_put(pool_alternate[i % 5], 8) == EXIT_SUCCESS);
+	}
+	for (i = 0; i < 5; i++) {
+		assert(nodepool_allocated(pool_alternate[i]) == 8);
+		nodepool_destroy(pool_alternate[i]);
+	}
+#endif
+
+#ifdef TEST_NODEPOOL_THREADS
+	// Set first parameter to pool to test with
+	// Set second parameter to number of threads sharing the pool
+
+	nodepool_t* pool_threads;
+	pool_threads = nodepool_create(sizeof(void*) * 3, 64);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Threads repeatedly take + return bursts of objects. Objects are never handed to two holders at once
+	assert(test_nodepool_threads(pool_threads, POOL_THREADS) == EXIT_SUCCESS);
+	//		Pool only grows to what is live at once plus what sits in thread caches, not to the total number of gets
+	assert(nodepool_allocated(pool_threads) < (size_t)(POOL_THREADS * POOL_ROUNDS * POOL_BURST));
+	nodepool_destroy(pool_threads);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Short-lived threads one after another, each leaving objects in its magazine as it exits. They go back to the depot, so the pool never grows past 1 block + this thread then takes them all without growing
+	pool_threads = nodepool_create(sizeof(void*), POOL_CHURN_HOLD);
+	assert(test_nodepool_churn(pool_threads, POOL_CHURN) == EXIT_SUCCESS);
+	assert(nodepool_allocated(pool_threads) == (size_t)(POOL_CHURN_HOLD));
+	assert(test_nodepool_get_put(pool_threads, POOL_CHURN_HOLD) == EXIT_SUCCESS);
+	assert(nodepool_allocated(pool_threads) == (size_t)(POOL_CHURN_HOLD));
+
+	nodepool_destroy(pool_threads);
+#endif
+
+	printf("\n");
+
+#ifdef TEST_NODEPOOL_GET_PUT
+	printf(GREEN "Asserts for all test cases against nodepool_get + nodepool_put have passed\n" RESET);
+#endif
+#ifdef TEST_NODEPOOL_THREADS
+	printf(GREEN "Asserts for all test cases against nodepool shared across threads have passed\n" RESET);
+#endif
+}
+
+/**
+ * \fn int test_nodepool_get_put(nodepool_t* pool, int count)
+ * \brief Takes count objects from the pool, checks they are all distinct, then puts them all back
+ *
+ * \param pool The pool in question
+ * \param count Number of objects to take out at once
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_nodepool_get_put(nodepool_t* pool, int count) {
+
+	int i;
+	int j;
+	void** objects;
+
+	objects = (void**)malloc(sizeof(void*) * count);
+	if (objects == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < count; i++) {
+		objects[i] = nodepool_get(pool);
+		if (objects[i] == NULL) {
+			free(objects);
+			return EXIT_FAILURE;
+		}
+
+		for (j = 0; j < i; j++) {
+			assert(objects[j] != objects[i]);
+		}
+	}
+
+	printf("\tnodepool at %p handed out %d objects, %u allocated\n", (void*)pool, count, (unsigned int)nodepool_allocated(pool));
+
+	for (i = 0; i < count; i++) {
+		nodepool_put(pool, objects[i]);
+	}
+
+	free(objects);
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn static void* test_nodepool_worker(void* arg)
+ * \brief Thread body for test_nodepool_threads. Stamps each object it holds with its own address so a double hand-out would be caught
+ *
+ * \param arg The pool in question
+ *
+ * \return NULL on success, or a non-NULL value if an object was handed out twice
+ */
+static void* test_nodepool_worker(void* arg) {
+
+	int round;
+	int i;
+	uintptr_t* objects[POOL_BURST];
+	nodepool_t* pool = (nodepool_t*)arg;
+
+	for (round = 0; round < POOL_ROUNDS; round++) {
+
+		for (i = 0; i < POOL_BURST; i++) {
+			objects[i] = (uintptr_t*)nodepool_get(pool);
+			objects[i][1] = (uintptr_t)(&objects[i]);
+		}
+
+		for (i = 0; i < POOL_BURST; i++) {
+			if (objects[i][1] != (uintptr_t)(&objects[i])) {
+				return arg;
+			}
+			nodepool_put(pool, objects[i]);
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \fn int test_nodepool_threads(nodepool_t* pool, int threads)
+ * \brief Hammers one pool from several threads at once
+ *
+ * \param pool The pool in question
+ * \param threads Number of threads to run, at most POOL_THREADS
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_nodepool_threads(nodepool_t* pool, int threads) {
+
+	int i;
+	int result = EXIT_SUCCESS;
+	void* thread_result;
+	pthread_t thread[POOL_THREADS];
+
+	for (i = 0; i < threads; i++) {
+		pthread_create(&thread[i], NULL, test_nodepool_worker, pool);
+	}
+
+	for (i = 0; i < threads; i++) {
+		pthread_join(thread[i], &thread_result);
+		if (thread_result != NULL) {
+			result = EXIT_FAILURE;
+		}
+	}
+
+	printf("\tnodepool at %p shared by %d threads, %u allocated\n", (void*)pool, threads, (unsigned int)nodepool_allocated(pool));
+
+	return result;
+}
+
+/**
+ * \fn static void* test_nodepool_churner(void* arg)
+ * \brief Thread body for test_nodepool_churn. Takes + returns POOL_CHURN_HOLD objects, then exits with them still in its magazine
+ *
+ * \param arg The pool in question
+ *
+ * \return NULL on success, or a non-NULL value if the objects weren't distinct
+ */
+static void* test_nodepool_churner(void* arg) {
+
+	return (test_nodepool_get_put((nodepool_t*)(arg), POOL_CHURN_HOLD) == EXIT_SUCCESS) ? (NULL) : (arg);
+}
+
+/**
+ * \fn int test_nodepool_churn(nodepool_t* pool, int threads)
+ * \brief Runs threads short-lived threads on the pool, one after another
+ *
+ * \param pool The pool in question
+ * \param threads Number of threads to run
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_nodepool_churn(nodepool_t* pool, int threads) {
+
+	int i;
+	void* result;
+	pthread_t thread;
+
+	for (i = 0; i < threads; i++) {
+
+		if (pthread_create(&thread, NULL, test_nodepool_churner, pool) != 0) {
+			return EXIT_FAILURE;
+		}
+
+		pthread_join(thread, &result);
+		if (result != NULL) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	printf("\tnodepool at %p served %d short-lived threads with %zu objects allocated\n", (void*)(pool), threads, nodepool_allocated(pool));
+
+	return EXIT_SUCCESS;
+}
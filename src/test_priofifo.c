@@ -0,0 +1,273 @@
+/**
+ * \file test_priofifo.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "priofifo.h"
+#include "test_priofifo.h"
+
+#define GREEN "\x1B[32m"
+#define RESET "\x1B[0m"
+
+#define EXIT_FAILURE_N ((size_t)(-1))
+
+#define PRIO_LANES ((int)(3))
+
+#define TEST_PRIOFIFO_CREATE
+#define TEST_PRIOFIFO_STRICT
+#define TEST_PRIOFIFO_WEIGHTED
+#define TEST_PRIOFIFO_STATS
+
+/**
+ * \fn void test_priofifo()
+ * \brief Runs unit tests for happy cases + failure cases + boundary cases for each priofifo function
+ *
+ * \param N/A
+ *
+ * \return N/A
+ */
+void test_priofifo() {
+#ifdef TEST_PRIOFIFO_CREATE
+	priofifo_t* priofifo_create_fifo;
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Create priofifo with 3 empty lanes
+	priofifo_create_fifo = priofifo_create(PRIO_LANES, PRIOFIFO_STRICT);
+	assert(priofifo_create_fifo != NULL);
+	assert(priofifo_length(priofifo_create_fifo) == 0);
+	priofifo_destroy(priofifo_create_fifo);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to create priofifo with no lanes, more lanes than the bitmap has bits, or an unknown policy
+	assert(priofifo_create(0, PRIOFIFO_STRICT) == NULL);
+	assert(priofifo_create(PRIOFIFO_MAX_LANES + 1, PRIOFIFO_STRICT) == NULL);
+	assert(priofifo_create(PRIO_LANES, (priofifo_policy_t)(7)) == NULL);
+	//		Attempt to grab length of NULL priofifo
+	assert(priofifo_length(NULL) == EXIT_FAILURE_N);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Create priofifo with 1 lane + with every bit of the bitmap in use
+	priofifo_create_fifo = priofifo_create(1, PRIOFIFO_WEIGHTED);
+	assert(priofifo_create_fifo != NULL);
+	priofifo_destroy(priofifo_create_fifo);
+	priofifo_create_fifo = priofifo_create(PRIOFIFO_MAX_LANES, PRIOFIFO_WEIGHTED);
+	assert(priofifo_create_fifo != NULL);
+	priofifo_destroy(priofifo_create_fifo);
+#endif
+
+#ifdef TEST_PRIOFIFO_STRICT
+	// Set first parameter to priofifo to test with
+	// Set second parameter to element expected to be dequeued (NULL if the dequeue should fail)
+	// Set third parameter to lane the element is expected to come from
+
+	char bulk1_strict[13] = "bulk1_strict";
+	char bulk2_strict[13] = "bulk2_strict";
+	char ctrl1_strict[13] = "ctrl1_strict";
+	char ctrl2_strict[13] = "ctrl2_strict";
+	char mid1_strict[12] = "mid1_strict";
+
+	priofifo_t* priofifo_strict;
+	priofifo_strict = priofifo_create(PRIO_LANES, PRIOFIFO_STRICT);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Bulk traffic queued on lane 2 first, then control traffic on lane 0 + something in between on lane 1
+	assert(priofifo_enqueue(priofifo_strict, 2, bulk1_strict) == 1);
+	assert(priofifo_enqueue(priofifo_strict, 2, bulk2_strict) == 2);
+	assert(priofifo_enqueue(priofifo_strict, 0, ctrl1_strict) == 3);
+	assert(priofifo_enqueue(priofifo_strict, 1, mid1_strict) == 4);
+	//		Control traffic jumps the bulk traffic queued ahead of it
+	assert(test_priofifo_dequeue(priofifo_strict, ctrl1_strict, 0) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_strict, mid1_strict, 1) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_strict, bulk1_strict, 2) == EXIT_SUCCESS);
+	//		Control traffic arriving mid-drain still goes first
+	assert(priofifo_enqueue(priofifo_strict, 0, ctrl2_strict) == 2);
+	assert(test_priofifo_dequeue(priofifo_strict, ctrl2_strict, 0) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_strict, bulk2_strict, 2) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to enqueue to NULL priofifo, to lanes that don't exist + NULL element
+	assert(priofifo_enqueue(NULL, 0, ctrl1_strict) == EXIT_FAILURE_N);
+	assert(priofifo_enqueue(priofifo_strict, -1, ctrl1_strict) == EXIT_FAILURE_N);
+	assert(priofifo_enqueue(priofifo_strict, PRIO_LANES, ctrl1_strict) == EXIT_FAILURE_N);
+	assert(priofifo_enqueue(priofifo_strict, 0, NULL) == EXIT_FAILURE_N);
+	//		Attempt to dequeue from NULL priofifo
+	assert(test_priofifo_dequeue(NULL, NULL, 0) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Attempt to dequeue from empty priofifo
+	assert(test_priofifo_dequeue(priofifo_strict, NULL, 0) == EXIT_FAILURE);
+	assert(priofifo_length(priofifo_strict) == 0);
+	//		Failed enqueues left nothing behind
+	assert(priofifo_enqueue(priofifo_strict, 1, mid1_strict) == 1);
+	assert(test_priofifo_dequeue(priofifo_strict, mid1_strict, 1) == EXIT_SUCCESS);
+
+	priofifo_destroy(priofifo_strict);
+#endif
+
+#ifdef TEST_PRIOFIFO_WEIGHTED
+	// Set first parameter to priofifo to test with
+	// Set second parameter to element expected to be dequeued (NULL if the dequeue should fail)
+	// Set third parameter to lane the element is expected to come from
+
+	int i_weighted;
+	int lane_weighted;
+	int served_weighted[PRIO_LANES] = { 0, 0, 0 };
+	char a_weighted[2] = "a";
+	char b_weighted[2] = "b";
+	char c_weighted[2] = "c";
+
+	priofifo_t* priofifo_weighted;
+	priofifo_weighted = priofifo_create(PRIO_LANES, PRIOFIFO_WEIGHTED);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Lane 0 gets 3 dequeues per round, lane 1 gets 2, lane 2 gets the default 1
+	assert(priofifo_set_weight(priofifo_weighted, 0, 3) == EXIT_SUCCESS);
+	assert(priofifo_set_weight(priofifo_weighted, 1, 2) == EXIT_SUCCESS);
+	for (i_weighted = 0; i_weighted < 12; i_weighted++) {
+		assert(priofifo_enqueue(priofifo_weighted, 0, a_weighted) != EXIT_FAILURE_N);
+		assert(priofifo_enqueue(priofifo_weighted, 1, b_weighted) != EXIT_FAILURE_N);
+		assert(priofifo_enqueue(priofifo_weighted, 2, c_weighted) != EXIT_FAILURE_N);
+	}
+	//		First round is a a a b b c
+	assert(test_priofifo_dequeue(priofifo_weighted, a_weighted, 0) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_weighted, a_weighted, 0) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_weighted, a_weighted, 0) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_weighted, b_weighted, 1) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_weighted, b_weighted, 1) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_weighted, c_weighted, 2) == EXIT_SUCCESS);
+	//		Over the next 3 rounds each lane is served in proportion to its weight
+	for (i_weighted = 0; i_weighted < 18; i_weighted++) {
+		assert(priofifo_dequeue(priofifo_weighted, &lane_weighted) != NULL);
+		served_weighted[lane_weighted]++;
+	}
+	assert((served_weighted[0] == 9) && (served_weighted[1] == 6) && (served_weighted[2] == 3));
+	//		Lane 0 is now empty, so its turn is skipped without losing lane 1's
+	assert(test_priofifo_dequeue(priofifo_weighted, b_weighted, 1) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_weighted, b_weighted, 1) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_weighted, c_weighted, 2) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_weighted, b_weighted, 1) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to set weight on NULL priofifo, on lanes that don't exist + to 0
+	assert(priofifo_set_weight(NULL, 0, 1) == EXIT_FAILURE);
+	assert(priofifo_set_weight(priofifo_weighted, PRIO_LANES, 1) == EXIT_FAILURE);
+	assert(priofifo_set_weight(priofifo_weighted, 0, 0) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		A lane running out mid-turn hands over to the next one straight away
+	while (priofifo_length(priofifo_weighted) > 0) {
+		assert(priofifo_dequeue(priofifo_weighted, NULL) != NULL);
+	}
+	assert(priofifo_enqueue(priofifo_weighted, 1, b_weighted) == 1);
+	assert(priofifo_enqueue(priofifo_weighted, 2, c_weighted) == 2);
+	assert(test_priofifo_dequeue(priofifo_weighted, b_weighted, 1) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_weighted, c_weighted, 2) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_weighted, NULL, 0) == EXIT_FAILURE);
+
+	priofifo_destroy(priofifo_weighted);
+#endif
+
+#ifdef TEST_PRIOFIFO_STATS
+	char element1_stats[15] = "element1_stats";
+	priofifo_stats_t stats;
+
+	priofifo_t* priofifo_stats_fifo;
+	priofifo_stats_fifo = priofifo_create(PRIO_LANES, PRIOFIFO_STRICT);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Lane 1 reaches 3 elements, then 2 are dequeued
+	assert(priofifo_enqueue(priofifo_stats_fifo, 1, element1_stats) == 1);
+	assert(priofifo_enqueue(priofifo_stats_fifo, 1, element1_stats) == 2);
+	assert(priofifo_enqueue(priofifo_stats_fifo, 1, element1_stats) == 3);
+	assert(test_priofifo_dequeue(priofifo_stats_fifo, element1_stats, 1) == EXIT_SUCCESS);
+	assert(test_priofifo_dequeue(priofifo_stats_fifo, element1_stats, 1) == EXIT_SUCCESS);
+	assert(priofifo_stats(priofifo_stats_fifo, 1, &stats) == EXIT_SUCCESS);
+	assert((stats.enqueued == 3) && (stats.dequeued == 2) && (stats.length == 1) && (stats.length_max == 3));
+	//		Lanes that were never used report all zeros
+	assert(priofifo_stats(priofifo_stats_fifo, 0, &stats) == EXIT_SUCCESS);
+	assert((stats.enqueued == 0) && (stats.dequeued == 0) && (stats.length == 0) && (stats.length_max == 0));
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to read stats from NULL priofifo, from lanes that don't exist + into NULL stats
+	assert(priofifo_stats(NULL, 0, &stats) == EXIT_FAILURE);
+	assert(priofifo_stats(priofifo_stats_fifo, -1, &stats) == EXIT_FAILURE);
+	assert(priofifo_stats(priofifo_stats_fifo, PRIO_LANES, &stats) == EXIT_FAILURE);
+	assert(priofifo_stats(priofifo_stats_fifo, 0, NULL) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Destroy priofifo with an element still queued
+	priofifo_destroy(priofifo_stats_fifo);
+#endif
+
+	printf("\n");
+
+#ifdef TEST_PRIOFIFO_CREATE
+	printf(GREEN "Asserts for all test cases against priofifo_create have passed\n" RESET);
+#endif
+#ifdef TEST_PRIOFIFO_STRICT
+	printf(GREEN "Asserts for all test cases against strict priofifo_dequeue have passed\n" RESET);
+#endif
+#ifdef TEST_PRIOFIFO_WEIGHTED
+	printf(GREEN "Asserts for all test cases against weighted priofifo_dequeue have passed\n" RESET);
+#endif
+#ifdef TEST_PRIOFIFO_STATS
+	printf(GREEN "Asserts for all test cases against priofifo_stats have passed\n" RESET);
+#endif
+}
+
+/**
+ * \fn int test_priofifo_dequeue(priofifo_t* fifo, void* expected, int expected_lane)
+ * \brief Removes ("dequeues") an element from the FIFO and checks it is the expected one, from the expected lane
+ *
+ * \param fifo The fifo in question
+ * \param expected Element that should be dequeued
+ * \param expected_lane Lane it should come from
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_priofifo_dequeue(priofifo_t* fifo, void* expected, int expected_lane) {
+
+	int lane = -1;
+	void* data;
+
+	data = priofifo_dequeue(fifo, &lane);
+
+	printf("\tpriofifo at %p : dequeue %s from lane %d -> length %d\n", (void*)fifo, (data == NULL) ? "NULL" : (char*)data, lane, (int)priofifo_length(fifo));
+
+	if (data == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	assert(data == expected);
+	assert(lane == expected_lane);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,447 @@
+/**
+ * \file test_sojourn.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "cbfifo_ext.h"
+#include "llfifo.h"
+#include "llfifo_ext.h"
+#include "sojourn.h"
+#include "test_sojourn.h"
+
+#define GREEN "\x1B[32m"
+#define RESET "\x1B[0m"
+
+#define SOJOURN_THREADS ((int)(4))
+#define SOJOURN_RECORDS ((int)(10000))
+#define SOJOURN_SLEEP_NS ((long)(2000000))
+
+#define TEST_SOJOURN_BUCKET
+#define TEST_SOJOURN_RECORD
+#ifdef FIFO_SOJOURN
+#define TEST_SOJOURN_LLFIFO
+#define TEST_SOJOURN_CBFIFO
+#endif
+
+#ifdef FIFO_SOJOURN
+/**
+ * \fn static void test_sojourn_sleep()
+ * \brief Sleeps for SOJOURN_SLEEP_NS, so whatever is queued has waited at least that long
+ *
+ * \param N/A
+ *
+ * \return N/A
+ */
+static void test_sojourn_sleep() {
+
+	struct timespec wait = { .tv_sec = 0, .tv_nsec = SOJOURN_SLEEP_NS };
+
+	nanosleep(&wait, NULL);
+}
+#endif
+
+/**
+ * \fn void test_sojourn()
+ * \brief Runs unit tests for happy cases + failure cases + boundary cases for each sojourn function, plus the FIFO_SOJOURN instrumentation in llfifo + cbfifo when built with it
+ *
+ * \param N/A
+ *
+ * \return N/A
+ */
+void test_sojourn() {
+#ifdef TEST_SOJOURN_BUCKET
+	// Set first parameter to the wait to map onto a bucket
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Waits below 32 ns each get an exact bucket
+	assert(test_sojourn_bucket(0) == EXIT_SUCCESS);
+	assert(test_sojourn_bucket(31) == EXIT_SUCCESS);
+	//		Waits from 32 ns up land in buckets no wider than 1/32 of their value
+	assert(test_sojourn_bucket(32) == EXIT_SUCCESS);
+	assert(test_sojourn_bucket(1000) == EXIT_SUCCESS);
+	assert(test_sojourn_bucket(1000000000ull) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Largest possible wait lands in the last bucket
+	assert(test_sojourn_bucket(UINT64_MAX) == EXIT_SUCCESS);
+	assert(sojourn_bucket(UINT64_MAX) == (SOJOURN_BUCKETS - 1));
+	//		Powers of 2 + the value just below them land in neighbouring buckets
+	assert(sojourn_bucket(4096) == (sojourn_bucket(4095) + 1));
+#endif
+
+#ifdef TEST_SOJOURN_RECORD
+	// Set first parameter to histogram to test with
+	// Set second parameter to how many waits it should hold
+	// Set third parameter to the shortest of those waits
+
+	int i;
+	sojourn_snapshot_t* snapshot_record;
+	sojourn_hist_t* hist_record;
+
+	hist_record = sojourn_create();
+	snapshot_record = (sojourn_snapshot_t*)malloc(sizeof(sojourn_snapshot_t));
+	assert((hist_record != NULL) && (snapshot_record != NULL));
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Record waits of 1 us, 2 us, ..., 100 us
+	for (i = 1; i <= 100; i++) {
+		sojourn_record(hist_record, (uint64_t)(i) * 1000);
+	}
+	assert(test_sojourn_expect(hist_record, 100, 1000) == EXIT_SUCCESS);
+	//		Snapshot keeps exact totals + reports percentiles to within a bucket
+	assert(sojourn_snapshot(hist_record, snapshot_record) == EXIT_SUCCESS);
+	assert(snapshot_record->sum_ns == 5050000);
+	assert(snapshot_record->max_ns == 100000);
+	assert(sojourn_percentile(snapshot_record, 100.0) == 100000);
+	//		Reset empties it
+	sojourn_reset(hist_record);
+	assert(test_sojourn_expect(hist_record, 0, 0) == EXIT_SUCCESS);
+	//		Nearest rank rounds up. Waits of 1, 2 + 3 ns sit in exact buckets, so p50 is 2 and p99 is 3
+	sojourn_record(hist_record, 1);
+	sojourn_record(hist_record, 2);
+	sojourn_record(hist_record, 3);
+	assert(sojourn_snapshot(hist_record, snapshot_record) == EXIT_SUCCESS);
+	assert(sojourn_percentile(snapshot_record, 0.0) == 1);
+	assert(sojourn_percentile(snapshot_record, 50.0) == 2);
+	assert(sojourn_percentile(snapshot_record, 99.0) == 3);
+	sojourn_reset(hist_record);
+	//		Threads record into it at once without losing any waits
+	assert(test_sojourn_threads(hist_record, SOJOURN_THREADS) == EXIT_SUCCESS);
+	assert(test_sojourn_expect(hist_record, (uint64_t)(SOJOURN_THREADS) * SOJOURN_RECORDS, 0) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to snapshot NULL histogram
+	assert(sojourn_snapshot(NULL, snapshot_record) == EXIT_FAILURE);
+	//		Attempt to snapshot into NULL
+	assert(sojourn_snapshot(hist_record, NULL) == EXIT_FAILURE);
+	//		Attempt to record into NULL histogram. Nothing happens
+	sojourn_record(NULL, 5);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Percentile of an empty snapshot is 0
+	sojourn_reset(hist_record);
+	assert(sojourn_snapshot(hist_record, snapshot_record) == EXIT_SUCCESS);
+	assert(sojourn_percentile(snapshot_record, 99.0) == 0);
+	//		A wait of 0 ns is recorded like any other
+	sojourn_record(hist_record, 0);
+	assert(test_sojourn_expect(hist_record, 1, 0) == EXIT_SUCCESS);
+
+	free(snapshot_record);
+	sojourn_destroy(hist_record);
+#endif
+
+#ifdef TEST_SOJOURN_LLFIFO
+	// Set first parameter to histogram the llfifo records into
+	// Set second parameter to how many waits it should hold
+	// Set third parameter to the shortest of those waits
+
+	int element_llfifo[6] = { 1, 2, 3, 4, 5, 6 };
+	void* batch_llfifo[6] = { &element_llfifo[3], &element_llfifo[4], &element_llfifo[5] };
+	sojourn_hist_t* hist_llfifo;
+	nodepool_t* pool_llfifo;
+	llfifo_t* llfifo_sojourn;
+	llfifo_t* llfifo_sojourn_pooled;
+#ifdef FIFO_DEADLINE
+	llfifo_t* llfifo_sojourn_deadline;
+#endif
+#ifdef FIFO_CODEL
+	sojourn_hist_t* hist_codel;
+	llfifo_t* llfifo_sojourn_codel;
+#endif
+
+	hist_llfifo = sojourn_create();
+	pool_llfifo = llfifo_pool_create(4);
+	llfifo_sojourn = llfifo_create(2);
+	llfifo_sojourn_pooled = llfifo_create_pooled(pool_llfifo);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Element enqueued before the histogram is attached is not stamped
+	assert(llfifo_enqueue(llfifo_sojourn, &element_llfifo[0]) == 1);
+	assert(llfifo_set_sojourn(llfifo_sojourn, hist_llfifo) == EXIT_SUCCESS);
+	//		Enqueue 2 elements one at a time + 3 in a batch, growing past the initial capacity
+	assert(llfifo_enqueue(llfifo_sojourn, &element_llfifo[1]) == 2);
+	assert(llfifo_enqueue(llfifo_sojourn, &element_llfifo[2]) == 3);
+	assert(llfifo_enqueue_batch(llfifo_sojourn, batch_llfifo, 3) == 6);
+	test_sojourn_sleep();
+	//		Dequeue the unstamped element. Nothing is recorded
+	assert(llfifo_dequeue(llfifo_sojourn) == &element_llfifo[0]);
+	assert(test_sojourn_expect(hist_llfifo, 0, 0) == EXIT_SUCCESS);
+	//		Dequeue 1 element, then the other 4 in a batch. Each waited at least as long as the sleep
+	assert(llfifo_dequeue(llfifo_sojourn) == &element_llfifo[1]);
+	assert(test_sojourn_expect(hist_llfifo, 1, SOJOURN_SLEEP_NS) == EXIT_SUCCESS);
+	assert(llfifo_dequeue_batch(llfifo_sojourn, batch_llfifo, 6) == 4);
+	assert(test_sojourn_expect(hist_llfifo, 5, SOJOURN_SLEEP_NS) == EXIT_SUCCESS);
+	//		Pooled FIFO records into the same histogram
+	assert(llfifo_set_sojourn(llfifo_sojourn_pooled, hist_llfifo) == EXIT_SUCCESS);
+	assert(llfifo_enqueue(llfifo_sojourn_pooled, &element_llfifo[0]) == 1);
+	assert(llfifo_enqueue_batch(llfifo_sojourn_pooled, batch_llfifo, 2) == 3);
+	test_sojourn_sleep();
+	assert(llfifo_dequeue(llfifo_sojourn_pooled) == &element_llfifo[0]);
+	assert(llfifo_dequeue_batch(llfifo_sojourn_pooled, batch_llfifo, 2) == 2);
+	assert(test_sojourn_expect(hist_llfifo, 8, SOJOURN_SLEEP_NS) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to attach histogram to NULL llfifo
+	assert(llfifo_set_sojourn(NULL, hist_llfifo) == EXIT_FAILURE);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Detached FIFO stops recording, even for elements stamped while attached
+	assert(llfifo_enqueue(llfifo_sojourn, &element_llfifo[0]) == 1);
+	assert(llfifo_set_sojourn(llfifo_sojourn, NULL) == EXIT_SUCCESS);
+	assert(llfifo_dequeue(llfifo_sojourn) == &element_llfifo[0]);
+	assert(test_sojourn_expect(hist_llfifo, 8, SOJOURN_SLEEP_NS) == EXIT_SUCCESS);
+#ifdef FIFO_DEADLINE
+	//		Elements discarded for missing their deadline are not recorded, by a single dequeue or a batch
+	llfifo_sojourn_deadline = llfifo_create(0);
+	assert(llfifo_set_sojourn(llfifo_sojourn_deadline, hist_llfifo) == EXIT_SUCCESS);
+	assert(llfifo_enqueue_deadline(llfifo_sojourn_deadline, &element_llfifo[0], 1) == 1);
+	assert(llfifo_enqueue(llfifo_sojourn_deadline, &element_llfifo[1]) == 2);
+	assert(llfifo_enqueue_deadline(llfifo_sojourn_deadline, &element_llfifo[2], 1) == 3);
+	assert(llfifo_enqueue(llfifo_sojourn_deadline, &element_llfifo[3]) == 4);
+	test_sojourn_sleep();
+	assert(llfifo_dequeue(llfifo_sojourn_deadline) == &element_llfifo[1]);
+	assert(test_sojourn_expect(hist_llfifo, 9, SOJOURN_SLEEP_NS) == EXIT_SUCCESS);
+	assert(llfifo_dequeue_batch(llfifo_sojourn_deadline, batch_llfifo, 2) == 1);
+	assert(batch_llfifo[0] == &element_llfifo[3]);
+	assert(test_sojourn_expect(hist_llfifo, 10, SOJOURN_SLEEP_NS) == EXIT_SUCCESS);
+	llfifo_destroy(llfifo_sojourn_deadline);
+#endif
+#ifdef FIFO_CODEL
+	//		Elements CoDel drops are not recorded. With a 1 ns target + interval the 1st dequeue starts the interval and the 2nd drops element 1
+	hist_codel = sojourn_create();
+	llfifo_sojourn_codel = llfifo_create(0);
+	assert(llfifo_set_sojourn(llfifo_sojourn_codel, hist_codel) == EXIT_SUCCESS);
+	assert(llfifo_set_codel(llfifo_sojourn_codel, 1, 1, NULL, NULL) == EXIT_SUCCESS);
+	assert(llfifo_enqueue(llfifo_sojourn_codel, &element_llfifo[0]) == 1);
+	assert(llfifo_enqueue(llfifo_sojourn_codel, &element_llfifo[1]) == 2);
+	assert(llfifo_enqueue(llfifo_sojourn_codel, &element_llfifo[2]) == 3);
+	assert(llfifo_enqueue(llfifo_sojourn_codel, &element_llfifo[3]) == 4);
+	test_sojourn_sleep();
+	assert(llfifo_dequeue(llfifo_sojourn_codel) == &element_llfifo[0]);
+	test_sojourn_sleep();
+	assert(llfifo_dequeue(llfifo_sojourn_codel) == &element_llfifo[2]);
+	assert(llfifo_codel_dropped(llfifo_sojourn_codel) == 1);
+	assert(test_sojourn_expect(hist_codel, 2, SOJOURN_SLEEP_NS) == EXIT_SUCCESS);
+	llfifo_destroy(llfifo_sojourn_codel);
+	sojourn_destroy(hist_codel);
+#endif
+
+	llfifo_destroy(llfifo_sojourn);
+	llfifo_destroy(llfifo_sojourn_pooled);
+	nodepool_destroy(pool_llfifo);
+	sojourn_destroy(hist_llfifo);
+#endif
+
+#ifdef TEST_SOJOURN_CBFIFO
+	// Set first parameter to histogram cbfifo records into
+	// Set second parameter to how many waits it should hold
+	// Set third parameter to the shortest of those waits
+
+	int batch_cbfifo;
+	char buf_cbfifo[8];
+	sojourn_hist_t* hist_cbfifo;
+
+	hist_cbfifo = sojourn_create();
+
+	// Start from an empty global cbfifo, whatever earlier tests left in it
+	while (cbfifo_dequeue(buf_cbfifo, sizeof(buf_cbfifo)) > 0) {
+	}
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		3 bytes enqueued before the histogram is attached are not stamped
+	assert(cbfifo_enqueue("xyz", 3) == 3);
+	assert(cbfifo_set_sojourn(hist_cbfifo) == EXIT_SUCCESS);
+	//		Enqueue batches of 2 + 3 bytes
+	assert(cbfifo_enqueue("ab", 2) == 2);
+	assert(cbfifo_enqueue("cde", 3) == 3);
+	test_sojourn_sleep();
+	//		Dequeue the unstamped bytes + the first byte of "ab". No batch has fully left yet
+	assert(cbfifo_dequeue(buf_cbfifo, 4) == 4);
+	assert(test_sojourn_expect(hist_cbfifo, 0, 0) == EXIT_SUCCESS);
+	//		Dequeue the rest of "ab". Its wait is recorded once
+	assert(cbfifo_dequeue(buf_cbfifo, 1) == 1);
+	assert(test_sojourn_expect(hist_cbfifo, 1, SOJOURN_SLEEP_NS) == EXIT_SUCCESS);
+	//		Dequeue "cde" + more than is left
+	assert(cbfifo_dequeue(buf_cbfifo, 8) == 3);
+	assert(test_sojourn_expect(hist_cbfifo, 2, SOJOURN_SLEEP_NS) == EXIT_SUCCESS);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Dequeue from empty cbfifo records nothing
+	assert(cbfifo_dequeue(buf_cbfifo, 1) == 0);
+	assert(test_sojourn_expect(hist_cbfifo, 2, SOJOURN_SLEEP_NS) == EXIT_SUCCESS);
+	//		More single-byte batches than there are marks get merged, but every batch still leaves exactly once
+	for (batch_cbfifo = 0; batch_cbfifo < 20; batch_cbfifo++) {
+		assert(cbfifo_enqueue("q", 1) == 1);
+	}
+	assert(cbfifo_dequeue(buf_cbfifo, 8) == 8);
+	assert(cbfifo_dequeue(buf_cbfifo, 8) == 8);
+	assert(cbfifo_dequeue(buf_cbfifo, 8) == 4);
+	assert(test_sojourn_expect(hist_cbfifo, 18, 0) == EXIT_SUCCESS);
+
+	assert(cbfifo_set_sojourn(NULL) == EXIT_SUCCESS);
+	sojourn_destroy(hist_cbfifo);
+#endif
+
+	printf("\n");
+
+#ifdef TEST_SOJOURN_BUCKET
+	printf(GREEN "Asserts for all test cases against sojourn_bucket have passed\n" RESET);
+#endif
+#ifdef TEST_SOJOURN_RECORD
+	printf(GREEN "Asserts for all test cases against sojourn_record + sojourn_snapshot have passed\n" RESET);
+#endif
+#ifdef TEST_SOJOURN_LLFIFO
+	printf(GREEN "Asserts for all test cases against llfifo_set_sojourn have passed\n" RESET);
+#endif
+#ifdef TEST_SOJOURN_CBFIFO
+	printf(GREEN "Asserts for all test cases against cbfifo_set_sojourn have passed\n" RESET);
+#endif
+}
+
+/**
+ * \fn int test_sojourn_bucket(uint64_t wait_ns)
+ * \brief Maps a wait onto its bucket + checks the bucket's bounds contain it, are no wider than 1/32 of the wait, and meet the neighbouring buckets with no gap
+ *
+ * \param wait_ns The wait in question
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_sojourn_bucket(uint64_t wait_ns) {
+
+	size_t bucket;
+	uint64_t lower;
+	uint64_t upper;
+
+	bucket = sojourn_bucket(wait_ns);
+	lower = sojourn_bucket_lower(bucket);
+	upper = sojourn_bucket_upper(bucket);
+
+	printf("\tsojourn wait %llu ns in bucket %u covering %llu to %llu ns\n", (unsigned long long)(wait_ns), (unsigned int)(bucket), (unsigned long long)(lower), (unsigned long long)(upper));
+
+	if ((bucket >= SOJOURN_BUCKETS) || (lower > wait_ns) || (upper < wait_ns)) {
+		return EXIT_FAILURE;
+	}
+
+	if ((upper - lower) > (wait_ns >> SOJOURN_SUB_BITS)) {
+		return EXIT_FAILURE;
+	}
+
+	if ((bucket > 0) && (sojourn_bucket_upper(bucket - 1) != (lower - 1))) {
+		return EXIT_FAILURE;
+	}
+
+	if ((bucket < (SOJOURN_BUCKETS - 1)) && (sojourn_bucket_lower(bucket + 1) != (upper + 1))) {
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int test_sojourn_expect(sojourn_hist_t* hist, uint64_t count, uint64_t min_ns)
+ * \brief Takes a snapshot + checks it holds count waits, none of them shorter than min_ns
+ *
+ * \param hist The histogram in question
+ * \param count How many waits it should hold
+ * \param min_ns Shortest wait it should hold
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_sojourn_expect(sojourn_hist_t* hist, uint64_t count, uint64_t min_ns) {
+
+	int result = EXIT_SUCCESS;
+	sojourn_snapshot_t* snapshot;
+
+	snapshot = (sojourn_snapshot_t*)malloc(sizeof(sojourn_snapshot_t));
+	if ((snapshot == NULL) || (sojourn_snapshot(hist, snapshot) != EXIT_SUCCESS)) {
+		free(snapshot);
+		return EXIT_FAILURE;
+	}
+
+	printf("\tsojourn histogram at %p : %llu waits, p50 %llu ns, p99 %llu ns, max %llu ns\n", (void*)(hist), (unsigned long long)(snapshot->count), (unsigned long long)sojourn_percentile(snapshot, 50.0), (unsigned long long)sojourn_percentile(snapshot, 99.0), (unsigned long long)(snapshot->max_ns));
+
+	// Percentile 0 is the upper bound of the lowest non-empty bucket, which is at least the shortest wait
+	if ((snapshot->count != count) || ((count > 0) && (sojourn_percentile(snapshot, 0.0) < min_ns))) {
+		result = EXIT_FAILURE;
+	}
+
+	free(snapshot);
+
+	return result;
+}
+
+/**
+ * \fn static void* test_sojourn_worker(void* arg)
+ * \brief Thread body for test_sojourn_threads. Records SOJOURN_RECORDS waits of varying length
+ *
+ * \param arg The histogram in question
+ *
+ * \return NULL
+ */
+static void* test_sojourn_worker(void* arg) {
+
+	int i;
+
+	for (i = 0; i < SOJOURN_RECORDS; i++) {
+		sojourn_record((sojourn_hist_t*)(arg), (uint64_t)(i) * 37);
+	}
+
+	return NULL;
+}
+
+/**
+ * \fn int test_sojourn_threads(sojourn_hist_t* hist, int threads)
+ * \brief Records into one histogram from several threads at once
+ *
+ * \param hist The histogram in question
+ * \param threads Number of threads to run, at most SOJOURN_THREADS
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_sojourn_threads(sojourn_hist_t* hist, int threads) {
+
+	int i;
+	pthread_t thread[SOJOURN_THREADS];
+
+	if ((threads <= 0) || (threads > SOJOURN_THREADS)) {
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < threads; i++) {
+		if (pthread_create(&thread[i], NULL, test_sojourn_worker, hist) != 0) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	for (i = 0; i < threads; i++) {
+		pthread_join(thread[i], NULL);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,348 @@
+/**
+ * \file test_wsdeque.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "wsdeque.h"
+#include "test_wsdeque.h"
+
+#define GREEN "\x1B[32m"
+#define RESET "\x1B[0m"
+
+#define WSDEQUE_THIEVES ((int)(3))
+#define WSDEQUE_TASKS ((int)(200000))
+
+#define TEST_WSDEQUE_PUSH_POP
+#define TEST_WSDEQUE_STEAL
+#define TEST_WSDEQUE_THREADS
+
+/**
+ * \fn void test_wsdeque()
+ * \brief Runs unit tests for happy cases + failure cases + boundary cases for each wsdeque function
+ *
+ * \param N/A
+ *
+ * \return N/A
+ */
+void test_wsdeque() {
+#ifdef TEST_WSDEQUE_PUSH_POP
+	// Set first parameter to deque to test with
+	// Set second parameter to the first value to push or expect. Values are small integers cast to pointers
+	// Set third parameter to how many values to push or pop
+
+	wsdeque_t* deque_push_pop;
+	deque_push_pop = wsdeque_create(0);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Push 1..8 then pop them back newest first. Resulting length will be 0
+	assert(test_wsdeque_push(deque_push_pop, 1, 8) == EXIT_SUCCESS);
+	assert(wsdeque_length(deque_push_pop) == 8);
+	assert(test_wsdeque_pop(deque_push_pop, 8, 8) == EXIT_SUCCESS);
+	assert(wsdeque_length(deque_push_pop) == 0);
+
+	// ------------------- //
+	// Failure Test Cases  //
+	// ------------------- //
+	//		Attempt to push NULL element + push to NULL deque
+	assert(wsdeque_push(deque_push_pop, NULL) == (size_t)(-1));
+	assert(wsdeque_push(NULL, (void*)(uintptr_t)(1)) == (size_t)(-1));
+	//		Attempt to pop + steal from NULL deque
+	assert(wsdeque_pop(NULL) == NULL);
+	assert(wsdeque_steal(NULL) == NULL);
+	assert(wsdeque_length(NULL) == (size_t)(-1));
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Attempt to pop from empty deque, twice, so bottom is restored each time
+	assert(wsdeque_pop(deque_push_pop) == NULL);
+	assert(wsdeque_pop(deque_push_pop) == NULL);
+	assert(wsdeque_length(deque_push_pop) == 0);
+	//		Capacity starts at the minimum of 16 + grows by doubling once 17 values are pushed
+	assert(wsdeque_capacity(deque_push_pop) == 16);
+	assert(test_wsdeque_push(deque_push_pop, 1, 17) == EXIT_SUCCESS);
+	assert(wsdeque_capacity(deque_push_pop) == 32);
+	//		Values survive the grow, in order
+	assert(test_wsdeque_pop(deque_push_pop, 17, 17) == EXIT_SUCCESS);
+	//		Requested capacity is rounded up to a power of 2
+	wsdeque_destroy(deque_push_pop);
+	deque_push_pop = wsdeque_create(100);
+	assert(wsdeque_capacity(deque_push_pop) == 128);
+	wsdeque_destroy(deque_push_pop);
+#endif
+
+#ifdef TEST_WSDEQUE_STEAL
+	// Set first parameter to deque to test with
+	// Set second parameter to the first value to push or expect. Values are small integers cast to pointers
+	// Set third parameter to how many values to push or steal
+
+	wsdeque_t* deque_steal;
+	deque_steal = wsdeque_create(4);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Push 1..4 then steal them oldest first. Resulting length will be 0
+	assert(test_wsdeque_push(deque_steal, 1, 4) == EXIT_SUCCESS);
+	assert(test_wsdeque_steal(deque_steal, 1, 4) == EXIT_SUCCESS);
+	//		Push 1..4, steal 1, pop 4. Owner + thief work at opposite ends
+	assert(test_wsdeque_push(deque_steal, 1, 4) == EXIT_SUCCESS);
+	assert(test_wsdeque_steal(deque_steal, 1, 1) == EXIT_SUCCESS);
+	assert(test_wsdeque_pop(deque_steal, 4, 1) == EXIT_SUCCESS);
+	assert(wsdeque_length(deque_steal) == 2);
+
+	// ------------------- //
+	// Boundary Test Cases //
+	// ------------------- //
+	//		Last element goes to exactly one of steal + pop
+	assert(test_wsdeque_steal(deque_steal, 2, 1) == EXIT_SUCCESS);
+	assert(wsdeque_steal(deque_steal) == (void*)(uintptr_t)(3));
+	assert(wsdeque_pop(deque_steal) == NULL);
+	assert(wsdeque_steal(deque_steal) == NULL);
+	//		Steals keep working across a grow, which happens while stolen-from indices are far from 0
+	assert(test_wsdeque_push(deque_steal, 1, 40) == EXIT_SUCCESS);
+	assert(test_wsdeque_steal(deque_steal, 1, 20) == EXIT_SUCCESS);
+	assert(test_wsdeque_pop(deque_steal, 40, 20) == EXIT_SUCCESS);
+	wsdeque_destroy(deque_steal);
+#endif
+
+#ifdef TEST_WSDEQUE_THREADS
+	// Set first parameter to deque to test with
+	// Set second parameter to number of thief threads
+
+	wsdeque_t* deque_threads;
+	deque_threads = wsdeque_create(0);
+
+	// ------------------- //
+	// Happy Test Cases    //
+	// ------------------- //
+	//		Owner pushes + pops while thieves steal. Every value is taken exactly once, and the deque grows under contention
+	assert(test_wsdeque_threads(deque_threads, WSDEQUE_THIEVES) == EXIT_SUCCESS);
+	assert(wsdeque_length(deque_threads) == 0);
+
+	wsdeque_destroy(deque_threads);
+#endif
+
+	printf("\n");
+
+#ifdef TEST_WSDEQUE_PUSH_POP
+	printf(GREEN "Asserts for all test cases against wsdeque_push + wsdeque_pop have passed\n" RESET);
+#endif
+#ifdef TEST_WSDEQUE_STEAL
+	printf(GREEN "Asserts for all test cases against wsdeque_steal have passed\n" RESET);
+#endif
+#ifdef TEST_WSDEQUE_THREADS
+	printf(GREEN "Asserts for all test cases against wsdeque shared with thieves have passed\n" RESET);
+#endif
+}
+
+/**
+ * \fn int test_wsdeque_push(wsdeque_t* deque, int first, int count)
+ * \brief Pushes the values first..first+count-1, cast to pointers, onto the deque
+ *
+ * \param deque The deque in question
+ * \param first First value to push, which cannot be 0
+ * \param count Number of values to push
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_wsdeque_push(wsdeque_t* deque, int first, int count) {
+
+	int i;
+
+	for (i = first; i < first + count; i++) {
+		if (wsdeque_push(deque, (void*)(uintptr_t)(i)) == (size_t)(-1)) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	printf("\twsdeque at %p pushed %d..%d, length %u, capacity %u\n", (void*)deque, first, first + count - 1, (unsigned int)wsdeque_length(deque), (unsigned int)wsdeque_capacity(deque));
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int test_wsdeque_pop(wsdeque_t* deque, int first, int count)
+ * \brief Pops count values off the deque and checks they come out as first, first-1, ... (newest first)
+ *
+ * \param deque The deque in question
+ * \param first Value expected from the first pop
+ * \param count Number of values to pop
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_wsdeque_pop(wsdeque_t* deque, int first, int count) {
+
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (wsdeque_pop(deque) != (void*)(uintptr_t)(first - i)) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	printf("\twsdeque at %p popped %d..%d, length %u\n", (void*)deque, first, first - count + 1, (unsigned int)wsdeque_length(deque));
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \fn int test_wsdeque_steal(wsdeque_t* deque, int first, int count)
+ * \brief Steals count values off the deque and checks they come out as first, first+1, ... (oldest first)
+ *
+ * \param deque The deque in question
+ * \param first Value expected from the first steal
+ * \param count Number of values to steal
+ *
+ * \return If successful, returns EXIT_SUCCESS (0). In the case of an error, the function returns EXIT_FAILURE (1)
+ */
+int test_wsdeque_steal(wsdeque_t* deque, int first, int count) {
+
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (wsdeque_steal(deque) != (void*)(uintptr_t)(first + i)) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	printf("\twsdeque at %p had %d..%d stolen, length %u\n", (void*)deque, first, first + count - 1, (unsigned int)wsdeque_length(deque));
+
+	return EXIT_SUCCESS;
+}
+
+/**
+ * \typedef test_wsdeque_shared_t
+ * \brief Allows struct test_wsdeque_shared_s to be instantiated as test_wsdeque_shared_t
+ */
+typedef struct test_wsdeque_shared_s test_wsdeque_shared_t;
+
+/**
+ * \struct test_wsdeque_shared_s
+ * \brief State shared by the owner + thieves in test_wsdeque_threads
+ *
+ * \detail wsdeque_t* deque - The deque in question
+ * \detail _Atomic(unsigned char)* taken - One flag per value, set by whoever took it. A second take of the same value is an error
+ * \detail atomic_int taken_count - Number of values taken so far, by anyone
+ * \detail atomic_int errors - Number of values taken twice or out of range
+ */
+struct test_wsdeque_shared_s {
+	wsdeque_t* deque;
+	_Atomic(unsigned char)* taken;
+	atomic_int taken_count;
+	atomic_int errors;
+};
+
+/**
+ * \fn static void test_wsdeque_take(test_wsdeque_shared_t* shared, void* element)
+ * \brief Records that element was taken, flagging it if it was taken before
+ *
+ * \param shared State shared by every thread
+ * \param element The value that was popped or stolen
+ *
+ * \return N/A
+ */
+static void test_wsdeque_take(test_wsdeque_shared_t* shared, void* element) {
+
+	uintptr_t value = (uintptr_t)(element);
+
+	if ((value == 0) || (value > WSDEQUE_TASKS) || (atomic_exchange(&(shared->taken[value]), 1) != 0)) {
+		atomic_fetch_add(&(shared->errors), 1);
+	}
+
+	atomic_fetch_add(&(shared->taken_count), 1);
+}
+
+/**
+ * \fn static void* test_wsdeque_thief(void* arg)
+ * \brief Thread body: steals until every value has been taken
+ *
+ * \param arg The test_wsdeque_shared_t in question
+ *
+ * \return NULL
+ */
+static void* test_wsdeque_thief(void* arg) {
+
+	void* element;
+	test_wsdeque_shared_t* shared = (test_wsdeque_shared_t*)arg;
+
+	while (atomic_load(&(shared->taken_count)) < WSDEQUE_TASKS) {
+		element = wsdeque_steal(shared->deque);
+		if (element != NULL) {
+			test_wsdeque_take(shared, element);
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \fn int test_wsdeque_threads(wsdeque_t* deque, int thieves)
+ * \brief The calling thread owns the deque and pushes WSDEQUE_TASKS values in bursts, popping a few after each burst, while thieves steal concurrently
+ *
+ * \param deque The deque in question, which must be empty
+ * \param thieves Number of thief threads, at most WSDEQUE_THIEVES
+ *
+ * \return If every value was taken exactly once, returns EXIT_SUCCESS (0). Otherwise the function returns EXIT_FAILURE (1)
+ */
+int test_wsdeque_threads(wsdeque_t* deque, int thieves) {
+
+	int i;
+	int value;
+	void* element;
+	pthread_t thread[WSDEQUE_THIEVES];
+	test_wsdeque_shared_t shared;
+
+	shared.deque = deque;
+	shared.taken = (_Atomic(unsigned char)*)calloc(WSDEQUE_TASKS + 1, sizeof(_Atomic(unsigned char)));
+	atomic_init(&(shared.taken_count), 0);
+	atomic_init(&(shared.errors), 0);
+	if (shared.taken == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < thieves; i++) {
+		pthread_create(&thread[i], NULL, test_wsdeque_thief, &shared);
+	}
+
+	// Push in bursts of 64, popping 16 after each burst, so pops race steals on a deque that keeps growing
+	for (value = 1; value <= WSDEQUE_TASKS; value++) {
+		assert(wsdeque_push(deque, (void*)(uintptr_t)(value)) != (size_t)(-1));
+
+		if ((value % 64) == 0) {
+			for (i = 0; i < 16; i++) {
+				element = wsdeque_pop(deque);
+				if (element != NULL) {
+					test_wsdeque_take(&shared, element);
+				}
+			}
+		}
+	}
+
+	// Drain whatever the thieves haven't taken yet
+	while ((element = wsdeque_pop(deque)) != NULL) {
+		test_wsdeque_take(&shared, element);
+	}
+
+	for (i = 0; i < thieves; i++) {
+		pthread_join(thread[i], NULL);
+	}
+
+	printf("\twsdeque at %p shared with %d thieves, %d values taken, capacity %u\n", (void*)deque, thieves, atomic_load(&(shared.taken_count)), (unsigned int)wsdeque_capacity(deque));
+
+	free(shared.taken);
+
+	if ((atomic_load(&(shared.errors)) != 0) || (atomic_load(&(shared.taken_count)) != WSDEQUE_TASKS)) {
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
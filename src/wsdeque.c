@@ -0,0 +1,345 @@
+/**
+ * \file wsdeque.c
+ * \author Dayton Flores, dayton.flores@colorado.edu
+ *
+ * \brief Chase-Lev deque with the C11 memory orderings from Le, Pop, Cohen + Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013)
+ */
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "wsdeque.h"
+
+#define EXIT_FAILURE_N ((size_t)(-1))
+
+#define WSDEQUE_MIN_CAPACITY ((size_t)(16))
+
+/**
+ * \typedef wsarray_t
+ * \brief Allows struct wsarray_s to be instantiated as wsarray_t
+ */
+typedef struct wsarray_s wsarray_t;
+
+/**
+ * \struct wsarray_s
+ * \brief Circular array backing the deque. Element i lives in slots[i & mask]
+ *
+ * \detail wsarray_t* retired - Next older array replaced by a grow. Only the owner touches this
+ * \detail size_t mask - Number of slots minus 1. The number of slots is always a power of 2
+ * \detail _Atomic(void*) slots[] - The elements. Atomic since a thief may read a slot while the owner writes another lap of it
+ */
+struct wsarray_s {
+	wsarray_t* retired;
+	size_t mask;
+	_Atomic(void*) slots[];
+};
+
+/**
+ * \struct wsdeque_s
+ * \brief Elements top..bottom-1 are in the deque. The owner works at bottom, thieves at top. Both only ever increase, except the owner briefly lowering bottom inside pop
+ *
+ * \detail _Atomic(int64_t) top - Index of the oldest element, the next one to be stolen. Only ever advanced by a successful CAS
+ * \detail _Atomic(int64_t) bottom - Index one past the newest element. Only the owner writes this
+ * \detail _Atomic(wsarray_t*) array - Current circular array. Only the owner replaces it
+ * \detail wsarray_t* retired - Arrays replaced by a grow. A thief that loaded one before the grow may still be reading it, so they are only freed on destroy. Each array is half the size of the next, so together they never take more memory than the current one
+ */
+struct wsdeque_s {
+	_Alignas(64) _Atomic(int64_t) top;
+	_Alignas(64) _Atomic(int64_t) bottom;
+	_Atomic(wsarray_t*) array;
+	wsarray_t* retired;
+};
+
+/**
+ * \fn static wsarray_t* wsarray_create(size_t slots)
+ * \brief Allocates an empty circular array
+ *
+ * \param slots Number of slots, which must be a power of 2
+ *
+ * \return Pointer to the array, or NULL if allocation failed
+ */
+static wsarray_t* wsarray_create(size_t slots) {
+
+	size_t i;
+	wsarray_t* array;
+
+	// Ensure the array size can be represented without overflowing
+	if (slots > ((SIZE_MAX - sizeof(wsarray_t)) / sizeof(_Atomic(void*)))) {
+		return NULL;
+	}
+
+	array = (wsarray_t*)malloc(sizeof(wsarray_t) + (slots * sizeof(_Atomic(void*))));
+	if (array == NULL) {
+		return NULL;
+	}
+
+	array->retired = NULL;
+	array->mask = slots - 1;
+	for (i = 0; i < slots; i++) {
+		atomic_init(&(array->slots[i]), NULL);
+	}
+
+	return array;
+}
+
+/**
+ * \fn static wsarray_t* wsdeque_grow(wsdeque_t* deque, wsarray_t* old, int64_t top, int64_t bottom)
+ * \brief Owner only: copies elements top..bottom-1 into an array twice the size and publishes it. The old array is retired rather than freed, since thieves may still be reading it
+ *
+ * \param deque The deque in question
+ * \param old The current array
+ * \param top Top as last seen by the owner
+ * \param bottom Current bottom
+ *
+ * \return The new array, or NULL if allocation failed, in which case the deque is unchanged
+ */
+static wsarray_t* wsdeque_grow(wsdeque_t* deque, wsarray_t* old, int64_t top, int64_t bottom) {
+
+	int64_t i;
+	wsarray_t* array;
+
+	array = wsarray_create((old->mask + 1) * 2);
+	if (array == NULL) {
+		return NULL;
+	}
+
+	for (i = top; i < bottom; i++) {
+		atomic_store_explicit(&(array->slots[(size_t)(i) & array->mask]), atomic_load_explicit(&(old->slots[(size_t)(i) & old->mask]), memory_order_relaxed), memory_order_relaxed);
+	}
+
+	old->retired = deque->retired;
+	deque->retired = old;
+
+	atomic_store_explicit(&(deque->array), array, memory_order_release);
+
+	return array;
+}
+
+/**
+ * \fn wsdeque_t* wsdeque_create(size_t capacity)
+ * \brief Creates and initializes the deque
+ *
+ * \param capacity Initial number of elements the deque can hold before growing. Rounded up to a power of 2, and to at least 16
+ *
+ * \return If successful, returns pointer to a newly-created wsdeque_t instance. In the case of an error, the function returns NULL
+ */
+wsdeque_t* wsdeque_create(size_t capacity) {
+
+	size_t slots;
+	wsdeque_t* deque;
+
+	// Round up to a power of 2 so indexing is a mask instead of a modulo
+	slots = WSDEQUE_MIN_CAPACITY;
+	while (slots < capacity) {
+		if (slots > (SIZE_MAX / 2)) {
+			return NULL;
+		}
+		slots *= 2;
+	}
+
+	deque = (wsdeque_t*)aligned_alloc(64, (sizeof(wsdeque_t) + 63) & ~((size_t)(63)));
+	if (deque == NULL) {
+		return NULL;
+	}
+
+	atomic_init(&(deque->top), 0);
+	atomic_init(&(deque->bottom), 0);
+	atomic_init(&(deque->array), wsarray_create(slots));
+	deque->retired = NULL;
+
+	if (atomic_load_explicit(&(deque->array), memory_order_relaxed) == NULL) {
+		free(deque);
+		return NULL;
+	}
+
+	return deque;
+}
+
+/**
+ * \fn size_t wsdeque_push(wsdeque_t* deque, void* element)
+ * \brief Owner only: pushes an element onto the bottom of the deque, growing the array if it is full. Never blocks and never waits on thieves
+ *
+ * \param deque The deque in question
+ * \param element The element to push, which cannot be NULL
+ *
+ * \return If successful, returns the number of elements in the deque as seen by the owner. In the case of an error, the function returns (size_t)(-1)
+ */
+size_t wsdeque_push(wsdeque_t* deque, void* element) {
+
+	int64_t top;
+	int64_t bottom;
+	wsarray_t* array;
+
+	// Ensure the deque + element are valid
+	if ((deque == NULL) || (element == NULL)) {
+		return EXIT_FAILURE_N;
+	}
+
+	bottom = atomic_load_explicit(&(deque->bottom), memory_order_relaxed);
+	top = atomic_load_explicit(&(deque->top), memory_order_acquire);
+	array = atomic_load_explicit(&(deque->array), memory_order_relaxed);
+
+	// Grow the array if every slot is in use
+	if ((size_t)(bottom - top) > array->mask) {
+		array = wsdeque_grow(deque, array, top, bottom);
+		if (array == NULL) {
+			return EXIT_FAILURE_N;
+		}
+	}
+
+	atomic_store_explicit(&(array->slots[(size_t)(bottom) & array->mask]), element, memory_order_relaxed);
+
+	// Make the element visible before a thief can see the new bottom. A release store rather than a release fence + relaxed store, so race detectors that don't model fences still see the hand-off
+	atomic_store_explicit(&(deque->bottom), bottom + 1, memory_order_release);
+
+	return (size_t)(bottom + 1 - top);
+}
+
+/**
+ * \fn void* wsdeque_pop(wsdeque_t* deque)
+ * \brief Owner only: pops the newest element off the bottom of the deque. Only synchronizes with thieves when a single element is left
+ *
+ * \param deque The deque in question
+ *
+ * \return If successful, returns the popped element, or NULL if the deque was empty or a thief took the last element
+ */
+void* wsdeque_pop(wsdeque_t* deque) {
+
+	int64_t top;
+	int64_t bottom;
+	void* element;
+	wsarray_t* array;
+
+	if (deque == NULL) {
+		return NULL;
+	}
+
+	// Claim the bottom element before looking at top, so a thief racing for it will see the lower bottom
+	bottom = atomic_load_explicit(&(deque->bottom), memory_order_relaxed) - 1;
+	array = atomic_load_explicit(&(deque->array), memory_order_relaxed);
+	atomic_store_explicit(&(deque->bottom), bottom, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	top = atomic_load_explicit(&(deque->top), memory_order_relaxed);
+
+	// Special case of deque already being empty
+	if (top > bottom) {
+		atomic_store_explicit(&(deque->bottom), bottom + 1, memory_order_relaxed);
+		return NULL;
+	}
+
+	element = atomic_load_explicit(&(array->slots[(size_t)(bottom) & array->mask]), memory_order_relaxed);
+
+	// Special case of taking the last element, which a thief may be trying to steal too. Whoever advances top gets it
+	if (top == bottom) {
+		if (!atomic_compare_exchange_strong_explicit(&(deque->top), &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+			element = NULL;
+		}
+		atomic_store_explicit(&(deque->bottom), bottom + 1, memory_order_relaxed);
+	}
+
+	return element;
+}
+
+/**
+ * \fn void* wsdeque_steal(wsdeque_t* deque)
+ * \brief Any thread: steals the oldest element off the top of the deque
+ *
+ * \param deque The deque in question
+ *
+ * \return If successful, returns the stolen element. Returns NULL if the deque was empty or another thread won the race for the element, in which case the caller should just try another victim
+ */
+void* wsdeque_steal(wsdeque_t* deque) {
+
+	int64_t top;
+	int64_t bottom;
+	void* element;
+	wsarray_t* array;
+
+	if (deque == NULL) {
+		return NULL;
+	}
+
+	top = atomic_load_explicit(&(deque->top), memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	bottom = atomic_load_explicit(&(deque->bottom), memory_order_acquire);
+
+	if (top >= bottom) {
+		return NULL;
+	}
+
+	// Read the element before claiming it. If the CAS fails the value is simply dropped
+	array = atomic_load_explicit(&(deque->array), memory_order_acquire);
+	element = atomic_load_explicit(&(array->slots[(size_t)(top) & array->mask]), memory_order_relaxed);
+
+	if (!atomic_compare_exchange_strong_explicit(&(deque->top), &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+		return NULL;
+	}
+
+	return element;
+}
+
+/**
+ * \fn size_t wsdeque_length(wsdeque_t* deque)
+ * \brief Returns the number of elements currently in the deque. Exact for the owner while no thief is active, otherwise a snapshot that may already be stale
+ *
+ * \param deque The deque in question
+ *
+ * \return Returns the number of elements in the deque, or (size_t)(-1) if deque is NULL
+ */
+size_t wsdeque_length(wsdeque_t* deque) {
+
+	int64_t top;
+	int64_t bottom;
+
+	if (deque == NULL) {
+		return EXIT_FAILURE_N;
+	}
+
+	bottom = atomic_load_explicit(&(deque->bottom), memory_order_acquire);
+	top = atomic_load_explicit(&(deque->top), memory_order_acquire);
+
+	return (bottom > top) ? ((size_t)(bottom - top)) : (0);
+}
+
+/**
+ * \fn size_t wsdeque_capacity(wsdeque_t* deque)
+ * \brief Returns the number of elements the current array holds before the next push grows it
+ *
+ * \param deque The deque in question
+ *
+ * \return Returns the current capacity, or (size_t)(-1) if deque is NULL
+ */
+size_t wsdeque_capacity(wsdeque_t* deque) {
+
+	if (deque == NULL) {
+		return EXIT_FAILURE_N;
+	}
+
+	return atomic_load_explicit(&(deque->array), memory_order_acquire)->mask + 1;
+}
+
+/**
+ * \fn void wsdeque_destroy(wsdeque_t* deque)
+ * \brief Teardown function: Frees the current array and every retired one. Elements still in the deque are not touched. No thread may be using the deque by now!
+ *
+ * \param deque The deque in question
+ *
+ * \return N/A
+ */
+void wsdeque_destroy(wsdeque_t* deque) {
+
+	wsarray_t* array;
+
+	if (deque == NULL) {
+		return;
+	}
+
+	while (deque->retired != NULL) {
+		array = deque->retired;
+		deque->retired = array->retired;
+		free(array);
+	}
+
+	free(atomic_load_explicit(&(deque->array), memory_order_relaxed));
+	free(deque);
+}